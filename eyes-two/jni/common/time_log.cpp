@@ -20,12 +20,314 @@
 #include "time_log.h"
 
 #ifdef LOG_TIME
-// Storage for logging functionality.
-int32 num_time_logs = 0;
-LogEntry time_logs[NUM_LOGS];
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
 
-int32 num_avg_entries = 0;
-AverageEntry avg_entries[NUM_LOGS];
+enum TraceEventKind {
+  TRACE_MARK,
+  TRACE_SCOPE_END
+};
 
-float32 running_total = 0.0f;
+// An event of a thread: the interval since the previous mark for a mark, or
+// the time from its begin to its end for a scope.
+struct TraceEvent {
+  const char* id;
+  int64 start_wall_ns;
+  int64 end_wall_ns;
+  int64 cpu_ns;
+  int16 depth;
+  int16 kind;
+};
+
+struct AverageEntry {
+  const char* id;
+  int32 kind;
+  float32 average_duration;
+};
+
+// The log of a thread. Logs are never freed, and the log of a thread that
+// exited is reused by the next new thread.
+struct ThreadTrace {
+  // Next log in trace_list.
+  ThreadTrace* next;
+  // Whether a live thread owns the log.
+  volatile int32 in_use;
+  // Id of the log in the Chrome trace.
+  int32 tid;
+
+  // Ring buffer of the events. Event i is at events[i % NUM_TRACE_EVENTS].
+  TraceEvent events[NUM_TRACE_EVENTS];
+  // Number of events ever logged. Only incremented once the event is
+  // written, so readers on other threads see complete events.
+  volatile uint32 num_events;
+
+  // Number of events at the last resetTimeLog.
+  uint32 frame_start;
+  // Time of the previous mark since the last resetTimeLog, if any.
+  bool has_mark;
+  int64 last_mark_wall_ns;
+  int64 last_mark_cpu_ns;
+
+  // The open scopes.
+  int32 depth;
+  const char* scope_ids[MAX_TRACE_DEPTH];
+  int64 scope_start_wall_ns[MAX_TRACE_DEPTH];
+  int64 scope_start_cpu_ns[MAX_TRACE_DEPTH];
+
+  // Storage for keeping track of average values (each entry may not be
+  // printed out each frame).
+  AverageEntry avg_entries[NUM_LOGS];
+  int32 num_avg_entries;
+  float32 running_total;
+};
+
+// All the logs ever created, pushed at the front without locks.
+static ThreadTrace* volatile trace_list = NULL;
+static volatile int32 num_traces = 0;
+
+static pthread_key_t trace_key;
+static pthread_once_t trace_key_once = PTHREAD_ONCE_INIT;
+
+// Called when a thread with a log exits, to let the next thread reuse it.
+static void releaseThreadTrace(void* data) {
+  ThreadTrace* const trace = static_cast<ThreadTrace*>(data);
+  __sync_synchronize();
+  trace->in_use = 0;
+}
+
+static void createTraceKey() {
+  pthread_key_create(&trace_key, releaseThreadTrace);
+}
+
+static void clearThreadTrace(ThreadTrace* const trace) {
+  trace->num_events = 0;
+  trace->frame_start = 0;
+  trace->has_mark = false;
+  trace->depth = 0;
+  trace->num_avg_entries = 0;
+  trace->running_total = 0.0f;
+}
+
+// Returns the log of the calling thread, claiming or creating one on the
+// first call of the thread.
+static ThreadTrace* getThreadTrace() {
+  pthread_once(&trace_key_once, createTraceKey);
+  ThreadTrace* trace = static_cast<ThreadTrace*>(pthread_getspecific(trace_key));
+  if (trace != NULL) {
+    return trace;
+  }
+
+  // Reuse the log of an exited thread if there is one.
+  for (trace = trace_list; trace != NULL; trace = trace->next) {
+    if (trace->in_use == 0 &&
+        __sync_bool_compare_and_swap(&trace->in_use, 0, 1)) {
+      break;
+    }
+  }
+  if (trace == NULL) {
+    trace = new ThreadTrace;
+    trace->in_use = 1;
+    trace->tid = __sync_fetch_and_add(&num_traces, 1);
+    clearThreadTrace(trace);
+    ThreadTrace* head;
+    do {
+      head = trace_list;
+      trace->next = head;
+    } while (!__sync_bool_compare_and_swap(&trace_list, head, trace));
+  } else {
+    clearThreadTrace(trace);
+  }
+  pthread_setspecific(trace_key, trace);
+  return trace;
+}
+
+static void addEvent(ThreadTrace* const trace, const char* id,
+                     const int64 start_wall_ns, const int64 end_wall_ns,
+                     const int64 cpu_ns, const TraceEventKind kind) {
+  const uint32 num_events = trace->num_events;
+  TraceEvent* const event =
+      trace->events + (num_events & (NUM_TRACE_EVENTS - 1));
+  event->id = id;
+  event->start_wall_ns = start_wall_ns;
+  event->end_wall_ns = end_wall_ns;
+  event->cpu_ns = cpu_ns;
+  event->depth = trace->depth;
+  event->kind = kind;
+  __sync_synchronize();
+  trace->num_events = num_events + 1;
+}
+
+void resetTimeLog() {
+  ThreadTrace* const trace = getThreadTrace();
+  trace->frame_start = trace->num_events;
+  trace->has_mark = false;
+}
+
+void timeLog(const char* str) {
+  ThreadTrace* const trace = getThreadTrace();
+  const int64 wall_ns = currentWallTimeNanos();
+  const int64 cpu_ns = currentThreadTimeNanos();
+  // The first mark since the reset has an empty interval.
+  if (!trace->has_mark) {
+    trace->last_mark_wall_ns = wall_ns;
+    trace->last_mark_cpu_ns = cpu_ns;
+    trace->has_mark = true;
+  }
+  addEvent(trace, str, trace->last_mark_wall_ns, wall_ns,
+           cpu_ns - trace->last_mark_cpu_ns, TRACE_MARK);
+  trace->last_mark_wall_ns = wall_ns;
+  trace->last_mark_cpu_ns = cpu_ns;
+}
+
+void beginTraceScope(const char* id) {
+  ThreadTrace* const trace = getThreadTrace();
+  if (trace->depth < MAX_TRACE_DEPTH) {
+    trace->scope_ids[trace->depth] = id;
+    trace->scope_start_wall_ns[trace->depth] = currentWallTimeNanos();
+    trace->scope_start_cpu_ns[trace->depth] = currentThreadTimeNanos();
+  }
+  // Scopes deeper than MAX_TRACE_DEPTH are counted but not logged.
+  ++trace->depth;
+}
+
+void endTraceScope() {
+  ThreadTrace* const trace = getThreadTrace();
+  if (trace->depth <= 0) {
+    LOGE("Ended a trace scope that was not begun!");
+    return;
+  }
+  --trace->depth;
+  if (trace->depth < MAX_TRACE_DEPTH) {
+    const int32 depth = trace->depth;
+    addEvent(trace, trace->scope_ids[depth],
+             trace->scope_start_wall_ns[depth], currentWallTimeNanos(),
+             currentThreadTimeNanos() - trace->scope_start_cpu_ns[depth],
+             TRACE_SCOPE_END);
+  }
+}
+
+inline static float32 blend(float32 old_val, float32 new_val) {
+  return ALPHA * old_val + (1.0f - ALPHA) * new_val;
+}
+
+static float32 updateAverage(ThreadTrace* const trace, const TraceEvent& event,
+                             const float32 new_val) {
+  for (int32 entry_num = 0; entry_num < trace->num_avg_entries; ++entry_num) {
+    AverageEntry* const entry = trace->avg_entries + entry_num;
+    if (event.id == entry->id && event.kind == entry->kind) {
+      entry->average_duration = blend(entry->average_duration, new_val);
+      return entry->average_duration;
+    }
+  }
+
+  if (trace->num_avg_entries >= NUM_LOGS) {
+    LOGE("Too many log entries!");
+    return new_val;
+  }
+
+  // If it wasn't there already, add it.
+  AverageEntry* const entry = trace->avg_entries + trace->num_avg_entries;
+  entry->id = event.id;
+  entry->kind = event.kind;
+  entry->average_duration = new_val;
+  ++trace->num_avg_entries;
+
+  return new_val;
+}
+
+void printTimeLog() {
+  ThreadTrace* const trace = getThreadTrace();
+  const uint32 num_events = trace->num_events;
+  uint32 first_event = trace->frame_start;
+  if (num_events - first_event > NUM_TRACE_EVENTS) {
+    LOGW("Lost the oldest %u events of the time log",
+         num_events - first_event - NUM_TRACE_EVENTS);
+    first_event = num_events - NUM_TRACE_EVENTS;
+  }
+
+  float32 total_time = 0.0f;
+  bool first_mark = true;
+  for (uint32 i = first_event; i != num_events; ++i) {
+    const TraceEvent& event = trace->events[i & (NUM_TRACE_EVENTS - 1)];
+    const float32 curr_time = event.cpu_ns / 1000000.0f;
+    const float32 avg_time = updateAverage(trace, event, curr_time);
+    const int32 indent = min(2 * event.depth, 16);
+    LOGD("%*s%*s:    %6.2fms    %6.2fms", indent, "", 32 - indent, event.id,
+         curr_time, avg_time);
+    if (event.kind == TRACE_MARK) {
+      // The interval of the first mark is not part of the total.
+      if (!first_mark) {
+        total_time += curr_time;
+      }
+      first_mark = false;
+    }
+  }
+
+  trace->running_total = blend(trace->running_total, total_time);
+
+  LOGD("TOTAL TIME:                          %6.2fms    %6.2fms\n",
+       total_time, trace->running_total);
+}
+
+// Writes str to fp as a JSON string.
+static void writeJsonString(FILE* const fp, const char* str) {
+  fputc('"', fp);
+  for (; *str != '\0'; ++str) {
+    const unsigned char c = *str;
+    if (c == '"' || c == '\\') {
+      fprintf(fp, "\\%c", c);
+    } else if (c < 0x20) {
+      fprintf(fp, "\\u%04x", c);
+    } else {
+      fputc(c, fp);
+    }
+  }
+  fputc('"', fp);
+}
+
+bool writeChromeTrace(const char* path) {
+  FILE* const fp = fopen(path, "w");
+  if (fp == NULL) {
+    LOGE("Could not open %s for the trace!", path);
+    return false;
+  }
+  fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  bool first = true;
+  for (ThreadTrace* trace = trace_list; trace != NULL; trace = trace->next) {
+    // Marks may overlap scopes without nesting in them, so each thread has
+    // a track for its scopes and a track for its marks.
+    for (int32 track = 0; track < 2; ++track) {
+      fprintf(fp, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+              "\"tid\":%d,\"args\":{\"name\":\"thread %d%s\"}}",
+              first ? "" : ",", 2 * trace->tid + track, trace->tid,
+              track == 0 ? " scopes" : " marks");
+      first = false;
+    }
+    const uint32 num_events = trace->num_events;
+    __sync_synchronize();
+    const uint32 first_event = num_events > NUM_TRACE_EVENTS ?
+        num_events - NUM_TRACE_EVENTS : 0;
+    for (uint32 i = first_event; i != num_events; ++i) {
+      const TraceEvent& event = trace->events[i & (NUM_TRACE_EVENTS - 1)];
+      fprintf(fp, "%s\n{\"name\":", first ? "" : ",");
+      writeJsonString(fp, event.id);
+      fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+              "\"pid\":0,\"tid\":%d,\"args\":{\"cpu_ms\":%.3f}}",
+              event.kind == TRACE_MARK ? "mark" : "scope",
+              event.start_wall_ns / 1000.0,
+              (event.end_wall_ns - event.start_wall_ns) / 1000.0,
+              2 * trace->tid + (event.kind == TRACE_MARK ? 1 : 0),
+              event.cpu_ns / 1000000.0);
+      first = false;
+    }
+  }
+  fprintf(fp, "\n]}\n");
+  const bool ok = ferror(fp) == 0;
+  fclose(fp);
+  if (!ok) {
+    LOGE("Could not write the trace to %s!", path);
+  }
+  return ok;
+}
 #endif
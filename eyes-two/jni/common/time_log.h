@@ -2,6 +2,29 @@
 // Author: andrewharp@google.com (Andrew Harp)
 //
 // Utility functions for performance profiling.
+//
+// Each thread has its own log, so threads that time their work at the same
+// time, such as the optical flow, blur detection and text detection
+// threads, don't mix up each other's numbers. A log is a ring buffer of the
+// most recent NUM_TRACE_EVENTS events of its thread, and is only written by
+// that thread, without locks.
+//
+// There are two kinds of events:
+// - Marks, logged with timeLog, time the interval since the previous mark
+//   of the thread, as in:
+//     resetTimeLog();
+//     timeLog("Start");
+//     ...
+//     timeLog("Did something");  // Time since "Start".
+//     printTimeLog();
+// - Scopes, logged with TRACE_SCOPE, time a block, and may be nested:
+//     {
+//       TRACE_SCOPE("Compute flow");
+//       ...
+//     }
+// printTimeLog prints the events of the calling thread since its last
+// resetTimeLog, with the running average of each. writeChromeTrace writes
+// the events of all the threads as a Chrome trace.
 
 #ifndef JAVA_COM_GOOGLE_ANDROID_APPS_UNVEIL_JNI_COMMON_TIME_LOG_H_
 #define JAVA_COM_GOOGLE_ANDROID_APPS_UNVEIL_JNI_COMMON_TIME_LOG_H_
@@ -13,112 +36,81 @@
 
 #ifdef LOG_TIME
 
-inline static long currentThreadTimeNanos() {
+inline static int64 currentThreadTimeNanos() {
   struct timespec tm;
   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &tm);
   return tm.tv_sec * 1000000000LL + tm.tv_nsec;
 }
 
+// Wall time, which unlike the thread time is comparable between threads.
+inline static int64 currentWallTimeNanos() {
+  struct timespec tm;
+  clock_gettime(CLOCK_MONOTONIC, &tm);
+  return tm.tv_sec * 1000000000LL + tm.tv_nsec;
+}
+
 // Blend constant for running average.
 #define ALPHA 0.98f
+// Max number of distinct ids with a running average, per thread.
 #define NUM_LOGS 100
+// Number of events kept per thread, a power of 2. The oldest events are
+// overwritten by new ones.
+#define NUM_TRACE_EVENTS 1024
+// Max nesting depth of scopes.
+#define MAX_TRACE_DEPTH 32
 
-struct LogEntry {
-  const char* id;
-  clock_t time_stamp;
-};
-
-struct AverageEntry {
-  const char* id;
-  float32 average_duration;
-};
-
-// Storage for keeping track of this frame's values.
-extern int32 num_time_logs;
-extern LogEntry time_logs[NUM_LOGS];
-
-// Storage for keeping track of average values (each entry may not be printed
-// out each frame).
-extern AverageEntry avg_entries[NUM_LOGS];
-extern int32 num_avg_entries;
-extern float32 running_total;
-
-// Call this at the start of a logging phase.
-inline static void resetTimeLog() {
-  num_time_logs = 0;
-}
-
+// Call this at the start of a logging phase of the calling thread.
+void resetTimeLog();
 
 // Log a message to be printed out when printTimeLog is called, along with the
-// amount of time in ms that has passed since the last call to this function.
-inline static void timeLog(const char* str) {
-  if (num_time_logs >= NUM_LOGS) {
-    LOGE("Out of log entries!");
-    return;
-  }
-
-  time_logs[num_time_logs].id = str;
-  time_logs[num_time_logs].time_stamp = currentThreadTimeNanos();
-  ++num_time_logs;
-}
-
-
-inline static float32 blend(float32 old_val, float32 new_val) {
-  return ALPHA * old_val + (1.0f - ALPHA) * new_val;
-}
-
-
-inline static float32 updateAverage(const char* str, const float32 new_val) {
-  for (int32 entry_num = 0; entry_num < num_avg_entries; ++entry_num) {
-    AverageEntry* const entry = avg_entries + entry_num;
-    if (str == entry->id) {
-      entry->average_duration = blend(entry->average_duration, new_val);
-      return entry->average_duration;
-    }
+// amount of time in ms that has passed since the last call to this function
+// on the calling thread.
+void timeLog(const char* str);
+
+// Prints out all the events of the calling thread since its last
+// resetTimeLog in the order they ended, with the cpu time they took and its
+// running average.  The total time between the first and last marks is
+// printed last.
+void printTimeLog();
+
+// Starts and ends a scope of the calling thread. Prefer TRACE_SCOPE.
+void beginTraceScope(const char* id);
+void endTraceScope();
+
+// Writes the events of all the threads to the given file, in the Chrome
+// trace event format read by chrome://tracing, with the wall time and the
+// cpu time of each. Events that are overwritten while this runs may be
+// missing or wrong. Returns false if the file could not be written.
+bool writeChromeTrace(const char* path);
+
+// Times the scope it is declared in.
+class TraceScope {
+ public:
+  explicit TraceScope(const char* id) {
+    beginTraceScope(id);
   }
-
-  if (num_avg_entries >= NUM_LOGS) {
-    LOGE("Too many log entries!");
-  }
-
-  // If it wasn't there already, add it.
-  avg_entries[num_avg_entries].id = str;
-  avg_entries[num_avg_entries].average_duration = new_val;
-  ++num_avg_entries;
-
-  return new_val;
-}
-
-
-// Prints out all the timeLog statements in chronological order with the
-// interval that passed between subsequent statements.  The total time between
-// the first and last statements is printed last.
-inline static void printTimeLog() {
-  LogEntry* last_time = time_logs;
-
-  for (int i = 0; i < num_time_logs; ++i) {
-    LogEntry* this_time = time_logs + i;
-
-    const float32 curr_time =
-        (this_time->time_stamp - last_time->time_stamp) / 1000000.0f;
-
-    const float32 avg_time = updateAverage(this_time->id, curr_time);
-    LOGD("%32s:    %6.2fms    %6.2fms", this_time->id, curr_time, avg_time);
-    last_time = this_time;
+  ~TraceScope() {
+    endTraceScope();
   }
-
-  float32 total_time =
-      (last_time->time_stamp - time_logs->time_stamp) / 1000000.0f;
-
-  running_total = blend(running_total, total_time);
-
-  LOGD("TOTAL TIME:                          %6.2fms    %6.2fms\n",
-       total_time, running_total);
-}
+};
 #else
 inline static void resetTimeLog() {}
 inline static void timeLog(const char* str) {}
 inline static void printTimeLog() {}
+inline static void beginTraceScope(const char* id) {}
+inline static void endTraceScope() {}
+inline static bool writeChromeTrace(const char* path) { return false; }
+
+class TraceScope {
+ public:
+  explicit TraceScope(const char* id) {}
+};
 #endif
 
+#define TRACE_SCOPE_NAME2(line) trace_scope_##line
+#define TRACE_SCOPE_NAME(line) TRACE_SCOPE_NAME2(line)
+// Times the rest of the enclosing block as a scope with the given id, which
+// must be a string that outlives the log, such as a literal.
+#define TRACE_SCOPE(id) TraceScope TRACE_SCOPE_NAME(__LINE__)(id)
+
 #endif  // JAVA_COM_GOOGLE_ANDROID_APPS_UNVEIL_JNI_COMMON_TIME_LOG_H_
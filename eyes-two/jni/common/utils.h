@@ -12,6 +12,10 @@
 #include <arm_neon.h>
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <math.h>
 #include "types.h"
 
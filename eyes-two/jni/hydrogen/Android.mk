@@ -7,8 +7,11 @@ include $(CLEAR_VARS)
 LOCAL_MODULE := libhydrogen
 
 LOCAL_SRC_FILES += \
+  src/boxindex.cpp \
   src/clusterer.cpp \
+  src/conncomp.cpp \
   src/hydrogentextdetector.cpp \
+  src/parallel.cpp \
   src/thresholder.cpp \
   src/utilities.cpp \
   src/validator.cpp
@@ -22,6 +25,12 @@ LOCAL_C_INCLUDES += \
   $(LOCAL_PATH)/src \
   $(LOCAL_PATH)/include/leptonica
 
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+  LOCAL_CFLAGS += -DHAVE_ARMEABI_V7A=1 -mfloat-abi=softfp -mfpu=neon
+  LOCAL_C_INCLUDES += $(NDK_ROOT)/sources/cpufeatures
+  LOCAL_STATIC_LIBRARIES += cpufeatures
+endif
+
 LOCAL_LDLIBS += \
   -llog
 
@@ -34,4 +43,33 @@ TARGET_PREBUILT_SHARED_LIBRARIES += \
 
 include $(BUILD_SHARED_LIBRARY)
 
+# Benchmark of the thresholders; see testing/thresholdbench.cpp
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := hydrogen_thresholdbench
+
+LOCAL_SRC_FILES += \
+  src/parallel.cpp \
+  src/thresholder.cpp \
+  testing/thresholdbench.cpp
+
+LOCAL_C_INCLUDES += \
+  $(LOCAL_PATH)/src \
+  $(LOCAL_PATH)/include/leptonica
+
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+  LOCAL_CFLAGS += -DHAVE_ARMEABI_V7A=1 -mfloat-abi=softfp -mfpu=neon
+  LOCAL_C_INCLUDES += $(NDK_ROOT)/sources/cpufeatures
+  LOCAL_STATIC_LIBRARIES += cpufeatures
+endif
+
+LOCAL_LDLIBS += \
+  -L$(PREBUILT_PATH) \
+  -llept
+
+LOCAL_MODULE_TAGS := optional
+
+include $(BUILD_EXECUTABLE)
+
 endif #TARGET_SIMULATOR
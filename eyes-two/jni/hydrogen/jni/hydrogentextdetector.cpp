@@ -98,6 +98,7 @@ void Java_com_googlecode_eyesfree_textdetect_HydrogenTextDetector_nativeSetParam
   myParams->edge_tile_y = getIntField(env, paramClass, params, "edge_tile_y");
   myParams->edge_thresh = getIntField(env, paramClass, params, "edge_thresh");
   myParams->edge_avg_thresh = getIntField(env, paramClass, params, "edge_avg_thresh");
+  myParams->edge_num_threads = getIntField(env, paramClass, params, "edge_num_threads");
 
   myParams->skew_enabled = getBoolField(env, paramClass, params, "skew_enabled");
   myParams->skew_min_angle = getFloatField(env, paramClass, params, "skew_min_angle");
@@ -127,6 +128,10 @@ void Java_com_googlecode_eyesfree_textdetect_HydrogenTextDetector_nativeSetParam
   myParams->cluster_min_fdr = getFloatField(env, paramClass, params, "cluster_min_fdr");
   myParams->cluster_min_edge = getIntField(env, paramClass, params, "cluster_min_edge");
   myParams->cluster_min_edge_avg = getIntField(env, paramClass, params, "cluster_min_edge_avg");
+
+  myParams->incremental_refresh = getIntField(env, paramClass, params, "incremental_refresh");
+  myParams->incremental_diff_thresh = getIntField(env, paramClass, params, "incremental_diff_thresh");
+  myParams->incremental_max_changed = getFloatField(env, paramClass, params, "incremental_max_changed");
 }
 
 jint Java_com_googlecode_eyesfree_textdetect_HydrogenTextDetector_nativeGetTextAreas(
@@ -246,6 +251,30 @@ void Java_com_googlecode_eyesfree_textdetect_HydrogenTextDetector_nativeDetectTe
   ptr->DetectText();
 }
 
+void Java_com_googlecode_eyesfree_textdetect_HydrogenTextDetector_nativeDetectTextIncremental(
+    JNIEnv *env,
+    jclass clazz,
+    jint nativePtr,
+    jfloat dx,
+    jfloat dy) {
+  if (DEBUG_MODE) LOGV(__FUNCTION__);
+
+  HydrogenTextDetector *ptr = (HydrogenTextDetector *) nativePtr;
+
+  ptr->DetectTextIncremental((l_float32) dx, (l_float32) dy);
+}
+
+void Java_com_googlecode_eyesfree_textdetect_HydrogenTextDetector_nativeResetIncremental(
+    JNIEnv *env,
+    jclass clazz,
+    jint nativePtr) {
+  if (DEBUG_MODE) LOGV(__FUNCTION__);
+
+  HydrogenTextDetector *ptr = (HydrogenTextDetector *) nativePtr;
+
+  ptr->ResetIncremental();
+}
+
 void Java_com_googlecode_eyesfree_textdetect_HydrogenTextDetector_nativeClear(
     JNIEnv *env,
     jclass clazz,
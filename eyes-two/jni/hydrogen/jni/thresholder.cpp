@@ -29,7 +29,7 @@ jint Java_com_googlecode_eyesfree_textdetect_Thresholder_nativeSobelEdgeThreshol
   LOGV(__FUNCTION__);
 
   PIX *pixs = (PIX *) nativePix;
-  PIX *pixd = pixThreshedSobelEdgeFilter(pixs, (l_int32) threshold);
+  PIX *pixd = pixThreshedSobelEdgeFilter(pixs, (l_int32) threshold, 0);
 
   return (jint) pixd;
 }
@@ -48,7 +48,7 @@ jint Java_com_googlecode_eyesfree_textdetect_Thresholder_nativeEdgeAdaptiveThres
   PIX *pixd;
 
   if (pixEdgeAdaptiveThreshold(pixs, &pixd, (l_int32) tileX, (l_int32) tileY, (l_int32) threshold,
-                               (l_int32) average)) {
+                               (l_int32) average, 0)) {
     return (jint) 0;
   }
 
@@ -69,7 +69,7 @@ jint Java_com_googlecode_eyesfree_textdetect_Thresholder_nativeFisherAdaptiveThr
   PIX *pixd;
 
   if (pixFisherAdaptiveThreshold(pixs, &pixd, (l_int32) tileX, (l_int32) tileY,
-                                 (l_float32) scoreFract, (l_float32) thresh)) {
+                                 (l_float32) scoreFract, (l_float32) thresh, 0)) {
     return (jint) 0;
   }
 
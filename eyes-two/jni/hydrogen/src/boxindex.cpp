@@ -0,0 +1,241 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+
+#include "leptonica.h"
+#include "boxindex.h"
+
+/* The grid has at most this many cells per box */
+static const l_int32 kMaxCellsPerBox = 4;
+
+/* Smallest cell side */
+static const l_int32 kMinCellSize = 4;
+
+static int compareIndices(const void *a, const void *b) {
+  return *(const l_int32 *) a - *(const l_int32 *) b;
+}
+
+/* Sets the range of cells [first, last] covering [start, end] along an axis
+ * of num_cells cells, clipped to the grid */
+static void getCellRange(l_int32 start, l_int32 end, l_int32 origin, l_int32 cell_size, l_int32 num_cells,
+                         l_int32 *first, l_int32 *last) {
+  *first = L_MAX(0, (start - origin) / cell_size);
+  *last = L_MIN(num_cells - 1, (end - origin) / cell_size);
+  if (start < origin)
+    *first = 0;
+}
+
+/*!
+ *  boxIndexCreate()
+ *
+ *      Input:  pixa (the boxes of its pix are indexed)
+ *      Return: index, or null on error
+ *
+ *  Notes:
+ *      (1) The cells are about as large as the average box, so that a query
+ *          about the size of a box looks at a few cells.
+ *      (2) Boxes are treated as closed, so a box of width w at x touches
+ *          x + w, as boxes that only touch do in the validators.
+ */
+BoxIndex *boxIndexCreate(PIXA *pixa) {
+  l_int32 i, n, x, y, w, h, c, r;
+  l_int32 right, bottom, total_size, num_cells;
+  l_int32 first_column, last_column, first_row, last_row;
+  BoxIndex *index;
+
+  PROCNAME("boxIndexCreate");
+
+  if (!pixa)
+    return (BoxIndex *) ERROR_PTR("pixa not defined", procName, NULL);
+
+  n = pixaGetCount(pixa);
+
+  index = (BoxIndex *) calloc(1, sizeof(BoxIndex));
+  index->n = n;
+  index->boxes = (BOX **) calloc(L_MAX(n, 1), sizeof(BOX *));
+  index->stamps = (l_int32 *) calloc(L_MAX(n, 1), sizeof(l_int32));
+
+  /* Find the extent of the boxes and their average size */
+  index->left = 0;
+  index->top = 0;
+  right = 0;
+  bottom = 0;
+  total_size = 0;
+  for (i = 0; i < n; i++) {
+    index->boxes[i] = pixaGetBox(pixa, i, L_CLONE);
+    boxGetGeometry(index->boxes[i], &x, &y, &w, &h);
+    if (i == 0 || x < index->left)
+      index->left = x;
+    if (i == 0 || y < index->top)
+      index->top = y;
+    if (i == 0 || x + w > right)
+      right = x + w;
+    if (i == 0 || y + h > bottom)
+      bottom = y + h;
+    total_size += L_MAX(w, h);
+  }
+
+  index->sorted_by_x = 1;
+  for (i = 1; i < n; i++) {
+    if (index->boxes[i]->x < index->boxes[i - 1]->x)
+      index->sorted_by_x = 0;
+  }
+
+  /* Grow the cells until there are few enough of them */
+  index->cell_size = L_MAX(kMinCellSize, n > 0 ? total_size / n : 0);
+  while (1) {
+    index->columns = (right - index->left) / index->cell_size + 1;
+    index->rows = (bottom - index->top) / index->cell_size + 1;
+    if ((l_float64) index->columns * index->rows <= kMaxCellsPerBox * L_MAX(n, 1))
+      break;
+    index->cell_size *= 2;
+  }
+  num_cells = index->columns * index->rows;
+
+  /* Count the boxes of each cell, then list them, in increasing order */
+  index->cell_starts = (l_int32 *) calloc(num_cells + 1, sizeof(l_int32));
+  for (i = 0; i < n; i++) {
+    boxGetGeometry(index->boxes[i], &x, &y, &w, &h);
+    getCellRange(x, x + w, index->left, index->cell_size, index->columns, &first_column, &last_column);
+    getCellRange(y, y + h, index->top, index->cell_size, index->rows, &first_row, &last_row);
+    for (r = first_row; r <= last_row; r++) {
+      for (c = first_column; c <= last_column; c++)
+        index->cell_starts[r * index->columns + c + 1]++;
+    }
+  }
+  for (c = 0; c < num_cells; c++)
+    index->cell_starts[c + 1] += index->cell_starts[c];
+
+  index->cell_boxes = (l_int32 *) malloc(L_MAX(index->cell_starts[num_cells], 1) * sizeof(l_int32));
+  l_int32 *cell_ends = (l_int32 *) malloc(num_cells * sizeof(l_int32));
+  for (c = 0; c < num_cells; c++)
+    cell_ends[c] = index->cell_starts[c];
+  for (i = 0; i < n; i++) {
+    boxGetGeometry(index->boxes[i], &x, &y, &w, &h);
+    getCellRange(x, x + w, index->left, index->cell_size, index->columns, &first_column, &last_column);
+    getCellRange(y, y + h, index->top, index->cell_size, index->rows, &first_row, &last_row);
+    for (r = first_row; r <= last_row; r++) {
+      for (c = first_column; c <= last_column; c++)
+        index->cell_boxes[cell_ends[r * index->columns + c]++] = i;
+    }
+  }
+  free(cell_ends);
+
+  return index;
+}
+
+/*!
+ *  boxIndexDestroy()
+ *
+ *      Input:  &index (<will be set to null>)
+ *      Return: void
+ */
+void boxIndexDestroy(BoxIndex **pindex) {
+  l_int32 i;
+  BoxIndex *index;
+
+  if (!pindex || !*pindex)
+    return;
+
+  index = *pindex;
+  for (i = 0; i < index->n; i++)
+    boxDestroy(&index->boxes[i]);
+  free(index->boxes);
+  free(index->stamps);
+  free(index->cell_starts);
+  free(index->cell_boxes);
+  free(index);
+
+  *pindex = NULL;
+}
+
+/*!
+ *  boxIndexQuery()
+ *
+ *      Input:  index
+ *              left, top, right, bottom (closed area to search)
+ *              first (smallest index of the boxes to return)
+ *              candidates (receives the indices, must hold index->n)
+ *      Return: number of candidates
+ *
+ *  Notes:
+ *      (1) Returns, in increasing order, the indices from first on of
+ *          boxes near the area. These include all the boxes that touch the
+ *          area, and may include others.
+ *      (2) If the boxes are sorted by x and fewer of them start in the
+ *          columns of the area than are listed in its cells, those are
+ *          scanned instead of the cells.
+ */
+l_int32 boxIndexQuery(BoxIndex *index, l_int32 left, l_int32 top, l_int32 right, l_int32 bottom,
+                      l_int32 first, l_int32 *candidates) {
+  l_int32 c, r, k, i, count;
+  l_int32 first_column, last_column, first_row, last_row;
+
+  if (right < left || bottom < top)
+    return 0;
+
+  getCellRange(left, right, index->left, index->cell_size, index->columns, &first_column, &last_column);
+  getCellRange(top, bottom, index->top, index->cell_size, index->rows, &first_row, &last_row);
+
+  if (index->sorted_by_x && first < index->n) {
+    /* Find the end of the boxes starting at most at right */
+    l_int32 low = first;
+    l_int32 high = index->n;
+    while (low < high) {
+      l_int32 middle = low + (high - low) / 2;
+      if (index->boxes[middle]->x <= right)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+
+    l_int32 num_listed = 0;
+    for (r = first_row; r <= last_row && num_listed < low - first; r++) {
+      l_int32 row_start = r * index->columns;
+      num_listed += index->cell_starts[row_start + last_column + 1] - index->cell_starts[row_start + first_column];
+    }
+
+    if (num_listed >= low - first) {
+      count = 0;
+      for (i = first; i < low; i++) {
+        BOX *box = index->boxes[i];
+        if (box->x + box->w >= left && box->y <= bottom && box->y + box->h >= top)
+          candidates[count++] = i;
+      }
+      return count;
+    }
+  }
+
+  index->query++;
+  count = 0;
+  for (r = first_row; r <= last_row; r++) {
+    for (c = first_column; c <= last_column; c++) {
+      l_int32 cell = r * index->columns + c;
+      for (k = index->cell_starts[cell]; k < index->cell_starts[cell + 1]; k++) {
+        i = index->cell_boxes[k];
+        if (i >= first && index->stamps[i] != index->query) {
+          index->stamps[i] = index->query;
+          candidates[count++] = i;
+        }
+      }
+    }
+  }
+
+  qsort(candidates, count, sizeof(l_int32), compareIndices);
+
+  return count;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYDROGEN_BOXINDEX_H_
+#define HYDROGEN_BOXINDEX_H_
+
+#include "leptonica.h"
+
+/* A uniform grid over the boxes of a pixa, for finding the boxes near a
+ * given area without testing every pair of boxes. Each box is listed in
+ * every cell it touches. When the boxes are sorted by x, wide areas are
+ * searched by scanning the boxes in order instead. */
+struct BoxIndex {
+  l_int32 n;            /* number of boxes */
+  BOX **boxes;          /* clone of the box of each pix */
+  l_int32 sorted_by_x;  /* whether the boxes are in increasing x order */
+
+  l_int32 left, top;    /* origin of the grid */
+  l_int32 cell_size;    /* width and height of the cells */
+  l_int32 columns, rows;
+  l_int32 *cell_starts; /* start of each cell's boxes in cell_boxes, and the end */
+  l_int32 *cell_boxes;  /* indices of the boxes of each cell */
+
+  l_int32 *stamps;      /* last query that found each box */
+  l_int32 query;        /* number of queries so far */
+};
+
+BoxIndex *boxIndexCreate(PIXA *pixa);
+
+void boxIndexDestroy(BoxIndex **pindex);
+
+l_int32 boxIndexQuery(BoxIndex *index, l_int32 left, l_int32 top, l_int32 right, l_int32 bottom,
+                      l_int32 first, l_int32 *candidates);
+
+#endif /* HYDROGEN_BOXINDEX_H_ */
@@ -15,26 +15,50 @@
  */
 
 #include <malloc.h>
+#include <math.h>
 #include "leptonica.h"
+#include "boxindex.h"
 #include "clusterer.h"
+#include "conncomp.h"
 #include "validator.h"
 
-/* Type of connected components: 4 is up/down/left/right. 8 includes diagonals */
-#define CONN_COMP 8
-
 l_int32 ConnCompValidPixa(PIX *pix8, PIX *pix, PIXA **ppixa, NUMA **pconfs,
                           HydrogenTextDetector::TextDetectorParameters &params) {
-  l_int32 h, iszero;
-  l_int32 x, y, xstart, ystart;
+  l_int32 result;
+  ConnCompLabels *labels;
+
+  PROCNAME("pixConnCompValidPixa");
+
+  if (!ppixa)
+    return ERROR_INT("&pixa not defined", procName, 1);
+  if (!pconfs)
+    return ERROR_INT("&confs not defined", procName, 1);
+  *ppixa = NULL;
+  *pconfs = NULL;
+  if (!pix || pixGetDepth(pix) != 1)
+    return ERROR_INT("pixs undefined or not 1 bpp", procName, 1);
+
+  if ((labels = connCompLabelsCreate(pix, CONN_COMP)) == NULL)
+    return ERROR_INT("labels not made", procName, 1);
+
+  result = ConnCompValidPixaLabeled(pix8, labels, 1, ppixa, pconfs, params);
+
+  connCompLabelsDestroy(&labels);
+
+  return result;
+}
+
+l_int32 ConnCompValidPixaLabeled(PIX *pix8, ConnCompLabels *labels, l_int32 polarity, PIXA **ppixa,
+                                 NUMA **pconfs, HydrogenTextDetector::TextDetectorParameters &params) {
+  l_int32 i, count;
   l_float32 singleton_conf;
-  PIX *pixt1, *pixt2, *pixt3, *pixt4, *pixt5;
+  PIX *pixt1, *pixt2;
   PIXA *pixa, *pixasort;
   NUMA *confs, *confsort;
   BOX *box;
   BOXA *boxa;
-  L_STACK *lstack, *auxstack;
 
-  PROCNAME("pixConnCompValidPixa");
+  PROCNAME("pixConnCompValidPixaLabeled");
 
   if (!ppixa)
     return ERROR_INT("&pixa not defined", procName, 1);
@@ -42,62 +66,46 @@ l_int32 ConnCompValidPixa(PIX *pix8, PIX *pix, PIXA **ppixa, NUMA **pconfs,
     return ERROR_INT("&confs not defined", procName, 1);
   *ppixa = NULL;
   *pconfs = NULL;
-  if (!pix || pixGetDepth(pix) != 1)
-    return ERROR_INT("pixs undefined or not 1 bpp", procName, 1);
+  if (!labels)
+    return ERROR_INT("labels not defined", procName, 1);
 
   pixa = pixaCreate(0);
   confs = numaCreate(0);
 
-  pixZero(pix, &iszero);
-  if (iszero) {
+  count = 0;
+  for (i = 0; i < labels->n; i++) {
+    if (labels->polarities[i] == polarity)
+      count++;
+  }
+  if (count == 0) {
+    numaDestroy(&confs);
     *ppixa = pixa;
     return 0;
   }
 
-  if ((pixt1 = pixCopy(NULL, pix)) == NULL)
-    return ERROR_INT("pixt1 not made", procName, 1);
-  if ((pixt2 = pixCopy(NULL, pix)) == NULL)
-    return ERROR_INT("pixt2 not made", procName, 1);
-
-  h = pixGetHeight(pix);
-  if ((lstack = lstackCreate(h)) == NULL)
-    return ERROR_INT("lstack not made", procName, 1);
-  if ((auxstack = lstackCreate(0)) == NULL)
-    return ERROR_INT("auxstack not made", procName, 1);
-  lstack->auxstack = auxstack;
   if ((boxa = boxaCreate(0)) == NULL)
     return ERROR_INT("boxa not made", procName, 1);
 
-  xstart = 0;
-  ystart = 0;
-  while (1) {
-    if (!nextOnPixelInRaster(pixt1, xstart, ystart, &x, &y))
-      break;
-
-    if ((box = pixSeedfillBB(pixt1, lstack, x, y, CONN_COMP)) == NULL)
-      return ERROR_INT("box not made", procName, 1);
+  /* Components are labelled in raster order, as pixSeedfillBB() finds them */
+  for (i = 0; i < labels->n; i++) {
+    if (labels->polarities[i] != polarity)
+      continue;
 
-    /* Save the c.c. and remove from pixt2 as well */
-    pixt3 = pixClipRectangle(pixt1, box, NULL);
-    pixt4 = pixClipRectangle(pixt2, box, NULL);
-    pixt5 = pixClipRectangle(pix8, box, NULL);
-    pixXor(pixt3, pixt3, pixt4);
-    pixRasterop(pixt2, box->x, box->y, box->w, box->h, PIX_SRC ^ PIX_DST, pixt3, 0, 0);
-    pixDestroy(&pixt4);
+    box = boxaGetBox(labels->boxa, i, L_COPY);
+    if ((pixt1 = connCompLabelsGetPix(labels, i)) == NULL)
+      return ERROR_INT("pixt1 not made", procName, 1);
+    pixt2 = pixClipRectangle(pix8, box, NULL);
 
-    if (ValidateSingleton(pixt3, box, pixt5, &singleton_conf, params)) {
+    if (ValidateSingleton(pixt1, box, pixt2, &singleton_conf, params)) {
       boxaAddBox(boxa, box, L_INSERT);
-      pixaAddPix(pixa, pixt3, L_INSERT);
+      pixaAddPix(pixa, pixt1, L_INSERT);
       numaAddNumber(confs, singleton_conf);
     } else {
       boxDestroy(&box);
-      pixDestroy(&pixt3);
+      pixDestroy(&pixt1);
     }
 
-    pixDestroy(&pixt5);
-
-    xstart = x;
-    ystart = y;
+    pixDestroy(&pixt2);
   }
 
   /* Remove old boxa of pixa and replace with a clone copy */
@@ -110,10 +118,9 @@ l_int32 ConnCompValidPixa(PIX *pix8, PIX *pix, PIXA **ppixa, NUMA **pconfs,
     return ERROR_INT("pixasort not made", procName, 1);
   confsort = numaSortByIndex(confs, naindex);
 
-  /* Cleanup, freeing the fillsegs on each stack */
-  lstackDestroy(&lstack, TRUE);
-  pixDestroy(&pixt1);
-  pixDestroy(&pixt2);
+  /* Cleanup */
+  numaDestroy(&naindex);
+  numaDestroy(&confs);
   boxaDestroy(&boxa);
   pixaDestroy(&pixa);
 
@@ -257,10 +264,12 @@ l_int32 MergePairFragments(PIX *pix8, PIXA *clusters, PIXA *pixa, l_uint8 *remov
 
 l_int32 RemoveInvalidPairs(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *remove,
                            HydrogenTextDetector::TextDetectorParameters &params) {
-  l_int32 i, j, n, count;
+  l_int32 i, j, k, n, count, num_candidates, max_h, max_h_dist;
+  l_int32 *candidates;
   l_float32 pair_conf;
   l_uint8 *has_partner;
   BOX *b1, *b2;
+  BoxIndex *index;
 
   PROCNAME("pixRemoveInvalidPairs");
 
@@ -277,40 +286,49 @@ l_int32 RemoveInvalidPairs(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *remove,
   }
 
   has_partner = (l_uint8 *) calloc(n, sizeof(l_uint8));
+  candidates = (l_int32 *) malloc(n * sizeof(l_int32));
+  index = boxIndexCreate(pixa);
   count = 0;
 
   for (i = 0; i < n; i++) {
     if (remove[i])
       continue;
 
-    b1 = pixaGetBox(pixa, i, L_CLONE);
+    b1 = index->boxes[i];
+
+    /* A valid partner shares part of i's vertical edge, and is at most
+     * pair_h_dist_ratio times the taller height away horizontally, where its
+     * height is bounded by pair_h_ratio. Only those boxes are validated. */
+    max_h = b1->h + (l_int32) ceil(L_MAX(0.0, params.pair_h_ratio) * (b1->h + 1)) + 1;
+    max_h_dist = (l_int32) ceil(L_MAX(0.0, params.pair_h_dist_ratio) * max_h) + 1;
+    num_candidates = boxIndexQuery(index, b1->x - max_h_dist, b1->y, b1->x + b1->w + max_h_dist,
+                                   b1->y + b1->h, i + 1, candidates);
 
     /* Search right for a partner for i */
-    for (j = i + 1; j < n; j++) {
+    for (k = 0; k < num_candidates; k++) {
+      j = candidates[k];
+
       if (remove[j])
         continue;
 
-      b2 = pixaGetBox(pixa, j, L_CLONE);
+      b2 = index->boxes[j];
 
       /* Check whether this is a valid pair */
-      if (!ValidatePair(b1, b2, &pair_conf, params)) {
-        boxDestroy(&b2);
+      if (!ValidatePair(b1, b2, &pair_conf, params))
         continue;
-      }
 
       // We don't need to adjust confidence values here, since we'll
       // generate cluster pairs and use those later.
 
-      boxDestroy(&b2);
-
       has_partner[i] = 1;
       has_partner[j] = 1;
       break;
     }
-
-    boxDestroy(&b1);
   }
 
+  boxIndexDestroy(&index);
+  free(candidates);
+
   for (i = 0; i < n; i++) {
     if (!has_partner[i]) {
       remove[i] = 1;
@@ -328,13 +346,15 @@ l_int32 RemoveInvalidPairs(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *remove,
 
 l_int32 GenerateClusterPartners(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *remove, l_int32 **pleft,
                                 l_int32 **pright, HydrogenTextDetector::TextDetectorParameters &params) {
-  l_int32 n, i, j;
+  l_int32 n, i, j, k, num_candidates;
   l_int32 xi, yi, wi, hi, maxd;
   l_int32 xj, yj, wj, hj;
   l_int32 dx, dy, d, mind, minj;
-  l_int32 *left, *right;
+  l_int32 top, bottom;
+  l_int32 *left, *right, *candidates;
   l_float32 clusterpair_conf, minconf;
   BOX *b1, *b2;
+  BoxIndex *index;
   bool too_far;
 
   PROCNAME("GenerateClusterPartners");
@@ -368,6 +388,9 @@ l_int32 GenerateClusterPartners(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *rem
     right[i] = -2;
   }
 
+  candidates = (l_int32 *) malloc(n * sizeof(l_int32));
+  index = boxIndexCreate(pixa);
+
   /* For each component, check all possible neighbors to find the most likely
    * right neighbor. If that right neighbor already has a left neighbor, insert
    * the component to the right of the existing neighbor and the left of the
@@ -377,20 +400,36 @@ l_int32 GenerateClusterPartners(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *rem
     if (remove[i])
       continue;
 
-    pixaGetBoxGeometry(pixa, i, &xi, &yi, &wi, &hi);
-    b1 = pixaGetBox(pixa, i, L_CLONE);
+    b1 = index->boxes[i];
+    boxGetGeometry(b1, &xi, &yi, &wi, &hi);
     mind = -1;
     minj = -1;
     maxd = L_MAX(wi, hi);
     minconf = 0.0;
 
+    /* The components are sorted by x, so the neighbors to the right up to
+     * the first one that is too far are those starting at most
+     * cluster_width_spacing times maxd past i. Those sharing enough of an
+     * edge with i also touch its rows, unless cluster_shared_edge is
+     * outside [0, 1]. Only those boxes are validated. */
+    top = yi;
+    bottom = yi + hi;
+    if (params.cluster_shared_edge < 0.0 || params.cluster_shared_edge > 1.0) {
+      top = index->top;
+      bottom = index->top + index->rows * index->cell_size;
+    }
+    num_candidates = boxIndexQuery(index, xi, top, xi + wi + params.cluster_width_spacing * maxd, bottom,
+                                   i + 1, candidates);
+
     /* Search for closest right neighbor */
-    for (j = i + 1; j < n; j++) {
+    for (k = 0; k < num_candidates; k++) {
+      j = candidates[k];
+
       if (remove[j])
         continue;
 
-      pixaGetBoxGeometry(pixa, j, &xj, &yj, &wj, &hj);
-      b2 = pixaGetBox(pixa, j, L_CLONE);
+      b2 = index->boxes[j];
+      boxGetGeometry(b2, &xj, &yj, &wj, &hj);
 
       if (!ValidateClusterPair(b1, b2, &too_far, &clusterpair_conf, params)) {
         if (too_far)
@@ -436,6 +475,9 @@ l_int32 GenerateClusterPartners(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *rem
     }
   }
 
+  boxIndexDestroy(&index);
+  free(candidates);
+
   *pleft = left;
   *pright = right;
 
@@ -626,6 +668,7 @@ l_int32 MergeClusterPartners(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *remove
   *ppixad = pixasort;
   *pclusterconfs = confsort;
 
+  numaDestroy(&naindex);
   pixaDestroy(&pixad);
   numaDestroy(&confd);
 
@@ -19,10 +19,17 @@
 
 #include "leptonica.h"
 #include "hydrogentextdetector.h"
+#include "conncomp.h"
+
+/* Type of connected components: 4 is up/down/left/right. 8 includes diagonals */
+#define CONN_COMP 8
 
 l_int32 ConnCompValidPixa(PIX *pix8, PIX *pix, PIXA **ppixa, NUMA **pconfs,
                           HydrogenTextDetector::TextDetectorParameters &params);
 
+l_int32 ConnCompValidPixaLabeled(PIX *pix8, ConnCompLabels *labels, l_int32 polarity, PIXA **ppixa,
+                                 NUMA **pconfs, HydrogenTextDetector::TextDetectorParameters &params);
+
 l_int32 MergePix(PIXA *pixad, l_int32 i, PIXA *pixas, l_int32 j);
 
 l_int32 RemoveInvalidPairs(PIX *pix8, PIXA *pixa, NUMA *confs, l_uint8 *remove,
@@ -0,0 +1,347 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+
+#include "leptonica.h"
+#include "conncomp.h"
+
+/* The runs of an image, with provisional labels. Labels are merged into the
+ * smallest label of their component, which is the label of its first run in
+ * raster order. */
+struct RunLabels {
+  l_int32 num_runs;
+  l_int32 runs_size;
+  l_int32 *starts;       /* first x of each run */
+  l_int32 *labels;       /* provisional label of each run */
+  l_int32 *row_starts;   /* first run of each row, and the end */
+
+  l_int32 num_labels;
+  l_int32 labels_size;
+  l_int32 *parents;
+  l_uint8 *polarities;
+};
+
+static l_int32 findRoot(RunLabels *runs, l_int32 label) {
+  l_int32 *parents = runs->parents;
+
+  while (parents[label] != label) {
+    parents[label] = parents[parents[label]];
+    label = parents[label];
+  }
+
+  return label;
+}
+
+static l_int32 mergeLabels(RunLabels *runs, l_int32 a, l_int32 b) {
+  if (a == b)
+    return a;
+
+  a = findRoot(runs, a);
+  b = findRoot(runs, b);
+
+  if (a < b) {
+    runs->parents[b] = a;
+    return a;
+  }
+
+  runs->parents[a] = b;
+  return b;
+}
+
+static l_int32 newLabel(RunLabels *runs, l_uint8 polarity) {
+  if (runs->num_labels == runs->labels_size) {
+    runs->labels_size *= 2;
+    runs->parents = (l_int32 *) realloc(runs->parents, runs->labels_size * sizeof(l_int32));
+    runs->polarities = (l_uint8 *) realloc(runs->polarities, runs->labels_size * sizeof(l_uint8));
+  }
+
+  runs->parents[runs->num_labels] = runs->num_labels;
+  runs->polarities[runs->num_labels] = polarity;
+
+  return runs->num_labels++;
+}
+
+static void addRun(RunLabels *runs, l_int32 start) {
+  if (runs->num_runs == runs->runs_size) {
+    runs->runs_size *= 2;
+    runs->starts = (l_int32 *) realloc(runs->starts, runs->runs_size * sizeof(l_int32));
+    runs->labels = (l_int32 *) realloc(runs->labels, runs->runs_size * sizeof(l_int32));
+  }
+
+  runs->starts[runs->num_runs++] = start;
+}
+
+/* Returns the first x after start, and before w, whose pixel is not value */
+static l_int32 findRunEnd(l_uint32 *line, l_int32 start, l_int32 w, l_uint8 value) {
+  l_int32 x = start & ~31;
+  l_uint32 word = (value ? ~line[x >> 5] : line[x >> 5]) & (0xffffffff >> (start & 31));
+
+  while (!word) {
+    x += 32;
+    if (x >= w)
+      return w;
+    word = value ? ~line[x >> 5] : line[x >> 5];
+  }
+
+  return L_MIN(w, x + __builtin_clz(word));
+}
+
+/* Sets the bits of line from x0 to x1 inclusive */
+static void setBits(l_uint32 *line, l_int32 x0, l_int32 x1) {
+  l_int32 first = x0 >> 5;
+  l_int32 last = x1 >> 5;
+  l_uint32 first_mask = 0xffffffff >> (x0 & 31);
+  l_uint32 last_mask = 0xffffffff << (31 - (x1 & 31));
+
+  if (first == last) {
+    line[first] |= first_mask & last_mask;
+    return;
+  }
+
+  line[first] |= first_mask;
+  for (l_int32 i = first + 1; i < last; i++)
+    line[i] = 0xffffffff;
+  line[last] |= last_mask;
+}
+
+/*!
+ *  connCompLabelsCreate()
+ *
+ *      Input:  pixs (1 bpp)
+ *              connectivity (4 or 8, for the components of both polarities)
+ *      Return: labels, or null on error
+ *
+ *  Notes:
+ *      (1) The components of polarity 1 are those of pixs, and the
+ *          components of polarity 0 are those of the inverse of pixs, both
+ *          with the given connectivity.
+ *      (2) The runs of each row alternate in polarity, so each run is
+ *          merged with the runs of the same polarity it touches in the row
+ *          above, in a single pass over the runs.
+ */
+ConnCompLabels *connCompLabelsCreate(PIX *pixs, l_int32 connectivity) {
+  l_int32 i, j, k, x, y, w, h, wpl, end, label, reach;
+  l_int32 prev_first, prev_last, first, last, num_runs;
+  l_int32 *finals, *ends, *component_ends;
+  l_int32 *lefts, *tops, *rights, *bottoms;
+  l_uint8 value;
+  l_uint32 *data, *line;
+  RunLabels runs;
+  ConnCompLabels *labels;
+
+  PROCNAME("connCompLabelsCreate");
+
+  if (!pixs || pixGetDepth(pixs) != 1)
+    return (ConnCompLabels *) ERROR_PTR("pixs undefined or not 1 bpp", procName, NULL);
+  if (connectivity != 4 && connectivity != 8)
+    return (ConnCompLabels *) ERROR_PTR("connectivity not 4 or 8", procName, NULL);
+
+  pixGetDimensions(pixs, &w, &h, NULL);
+  data = pixGetData(pixs);
+  wpl = pixGetWpl(pixs);
+
+  runs.num_runs = 0;
+  runs.runs_size = L_MAX(2 * h, 16);
+  runs.starts = (l_int32 *) malloc(runs.runs_size * sizeof(l_int32));
+  runs.labels = (l_int32 *) malloc(runs.runs_size * sizeof(l_int32));
+  runs.row_starts = (l_int32 *) malloc((h + 1) * sizeof(l_int32));
+  runs.num_labels = 0;
+  runs.labels_size = 16;
+  runs.parents = (l_int32 *) malloc(runs.labels_size * sizeof(l_int32));
+  runs.polarities = (l_uint8 *) malloc(runs.labels_size * sizeof(l_uint8));
+
+  /* 8-connected runs touch the runs above that reach a pixel past them */
+  reach = connectivity == 8 ? 1 : 0;
+
+  /* Give each run the label of the runs of its value it touches in the row
+   * above, merging them, or a new label if there are none. The runs of a
+   * row alternate in value, so every other run above has the same value. */
+  prev_first = prev_last = 0;
+  for (y = 0; y < h; y++) {
+    line = data + y * wpl;
+    runs.row_starts[y] = runs.num_runs;
+    first = runs.num_runs;
+    j = prev_first;
+
+    for (x = 0; x < w; x = end) {
+      value = GET_DATA_BIT(line, x);
+      end = findRunEnd(line, x, w, value);
+      addRun(&runs, x);
+
+      /* Skip the runs above that end before this run can touch them */
+      while (j < prev_last) {
+        l_int32 above_end = j + 1 < prev_last ? runs.starts[j + 1] : w;
+        if (above_end + reach > x)
+          break;
+        j++;
+      }
+
+      label = -1;
+      for (k = j; k < prev_last && runs.starts[k] < end + reach; k++) {
+        if (runs.polarities[runs.labels[k]] != value)
+          continue;
+        label = label < 0 ? runs.labels[k] : mergeLabels(&runs, label, runs.labels[k]);
+      }
+
+      if (label < 0)
+        label = newLabel(&runs, value);
+      runs.labels[runs.num_runs - 1] = label;
+    }
+
+    last = runs.num_runs;
+    prev_first = first;
+    prev_last = last;
+  }
+  runs.row_starts[h] = runs.num_runs;
+  num_runs = runs.num_runs;
+
+  /* Number the components in the order of their smallest labels. Each
+   * label's root is smaller than the label, so it is numbered first. */
+  labels = (ConnCompLabels *) calloc(1, sizeof(ConnCompLabels));
+  finals = (l_int32 *) malloc(L_MAX(runs.num_labels, 1) * sizeof(l_int32));
+  labels->polarities = (l_uint8 *) malloc(L_MAX(runs.num_labels, 1) * sizeof(l_uint8));
+  labels->n = 0;
+  for (i = 0; i < runs.num_labels; i++) {
+    if (runs.parents[i] == i) {
+      labels->polarities[labels->n] = runs.polarities[i];
+      finals[i] = labels->n++;
+    } else {
+      finals[i] = finals[findRoot(&runs, i)];
+    }
+  }
+
+  /* Find the extent of the components, and list their runs in order */
+  lefts = (l_int32 *) malloc(4 * L_MAX(labels->n, 1) * sizeof(l_int32));
+  tops = lefts + L_MAX(labels->n, 1);
+  rights = tops + L_MAX(labels->n, 1);
+  bottoms = rights + L_MAX(labels->n, 1);
+  for (i = 0; i < labels->n; i++) {
+    lefts[i] = w;
+    rights[i] = -1;
+    tops[i] = -1;
+  }
+
+  labels->run_starts = (l_int32 *) calloc(labels->n + 1, sizeof(l_int32));
+  ends = (l_int32 *) malloc(L_MAX(num_runs, 1) * sizeof(l_int32));
+  for (y = 0; y < h; y++) {
+    for (i = runs.row_starts[y]; i < runs.row_starts[y + 1]; i++) {
+      label = finals[runs.labels[i]];
+      runs.labels[i] = label;
+      ends[i] = i + 1 < runs.row_starts[y + 1] ? runs.starts[i + 1] - 1 : w - 1;
+      labels->run_starts[label + 1]++;
+
+      if (tops[label] < 0)
+        tops[label] = y;
+      bottoms[label] = y;
+      if (runs.starts[i] < lefts[label])
+        lefts[label] = runs.starts[i];
+      if (ends[i] > rights[label])
+        rights[label] = ends[i];
+    }
+  }
+  for (i = 0; i < labels->n; i++)
+    labels->run_starts[i + 1] += labels->run_starts[i];
+
+  labels->runs = (l_int32 *) malloc(3 * L_MAX(num_runs, 1) * sizeof(l_int32));
+  component_ends = (l_int32 *) malloc(L_MAX(labels->n, 1) * sizeof(l_int32));
+  for (i = 0; i < labels->n; i++)
+    component_ends[i] = labels->run_starts[i];
+  for (y = 0; y < h; y++) {
+    for (i = runs.row_starts[y]; i < runs.row_starts[y + 1]; i++) {
+      l_int32 *run = labels->runs + 3 * component_ends[runs.labels[i]]++;
+      run[0] = y;
+      run[1] = runs.starts[i];
+      run[2] = ends[i];
+    }
+  }
+
+  labels->boxa = boxaCreate(labels->n);
+  for (i = 0; i < labels->n; i++) {
+    boxaAddBox(labels->boxa, boxCreate(lefts[i], tops[i], rights[i] - lefts[i] + 1, bottoms[i] - tops[i] + 1),
+               L_INSERT);
+  }
+
+  free(component_ends);
+  free(ends);
+  free(lefts);
+  free(finals);
+  free(runs.starts);
+  free(runs.labels);
+  free(runs.row_starts);
+  free(runs.parents);
+  free(runs.polarities);
+
+  return labels;
+}
+
+/*!
+ *  connCompLabelsDestroy()
+ *
+ *      Input:  &labels (<will be set to null before returning>)
+ *      Return: void
+ */
+void connCompLabelsDestroy(ConnCompLabels **plabels) {
+  ConnCompLabels *labels;
+
+  if (!plabels || !*plabels)
+    return;
+
+  labels = *plabels;
+  free(labels->polarities);
+  boxaDestroy(&labels->boxa);
+  free(labels->run_starts);
+  free(labels->runs);
+  free(labels);
+
+  *plabels = NULL;
+}
+
+/*!
+ *  connCompLabelsGetPix()
+ *
+ *      Input:  labels
+ *              index (of the component)
+ *      Return: 1 bpp pix of the component, clipped to its bounding box, or
+ *              null on error
+ */
+PIX *connCompLabelsGetPix(ConnCompLabels *labels, l_int32 index) {
+  l_int32 i, bx, by, bw, bh, wpl;
+  l_int32 *run;
+  l_uint32 *data;
+  PIX *pixd;
+
+  PROCNAME("connCompLabelsGetPix");
+
+  if (!labels)
+    return (PIX *) ERROR_PTR("labels not defined", procName, NULL);
+  if (index < 0 || index >= labels->n)
+    return (PIX *) ERROR_PTR("index not valid", procName, NULL);
+
+  boxaGetBoxGeometry(labels->boxa, index, &bx, &by, &bw, &bh);
+
+  if ((pixd = pixCreate(bw, bh, 1)) == NULL)
+    return (PIX *) ERROR_PTR("pixd not made", procName, NULL);
+  data = pixGetData(pixd);
+  wpl = pixGetWpl(pixd);
+
+  for (i = labels->run_starts[index]; i < labels->run_starts[index + 1]; i++) {
+    run = labels->runs + 3 * i;
+    setBits(data + (run[0] - by) * wpl, run[1] - bx, run[2] - bx);
+  }
+
+  return pixd;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYDROGEN_CONNCOMP_H_
+#define HYDROGEN_CONNCOMP_H_
+
+#include "leptonica.h"
+
+/* The connected components of a 1 bpp image and of its inverse, labelled
+ * together in one pass over the runs of each row. Components are numbered
+ * in raster order of their first pixel, so the components of either
+ * polarity are in the order pixConnComp() would find them in. */
+struct ConnCompLabels {
+  l_int32 n;             /* number of components of both polarities */
+  l_uint8 *polarities;   /* value of the pixels of each component */
+  BOXA *boxa;            /* bounding box of each component */
+  l_int32 *run_starts;   /* start of each component's runs in runs, and the end */
+  l_int32 *runs;         /* y, first x and last x of each run, by component */
+};
+
+ConnCompLabels *connCompLabelsCreate(PIX *pixs, l_int32 connectivity);
+
+void connCompLabelsDestroy(ConnCompLabels **plabels);
+
+PIX *connCompLabelsGetPix(ConnCompLabels *labels, l_int32 index);
+
+#endif /* HYDROGEN_CONNCOMP_H_ */
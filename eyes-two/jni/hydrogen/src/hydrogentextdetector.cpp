@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <cmath>
 #include <ctime>
 #include <cstring>
 #include <cstdlib>
@@ -21,6 +22,8 @@
 #include "leptonica.h"
 #include "hydrogentextdetector.h"
 #include "clusterer.h"
+#include "conncomp.h"
+#include "parallel.h"
 #include "thresholder.h"
 #include "utilities.h"
 
@@ -28,16 +31,44 @@ HydrogenTextDetector::HydrogenTextDetector() {
   pixs_ = NULL;
   text_areas_ = NULL;
   text_confs_ = NULL;
+  skew_angle_ = 0.0;
+  prev_pix8_ = NULL;
+  prev_areas_ = NULL;
+  prev_confs_ = NULL;
+  frames_since_refresh_ = 0;
 }
 
 HydrogenTextDetector::~HydrogenTextDetector() {
   Clear();
+  ResetIncremental();
+}
+
+/* Text regions of both polarities of the edge map, each found by a task of
+ * DetectText() */
+struct HydrogenTextDetector::PolarityTask {
+  HydrogenTextDetector *detector;
+  PIX *pix8;
+  ConnCompLabels *labels;
+  PIXA *clusters[2];
+  NUMA *confs[2];
+};
+
+void HydrogenTextDetector::ExtractPolarity(void *data, l_int32 index) {
+  PolarityTask *task = (PolarityTask *) data;
+
+  /* The text of the edge map itself comes first in the results, and then
+   * the text of its inverse */
+  l_int32 polarity = 1 - index;
+  task->clusters[index] = task->detector->ExtractTextRegions(task->pix8, task->labels, polarity,
+                                                             &task->confs[index]);
 }
 
-PIXA *HydrogenTextDetector::ExtractTextRegions(PIX *pix8, PIX *edges, NUMA **pconfs) {
+PIXA *HydrogenTextDetector::ExtractTextRegions(PIX *pix8, ConnCompLabels *labels, l_int32 polarity,
+                                               NUMA **pconfs) {
   l_int32 result;
+  const char *suffix = polarity ? "" : "_inv";
 
-  if (parameters_.debug) fprintf(stderr, "ExtractTextRegions()\n");
+  if (parameters_.debug) fprintf(stderr, "ExtractTextRegions(%d)\n", polarity);
 
   // TODO(alanv): More error checking for invalid arguments
   if (!pconfs) {
@@ -49,14 +80,14 @@ PIXA *HydrogenTextDetector::ExtractTextRegions(PIX *pix8, PIX *edges, NUMA **pco
   PIXA *conncomp;
 
   if (parameters_.debug) fprintf(stderr, "ConnCompValidPixa()\n");
-  result = ConnCompValidPixa(pix8, edges, &conncomp, &connconfs, parameters_);
+  result = ConnCompValidPixaLabeled(pix8, labels, polarity, &conncomp, &connconfs, parameters_);
 
   if (parameters_.debug) fprintf(stderr, "Found %d connected components\n", result);
 
   if (parameters_.debug && parameters_.out_dir[0] != '\0' && result > 0) {
     PIX *temp = pixaDisplayHeatmap(conncomp, pix8->w, pix8->h, connconfs);
     char filename[255];
-    sprintf(filename, "%s/%d_validsingles.jpg", parameters_.out_dir, (int) timer);
+    sprintf(filename, "%s/%d_validsingles%s.jpg", parameters_.out_dir, (int) timer, suffix);
     pixWriteImpliedFormat(filename, temp, 85, 0);
   }
 
@@ -71,7 +102,7 @@ PIXA *HydrogenTextDetector::ExtractTextRegions(PIX *pix8, PIX *edges, NUMA **pco
   if (parameters_.debug && parameters_.out_dir[0] != '\0' && result > 0) {
     PIX *temp = pixaDisplayRandomCmapFiltered(conncomp, pix8->w, pix8->h, remove);
     char filename[255];
-    sprintf(filename, "%s/%d_validpairs.jpg", parameters_.out_dir, (int) timer);
+    sprintf(filename, "%s/%d_validpairs%s.jpg", parameters_.out_dir, (int) timer, suffix);
     pixWriteImpliedFormat(filename, temp, 85, 0);
   }
 
@@ -85,7 +116,7 @@ PIXA *HydrogenTextDetector::ExtractTextRegions(PIX *pix8, PIX *edges, NUMA **pco
   if (parameters_.debug && parameters_.out_dir[0] != '\0' && result > 0) {
     PIX *temp = pixaDisplayHeatmap(clusters, pix8->w, pix8->h, clusterconfs);
     char filename[255];
-    sprintf(filename, "%s/%d_validclusters.jpg", parameters_.out_dir, (int) timer);
+    sprintf(filename, "%s/%d_validclusters%s.jpg", parameters_.out_dir, (int) timer, suffix);
     pixWriteImpliedFormat(filename, temp, 85, 0);
   }
 
@@ -97,6 +128,7 @@ PIXA *HydrogenTextDetector::ExtractTextRegions(PIX *pix8, PIX *edges, NUMA **pco
   *pconfs = clusterconfs;
 
   pixaDestroy(&conncomp);
+  numaDestroy(&connconfs);
   free(remove);
 
   return clusters;
@@ -160,7 +192,8 @@ void HydrogenTextDetector::DetectText() {
 
   PIX *edges;
   pixEdgeAdaptiveThreshold(pix8, &edges, parameters_.edge_tile_x, parameters_.edge_tile_y,
-                           parameters_.edge_thresh, parameters_.edge_avg_thresh);
+                           parameters_.edge_thresh, parameters_.edge_avg_thresh,
+                           parameters_.edge_num_threads);
 
   if (parameters_.debug && parameters_.out_dir[0] != '\0') {
     char filename[255];
@@ -183,21 +216,8 @@ void HydrogenTextDetector::DetectText() {
   }
 
   NUMA *confs;
-  PIXA *clusters = ExtractTextRegions(pix8, deskew, &confs);
-
-  if (parameters_.debug) fprintf(stderr, "Inverting image...\n");
-  pixInvert(deskew, deskew);
-
-  NUMA *invconfs;
-  PIXA *invclusters = ExtractTextRegions(pix8, deskew, &invconfs);
+  PIXA *clusters = FindTextAreas(pix8, deskew, &confs);
   pixDestroy(&deskew);
-  pixDestroy(&pix8);
-
-  pixaJoin(clusters, invclusters, 0, 0);
-  pixaDestroy(&invclusters);
-
-  numaJoin(confs, invconfs);
-  numaDestroy(&invconfs);
 
   text_areas_ = pixaCopy(clusters, L_CLONE);
   pixaDestroy(&clusters);
@@ -205,6 +225,9 @@ void HydrogenTextDetector::DetectText() {
   text_confs_ = numaClone(confs);
   numaDestroy(&confs);
 
+  RememberFrame(pix8, 0);
+  pixDestroy(&pix8);
+
   if (parameters_.debug && parameters_.out_dir[0] != '\0') {
     PIX *temp = pixaDisplayHeatmap(text_areas_, pixs_->w, pixs_->h, text_confs_);
     char filename[255];
@@ -213,6 +236,293 @@ void HydrogenTextDetector::DetectText() {
   }
 }
 
+PIXA *HydrogenTextDetector::FindTextAreas(PIX *pix8, PIX *edges, NUMA **pconfs) {
+  // Text may be darker or lighter than its background, so the edge map and
+  // its inverse are both searched for text. Their components are labelled
+  // together, and the two searches run in parallel.
+  PolarityTask task;
+  task.detector = this;
+  task.pix8 = pix8;
+  task.labels = connCompLabelsCreate(edges, CONN_COMP);
+
+  runParallelTasks(2, 0, ExtractPolarity, &task);
+
+  connCompLabelsDestroy(&task.labels);
+
+  PIXA *clusters = task.clusters[0];
+  NUMA *confs = task.confs[0];
+  PIXA *invclusters = task.clusters[1];
+  NUMA *invconfs = task.confs[1];
+
+  pixaJoin(clusters, invclusters, 0, 0);
+  pixaDestroy(&invclusters);
+
+  numaJoin(confs, invconfs);
+  numaDestroy(&invconfs);
+
+  *pconfs = confs;
+
+  return clusters;
+}
+
+/* Sets the range of tiles [first, last] of num_tiles tiles of tile_size
+ * covering the part of [start, start + size) in [0, length) */
+static void getTileRange(l_int32 start, l_int32 size, l_int32 length, l_int32 tile_size, l_int32 num_tiles,
+                         l_int32 *first, l_int32 *last) {
+  *first = L_MIN(num_tiles - 1, L_MAX(0, start) / tile_size);
+  *last = L_MIN(num_tiles - 1, L_MAX(0, L_MIN(length, start + size) - 1) / tile_size);
+}
+
+/* Returns the number of set tiles in columns [c0, c1] and rows [r0, r1] */
+static l_int32 countSetTiles(PIX *tiles, l_int32 c0, l_int32 r0, l_int32 c1, l_int32 r1) {
+  l_int32 wpl = pixGetWpl(tiles);
+  l_uint32 *data = pixGetData(tiles);
+  l_int32 count = 0;
+
+  for (l_int32 r = r0; r <= r1; r++) {
+    l_uint32 *line = data + r * wpl;
+    for (l_int32 c = c0; c <= c1; c++)
+      count += GET_DATA_BIT(line, c);
+  }
+
+  return count;
+}
+
+/* Covers the set tiles with rectangles, in tiles, by merging runs of set
+ * tiles that span the same columns on consecutive rows */
+static BOXA *getTileRegions(PIX *tiles) {
+  l_int32 nx = pixGetWidth(tiles);
+  l_int32 ny = pixGetHeight(tiles);
+  l_int32 wpl = pixGetWpl(tiles);
+  l_uint32 *data = pixGetData(tiles);
+  BOXA *regions = boxaCreate(0);
+
+  for (l_int32 r = 0; r < ny; r++) {
+    l_uint32 *line = data + r * wpl;
+    l_int32 c = 0;
+    while (c < nx) {
+      if (!GET_DATA_BIT(line, c)) {
+        c++;
+        continue;
+      }
+
+      l_int32 c0 = c;
+      while (c < nx && GET_DATA_BIT(line, c))
+        c++;
+
+      bool extended = false;
+      for (l_int32 i = 0; i < boxaGetCount(regions) && !extended; i++) {
+        BOX *region = boxaGetBox(regions, i, L_CLONE);
+        if (region->x == c0 && region->w == c - c0 && region->y + region->h == r) {
+          region->h++;
+          extended = true;
+        }
+        boxDestroy(&region);
+      }
+
+      if (!extended)
+        boxaAddBox(regions, boxCreate(c0, r, c - c0, 1), L_INSERT);
+    }
+  }
+
+  return regions;
+}
+
+void HydrogenTextDetector::DetectTextIncremental(l_float32 dx, l_float32 dy) {
+  if (parameters_.debug) fprintf(stderr, "DetectTextIncremental(%f, %f)\n", dx, dy);
+
+  // Text areas of a deskewed edge map are not in frame coordinates, so they
+  // can't be moved with the frame.
+  if (!prev_pix8_ || !prev_areas_ || skew_angle_ != 0.0 ||
+      frames_since_refresh_ + 1 >= parameters_.incremental_refresh ||
+      pixGetWidth(prev_pix8_) != pixGetWidth(pixs_) || pixGetHeight(prev_pix8_) != pixGetHeight(pixs_)) {
+    DetectText();
+    return;
+  }
+
+  PIX *pix8 = pixConvertTo8(pixs_, false);
+  l_int32 w = pixGetWidth(pix8);
+  l_int32 h = pixGetHeight(pix8);
+  l_int32 shift_x = (l_int32) floor(dx + 0.5);
+  l_int32 shift_y = (l_int32) floor(dy + 0.5);
+
+  // Compare the frames on the tiles of the edge thresholding, so that the
+  // searched regions are thresholded on the same tiles as in a full detection.
+  l_int32 nx = L_MAX(1, w / parameters_.edge_tile_x);
+  l_int32 ny = L_MAX(1, h / parameters_.edge_tile_y);
+  l_int32 tw = w / nx;
+  l_int32 th = h / ny;
+  PIX *changed = pixFindChangedTiles(pix8, prev_pix8_, shift_x, shift_y, nx, ny,
+                                     parameters_.incremental_diff_thresh);
+
+  // Move the previous text areas with the scene
+  PIXA *moved = pixaTranslateBoxes(prev_areas_, shift_x, shift_y);
+  l_int32 num_moved = pixaGetCount(moved);
+
+  // Grow the changed tiles until every text area they touch lies in one of
+  // the rectangles they are searched in, so that text areas are either all
+  // kept or all searched again. Text areas moved partly out of the frame are
+  // searched again too.
+  BOXA *regions = NULL;
+  l_int32 count, prev_count = -1;
+  pixCountPixels(changed, &count, NULL);
+  while (count != prev_count) {
+    prev_count = count;
+
+    for (l_int32 i = 0; i < num_moved; i++) {
+      l_int32 bx, by, bw, bh, c0, c1, r0, r1;
+      pixaGetBoxGeometry(moved, i, &bx, &by, &bw, &bh);
+      if (bx >= w || by >= h || bx + bw <= 0 || by + bh <= 0)
+        continue;
+
+      bool inside = bx >= 0 && by >= 0 && bx + bw <= w && by + bh <= h;
+      getTileRange(bx, bw, w, tw, nx, &c0, &c1);
+      getTileRange(by, bh, h, th, ny, &r0, &r1);
+      l_int32 set = countSetTiles(changed, c0, r0, c1, r1);
+      if ((set > 0 || !inside) && set < (c1 - c0 + 1) * (r1 - r0 + 1))
+        pixRasterop(changed, c0, r0, c1 - c0 + 1, r1 - r0 + 1, PIX_SET, NULL, 0, 0);
+    }
+
+    boxaDestroy(&regions);
+    regions = getTileRegions(changed);
+
+    // Join the rectangles that a text area straddles
+    for (l_int32 i = 0; i < num_moved; i++) {
+      l_int32 bx, by, bw, bh, c0, c1, r0, r1;
+      pixaGetBoxGeometry(moved, i, &bx, &by, &bw, &bh);
+      if (bx >= w || by >= h || bx + bw <= 0 || by + bh <= 0)
+        continue;
+
+      getTileRange(bx, bw, w, tw, nx, &c0, &c1);
+      getTileRange(by, bh, h, th, ny, &r0, &r1);
+      l_int32 num_touched = 0;
+      l_int32 jc0 = c0, jr0 = r0, jc1 = c1, jr1 = r1;
+      for (l_int32 j = 0; j < boxaGetCount(regions); j++) {
+        l_int32 rx, ry, rw, rh;
+        boxaGetBoxGeometry(regions, j, &rx, &ry, &rw, &rh);
+        if (rx > c1 || ry > r1 || rx + rw <= c0 || ry + rh <= r0)
+          continue;
+
+        num_touched++;
+        jc0 = L_MIN(jc0, rx);
+        jr0 = L_MIN(jr0, ry);
+        jc1 = L_MAX(jc1, rx + rw - 1);
+        jr1 = L_MAX(jr1, ry + rh - 1);
+      }
+
+      if (num_touched > 1)
+        pixRasterop(changed, jc0, jr0, jc1 - jc0 + 1, jr1 - jr0 + 1, PIX_SET, NULL, 0, 0);
+    }
+
+    pixCountPixels(changed, &count, NULL);
+  }
+
+  if (count > parameters_.incremental_max_changed * nx * ny) {
+    if (parameters_.debug) fprintf(stderr, "%d of %d tiles changed\n", count, nx * ny);
+
+    boxaDestroy(&regions);
+    pixaDestroy(&moved);
+    pixDestroy(&changed);
+    pixDestroy(&pix8);
+    DetectText();
+    return;
+  }
+
+  // Keep the moved text areas that are in the frame and out of the regions
+  PIXA *clusters = pixaCreate(0);
+  NUMA *confs = numaCreate(0);
+  for (l_int32 i = 0; i < num_moved; i++) {
+    l_int32 bx, by, bw, bh, c0, c1, r0, r1;
+    pixaGetBoxGeometry(moved, i, &bx, &by, &bw, &bh);
+    if (bx < 0 || by < 0 || bx + bw > w || by + bh > h)
+      continue;
+
+    getTileRange(bx, bw, w, tw, nx, &c0, &c1);
+    getTileRange(by, bh, h, th, ny, &r0, &r1);
+    if (countSetTiles(changed, c0, r0, c1, r1) > 0)
+      continue;
+
+    l_float32 conf = 0.0;
+    if (prev_confs_)
+      numaGetFValue(prev_confs_, i, &conf);
+    pixaAddPix(clusters, pixaGetPix(moved, i, L_CLONE), L_INSERT);
+    pixaAddBox(clusters, pixaGetBox(moved, i, L_CLONE), L_INSERT);
+    numaAddNumber(confs, conf);
+  }
+  pixaDestroy(&moved);
+  pixDestroy(&changed);
+
+  if (parameters_.debug) {
+    fprintf(stderr, "Kept %d text areas, searching %d of %d tiles in %d regions\n", pixaGetCount(clusters),
+            count, nx * ny, boxaGetCount(regions));
+  }
+
+  // Search the regions, cut on the edge thresholding tiles
+  for (l_int32 i = 0; i < boxaGetCount(regions); i++) {
+    l_int32 rx, ry, rw, rh;
+    boxaGetBoxGeometry(regions, i, &rx, &ry, &rw, &rh);
+    l_int32 x0 = rx * tw;
+    l_int32 y0 = ry * th;
+    l_int32 x1 = rx + rw == nx ? w : (rx + rw) * tw;
+    l_int32 y1 = ry + rh == ny ? h : (ry + rh) * th;
+
+    BOX *box = boxCreate(x0, y0, x1 - x0, y1 - y0);
+    PIX *region8 = pixClipRectangle(pix8, box, NULL);
+    boxDestroy(&box);
+
+    PIX *edges;
+    if (pixEdgeAdaptiveThreshold(region8, &edges, tw, th, parameters_.edge_thresh,
+                                 parameters_.edge_avg_thresh, parameters_.edge_num_threads)) {
+      pixDestroy(&region8);
+      continue;
+    }
+
+    NUMA *region_confs;
+    PIXA *region_clusters = FindTextAreas(region8, edges, &region_confs);
+    pixDestroy(&edges);
+    pixDestroy(&region8);
+
+    PIXA *found = pixaTranslateBoxes(region_clusters, x0, y0);
+    pixaJoin(clusters, found, 0, 0);
+    numaJoin(confs, region_confs);
+    pixaDestroy(&found);
+    pixaDestroy(&region_clusters);
+    numaDestroy(&region_confs);
+  }
+  boxaDestroy(&regions);
+
+  text_areas_ = clusters;
+  text_confs_ = confs;
+
+  RememberFrame(pix8, frames_since_refresh_ + 1);
+  pixDestroy(&pix8);
+}
+
+void HydrogenTextDetector::RememberFrame(PIX *pix8, l_int32 frames_since_refresh) {
+  ResetIncremental();
+
+  prev_pix8_ = pixClone(pix8);
+  prev_areas_ = pixaCopy(text_areas_, L_CLONE);
+  prev_confs_ = text_confs_ ? numaClone(text_confs_) : NULL;
+  frames_since_refresh_ = frames_since_refresh;
+}
+
+void HydrogenTextDetector::ResetIncremental() {
+  if (prev_confs_) {
+    numaDestroy(&prev_confs_);
+  }
+
+  if (prev_areas_) {
+    pixaDestroy(&prev_areas_);
+  }
+
+  if (prev_pix8_) {
+    pixDestroy(&prev_pix8_);
+  }
+
+  frames_since_refresh_ = 0;
+}
+
 void HydrogenTextDetector::Clear() {
   if (text_confs_) {
     numaDestroy(&text_confs_);
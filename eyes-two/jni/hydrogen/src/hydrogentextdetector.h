@@ -19,6 +19,8 @@
 
 #include "leptonica.h"
 
+struct ConnCompLabels;
+
 class HydrogenTextDetector {
 public:
   HydrogenTextDetector();
@@ -34,6 +36,7 @@ public:
     l_int32 edge_tile_y;
     l_int32 edge_thresh;
     l_int32 edge_avg_thresh;
+    l_int32 edge_num_threads;
 
     // Skew angle correction
     bool skew_enabled;
@@ -69,12 +72,18 @@ public:
     l_int32 cluster_min_edge;
     l_int32 cluster_min_edge_avg;
 
+    // Incremental detection
+    l_int32 incremental_refresh;
+    l_int32 incremental_diff_thresh;
+    l_float32 incremental_max_changed;
+
     TextDetectorParameters()
         : debug(false),
           edge_tile_x(32),
           edge_tile_y(64),
           edge_thresh(64),
           edge_avg_thresh(4),
+          edge_num_threads(0),
           skew_enabled(true),
           skew_min_angle(1.0),
           skew_sweep_range(30.0),
@@ -98,7 +107,10 @@ public:
           cluster_min_aspect(2),
           cluster_min_fdr(2.5),
           cluster_min_edge(32),
-          cluster_min_edge_avg(1)
+          cluster_min_edge_avg(1),
+          incremental_refresh(15),
+          incremental_diff_thresh(12),
+          incremental_max_changed(0.5)
           {
     }
   };
@@ -109,6 +121,18 @@ public:
   // Main text detection function
   void DetectText();
 
+  // Text detection for the consecutive frames of a video. The text areas of
+  // the previous frame are moved by the motion (dx, dy) of the scene since
+  // then, such as the accumulated optical flow at the center of the frame,
+  // and only the areas that changed or came into view are searched for text.
+  // Falls back to DetectText() every incremental_refresh frames, when more
+  // than incremental_max_changed of the frame changed, and after frames with
+  // skewed text.
+  void DetectTextIncremental(l_float32 dx, l_float32 dy);
+
+  // Forget the previous frame, so the next incremental detection is a full one
+  void ResetIncremental();
+
   // Clear recognition results between calls
   void Clear();
 
@@ -141,8 +165,27 @@ private:
   // Detected skew angle
   l_float32 skew_angle_;
 
-  // Function to extract text areas from a PIX
-  PIXA *ExtractTextRegions(PIX *pix8, PIX *edges, NUMA **pconfs);
+  // Grayscale previous frame, and its text areas and confidences, kept for
+  // incremental detection
+  PIX *prev_pix8_;
+  PIXA *prev_areas_;
+  NUMA *prev_confs_;
+  // Incremental detections since the last full detection
+  l_int32 frames_since_refresh_;
+
+  struct PolarityTask;
+
+  // Function to extract text areas of one polarity of labelled edges
+  PIXA *ExtractTextRegions(PIX *pix8, ConnCompLabels *labels, l_int32 polarity, NUMA **pconfs);
+
+  // Task of runParallelTasks extracting the text areas of one polarity
+  static void ExtractPolarity(void *data, l_int32 index);
+
+  // Function to extract text areas of both polarities of edges
+  PIXA *FindTextAreas(PIX *pix8, PIX *edges, NUMA **pconfs);
+
+  // Function to keep a frame and its text areas for incremental detection
+  void RememberFrame(PIX *pix8, l_int32 frames_since_refresh);
 
   // Function to detect and fix text skew
   PIX *DetectAndFixSkew(PIX *pixs);
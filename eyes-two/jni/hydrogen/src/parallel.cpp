@@ -0,0 +1,114 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "leptonica.h"
+#include "parallel.h"
+
+/* The maximum number of threads runParallelTasks will start */
+static const l_int32 kMaxThreads = 16;
+
+struct ParallelTasks {
+  l_int32 num_tasks;
+  PARALLEL_TASK task;
+  void *data;
+
+  /* Guards next */
+  pthread_mutex_t mutex;
+  l_int32 next;
+};
+
+static void *runTasks(void *arg) {
+  ParallelTasks *tasks = (ParallelTasks *) arg;
+
+  while (true) {
+    pthread_mutex_lock(&tasks->mutex);
+    l_int32 index = tasks->next++;
+    pthread_mutex_unlock(&tasks->mutex);
+
+    if (index >= tasks->num_tasks)
+      break;
+
+    tasks->task(tasks->data, index);
+  }
+
+  return NULL;
+}
+
+/*!
+ *  getNumProcessors()
+ *
+ *      Return: the number of online processors, or 1 if unknown
+ */
+l_int32 getNumProcessors() {
+  long num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return num_processors > 0 ? (l_int32) num_processors : 1;
+}
+
+/*!
+ *  runParallelTasks()
+ *
+ *      Input:  num_tasks (number of tasks)
+ *              num_threads (number of threads, including the calling thread;
+ *                           use 0 for one per processor)
+ *              task (function to call once with each task index)
+ *              data (passed to each call of task)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) Tasks are handed out in index order to whichever thread is free,
+ *          so they may be run in any order and must be independent.
+ *      (2) Returns when all the tasks have been run. If threads can't be
+ *          started, the remaining threads run all the tasks.
+ */
+l_int32 runParallelTasks(l_int32 num_tasks, l_int32 num_threads, PARALLEL_TASK task, void *data) {
+  pthread_t threads[kMaxThreads];
+  ParallelTasks tasks;
+  l_int32 i, num_started;
+
+  PROCNAME("runParallelTasks");
+
+  if (!task)
+    return ERROR_INT("task not defined", procName, 1);
+
+  if (num_threads <= 0)
+    num_threads = getNumProcessors();
+  num_threads = L_MIN(num_threads, L_MIN(num_tasks, kMaxThreads));
+
+  tasks.num_tasks = num_tasks;
+  tasks.task = task;
+  tasks.data = data;
+  tasks.next = 0;
+  pthread_mutex_init(&tasks.mutex, NULL);
+
+  num_started = 0;
+  for (i = 1; i < num_threads; i++) {
+    if (pthread_create(&threads[num_started], NULL, runTasks, &tasks) == 0)
+      num_started++;
+  }
+
+  runTasks(&tasks);
+
+  for (i = 0; i < num_started; i++)
+    pthread_join(threads[i], NULL);
+
+  pthread_mutex_destroy(&tasks.mutex);
+
+  return 0;
+}
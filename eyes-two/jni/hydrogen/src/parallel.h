@@ -0,0 +1,29 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HYDROGEN_PARALLEL_H_
+#define HYDROGEN_PARALLEL_H_
+
+#include "leptonica.h"
+
+/* A task of runParallelTasks, called once with each index in [0, num_tasks) */
+typedef void (*PARALLEL_TASK)(void *data, l_int32 index);
+
+l_int32 getNumProcessors();
+
+l_int32 runParallelTasks(l_int32 num_tasks, l_int32 num_threads, PARALLEL_TASK task, void *data);
+
+#endif /* HYDROGEN_PARALLEL_H_ */
@@ -15,10 +15,49 @@
  */
 
 #include <math.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef HAVE_ARMEABI_V7A
+#include <arm_neon.h>
+#include <cpu-features.h>
+#endif
 
 #include "leptonica.h"
+#include "parallel.h"
 #include "thresholder.h"
 
+/* Number of image rows in each parallel task of pixThreshedSobelEdgeFilter */
+static const l_int32 kSobelBandHeight = 64;
+
+/* Arguments of the per-tile-row tasks of the adaptive thresholders */
+struct AdaptiveThresholdTiles {
+  PIXTILING *pt;
+  PIX *pixd;
+  l_int32 nx;
+
+  /* pixFisherAdaptiveThreshold */
+  l_float32 score_fract;
+  l_float32 fdr_thresh;
+
+  /* pixEdgeAdaptiveThreshold */
+  l_int32 edge_thresh;
+  l_int32 avg_thresh;
+};
+
+/* Arguments of the per-band tasks of pixThreshedSobelEdgeFilter */
+struct SobelBands {
+  PIX *pixs;
+  PIX *pixd;
+  l_int32 threshold;
+  l_int32 nrows;
+  l_int32 nbytes;
+  bool use_neon;
+};
+
 /*!
  *  pixFisherAdaptiveThreshold()
  *
@@ -27,14 +66,36 @@
  *              sx, sy (desired tile dimensions; actual size may vary)
  *              scorefract (fraction of the max Otsu score; typ. 0.1)
  *              fdrthresh (threshold for Fisher's Discriminant Rate; typ. 5.0)
+ *              num_threads (threads to threshold the tiles on; 0 for one
+ *                           per processor)
  *      Return: 0 if OK, 1 on error
  */
-l_int32 pixFisherAdaptiveThreshold(PIX *pixs, PIX **ppixd, l_int32 tile_x, l_int32 tile_y,
-                                l_float32 score_fract, l_float32 thresh) {
+static void fisherThresholdTileRow(void *data, l_int32 y) {
+  AdaptiveThresholdTiles *tiles = (AdaptiveThresholdTiles *) data;
   l_float32 fdr;
-  l_int32 w, h, d, nx, ny, x, y, t;
-  PIX *pixb, *pixd, *pixt;
+  l_int32 x, t;
+  PIX *pixb, *pixt;
+
+  for (x = 0; x < tiles->nx; x++) {
+    pixt = pixTilingGetTile(tiles->pt, y, x);
+    pixGetFisherThresh(pixt, tiles->score_fract, &fdr, &t);
+
+    if (fdr > tiles->fdr_thresh) {
+      pixb = pixThresholdToBinary(pixt, t);
+      pixTilingPaintTile(tiles->pixd, y, x, pixb, tiles->pt);
+      pixDestroy(&pixb);
+    }
+
+    pixDestroy(&pixt);
+  }
+}
+
+l_int32 pixFisherAdaptiveThreshold(PIX *pixs, PIX **ppixd, l_int32 tile_x, l_int32 tile_y,
+                                l_float32 score_fract, l_float32 thresh, l_int32 num_threads) {
+  l_int32 w, h, d, nx, ny;
+  PIX *pixd;
   PIXTILING *pt;
+  AdaptiveThresholdTiles tiles;
 
   PROCNAME("pixFisherAdaptiveThreshold");
 
@@ -53,20 +114,15 @@ l_int32 pixFisherAdaptiveThreshold(PIX *pixs, PIX **ppixd, l_int32 tile_x, l_int
   ny = L_MAX(1, h / tile_y);
   pt = pixTilingCreate(pixs, nx, ny, 0, 0, 0, 0);
   pixd = pixCreate(w, h, 1);
-  for (y = 0; y < ny; y++) {
-    for (x = 0; x < nx; x++) {
-      pixt = pixTilingGetTile(pt, y, x);
-      pixGetFisherThresh(pixt, score_fract, &fdr, &t);
-
-      if (fdr > thresh) {
-        pixb = pixThresholdToBinary(pixt, t);
-        pixTilingPaintTile(pixd, y, x, pixb, pt);
-        pixDestroy(&pixb);
-      }
 
-      pixDestroy(&pixt);
-    }
-  }
+  /* Each row of tiles paints its own rows of pixd, so they can be
+   * thresholded in parallel. */
+  tiles.pt = pt;
+  tiles.pixd = pixd;
+  tiles.nx = nx;
+  tiles.score_fract = score_fract;
+  tiles.fdr_thresh = thresh;
+  runParallelTasks(ny, num_threads, fisherThresholdTileRow, &tiles);
 
   pixTilingDestroy(&pt);
 
@@ -135,79 +191,248 @@ l_int32 pixGetFisherThresh(PIX *pixs, l_float32 scorefract, l_float32 *pfdr, l_i
   return 0;
 }
 
-PIX *pixThreshedSobelEdgeFilter(PIX *pixs, l_int32 threshold) {
-  l_uint8 bval, bidx;
-  l_int32 w, h, d, i, j, wplt, wpld, gx, gy, vald;
-  l_int32 val1, val2, val3, val4, val5, val6, val7, val8, val9;
-  l_uint32 *datat, *linet, *datad, *lined;
-  PIX *pixd;
+/*!
+ *  sobelThresholdRow()
+ *
+ *      Input:  top, mid, bot (three consecutive rows of 8 bpp pixels, one
+ *                             byte per pixel in pixel order, with at least
+ *                             nbytes * 8 + 2 readable bytes)
+ *              nbytes (number of output bytes)
+ *              threshold (edge threshold in [0, kSobelNoThreshold])
+ *              out (<return> nbytes bytes of 1 bpp output, MSB first)
+ *
+ *  Notes:
+ *      (1) Output pixel j is the thresholded Sobel magnitude of the 3x3
+ *          neighborhood with top left corner at pixel j of top.
+ */
+void sobelThresholdRow(const l_uint8 *top, const l_uint8 *mid, const l_uint8 *bot,
+                       l_int32 nbytes, l_int32 threshold, l_uint8 *out) {
+  l_int32 b = 0;
+
+#ifdef __SSE2__
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i thresh = _mm_set1_epi16((short) (threshold - 1));
+  const __m128i weights = _mm_setr_epi8((char) 128, 64, 32, 16, 8, 4, 2, 1,
+                                        (char) 128, 64, 32, 16, 8, 4, 2, 1);
+
+  /* 16 pixels at a time, in two halves of 8 16-bit lanes */
+  for (; b + 2 <= nbytes; b += 2) {
+    const l_int32 j = b * 8;
+    __m128i t0 = _mm_loadu_si128((const __m128i *) (top + j));
+    __m128i t1 = _mm_loadu_si128((const __m128i *) (top + j + 1));
+    __m128i t2 = _mm_loadu_si128((const __m128i *) (top + j + 2));
+    __m128i m0 = _mm_loadu_si128((const __m128i *) (mid + j));
+    __m128i m2 = _mm_loadu_si128((const __m128i *) (mid + j + 2));
+    __m128i b0 = _mm_loadu_si128((const __m128i *) (bot + j));
+    __m128i b1 = _mm_loadu_si128((const __m128i *) (bot + j + 1));
+    __m128i b2 = _mm_loadu_si128((const __m128i *) (bot + j + 2));
+    __m128i edge[2];
+
+    for (int half = 0; half < 2; half++) {
+      __m128i t0w, t1w, t2w, m0w, m2w, b0w, b1w, b2w;
+      if (half == 0) {
+        t0w = _mm_unpacklo_epi8(t0, zero);
+        t1w = _mm_unpacklo_epi8(t1, zero);
+        t2w = _mm_unpacklo_epi8(t2, zero);
+        m0w = _mm_unpacklo_epi8(m0, zero);
+        m2w = _mm_unpacklo_epi8(m2, zero);
+        b0w = _mm_unpacklo_epi8(b0, zero);
+        b1w = _mm_unpacklo_epi8(b1, zero);
+        b2w = _mm_unpacklo_epi8(b2, zero);
+      } else {
+        t0w = _mm_unpackhi_epi8(t0, zero);
+        t1w = _mm_unpackhi_epi8(t1, zero);
+        t2w = _mm_unpackhi_epi8(t2, zero);
+        m0w = _mm_unpackhi_epi8(m0, zero);
+        m2w = _mm_unpackhi_epi8(m2, zero);
+        b0w = _mm_unpackhi_epi8(b0, zero);
+        b1w = _mm_unpackhi_epi8(b1, zero);
+        b2w = _mm_unpackhi_epi8(b2, zero);
+      }
 
-  PROCNAME("pixThreshedSobelEdgeFilter");
+      /* gx = left column - right column, gy = top row - bottom row */
+      __m128i gx = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(t0w, b0w), _mm_add_epi16(m0w, m0w)),
+                                 _mm_add_epi16(_mm_add_epi16(t2w, b2w), _mm_add_epi16(m2w, m2w)));
+      __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(t0w, t2w), _mm_add_epi16(t1w, t1w)),
+                                 _mm_add_epi16(_mm_add_epi16(b0w, b2w), _mm_add_epi16(b1w, b1w)));
+      gx = _mm_max_epi16(gx, _mm_sub_epi16(zero, gx));
+      gy = _mm_max_epi16(gy, _mm_sub_epi16(zero, gy));
+      edge[half] = _mm_cmpgt_epi16(_mm_add_epi16(gx, gy), thresh);
+    }
 
-  if (!pixs)
-    return (PIX *) ERROR_PTR("pixs not defined", procName, NULL);
-  pixGetDimensions(pixs, &w, &h, &d);
-  if (d != 8)
-    return (PIX *) ERROR_PTR("pixs not 8 bpp", procName, NULL);
+    /* Weight each edge byte by its bit and sum each group of 8 */
+    __m128i bits = _mm_and_si128(_mm_packs_epi16(edge[0], edge[1]), weights);
+    __m128i sums = _mm_sad_epu8(bits, zero);
+    out[b] = (l_uint8) _mm_cvtsi128_si32(sums);
+    out[b + 1] = (l_uint8) _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+  }
+#endif
 
-  /* Compute filter output at each location. */
-  pixd = pixCreateNoInit(w, h, 1);
-  datat = pixGetData(pixs);
-  wplt = pixGetWpl(pixs);
-  datad = pixGetData(pixd);
-  wpld = pixGetWpl(pixd);
-  val1 = val2 = val3 = val4 = val5 = 0;
-  val6 = val7 = val8 = val9 = 0;
-  bval = bidx = 0;
-  for (i = 0; i < h - 1; i++) {
-    linet = datat + i * wplt;
-    lined = datad + i * wpld;
-    for (j = 0; j < w - 1; j++) {
-      if (j == 0) { /* start a new row */
-        val1 = GET_DATA_BYTE(linet, j);
-        val2 = GET_DATA_BYTE(linet + wplt, j);
-        val3 = GET_DATA_BYTE(linet + (wplt << 1), j);
-        val4 = GET_DATA_BYTE(linet, j + 1);
-        val5 = GET_DATA_BYTE(linet + wplt, j + 1);
-        val6 = GET_DATA_BYTE(linet + (wplt << 1), j + 1);
-        val7 = GET_DATA_BYTE(linet, j + 2);
-        val8 = GET_DATA_BYTE(linet + wplt, j + 2);
-        val9 = GET_DATA_BYTE(linet + (wplt << 1), j + 2);
-        bval = 0;
-        bidx = 0x80;
-      } else { /* shift right by 1 pixel; update incrementally */
-        val1 = val4;
-        val2 = val5;
-        val3 = val6;
-        val4 = val7;
-        val5 = val8;
-        val6 = val9;
-        val7 = GET_DATA_BYTE(linet, j + 2);
-        val8 = GET_DATA_BYTE(linet + wplt, j + 2);
-        val9 = GET_DATA_BYTE(linet + (wplt << 1), j + 2);
-      }
+  for (; b < nbytes; b++) {
+    l_uint8 bval = 0;
 
-      bval <<= 1;
-      bidx >>= 1;
+    for (l_int32 j = b * 8; j < b * 8 + 8; j++) {
+      l_int32 gx = top[j] + (mid[j] << 1) + bot[j] - top[j + 2] - (mid[j + 2] << 1) - bot[j + 2];
+      l_int32 gy = top[j] + (top[j + 1] << 1) + top[j + 2] - bot[j] - (bot[j + 1] << 1) - bot[j + 2];
 
-      gx = val1 + (val2 << 1) + val3 - val7 - (val8 << 1) - val9;
-      gy = val1 + (val4 << 1) + val7 - val3 - (val6 << 1) - val9;
-      vald = L_MIN(255, L_ABS(gx) + L_ABS(gy));
-
-      /* Flip high bit if value exceeds threshold */
-      if (vald >= threshold) {
+      bval <<= 1;
+      if (L_ABS(gx) + L_ABS(gy) >= threshold) {
         bval |= 1;
       }
+    }
 
-      if (bidx == 0) {
-        SET_DATA_BYTE(lined, j / 8, bval);
+    out[b] = bval;
+  }
+}
 
-        bval = 0;
-        bidx = 0x80;
-      }
-    }
+#ifdef HAVE_ARMEABI_V7A
+/*!
+ *  sobelThresholdRowNEON()
+ *
+ *  Notes:
+ *      (1) Same as sobelThresholdRow(); only call if the cpu supports NEON.
+ */
+void sobelThresholdRowNEON(const l_uint8 *top, const l_uint8 *mid, const l_uint8 *bot,
+                           l_int32 nbytes, l_int32 threshold, l_uint8 *out) {
+  static const l_uint8 kBitWeights[8] = { 128, 64, 32, 16, 8, 4, 2, 1 };
+  const int16x8_t thresh = vdupq_n_s16((int16_t) threshold);
+  const uint8x8_t weights = vld1_u8(kBitWeights);
+
+  /* 8 pixels at a time in 16-bit lanes */
+  for (l_int32 b = 0; b < nbytes; b++) {
+    const l_int32 j = b * 8;
+    int16x8_t t0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(top + j)));
+    int16x8_t t1 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(top + j + 1)));
+    int16x8_t t2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(top + j + 2)));
+    int16x8_t m0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(mid + j)));
+    int16x8_t m2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(mid + j + 2)));
+    int16x8_t b0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(bot + j)));
+    int16x8_t b1 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(bot + j + 1)));
+    int16x8_t b2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(bot + j + 2)));
+
+    /* gx = left column - right column, gy = top row - bottom row */
+    int16x8_t gx = vsubq_s16(vaddq_s16(vaddq_s16(t0, b0), vshlq_n_s16(m0, 1)),
+                             vaddq_s16(vaddq_s16(t2, b2), vshlq_n_s16(m2, 1)));
+    int16x8_t gy = vsubq_s16(vaddq_s16(vaddq_s16(t0, t2), vshlq_n_s16(t1, 1)),
+                             vaddq_s16(vaddq_s16(b0, b2), vshlq_n_s16(b1, 1)));
+    uint16x8_t edge = vcgeq_s16(vaddq_s16(vabsq_s16(gx), vabsq_s16(gy)), thresh);
+
+    /* Weight each edge byte by its bit and sum them */
+    uint8x8_t bits = vand_u8(vmovn_u16(edge), weights);
+    out[b] = (l_uint8) vget_lane_u64(vpaddl_u32(vpaddl_u16(vpaddl_u8(bits))), 0);
+  }
+}
+#endif
+
+/* Copies a row of an 8 bpp pix into bytes in pixel order */
+static void unpackRow8(const l_uint32 *line, l_int32 wpl, l_uint8 *bytes) {
+#ifdef L_BIG_ENDIAN
+  memcpy(bytes, line, wpl * 4);
+#else
+  for (l_int32 k = 0; k < wpl; k++) {
+    l_uint32 word = line[k];
+
+    bytes[4 * k] = (l_uint8) (word >> 24);
+    bytes[4 * k + 1] = (l_uint8) (word >> 16);
+    bytes[4 * k + 2] = (l_uint8) (word >> 8);
+    bytes[4 * k + 3] = (l_uint8) word;
+  }
+#endif
+}
+
+static void sobelThresholdBand(void *data, l_int32 band) {
+  SobelBands *bands = (SobelBands *) data;
+  l_int32 wpls = pixGetWpl(bands->pixs);
+  l_int32 wpld = pixGetWpl(bands->pixd);
+  l_uint32 *datas = pixGetData(bands->pixs);
+  l_uint32 *datad = pixGetData(bands->pixd);
+  l_int32 first = band * kSobelBandHeight;
+  l_int32 last = L_MIN(first + kSobelBandHeight, bands->nrows);
+
+  /* Three rolling input rows, padded for the 16-byte loads, and an output
+   * row; allocated together. */
+  l_int32 stride = wpls * 4 + 16;
+  l_uint8 *buffer = (l_uint8 *) CALLOC(3 * stride + wpld * 4, 1);
+  l_uint8 *rows[3];
+  l_uint8 *out = buffer + 3 * stride;
+
+  for (l_int32 k = 0; k < 3; k++)
+    rows[k] = buffer + k * stride;
+  unpackRow8(datas + first * wpls, wpls, rows[0]);
+  unpackRow8(datas + (first + 1) * wpls, wpls, rows[1]);
+
+  for (l_int32 i = first; i < last; i++) {
+    l_uint8 *top = rows[(i - first) % 3];
+    l_uint8 *mid = rows[(i - first + 1) % 3];
+    l_uint8 *bot = rows[(i - first + 2) % 3];
+    l_uint32 *lined = datad + i * wpld;
+
+    unpackRow8(datas + (i + 2) * wpls, wpls, bot);
+
+#ifdef HAVE_ARMEABI_V7A
+    if (bands->use_neon)
+      sobelThresholdRowNEON(top, mid, bot, bands->nbytes, bands->threshold, out);
+    else
+#endif
+      sobelThresholdRow(top, mid, bot, bands->nbytes, bands->threshold, out);
+
+    for (l_int32 b = 0; b < bands->nbytes; b++)
+      SET_DATA_BYTE(lined, b, out[b]);
   }
 
+  FREE(buffer);
+}
+
+/*!
+ *  pixThreshedSobelEdgeFilter()
+ *
+ *      Input:  pixs (8 bpp)
+ *              threshold (minimum Sobel edge magnitude of an edge pixel)
+ *              num_threads (threads to filter the image on; 0 for one per
+ *                           processor)
+ *      Return: pixd (1 bpp edge mask), or null on error
+ *
+ *  Notes:
+ *      (1) Pixel (x, y) of pixd is set if the Sobel magnitude of the 3x3
+ *          neighborhood of pixs with top left corner (x, y), clipped to 255,
+ *          is at least threshold.
+ *      (2) Only the pixels with complete neighborhoods and in complete bytes
+ *          of pixd are computed; the last two rows and the remaining pixels
+ *          of each row are cleared.
+ */
+PIX *pixThreshedSobelEdgeFilter(PIX *pixs, l_int32 threshold, l_int32 num_threads) {
+  l_int32 w, h, d, nbands;
+  PIX *pixd;
+  SobelBands bands;
+
+  PROCNAME("pixThreshedSobelEdgeFilter");
+
+  if (!pixs)
+    return (PIX *) ERROR_PTR("pixs not defined", procName, NULL);
+  pixGetDimensions(pixs, &w, &h, &d);
+  if (d != 8)
+    return (PIX *) ERROR_PTR("pixs not 8 bpp", procName, NULL);
+
+  pixd = pixCreate(w, h, 1);
+  if (w < 3 || h < 3)
+    return pixd;
+
+  /* Magnitudes are clipped to 255, so higher thresholds never match */
+  bands.pixs = pixs;
+  bands.pixd = pixd;
+  bands.threshold = threshold > 255 ? kSobelNoThreshold : L_MAX(0, threshold);
+  bands.nrows = h - 2;
+  bands.nbytes = (w - 1) / 8;
+  bands.use_neon = false;
+#ifdef HAVE_ARMEABI_V7A
+  bands.use_neon = (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0;
+#endif
+
+  /* Bands of rows write separate rows of pixd, so they can be filtered in
+   * parallel. */
+  nbands = (bands.nrows + kSobelBandHeight - 1) / kSobelBandHeight;
+  runParallelTasks(nbands, num_threads, sobelThresholdBand, &bands);
+
   return pixd;
 }
 
@@ -329,13 +554,36 @@ l_uint8 pixEdgeMax(PIX *pixs, l_int32 *pmax, l_int32 *pavg) {
  *              tile_x, tile_y (desired tile dimensions; actual size may vary)
  *              thresh
  *              avg_thresh
+ *              num_threads (threads to threshold the tiles on; 0 for one
+ *                           per processor)
  *      Return: 0 if OK, 1 on error
  */
+static void edgeThresholdTileRow(void *data, l_int32 y) {
+  AdaptiveThresholdTiles *tiles = (AdaptiveThresholdTiles *) data;
+  l_int32 x, t, max, avg;
+  PIX *pixb, *pixt;
+
+  for (x = 0; x < tiles->nx; x++) {
+    pixt = pixTilingGetTile(tiles->pt, y, x);
+    pixEdgeMax(pixt, &max, &avg);
+
+    if (max > tiles->edge_thresh && avg > tiles->avg_thresh) {
+      pixSplitDistributionFgBg(pixt, 0.0, 1, &t, NULL, NULL, 0);
+      pixb = pixThresholdToBinary(pixt, t);
+      pixTilingPaintTile(tiles->pixd, y, x, pixb, tiles->pt);
+      pixDestroy(&pixb);
+    }
+
+    pixDestroy(&pixt);
+  }
+}
+
 l_uint8 pixEdgeAdaptiveThreshold(PIX *pixs, PIX **ppixd, l_int32 tile_x, l_int32 tile_y,
-                                  l_int32 thresh, l_int32 avg_thresh) {
-  l_int32 w, h, d, nx, ny, x, y, t, max, avg;
-  PIX *pixb, *pixd, *pixt;
+                                  l_int32 thresh, l_int32 avg_thresh, l_int32 num_threads) {
+  l_int32 w, h, d, nx, ny;
+  PIX *pixd;
   PIXTILING *pt;
+  AdaptiveThresholdTiles tiles;
 
   PROCNAME("pixEdgeAdaptiveThreshold");
 
@@ -354,21 +602,15 @@ l_uint8 pixEdgeAdaptiveThreshold(PIX *pixs, PIX **ppixd, l_int32 tile_x, l_int32
   ny = L_MAX(1, h / tile_y);
   pt = pixTilingCreate(pixs, nx, ny, 0, 0, 0, 0);
   pixd = pixCreate(w, h, 1);
-  for (y = 0; y < ny; y++) {
-    for (x = 0; x < nx; x++) {
-      pixt = pixTilingGetTile(pt, y, x);
-      pixEdgeMax(pixt, &max, &avg);
-
-      if (max > thresh && avg > avg_thresh) {
-        pixSplitDistributionFgBg(pixt, 0.0, 1, &t, NULL, NULL, 0);
-        pixb = pixThresholdToBinary(pixt, t);
-        pixTilingPaintTile(pixd, y, x, pixb, pt);
-        pixDestroy(&pixb);
-      }
 
-      pixDestroy(&pixt);
-    }
-  }
+  /* Each row of tiles paints its own rows of pixd, so they can be
+   * thresholded in parallel. */
+  tiles.pt = pt;
+  tiles.pixd = pixd;
+  tiles.nx = nx;
+  tiles.edge_thresh = thresh;
+  tiles.avg_thresh = avg_thresh;
+  runParallelTasks(ny, num_threads, edgeThresholdTileRow, &tiles);
 
   pixTilingDestroy(&pt);
 
@@ -22,15 +22,26 @@
 l_int32 pixGetFisherThresh(PIX *pixs, l_float32 scorefract, l_float32 *pfdr, l_int32 *pthresh);
 
 l_int32 pixFisherAdaptiveThreshold(PIX *pixs, PIX **ppixd, l_int32 tile_x, l_int32 tile_y,
-                                l_float32 score_fract, l_float32 thresh);
+                                l_float32 score_fract, l_float32 thresh, l_int32 num_threads);
 
-PIX *pixThreshedSobelEdgeFilter(PIX *pixs, l_int32 threshold);
+PIX *pixThreshedSobelEdgeFilter(PIX *pixs, l_int32 threshold, l_int32 num_threads);
+
+/* A Sobel threshold above any unclipped magnitude, which are at most 2040 */
+const l_int32 kSobelNoThreshold = 2041;
+
+void sobelThresholdRow(const l_uint8 *top, const l_uint8 *mid, const l_uint8 *bot,
+                       l_int32 nbytes, l_int32 threshold, l_uint8 *out);
+
+#ifdef HAVE_ARMEABI_V7A
+void sobelThresholdRowNEON(const l_uint8 *top, const l_uint8 *mid, const l_uint8 *bot,
+                           l_int32 nbytes, l_int32 threshold, l_uint8 *out);
+#endif
 
 l_uint8 pixGradientEnergy(PIX *pixs, PIX *mask, l_float32 *pdensity);
 
 l_uint8 pixEdgeMax(PIX *pixs, l_int32 *pmax, l_int32 *pavg);
 
 l_uint8 pixEdgeAdaptiveThreshold(PIX *pixs, PIX **ppixd, l_int32 tile_x, l_int32 tile_y,
-                                 l_int32 thresh, l_int32 avg_thresh);
+                                 l_int32 thresh, l_int32 avg_thresh, l_int32 num_threads);
 
 #endif /* HYDROGEN_THRESHOLDER_H_ */
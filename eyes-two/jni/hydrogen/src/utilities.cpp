@@ -177,3 +177,113 @@ PIX *pixaDisplayHeatmap(PIXA *pixa, l_int32 w, l_int32 h, NUMA *confs) {
 
   return pixd;
 }
+
+/*!
+ *  pixaTranslateBoxes()
+ *
+ *      Input:  pixa
+ *              dx, dy (added to the position of each box)
+ *      Return: pixad, with clones of the pix of pixa and the moved boxes, or
+ *              null on error
+ */
+PIXA *pixaTranslateBoxes(PIXA *pixa, l_int32 dx, l_int32 dy) {
+  BOXA *boxa;
+  PIXA *pixad;
+
+  PROCNAME("pixaTranslateBoxes");
+
+  if (!pixa)
+    return (PIXA *) ERROR_PTR("pixa not defined", procName, NULL);
+
+  if ((pixad = pixaCopy(pixa, L_CLONE)) == NULL)
+    return (PIXA *) ERROR_PTR("pixad not made", procName, NULL);
+
+  /* The boxes of the copy are clones, so replace them instead of moving them */
+  boxa = pixaGetBoxa(pixa, L_CLONE);
+  boxaDestroy(&pixad->boxa);
+  pixad->boxa = boxaTransform(boxa, dx, dy, 1.0, 1.0);
+  boxaDestroy(&boxa);
+
+  return pixad;
+}
+
+/*!
+ *  pixFindChangedTiles()
+ *
+ *      Input:  pixs (8 bpp, the current frame)
+ *              pixp (8 bpp, the previous frame, of the same size)
+ *              dx, dy (motion of the scene from pixp to pixs)
+ *              nx, ny (number of tiles across and down)
+ *              thresh (mean absolute difference over which a tile changed)
+ *      Return: 1 bpp pix of nx x ny, with the changed tiles set, or null on
+ *              error
+ *
+ *  Notes:
+ *      (1) The tiles are laid out as by pixTilingCreate(), with the last
+ *          tile of each row and column taking the remainder.
+ *      (2) Pixel (x, y) of pixs is compared with pixel (x - dx, y - dy) of
+ *          pixp, so tiles that were partly outside of pixp have changed.
+ *      (3) Every other pixel of every other row is compared, which is plenty
+ *          for tiles the size of the edge thresholding tiles.
+ */
+PIX *pixFindChangedTiles(PIX *pixs, PIX *pixp, l_int32 dx, l_int32 dy, l_int32 nx, l_int32 ny,
+                         l_int32 thresh) {
+  l_int32 w, h, d, wp, hp, tw, th, tx, ty, x, y, x0, y0, x1, y1;
+  l_int32 wpls, wplp, sum, count;
+  l_uint32 *datas, *datap, *lines, *linep;
+  PIX *pixd;
+
+  PROCNAME("pixFindChangedTiles");
+
+  if (!pixs || !pixp)
+    return (PIX *) ERROR_PTR("pixs or pixp not defined", procName, NULL);
+  pixGetDimensions(pixs, &w, &h, &d);
+  if (d != 8 || pixGetDepth(pixp) != 8)
+    return (PIX *) ERROR_PTR("pixs and pixp not both 8 bpp", procName, NULL);
+  pixGetDimensions(pixp, &wp, &hp, NULL);
+  if (wp != w || hp != h)
+    return (PIX *) ERROR_PTR("pixs and pixp not the same size", procName, NULL);
+  if (nx < 1 || ny < 1 || nx > w || ny > h)
+    return (PIX *) ERROR_PTR("invalid number of tiles", procName, NULL);
+
+  if ((pixd = pixCreate(nx, ny, 1)) == NULL)
+    return (PIX *) ERROR_PTR("pixd not made", procName, NULL);
+
+  datas = pixGetData(pixs);
+  wpls = pixGetWpl(pixs);
+  datap = pixGetData(pixp);
+  wplp = pixGetWpl(pixp);
+  tw = w / nx;
+  th = h / ny;
+
+  for (ty = 0; ty < ny; ty++) {
+    y0 = ty * th;
+    y1 = ty == ny - 1 ? h : y0 + th;
+
+    for (tx = 0; tx < nx; tx++) {
+      x0 = tx * tw;
+      x1 = tx == nx - 1 ? w : x0 + tw;
+
+      if (x0 - dx < 0 || x1 - dx > w || y0 - dy < 0 || y1 - dy > h) {
+        pixSetPixel(pixd, tx, ty, 1);
+        continue;
+      }
+
+      sum = 0;
+      count = 0;
+      for (y = y0; y < y1; y += 2) {
+        lines = datas + y * wpls;
+        linep = datap + (y - dy) * wplp;
+        for (x = x0; x < x1; x += 2) {
+          sum += L_ABS((l_int32) GET_DATA_BYTE(lines, x) - (l_int32) GET_DATA_BYTE(linep, x - dx));
+          count++;
+        }
+      }
+
+      if (sum > thresh * count)
+        pixSetPixel(pixd, tx, ty, 1);
+    }
+  }
+
+  return pixd;
+}
@@ -25,4 +25,9 @@ PIX *pixaDisplayRandomCmapFiltered(PIXA *pixa, l_int32 w, l_int32 h, l_uint8 *fi
 
 PIX *pixaDisplayHeatmap(PIXA *pixa, l_int32 w, l_int32 h, NUMA *confs);
 
+PIXA *pixaTranslateBoxes(PIXA *pixa, l_int32 dx, l_int32 dy);
+
+PIX *pixFindChangedTiles(PIX *pixs, PIX *pixp, l_int32 dx, l_int32 dy, l_int32 nx, l_int32 ny,
+                         l_int32 thresh);
+
 #endif /* HYDROGEN_UTILITIES_H_ */
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Benchmark of the hydrogen thresholders on a synthetic 5MP camera frame.
+ *
+ * Runs pixThreshedSobelEdgeFilter, pixEdgeAdaptiveThreshold and
+ * pixFisherAdaptiveThreshold with 1, 2, 4 and 8 threads and reports
+ * ms/frame for each. Every result is compared against the single-threaded
+ * result, and the Sobel filter also against a plain serial reference, and
+ * the program exits with an error if any of them differ.
+ *
+ * Usage: thresholdbench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "leptonica.h"
+#include "thresholder.h"
+
+/* A 5MP frame, as from a typical phone camera */
+static const l_int32 kFrameWidth = 2592;
+static const l_int32 kFrameHeight = 1944;
+
+/* Default number of frames per measurement */
+static const l_int32 kDefaultIterations = 5;
+
+/* Parameters of HydrogenTextDetector and Thresholder */
+static const l_int32 kEdgeTileX = 32;
+static const l_int32 kEdgeTileY = 64;
+static const l_int32 kEdgeThresh = 64;
+static const l_int32 kEdgeAvgThresh = 4;
+static const l_int32 kFdrTileX = 48;
+static const l_int32 kFdrTileY = 48;
+static const l_float32 kFdrScoreFract = 0.0;
+static const l_float32 kFdrThresh = 2.5;
+static const l_int32 kSobelThresh = 64;
+
+static const l_int32 kThreadCounts[] = { 1, 2, 4, 8 };
+static const l_int32 kNumThreadCounts = sizeof(kThreadCounts) / sizeof(kThreadCounts[0]);
+
+/* Fixed-seed generator, so the frame is the same on every run */
+static l_uint32 rand_state = 12345;
+
+static l_int32 nextRand(l_int32 range) {
+  rand_state = rand_state * 1103515245 + 12345;
+  return (rand_state >> 8) % range;
+}
+
+static double nowMs() {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+
+  return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+/* Makes a noisy gradient with dark, text-sized blocks scattered over it */
+static PIX *createFrame() {
+  PIX *pixs = pixCreate(kFrameWidth, kFrameHeight, 8);
+  l_uint32 *data = pixGetData(pixs);
+  l_int32 wpl = pixGetWpl(pixs);
+
+  for (l_int32 i = 0; i < kFrameHeight; i++) {
+    l_uint32 *line = data + i * wpl;
+
+    for (l_int32 j = 0; j < kFrameWidth; j++) {
+      l_int32 val = 96 + (128 * j) / kFrameWidth + nextRand(16);
+      SET_DATA_BYTE(line, j, val);
+    }
+  }
+
+  for (l_int32 k = 0; k < 4000; k++) {
+    l_int32 w = 4 + nextRand(12);
+    l_int32 h = 12 + nextRand(20);
+
+    pixRasterop(pixs, nextRand(kFrameWidth - w), nextRand(kFrameHeight - h), w, h,
+                PIX_CLR, NULL, 0, 0);
+  }
+
+  return pixs;
+}
+
+/* The serial Sobel filter, with the same output as pixThreshedSobelEdgeFilter */
+static PIX *referenceSobel(PIX *pixs, l_int32 threshold) {
+  l_int32 w = pixGetWidth(pixs);
+  l_int32 h = pixGetHeight(pixs);
+  l_int32 wpls = pixGetWpl(pixs);
+  l_uint32 *datas = pixGetData(pixs);
+  PIX *pixd = pixCreate(w, h, 1);
+
+  for (l_int32 i = 0; i < h - 2; i++) {
+    l_uint32 *top = datas + i * wpls;
+    l_uint32 *mid = top + wpls;
+    l_uint32 *bot = mid + wpls;
+
+    for (l_int32 j = 0; j < (w - 1) / 8 * 8; j++) {
+      l_int32 gx = GET_DATA_BYTE(top, j) + (GET_DATA_BYTE(mid, j) << 1) + GET_DATA_BYTE(bot, j)
+          - GET_DATA_BYTE(top, j + 2) - (GET_DATA_BYTE(mid, j + 2) << 1)
+          - GET_DATA_BYTE(bot, j + 2);
+      l_int32 gy = GET_DATA_BYTE(top, j) + (GET_DATA_BYTE(top, j + 1) << 1)
+          + GET_DATA_BYTE(top, j + 2) - GET_DATA_BYTE(bot, j)
+          - (GET_DATA_BYTE(bot, j + 1) << 1) - GET_DATA_BYTE(bot, j + 2);
+
+      if (L_MIN(255, L_ABS(gx) + L_ABS(gy)) >= threshold)
+        pixSetPixel(pixd, j, i, 1);
+    }
+  }
+
+  return pixd;
+}
+
+static PIX *runSobel(PIX *pixs, l_int32 num_threads) {
+  return pixThreshedSobelEdgeFilter(pixs, kSobelThresh, num_threads);
+}
+
+static PIX *runEdge(PIX *pixs, l_int32 num_threads) {
+  PIX *pixd = NULL;
+
+  pixEdgeAdaptiveThreshold(pixs, &pixd, kEdgeTileX, kEdgeTileY, kEdgeThresh, kEdgeAvgThresh,
+                           num_threads);
+
+  return pixd;
+}
+
+static PIX *runFisher(PIX *pixs, l_int32 num_threads) {
+  PIX *pixd = NULL;
+
+  pixFisherAdaptiveThreshold(pixs, &pixd, kFdrTileX, kFdrTileY, kFdrScoreFract, kFdrThresh,
+                             num_threads);
+
+  return pixd;
+}
+
+/* Times a thresholder at each thread count; returns false if results differ */
+static bool benchmark(const char *name, PIX *(*run)(PIX *, l_int32), PIX *pixs, PIX *pixref,
+                      l_int32 iterations) {
+  bool ok = true;
+
+  for (l_int32 t = 0; t < kNumThreadCounts; t++) {
+    PIX *pixd = NULL;
+    double start = nowMs();
+
+    for (l_int32 k = 0; k < iterations; k++) {
+      pixDestroy(&pixd);
+      pixd = run(pixs, kThreadCounts[t]);
+    }
+
+    double ms = (nowMs() - start) / iterations;
+    l_int32 same = 0;
+
+    if (pixd && pixref)
+      pixEqual(pixd, pixref, &same);
+    printf("%-28s %d threads: %8.2f ms/frame%s\n", name, kThreadCounts[t], ms,
+           same ? "" : "  MISMATCH");
+    ok = ok && same;
+
+    pixDestroy(&pixd);
+  }
+
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  l_int32 iterations = argc > 1 ? atoi(argv[1]) : kDefaultIterations;
+  bool ok = true;
+
+  if (iterations <= 0) {
+    fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  PIX *pixs = createFrame();
+  printf("%dx%d frame, %d iterations\n", kFrameWidth, kFrameHeight, iterations);
+
+  PIX *pixref = referenceSobel(pixs, kSobelThresh);
+  ok = benchmark("pixThreshedSobelEdgeFilter", runSobel, pixs, pixref, iterations) && ok;
+  pixDestroy(&pixref);
+
+  pixref = runEdge(pixs, 1);
+  ok = benchmark("pixEdgeAdaptiveThreshold", runEdge, pixs, pixref, iterations) && ok;
+  pixDestroy(&pixref);
+
+  pixref = runFisher(pixs, 1);
+  ok = benchmark("pixFisherAdaptiveThreshold", runFisher, pixs, pixref, iterations) && ok;
+  pixDestroy(&pixref);
+
+  pixDestroy(&pixs);
+
+  if (!ok) {
+    fprintf(stderr, "Thresholder results differ\n");
+    return 1;
+  }
+
+  return 0;
+}
@@ -16,6 +16,11 @@ endif
 
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../common
 
+ifeq ($(LOG_TIME),true)
+  LOCAL_CFLAGS += -DLOG_TIME
+  LOCAL_LDLIBS += -llog
+endif
+
 LOCAL_STATIC_LIBRARIES += common
 
 include $(BUILD_SHARED_LIBRARY)
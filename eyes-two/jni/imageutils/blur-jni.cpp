@@ -32,6 +32,11 @@ JNIEXPORT jboolean JNICALL
 Java_com_googlecode_eyesfree_opticflow_ImageBlur_isBlurred(
     JNIEnv* env, jclass clazz, jbyteArray input, jint width, jint height);
 
+JNIEXPORT jboolean JNICALL
+Java_com_googlecode_eyesfree_opticflow_ImageBlur_isBlurredTiled(
+    JNIEnv* env, jclass clazz, jbyteArray input, jint width, jint height,
+    jint tilesX, jint tilesY, jfloatArray tileBlurs);
+
 #ifdef __cplusplus
 }
 #endif
@@ -55,3 +60,35 @@ Java_com_googlecode_eyesfree_opticflow_ImageBlur_isBlurred(
 
   return blurred ? JNI_TRUE : JNI_FALSE;
 }
+
+JNIEXPORT jboolean JNICALL
+Java_com_googlecode_eyesfree_opticflow_ImageBlur_isBlurredTiled(
+    JNIEnv* env, jclass clazz, jbyteArray input, jint width, jint height,
+    jint tilesX, jint tilesY, jfloatArray tileBlurs) {
+  jboolean inputCopy = JNI_FALSE;
+  jbyte* const i = env->GetByteArrayElements(input, &inputCopy);
+
+  // The tile results are only returned if the array can hold them all.
+  jfloat* blurs = NULL;
+  if (tileBlurs != NULL && tilesX > 0 && tilesY > 0 &&
+      env->GetArrayLength(tileBlurs) >= tilesX * tilesY) {
+    blurs = env->GetFloatArrayElements(tileBlurs, NULL);
+  }
+
+  float blur = 0;
+  float extent = 0;
+
+  resetTimeLog();
+  int blurred = IsBlurredTiled(NULL, reinterpret_cast<uint8*>(i),
+                               width, height, 0, 0, width, height,
+                               tilesX, tilesY, &blur, &extent, blurs);
+  timeLog("Finished tiled image blur detection");
+  printTimeLog();
+
+  if (blurs != NULL) {
+    env->ReleaseFloatArrayElements(tileBlurs, blurs, 0);
+  }
+  env->ReleaseByteArrayElements(input, i, JNI_ABORT);
+
+  return blurred ? JNI_TRUE : JNI_FALSE;
+}
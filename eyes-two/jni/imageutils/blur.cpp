@@ -19,8 +19,9 @@
 // This library contains image processing method to detect
 // image blurriness.
 //
-// This library is *not* thread safe because static memory is
-// used for performance.
+// Scratch memory lives in a BlurContext, so frames may be scored on several
+// threads at once as long as each uses its own context. Contexts may be
+// created by the caller, or taken from a small pool.
 //
 // A method to detect whether a given image is blurred or not.
 // The algorithm is based on H. Tong, M. Li, H. Zhang, J. He,
@@ -28,11 +29,14 @@
 // transform".
 //
 // To achieve better performance on client side, the method
-// is running on four 128x128 portions which compose the 256x256
-// central area of the given image. On Nexus One, average time
-// to process a single image is ~5 milliseconds.
+// is running on tiles of the image, by default four 128x128 portions
+// which compose the 256x256 central area of the given image. On Nexus One,
+// average time to process a single image is ~5 milliseconds.
+// The Haar transforms process whole rows at a time, with NEON or SSE2 where
+// available.
 
 #include <math.h>
+#include <string.h>
 
 #include "blur.h"
 #include "utils.h"
@@ -44,125 +48,247 @@ static const float kMinZero = 0.05;
 static const int kMaximumWidth = 256;
 static const int kMaximumHeight = 256;
 
-static int32 _smatrix[kMaximumWidth * kMaximumHeight];
-static int32 _arow[kMaximumWidth > kMaximumHeight ?
-    kMaximumWidth : kMaximumHeight];
+// Tile sides are multiples of this, so that each round of the transform
+// halves them exactly.
+static const int kTileAlignment = 1 << kDecomposition;
+// Smallest tile side analyzed, the window size of the first scale.
+static const int kMinTileSize = 16;
+
+// Number of contexts kept for calls without a context.
+static const int kNumPooledContexts = 4;
+
+struct BlurContext {
+  // The transformed tile, and the capacity of matrix in int32s.
+  int32* matrix;
+  int matrix_size;
+  // Scratch for the transform, and its capacity in int32s.
+  int32* scratch;
+  int scratch_size;
+};
+
+static BlurContext* volatile _pooled_contexts[kNumPooledContexts];
+
+BlurContext* CreateBlurContext() {
+  BlurContext* const context = new BlurContext;
+  context->matrix = NULL;
+  context->matrix_size = 0;
+  context->scratch = NULL;
+  context->scratch_size = 0;
+  return context;
+}
 
-// Does Haar Wavelet Transformation in place on a given row of a matrix.
-// The matrix is in size of matrix_height * matrix_width and represented
-// in a linear array. Parameter offset_row indicates transformation is
-// performed on which row. offset_column and num_columns indicate column
-// range of the given row.
-inline void Haar1DX(int* matrix, int matrix_height, int matrix_width,
-    int offset_row, int offset_column, int num_columns) {
-  int32* ptr_a = _arow;
-  int32* ptr_matrix = matrix + offset_row * matrix_width + offset_column;
-  int half_num_columns = num_columns / 2;
+void DestroyBlurContext(BlurContext* context) {
+  if (context != NULL) {
+    delete[] context->matrix;
+    delete[] context->scratch;
+    delete context;
+  }
+}
 
-  int32* a_tmp = ptr_a;
-  int32* matrix_tmp = ptr_matrix;
-  for (int j = 0; j < half_num_columns; ++j) {
-    *a_tmp++ = (matrix_tmp[0] + matrix_tmp[1]) / 2;
-    matrix_tmp += 2;
+// Takes a context from the pool, or creates one if the pool is empty.
+static BlurContext* AcquirePooledContext() {
+  for (int i = 0; i < kNumPooledContexts; ++i) {
+    BlurContext* const context = _pooled_contexts[i];
+    if (context != NULL &&
+        __sync_bool_compare_and_swap(&_pooled_contexts[i], context, NULL)) {
+      return context;
+    }
   }
+  return CreateBlurContext();
+}
 
-  int32* average = ptr_a;
-  a_tmp = ptr_a + half_num_columns;
-  matrix_tmp = ptr_matrix;
-  for (int j = 0; j < half_num_columns; ++j) {
-    *a_tmp++ = *matrix_tmp - *average++;
-    matrix_tmp += 2;
+// Returns a context to the pool, or destroys it if the pool is full.
+static void ReleasePooledContext(BlurContext* context) {
+  for (int i = 0; i < kNumPooledContexts; ++i) {
+    if (_pooled_contexts[i] == NULL &&
+        __sync_bool_compare_and_swap(&_pooled_contexts[i], NULL, context)) {
+      return;
+    }
   }
+  DestroyBlurContext(context);
+}
 
-  memcpy(ptr_matrix, ptr_a, sizeof(int32) * num_columns);
+// Grows the buffers of context as needed for a tile of the given size.
+static void ReserveTile(BlurContext* context, int num_columns, int num_rows) {
+  const int matrix_size = num_columns * num_rows;
+  if (context->matrix_size < matrix_size) {
+    delete[] context->matrix;
+    context->matrix = new int32[matrix_size];
+    context->matrix_size = matrix_size;
+  }
+  // A row, or the details of half the rows.
+  const int scratch_size = max(num_columns, num_columns * (num_rows / 2));
+  if (context->scratch_size < scratch_size) {
+    delete[] context->scratch;
+    context->scratch = new int32[scratch_size];
+    context->scratch_size = scratch_size;
+  }
 }
 
-// Does Haar Wavelet Transformation in place on a given column of a matrix.
-inline void Haar1DY(int* matrix, int matrix_height, int matrix_width,
-    int offset_column, int offset_row, int num_rows) {
-  int32* ptr_a = _arow;
-  int32* ptr_matrix = matrix + offset_row * matrix_width + offset_column;
-  int half_num_rows = num_rows / 2;
-  int two_line_width = matrix_width * 2;
+#ifdef HAVE_ARMEABI_V7A
+// Returns sums / 2 rounded toward zero, as the integer division does.
+inline int32x4_t HalveTowardZero(const int32x4_t sums) {
+  const int32x4_t signs = vreinterpretq_s32_u32(
+      vshrq_n_u32(vreinterpretq_u32_s32(sums), 31));
+  return vshrq_n_s32(vaddq_s32(sums, signs), 1);
+}
+#elif defined(__SSE2__)
+// Returns sums / 2 rounded toward zero, as the integer division does.
+inline __m128i HalveTowardZero(const __m128i sums) {
+  return _mm_srai_epi32(_mm_add_epi32(sums, _mm_srli_epi32(sums, 31)), 1);
+}
+#endif
+
+// Does a Haar step on num_pairs adjacent pairs of values, putting the
+// average of each pair in averages and its difference to the first value
+// in details.
+inline void HaarPairs(const int32* values, int num_pairs,
+    int32* averages, int32* details) {
+  int j = 0;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon()) {
+    for (; j + 4 <= num_pairs; j += 4) {
+      const int32x4x2_t pairs = vld2q_s32(values + 2 * j);
+      const int32x4_t average =
+          HalveTowardZero(vaddq_s32(pairs.val[0], pairs.val[1]));
+      vst1q_s32(averages + j, average);
+      vst1q_s32(details + j, vsubq_s32(pairs.val[0], average));
+    }
+  }
+#elif defined(__SSE2__)
+  for (; j + 4 <= num_pairs; j += 4) {
+    const __m128 low = _mm_castsi128_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 2 * j)));
+    const __m128 high = _mm_castsi128_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 2 * j + 4)));
+    const __m128i firsts =
+        _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+    const __m128i seconds =
+        _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+    const __m128i average = HalveTowardZero(_mm_add_epi32(firsts, seconds));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(averages + j), average);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(details + j),
+                     _mm_sub_epi32(firsts, average));
+  }
+#endif
+  for (; j < num_pairs; ++j) {
+    averages[j] = (values[2 * j] + values[2 * j + 1]) / 2;
+    details[j] = values[2 * j] - averages[j];
+  }
+}
 
-  int32* a_tmp = ptr_a;
-  int32* matrix_tmp = ptr_matrix;
-  for (int j = 0; j < half_num_rows; ++j) {
-    *a_tmp++ = (matrix_tmp[matrix_width] + matrix_tmp[0]) / 2;
-    matrix_tmp += two_line_width;
+// Does a Haar step on two rows of num_columns values, putting the averages
+// of the columns in averages and their differences to the first row in
+// details. averages may be the first row.
+inline void HaarRowPair(const int32* first_row, const int32* second_row,
+    int num_columns, int32* averages, int32* details) {
+  int j = 0;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon()) {
+    for (; j + 4 <= num_columns; j += 4) {
+      const int32x4_t firsts = vld1q_s32(first_row + j);
+      const int32x4_t average =
+          HalveTowardZero(vaddq_s32(firsts, vld1q_s32(second_row + j)));
+      vst1q_s32(averages + j, average);
+      vst1q_s32(details + j, vsubq_s32(firsts, average));
+    }
+  }
+#elif defined(__SSE2__)
+  for (; j + 4 <= num_columns; j += 4) {
+    const __m128i firsts =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(first_row + j));
+    const __m128i seconds =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(second_row + j));
+    const __m128i average = HalveTowardZero(_mm_add_epi32(firsts, seconds));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(averages + j), average);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(details + j),
+                     _mm_sub_epi32(firsts, average));
   }
+#endif
+  for (; j < num_columns; ++j) {
+    const int32 first = first_row[j];
+    averages[j] = (first + second_row[j]) / 2;
+    details[j] = first - averages[j];
+  }
+}
+
+// Does Haar Wavelet Transformation in place on a given row of a matrix.
+// The matrix rows are matrix_width apart in a linear array. Parameter
+// offset_row indicates transformation is performed on which row.
+// offset_column and num_columns indicate column range of the given row.
+// scratch must hold num_columns values.
+inline void Haar1DX(int32* matrix, int matrix_width,
+    int offset_row, int offset_column, int num_columns, int32* scratch) {
+  int32* ptr_matrix = matrix + offset_row * matrix_width + offset_column;
+  int half_num_columns = num_columns / 2;
+
+  HaarPairs(ptr_matrix, half_num_columns,
+            scratch, scratch + half_num_columns);
+  memcpy(ptr_matrix, scratch, sizeof(int32) * num_columns);
+}
+
+// Does Haar Wavelet Transformation in place on a range of columns of a
+// matrix, a pair of rows at a time. The averages of the pairs are written
+// over the rows already read, and the details kept in scratch, which must
+// hold num_rows / 2 * num_columns values, until all the rows are read.
+inline void Haar1DY(int32* matrix, int matrix_width,
+    int offset_column, int num_columns, int offset_row, int num_rows,
+    int32* scratch) {
+  int32* ptr_matrix = matrix + offset_row * matrix_width + offset_column;
+  int half_num_rows = num_rows / 2;
 
-  int32* average = ptr_a;
-  a_tmp = ptr_a + half_num_rows;
-  matrix_tmp = ptr_matrix;
-  for (int j = 0; j < num_rows; j += 2) {
-    *a_tmp++ = *matrix_tmp - *average++;
-    matrix_tmp += two_line_width;
+  for (int i = 0; i < half_num_rows; ++i) {
+    const int32* first_row = ptr_matrix + 2 * i * matrix_width;
+    HaarRowPair(first_row, first_row + matrix_width, num_columns,
+                ptr_matrix + i * matrix_width, scratch + i * num_columns);
   }
 
-  for (int j = 0; j < num_rows; ++j) {
-    *ptr_matrix = *ptr_a++;
-    ptr_matrix += matrix_width;
+  for (int i = 0; i < half_num_rows; ++i) {
+    memcpy(ptr_matrix + (half_num_rows + i) * matrix_width,
+           scratch + i * num_columns, sizeof(int32) * num_columns);
   }
 }
 
 // Does Haar Wavelet Transformation in place for a specified area of
-// a matrix. The matrix size is specified by matrix_width and matrix_height.
-// The area on which the transformation is performed is specified by
-// offset_column, num_columns, offset_row and num_rows.
-void Haar2D(int* matrix, int matrix_height, int matrix_width,
-    int offset_column, int num_columns, int offset_row, int num_rows) {
+// a matrix. The matrix rows are matrix_width apart. The area on which the
+// transformation is performed is specified by offset_column, num_columns,
+// offset_row and num_rows.
+void Haar2D(int32* matrix, int matrix_width,
+    int offset_column, int num_columns, int offset_row, int num_rows,
+    int32* scratch) {
   for (int i = offset_row; i < offset_row + num_rows; ++i) {
-    Haar1DX(matrix, matrix_height, matrix_width, i, offset_column, num_columns);
+    Haar1DX(matrix, matrix_width, i, offset_column, num_columns, scratch);
   }
 
-  for (int i = offset_column; i < offset_column + num_columns; ++i){
-    Haar1DY(matrix, matrix_height, matrix_width, i, offset_row, num_rows);
-  }
+  Haar1DY(matrix, matrix_width, offset_column, num_columns,
+          offset_row, num_rows, scratch);
 }
 
 // Reads in a given matrix, does first round HWT and outputs result
 // matrix into target array. This function is used for optimization by
-// avoiding a memory copy. The input matrix has height rows and width
-// columns. The transformation is performed on the given area specified
-// by offset_column, num_columns, offset_row, num_rows. After
-// transformation, the output matrix has num_columns columns and
-// num_rows rows.
-void HwtFirstRound(const uint8* const data, int height, int width,
+// avoiding a memory copy. The input matrix has rows width apart. The
+// transformation is performed on the given area specified by offset_column,
+// num_columns, offset_row, num_rows. After transformation, the output
+// matrix has num_columns columns and num_rows rows.
+void HwtFirstRound(const uint8* const data, int width,
     int offset_column, int num_columns,
-    int offset_row, int num_rows, int32* matrix) {
-  int32* ptr_a = _arow;
+    int offset_row, int num_rows, int32* matrix, int32* scratch) {
   const uint8* ptr_data = data + offset_row * width + offset_column;
   int half_num_columns = num_columns / 2;
   for (int i = 0; i < num_rows; ++i) {
-    int32* a_tmp = ptr_a;
-    const uint8* data_tmp = ptr_data;
-    for (int j = 0; j < half_num_columns; ++j) {
-      *a_tmp++ = (int32) ((data_tmp[0] + data_tmp[1]) / 2);
-      data_tmp += 2;
-    }
-
-    int32* average = ptr_a;
-    a_tmp = ptr_a + half_num_columns;
-    data_tmp = ptr_data;
-    for (int j = 0; j < half_num_columns; ++j) {
-      *a_tmp++ = *data_tmp - *average++;
-      data_tmp += 2;
+    for (int j = 0; j < num_columns; ++j) {
+      scratch[j] = ptr_data[j];
     }
 
     int32* ptr_matrix = matrix + i * num_columns;
-    a_tmp = ptr_a;
-    for (int j = 0; j < num_columns; ++j) {
-      *ptr_matrix++ = *a_tmp++;
-    }
+    HaarPairs(scratch, half_num_columns,
+              ptr_matrix, ptr_matrix + half_num_columns);
 
     ptr_data += width;
   }
 
   // Column transformation does not involve input data.
-  for (int i = 0; i < num_columns; ++i) {
-    Haar1DY(matrix, num_rows, num_columns, i, 0, num_rows);
-  }
+  Haar1DY(matrix, num_columns, 0, num_columns, 0, num_rows, scratch);
 }
 
 // Returns the weight of a given point in a certain scale of a matrix
@@ -171,7 +297,7 @@ void HwtFirstRound(const uint8* const data, int height, int width,
 // respectively. Parameter scale tells in which scale the weight is
 // computed, must be 1, 2 or 3 which stands respectively for 1/2, 1/4
 // and 1/8 of original size.
-int ComputeEdgePointWeight(int* matrix, int width, int height,
+int ComputeEdgePointWeight(const int32* matrix, int width, int height,
     int k, int l, int scale) {
   int r = k >> scale;
   int c = l >> scale;
@@ -194,7 +320,7 @@ int ComputeEdgePointWeight(int* matrix, int width, int height,
 // window_size. Output value k and l store row (y coordinate) and
 // column (x coordinate) respectively of the point with maximum weight.
 // The maximum weight is returned.
-int ComputeLocalMaximum(int* matrix, int width, int height,
+int ComputeLocalMaximum(const int32* matrix, int width, int height,
     int scaled_width, int scaled_height,
     int top, int left, int window_size, int* k, int* l) {
   int max = -1;
@@ -234,7 +360,7 @@ int ComputeLocalMaximum(int* matrix, int width, int height,
 // Detects blurriness of a transformed matrix.
 // Blur confidence and extent will be returned through blur_conf
 // and blur_extent. 1 is returned while input matrix is blurred.
-int DetectBlur(int* matrix, int width, int height,
+int DetectBlur(const int32* matrix, int width, int height,
     float* blur_conf, float* blur_extent) {
   int nedge = 0;
   int nda = 0;
@@ -309,25 +435,88 @@ int DetectBlur(int* matrix, int width, int height,
 }
 
 // Detects blurriness of a given portion of a luminance matrix.
-int IsBlurredInner(const uint8* const luminance,
-    const int width, const int height,
-    const int left, const int top,
+int IsBlurredInner(BlurContext* context, const uint8* const luminance,
+    const int width, const int left, const int top,
     const int width_wanted, const int height_wanted,
     float* const blur, float* const extent) {
-  int32* matrix = _smatrix;
+  ReserveTile(context, width_wanted, height_wanted);
+  int32* matrix = context->matrix;
+  int32* scratch = context->scratch;
 
-  HwtFirstRound(luminance, height, width,
-                left, width_wanted, top, height_wanted, matrix);
-  Haar2D(matrix, height_wanted, width_wanted,
-         0, width_wanted >> 1, 0, height_wanted >> 1);
-  Haar2D(matrix, height_wanted, width_wanted,
-         0, width_wanted >> 2, 0, height_wanted >> 2);
+  HwtFirstRound(luminance, width,
+                left, width_wanted, top, height_wanted, matrix, scratch);
+  Haar2D(matrix, width_wanted,
+         0, width_wanted >> 1, 0, height_wanted >> 1, scratch);
+  Haar2D(matrix, width_wanted,
+         0, width_wanted >> 2, 0, height_wanted >> 2, scratch);
 
   int blurred = DetectBlur(matrix, width_wanted, height_wanted, blur, extent);
 
   return blurred;
 }
 
+int IsBlurredTiled(BlurContext* context, const uint8* const luminance,
+    const int width, const int height,
+    const int left, const int top,
+    const int region_width, const int region_height,
+    const int tiles_x, const int tiles_y,
+    float* const blur, float* const extent, float* const tile_blurs) {
+  *blur = 0;
+  *extent = 0;
+
+  if (tiles_x <= 0 || tiles_y <= 0 || left < 0 || top < 0 ||
+      left + region_width > width || top + region_height > height) {
+    LOGE("Invalid blur region %dx%d+%d+%d in %dx%d as %dx%d tiles!",
+         region_width, region_height, left, top, width, height,
+         tiles_x, tiles_y);
+    return 0;
+  }
+
+  // Each tile is centered in its cell of the grid.
+  const int cell_width = region_width / tiles_x;
+  const int cell_height = region_height / tiles_y;
+  const int tile_width = cell_width - cell_width % kTileAlignment;
+  const int tile_height = cell_height - cell_height % kTileAlignment;
+  if (tile_width < kMinTileSize || tile_height < kMinTileSize) {
+    LOGW("Blur tiles of %dx%d are too small, treating as blurred.",
+         tile_width, tile_height);
+    if (tile_blurs != NULL) {
+      memset(tile_blurs, 0, sizeof(*tile_blurs) * tiles_x * tiles_y);
+    }
+    return 1;
+  }
+
+  BlurContext* const tile_context =
+      context != NULL ? context : AcquirePooledContext();
+
+  float total_blur = 0;
+  float total_extent = 0;
+  for (int ty = 0; ty < tiles_y; ++ty) {
+    const int tile_top =
+        top + ty * cell_height + (cell_height - tile_height) / 2;
+    for (int tx = 0; tx < tiles_x; ++tx) {
+      const int tile_left =
+          left + tx * cell_width + (cell_width - tile_width) / 2;
+      float tile_blur, tile_extent;
+      IsBlurredInner(tile_context, luminance, width, tile_left, tile_top,
+                     tile_width, tile_height, &tile_blur, &tile_extent);
+      if (tile_blurs != NULL) {
+        tile_blurs[ty * tiles_x + tx] = tile_blur;
+      }
+      total_blur += tile_blur;
+      total_extent += tile_extent;
+    }
+  }
+
+  if (context == NULL) {
+    ReleasePooledContext(tile_context);
+  }
+
+  *blur = total_blur / (tiles_x * tiles_y);
+  *extent = total_extent / (tiles_x * tiles_y);
+  return *blur < kMinZero;
+}
+
 int IsBlurred(const uint8* const luminance,
     const int width, const int height, float* const blur, float* const extent) {
 
@@ -336,23 +525,7 @@ int IsBlurred(const uint8* const luminance,
   int left = (width - desired_width) >> 1;
   int top = (height - desired_height) >> 1;
 
-  float conf1, extent1;
-  int blur1 = IsBlurredInner(luminance, width, height,
-      left, top, desired_width >> 1, desired_height >> 1, &conf1, &extent1);
-  float conf2, extent2;
-  int blur2 = IsBlurredInner(luminance, width, height,
-      left + (desired_width >> 1), top, desired_width >> 1, desired_height >> 1,
-      &conf2, &extent2);
-  float conf3, extent3;
-  int blur3 = IsBlurredInner(luminance, width, height,
-      left, top + (desired_height >> 1), desired_width >> 1,
-      desired_height >> 1, &conf3, &extent3);
-  float conf4, extent4;
-  int blur4 = IsBlurredInner(luminance, width, height,
-      left + (desired_width >> 1), top + (desired_height >> 1),
-      desired_width >> 1, desired_height >> 1, &conf4, &extent4);
-
-  *blur = (conf1 + conf2 + conf3 + conf4) / 4;
-  *extent = (extent1 + extent2 + extent3 + extent4) / 4;
-  return *blur < kMinZero;
+  return IsBlurredTiled(NULL, luminance, width, height,
+                        left, top, desired_width, desired_height, 2, 2,
+                        blur, extent, NULL);
 }
@@ -10,10 +10,39 @@
 extern "C" {
 #endif
 
+// Scratch memory for blur detection. A context may only be used by one
+// thread at a time, so threads scoring frames concurrently each need their
+// own, or may pass NULL to use one from a shared pool.
+typedef struct BlurContext BlurContext;
+
+// Returns a new context, which grows as needed for the tiles it is used on.
+BlurContext* CreateBlurContext();
+
+void DestroyBlurContext(BlurContext* context);
+
+// Detects whether a region of a luminance matrix of size width * height is
+// blurred, by analyzing it as a grid of tiles_x * tiles_y tiles. The region
+// starts at left, top and is region_width * region_height. Tile sides are
+// rounded down to multiples of 8, and tiles smaller than 16 pixels on a side
+// are not analyzed. 1 is returned when the region is blurred, along with the
+// average blur confidence and extent of the tiles returned through blur and
+// extent. If tile_blurs is not NULL, the blur confidence of each tile is
+// returned in it, in row major order. context may be NULL to use a pooled
+// context.
+int IsBlurredTiled(BlurContext* context, const uint8* const luminance,
+                   const int width, const int height,
+                   const int left, const int top,
+                   const int region_width, const int region_height,
+                   const int tiles_x, const int tiles_y,
+                   float* const blur, float* const extent,
+                   float* const tile_blurs);
+
 // Detects whether a given luminance matrix is blurred or not.
 // The input matrix size if width * height. 1 is returned when
 // input image is blurred along with blur confidence and extent
 // returned through output value blur and extent.
+// Only the central 256x256 area is analyzed, as 2x2 tiles, using a pooled
+// context.
 int IsBlurred(const uint8* const luminance, const int width, const int height,
               float* const blur, float* const extent);
 
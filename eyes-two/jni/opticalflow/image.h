@@ -31,6 +31,177 @@
 
 namespace flow {
 
+// Max radius of the windows sampled by Image::getWindowInterp.
+#define MAX_WINDOW_RADIUS 5
+
+// Row kernels of the image pyramids and of the window sampling, accelerated
+// with NEON or SSE2 where available. Each gives the same results as the
+// equivalent per pixel code.
+
+// Sets sums[i] to top[i] + 2 * middle[i] + bottom[i] for each of the width
+// pixels, the vertical pass of a [1 2 1] x [1 2 1] filter.
+inline void sumRows121(const uint8* const top, const uint8* const middle,
+                       const uint8* const bottom, const int32 width,
+                       uint16* const sums) {
+  int32 x = 0;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon()) {
+    for (; x + 8 <= width; x += 8) {
+      const uint16x8_t outer = vaddl_u8(vld1_u8(top + x), vld1_u8(bottom + x));
+      const uint16x8_t center = vshll_n_u8(vld1_u8(middle + x), 1);
+      vst1q_u16(sums + x, vaddq_u16(outer, center));
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 8 <= width; x += 8) {
+    const __m128i top8 = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(top + x)), zero);
+    const __m128i middle8 = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(middle + x)), zero);
+    const __m128i bottom8 = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bottom + x)), zero);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + x),
+                     _mm_add_epi16(_mm_add_epi16(top8, bottom8),
+                                   _mm_slli_epi16(middle8, 1)));
+  }
+#endif
+  for (; x < width; ++x) {
+    sums[x] = top[x] + 2 * middle[x] + bottom[x];
+  }
+}
+
+// Sets dst[x] to (sums[2x - 1] + 2 * sums[2x] + sums[2x + 1]) / 16 for x in
+// [start_x, end_x), the horizontal pass of a [1 2 1] x [1 2 1] filter
+// downsampling by 2. sums must be readable up to sums[2 * end_x + 16].
+inline void downsampleRow121(const uint16* const sums, const int32 start_x,
+                             const int32 end_x, uint8* const dst) {
+  int32 x = start_x;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon()) {
+    for (; x + 8 <= end_x; x += 8) {
+      // Deinterleaving loads split the sums into the left, center and right
+      // neighbors of each output pixel.
+      const uint16x8x2_t left_center = vld2q_u16(sums + 2 * x - 1);
+      const uint16x8x2_t right = vld2q_u16(sums + 2 * x + 1);
+      const uint16x8_t total =
+          vaddq_u16(vaddq_u16(left_center.val[0], right.val[0]),
+                    vshlq_n_u16(left_center.val[1], 1));
+      vst1_u8(dst + x, vshrn_n_u16(total, 4));
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i low_halves = _mm_set1_epi32(0xffff);
+  for (; x + 8 <= end_x; x += 8) {
+    // Filter all 16 sums about 2x, then keep the even ones.
+    const uint16* const center = sums + 2 * x;
+    __m128i total[2];
+    for (int32 i = 0; i < 2; ++i) {
+      const __m128i left16 = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(center + 8 * i - 1));
+      const __m128i center16 = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(center + 8 * i));
+      const __m128i right16 = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(center + 8 * i + 1));
+      total[i] = _mm_and_si128(
+          _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(left16, right16),
+                                       _mm_slli_epi16(center16, 1)), 4),
+          low_halves);
+    }
+    const __m128i words = _mm_packs_epi32(total[0], total[1]);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x),
+                     _mm_packus_epi16(words, words));
+  }
+#endif
+  for (; x < end_x; ++x) {
+    dst[x] = (sums[2 * x - 1] + 2 * sums[2 * x] + sums[2 * x + 1]) >> 4;
+  }
+}
+
+// Sets diffs[i] to (next[i] - prev[i]) / 2 for each of the width pixels.
+inline void halfDiffRow(const uint8* const prev, const uint8* const next,
+                        const int32 width, int32* const diffs) {
+  int32 x = 0;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon()) {
+    for (; x + 8 <= width; x += 8) {
+      const int16x8_t diff = vreinterpretq_s16_u16(
+          vsubl_u8(vld1_u8(next + x), vld1_u8(prev + x)));
+      // Add the sign bit before shifting, to round toward zero as the
+      // integer division does.
+      const int16x8_t half = vshrq_n_s16(
+          vaddq_s16(diff, vreinterpretq_s16_u16(
+              vshrq_n_u16(vreinterpretq_u16_s16(diff), 15))), 1);
+      vst1q_s32(diffs + x, vmovl_s16(vget_low_s16(half)));
+      vst1q_s32(diffs + x + 4, vmovl_s16(vget_high_s16(half)));
+    }
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 8 <= width; x += 8) {
+    const __m128i next8 = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(next + x)), zero);
+    const __m128i prev8 = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(prev + x)), zero);
+    const __m128i diff = _mm_sub_epi16(next8, prev8);
+    // Add the sign bit before shifting, to round toward zero as the
+    // integer division does.
+    const __m128i half =
+        _mm_srai_epi16(_mm_add_epi16(diff, _mm_srli_epi16(diff, 15)), 1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(diffs + x),
+                     _mm_srai_epi32(_mm_unpacklo_epi16(half, half), 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(diffs + x + 4),
+                     _mm_srai_epi32(_mm_unpackhi_epi16(half, half), 16));
+  }
+#endif
+  for (; x < width; ++x) {
+    diffs[x] = (next[x] - prev[x]) / 2;
+  }
+}
+
+// Sets dst[i] to scale * src[i] + next_scale * next_src[i] for i < n. The
+// last 4 values are recomputed if n is not a multiple of 4, so n must be at
+// least 4 for the accelerated versions.
+inline void blendArrays(const float32* const src, const float32* const next_src,
+                        const int32 n, const float32 scale,
+                        const float32 next_scale, float32* const dst) {
+  int32 i = 0;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon() && n >= 4) {
+    for (;; i += 4) {
+      if (i + 4 > n) {
+        i = n - 4;
+      }
+      vst1q_f32(dst + i, vmlaq_n_f32(vmulq_n_f32(vld1q_f32(src + i), scale),
+                                     vld1q_f32(next_src + i), next_scale));
+      if (i + 4 == n) {
+        return;
+      }
+    }
+  }
+#elif defined(__SSE2__)
+  if (n >= 4) {
+    const __m128 scale4 = _mm_set1_ps(scale);
+    const __m128 next_scale4 = _mm_set1_ps(next_scale);
+    for (;; i += 4) {
+      if (i + 4 > n) {
+        i = n - 4;
+      }
+      _mm_storeu_ps(dst + i,
+                    _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale4),
+                               _mm_mul_ps(_mm_loadu_ps(next_src + i),
+                                          next_scale4)));
+      if (i + 4 == n) {
+        return;
+      }
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = scale * src[i] + next_scale * next_src[i];
+  }
+}
+
 // TODO(andrewharp): Make explicit which operations support negative numbers or
 // struct/class types in image data (possibly create fast multi-dim array class
 // for data where pixel arithmetic does not make sense).
@@ -162,6 +333,53 @@ class Image {
            (y >= ZERO) && (y < height_less_one_);
   }
 
+  // Bilinearly samples the square window of the given radius about x, y into
+  // vals, in row major order, with the same values as getPixelInterp on each
+  // pixel of the window. All the pixels of the window must be valid for
+  // interpolation, which is the case iff its corners are.
+  // As the fractional offsets are the same for all the pixels of the window,
+  // each row is interpolated horizontally once, and blended vertically with
+  // the next row.
+  inline void getWindowInterp(const float32 x, const float32 y,
+                              const int32 radius, float32* const vals) const {
+    CHECK(radius <= MAX_WINDOW_RADIUS,
+          "Window %d > %d!", radius, MAX_WINDOW_RADIUS);
+    CHECK(validInterpPixel(x - radius, y - radius) &&
+          validInterpPixel(x + radius, y + radius),
+          "Window out of bounds! %.2f, %.2f", x, y);
+
+    const float32 left = x - radius;
+    const float32 top = y - radius;
+    const int32 floored_x = (int32) left;
+    const int32 floored_y = (int32) top;
+
+    const float32 b = left - floored_x;
+    const float32 a = 1.0f - b;
+
+    const float32 d = top - floored_y;
+    const float32 c = 1.0f - d;
+
+    const int32 size = 2 * radius + 1;
+
+    // The pixels of a row, and the horizontally interpolated previous and
+    // current rows.
+    float32 pixels[2 * MAX_WINDOW_RADIUS + 2];
+    float32 rows[2][2 * MAX_WINDOW_RADIUS + 1];
+
+    for (int32 row = 0; row <= size; ++row) {
+      const T* const pix_ptr = getPixelPtrConst(floored_x, floored_y + row);
+      for (int32 i = 0; i <= size; ++i) {
+        pixels[i] = pix_ptr[i];
+      }
+      float32* const curr_row = rows[row & 1];
+      blendArrays(pixels, pixels + 1, size, a, b, curr_row);
+      if (row > 0) {
+        blendArrays(rows[(row - 1) & 1], curr_row, size, c, d,
+                    vals + (row - 1) * size);
+      }
+    }
+  }
+
   // Safe lookup with boundary enforcement.
   inline T getPixelClipped(const int32 x, const int32 y) const {
     return getPixel(clip(x, ZERO, width_less_one_),
@@ -591,6 +809,73 @@ class Image {
 };
 
 
+// Downsamples 8 bit images a row at a time with the row kernels, with the same
+// results as the generic version.
+template <>
+inline void Image<uint8>::downsampleSmoothed3x3(const Image<uint8>& original) {
+  const int32 orig_width = original.width_;
+
+  // The vertical sums of 3 rows of the original, with room for the reads
+  // past the end by downsampleRow121.
+  uint16* const sums = new uint16[orig_width + 24]();
+
+  // Output pixels whose 3 source columns are all in the original, so need no
+  // clipping.
+  const int32 start_x = 1;
+  const int32 end_x = max(start_x, min(width_, orig_width / 2));
+
+  for (int32 y = 0; y < height_; ++y) {
+    const int32 orig_y = clip(2 * y, ZERO, original.height_less_one_);
+    const int32 min_y = clip(orig_y - 1, ZERO, original.height_less_one_);
+    const int32 max_y = clip(orig_y + 1, ZERO, original.height_less_one_);
+
+    sumRows121(original.getPixelPtrConst(0, min_y),
+               original.getPixelPtrConst(0, orig_y),
+               original.getPixelPtrConst(0, max_y), orig_width, sums);
+
+    uint8* const dst_row = getPixelPtr(0, y);
+    downsampleRow121(sums, start_x, end_x, dst_row);
+
+    // The clipped pixels at the edges.
+    for (int32 x = 0; x < width_; x = (x < start_x ? end_x : x + 1)) {
+      const int32 orig_x = clip(2 * x, ZERO, original.width_less_one_);
+      const int32 min_x = clip(orig_x - 1, ZERO, original.width_less_one_);
+      const int32 max_x = clip(orig_x + 1, ZERO, original.width_less_one_);
+      dst_row[x] = (sums[min_x] + 2 * sums[orig_x] + sums[max_x]) >> 4;
+    }
+  }
+
+  delete[] sums;
+}
+
+template <>
+template <>
+inline void Image<int32>::derivativeX(const Image<uint8>& original) {
+  for (int32 y = 0; y < height_; ++y) {
+    int32* const dest_row = getPixelPtr(0, y);
+    const uint8* const source_row = original.getPixelPtrConst(0, y);
+
+    // First and last pixels.
+    dest_row[0] = halfDiff(source_row[0], source_row[1]);
+    dest_row[width_less_one_] = halfDiff(source_row[width_less_one_ - 1],
+                                         source_row[width_less_one_]);
+
+    // All the pixels in between.
+    halfDiffRow(source_row, source_row + 2, width_ - 2, dest_row + 1);
+  }
+}
+
+template <>
+template <>
+inline void Image<int32>::derivativeY(const Image<uint8>& original) {
+  for (int32 y = 0; y < height_; ++y) {
+    halfDiffRow(original.getPixelPtrConst(0, max(0, y - 1)),
+                original.getPixelPtrConst(0, min(height_less_one_, y + 1)),
+                width_, getPixelPtr(0, y));
+  }
+}
+
+
 // Create a pyramid of downsampled images. The first level of the pyramid is the
 // original image.
 inline void computeSmoothedPyramid(const Image<uint8>& frame,
@@ -671,8 +956,8 @@ inline static bool markImage(const int32 x, const int32 y,
 inline void calculateG(const float32* const vals_x, const float32* const vals_y,
                        const int32 num_vals, float* const G) {
   // Defined here because we want to keep track of how many values were
-  // processed by NEON, so that we can finish off the remainder the normal
-  // way.
+  // processed by NEON or SSE2, so that we can finish off the remainder the
+  // normal way.
   int32 i = 0;
 
 #ifdef HAVE_ARMEABI_V7A
@@ -709,9 +994,9 @@ inline void calculateG(const float32* const vals_x, const float32* const vals_y,
       yy = vmlaq_f32(yy, y, y);
     }
 
-    static float32_t xx_vals[4];
-    static float32_t xy_vals[4];
-    static float32_t yy_vals[4];
+    float32_t xx_vals[4];
+    float32_t xy_vals[4];
+    float32_t yy_vals[4];
 
     vst1q_f32(xx_vals, xx);
     vst1q_f32(xy_vals, xy);
@@ -725,6 +1010,32 @@ inline void calculateG(const float32* const vals_x, const float32* const vals_y,
       G[3] += yy_vals[j];
     }
   }
+#elif defined(__SSE2__)
+  __m128 xx = _mm_setzero_ps();
+  __m128 xy = _mm_setzero_ps();
+  __m128 yy = _mm_setzero_ps();
+
+  for (; i + 4 <= num_vals; i += 4) {
+    const __m128 x = _mm_loadu_ps(vals_x + i);
+    const __m128 y = _mm_loadu_ps(vals_y + i);
+    xx = _mm_add_ps(xx, _mm_mul_ps(x, x));
+    xy = _mm_add_ps(xy, _mm_mul_ps(x, y));
+    yy = _mm_add_ps(yy, _mm_mul_ps(y, y));
+  }
+
+  float32 xx_vals[4];
+  float32 xy_vals[4];
+  float32 yy_vals[4];
+
+  _mm_storeu_ps(xx_vals, xx);
+  _mm_storeu_ps(xy_vals, xy);
+  _mm_storeu_ps(yy_vals, yy);
+
+  for (int32 j = 0; j < 4; ++j) {
+    G[0] += xx_vals[j];
+    G[1] += xy_vals[j];
+    G[3] += yy_vals[j];
+  }
 #endif
   // Non-accelerated version, also finishes off last few values (< 4) from
   // above.
@@ -747,18 +1058,13 @@ inline void calculateG(const int window_size,
                        float* const G) {
   CHECK(I_x.validPixel(center_x, center_y), "Problem in calculateG!");
 
-  // Hardcoded to allow for a max window radius of 5 (9 pixels x 9 pixels).
-  static const int kMaxWindowRadius = 5;
-  CHECK(window_size <= kMaxWindowRadius,
-        "Window %d > %d!", window_size, kMaxWindowRadius);
-
-  // Diameter of window is 2 * radius + 1 for center pixel.
-  static const int kWindowBufferSize =
-      (kMaxWindowRadius * 2 + 1) * (kMaxWindowRadius * 2 + 1);
+  CHECK(window_size <= MAX_WINDOW_RADIUS,
+        "Window %d > %d!", window_size, MAX_WINDOW_RADIUS);
 
-  // Preallocate buffers statically for efficiency.
-  static float32 vals_x[kWindowBufferSize];
-  static float32 vals_y[kWindowBufferSize];
+  // Diameter of window is 2 * radius + 1 for center pixel. The buffers are on
+  // the stack so that features may be scored from several threads.
+  float32 vals_x[(MAX_WINDOW_RADIUS * 2 + 1) * (MAX_WINDOW_RADIUS * 2 + 1)];
+  float32 vals_y[(MAX_WINDOW_RADIUS * 2 + 1) * (MAX_WINDOW_RADIUS * 2 + 1)];
 
   int32 num_vals = 0;
 
@@ -16,6 +16,11 @@
 
 // Author: Andrew Harp
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #include "utils.h"
 #include "time_log.h"
 
@@ -256,6 +261,49 @@ int32 OpticalFlow::getFeatures(const bool only_found,
 }
 
 
+// The features of a FramePair being tracked by several threads.
+struct CorrespondenceTask {
+  const OpticalFlow* optical_flow;
+  FramePair* frame_pair;
+  // Index of the next feature to track.
+  volatile int32 next_feature;
+};
+
+// Tracks features of the task until there are none left. Each feature is
+// tracked by whichever thread takes it first.
+static void* trackFeatures(void* const arg) {
+  CorrespondenceTask* const task = static_cast<CorrespondenceTask*>(arg);
+  FramePair* const frame_pair = task->frame_pair;
+
+  while (true) {
+    const int32 i_feat = __sync_fetch_and_add(&task->next_feature, 1);
+    if (i_feat >= frame_pair->number_of_features_) {
+      break;
+    }
+
+    const Point2D& feature1 = frame_pair->frame1_features_[i_feat];
+    Point2D* const feature2 = frame_pair->frame2_features_ + i_feat;
+
+    frame_pair->optical_flow_found_feature_[i_feat] =
+        task->optical_flow->findFlowAtPoint(feature1.x, feature1.y,
+                                            &feature2->x, &feature2->y);
+  }
+  return NULL;
+}
+
+// Returns the number of threads to track num_features features with,
+// including the calling thread.
+static int32 getNumTrackingThreads(const int32 num_features) {
+#ifdef HAVE_PTHREAD
+  const long num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+  const int32 num_threads = num_processors > 0 ? num_processors : 1;
+  return clip(min(num_threads, num_features / MIN_FEATURES_PER_THREAD),
+              1, MAX_TRACKING_THREADS);
+#else
+  return 1;
+#endif
+}
+
 // Finds the correspondences for all the points in the current pair of frames.
 // Stores the results in the given FramePair.
 void OpticalFlow::findCorrespondences(FramePair* const frame_pair) const {
@@ -264,24 +312,38 @@ void OpticalFlow::findCorrespondences(FramePair* const frame_pair) const {
          sizeof(*frame_pair->optical_flow_found_feature_) * MAX_FEATURES);
   timeLog("Cleared old found features");
 
-  int32 num_features_found = 0;
-
-  // For every feature...
-  for (int32 i_feat = 0; i_feat < frame_pair->number_of_features_; ++i_feat) {
-    Point2D* feature1 = frame_pair->frame1_features_ + i_feat;
-    Point2D* feature2 = frame_pair->frame2_features_ + i_feat;
-
-    if (findFlowAtPoint(feature1->x, feature1->y,
-                        &feature2->x, &feature2->y)) {
-      frame_pair->optical_flow_found_feature_[i_feat] = true;
-      ++num_features_found;
+  CorrespondenceTask task;
+  task.optical_flow = this;
+  task.frame_pair = frame_pair;
+  task.next_feature = 0;
+
+  const int32 num_threads =
+      getNumTrackingThreads(frame_pair->number_of_features_);
+
+#ifdef HAVE_PTHREAD
+  // The calling thread tracks features too. If a thread can't be started,
+  // the others track its share.
+  pthread_t threads[MAX_TRACKING_THREADS];
+  int32 num_started = 0;
+  for (int32 i = 1; i < num_threads; ++i) {
+    if (pthread_create(&threads[num_started], NULL, trackFeatures,
+                       &task) == 0) {
+      ++num_started;
     }
   }
+  trackFeatures(&task);
+  for (int32 i = 0; i < num_started; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+#else
+  trackFeatures(&task);
+#endif
 
   timeLog("Found correspondences");
 
-  LOGV("Found %d of %d feature correspondences",
-       num_features_found, frame_pair->number_of_features_);
+  LOGV("Found %d of %d feature correspondences using %d threads",
+       frame_pair->countFoundFeatures(), frame_pair->number_of_features_,
+       num_threads);
 }
 
 
@@ -317,28 +379,18 @@ bool OpticalFlow::findFlowAtPoint(const float32 u_x, const float32 u_y,
 
     // Get values for frame 1.  They remain constant through the inner
     // iteration loop.
+    if (!img_I.validInterpPixel(p_x - WINDOW_SIZE, p_y - WINDOW_SIZE) ||
+        !img_I.validInterpPixel(p_x + WINDOW_SIZE, p_y + WINDOW_SIZE)) {
+      return false;
+    }
+
     float32 vals_I[ARRAY_SIZE];
     float32 vals_I_x[ARRAY_SIZE];
     float32 vals_I_y[ARRAY_SIZE];
 
-    int32 val_idx = 0;
-    for (int32 win_x = -WINDOW_SIZE; win_x <= WINDOW_SIZE; ++win_x) {
-      for (int32 win_y = -WINDOW_SIZE; win_y <= WINDOW_SIZE; ++win_y) {
-        const float32 x_pos = p_x + win_x;
-        const float32 y_pos = p_y + win_y;
-
-        if (!img_I.validInterpPixel(x_pos, y_pos)) {
-          return false;
-        }
-
-        vals_I[val_idx] = img_I.getPixelInterp(x_pos, y_pos);
-
-        vals_I_x[val_idx] = I_x.getPixelInterp(x_pos, y_pos);
-        vals_I_y[val_idx] = I_y.getPixelInterp(x_pos, y_pos);
-
-        ++val_idx;
-      }
-    }
+    img_I.getWindowInterp(p_x, p_y, WINDOW_SIZE, vals_I);
+    I_x.getWindowInterp(p_x, p_y, WINDOW_SIZE, vals_I_x);
+    I_y.getWindowInterp(p_x, p_y, WINDOW_SIZE, vals_I_y);
 
     // Compute the spatial gradient matrix about point p.
     float32 G[] = { 0, 0, 0, 0 };
@@ -354,56 +406,38 @@ bool OpticalFlow::findFlowAtPoint(const float32 u_x, const float32 u_y,
 #ifdef NORMALIZE
     const float32 mean_I = computeMean(vals_I, ARRAY_SIZE);
     const float32 std_dev_I = computeStdDev(vals_I, ARRAY_SIZE, mean_I);
+#else
+    const float32 mean_I = 0.0f;
 #endif
 
     // Iterate NUM_ITERATIONS times or until we converge.
     for (int32 iteration = 0; iteration < NUM_ITERATIONS; ++iteration) {
       // Get values for frame 2.
-      float32 vals_J[ARRAY_SIZE];
-      int32 val_idx = 0;
-      for (int32 win_x = -WINDOW_SIZE; win_x <= WINDOW_SIZE; ++win_x) {
-        for (int32 win_y = -WINDOW_SIZE; win_y <= WINDOW_SIZE; ++win_y) {
-          const float32 x_pos = p_x + win_x + g_x;
-          const float32 y_pos = p_y + win_y + g_y;
-
-          if (!img_I.validInterpPixel(x_pos, y_pos)) {
-            return false;
-          }
-
-          vals_J[val_idx] = img_J.getPixelInterp(x_pos, y_pos);
-
-          ++val_idx;
-        }
+      const float32 q_x = p_x + g_x;
+      const float32 q_y = p_y + g_y;
+      if (!img_J.validInterpPixel(q_x - WINDOW_SIZE, q_y - WINDOW_SIZE) ||
+          !img_J.validInterpPixel(q_x + WINDOW_SIZE, q_y + WINDOW_SIZE)) {
+        return false;
       }
 
+      float32 vals_J[ARRAY_SIZE];
+      img_J.getWindowInterp(q_x, q_y, WINDOW_SIZE, vals_J);
+
 #ifdef NORMALIZE
       const float32 mean_J = computeMean(vals_J, ARRAY_SIZE);
       const float32 std_dev_J = computeStdDev(vals_J, ARRAY_SIZE, mean_J);
 
       const float32 std_dev_ratio = std_dev_I / std_dev_J;
-#endif
-
-      // Compute image mismatch vector.
-      float32 b_x = 0.0f;
-      float32 b_y = 0.0f;
-      val_idx = 0;
-      for (int32 win_x = -WINDOW_SIZE; win_x <= WINDOW_SIZE; ++win_x) {
-        for (int32 win_y = -WINDOW_SIZE; win_y <= WINDOW_SIZE; ++win_y) {
-          // Normalized Image difference.
-
-#ifdef NORMALIZE
-          const float32 dI = (vals_I[val_idx] - mean_I) -
-                             (vals_J[val_idx] - mean_J) * std_dev_ratio;
 #else
-          const float32 dI = vals_I[val_idx] - vals_J[val_idx];
+      const float32 mean_J = 0.0f;
+      const float32 std_dev_ratio = 1.0f;
 #endif
 
-          b_x += dI * vals_I_x[val_idx];
-          b_y += dI * vals_I_y[val_idx];
-
-          ++val_idx;
-        }
-      }
+      // Compute image mismatch vector from the normalized image difference.
+      float32 b_x;
+      float32 b_y;
+      computeMismatch(vals_I, vals_J, vals_I_x, vals_I_y, ARRAY_SIZE,
+                      mean_I, mean_J, std_dev_ratio, &b_x, &b_y);
 
       // Optical flow... solve n = G^-1 * b
       const float32 n_x = (G_inv[0] * b_x) + (G_inv[1] * b_y);
@@ -46,6 +46,11 @@
 #define FEATURE_GRID_WIDTH 4
 #define FEATURE_GRID_HEIGHT 3
 
+// Max number of threads tracking the features of a frame, and the min number
+// of features each thread must have to track for another to be started.
+#define MAX_TRACKING_THREADS 4
+#define MIN_FEATURES_PER_THREAD 16
+
 // Whether to normalize feature windows for intensity.
 #define NORMALIZE
 
@@ -215,6 +220,7 @@ class OpticalFlow {
   void findCorrespondences(FramePair* const curr_change) const;
 
   // An implementation of the Pyramidal Lucas-Kanade Optical Flow algorithm.
+  // May be called from several threads at once.
   bool findFlowAtPoint(const float32 u_x, const float32 u_y,
                        float32* final_x, float32* final_y) const;
 
@@ -78,29 +78,136 @@ inline bool invert2x2(const float32* const a, float32* const a_inv) {
   return true;
 }
 
-// TODO(andrewharp): Accelerate with NEON.
+// Returns the sum of the 4 lanes of a float vector.
+#ifdef HAVE_ARMEABI_V7A
+inline float32 sumLanes(const float32x4_t sums) {
+  const float32x2_t half_sums =
+      vadd_f32(vget_low_f32(sums), vget_high_f32(sums));
+  return vget_lane_f32(vpadd_f32(half_sums, half_sums), 0);
+}
+#elif defined(__SSE2__)
+inline float32 sumLanes(const __m128 sums) {
+  float32 lanes[4];
+  _mm_storeu_ps(lanes, sums);
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+#endif
+
 inline float32 computeMean(const float32* const values,
                            const int32 num_vals) {
   // Get mean.
   float32 sum = 0.0f;
-  for (int32 i = 0; i < num_vals; ++i) {
+  int32 i = 0;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon()) {
+    float32x4_t sums = vdupq_n_f32(0.0f);
+    for (; i + 4 <= num_vals; i += 4) {
+      sums = vaddq_f32(sums, vld1q_f32(values + i));
+    }
+    sum = sumLanes(sums);
+  }
+#elif defined(__SSE2__)
+  __m128 sums = _mm_setzero_ps();
+  for (; i + 4 <= num_vals; i += 4) {
+    sums = _mm_add_ps(sums, _mm_loadu_ps(values + i));
+  }
+  sum = sumLanes(sums);
+#endif
+  for (; i < num_vals; ++i) {
     sum += values[i];
   }
   return sum / static_cast<float32>(num_vals);
 }
 
-// TODO(andrewharp): Accelerate with NEON.
 inline float32 computeStdDev(const float32* const values,
                              const int32 num_vals,
                              const float32 mean) {
   // Get Std dev.
   float32 squared_sum = 0.0f;
-  for (int32 i = 0; i < num_vals; ++i) {
+  int32 i = 0;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon()) {
+    const float32x4_t means = vdupq_n_f32(mean);
+    float32x4_t squared_sums = vdupq_n_f32(0.0f);
+    for (; i + 4 <= num_vals; i += 4) {
+      const float32x4_t diffs = vsubq_f32(vld1q_f32(values + i), means);
+      squared_sums = vmlaq_f32(squared_sums, diffs, diffs);
+    }
+    squared_sum = sumLanes(squared_sums);
+  }
+#elif defined(__SSE2__)
+  const __m128 means = _mm_set1_ps(mean);
+  __m128 squared_sums = _mm_setzero_ps();
+  for (; i + 4 <= num_vals; i += 4) {
+    const __m128 diffs = _mm_sub_ps(_mm_loadu_ps(values + i), means);
+    squared_sums = _mm_add_ps(squared_sums, _mm_mul_ps(diffs, diffs));
+  }
+  squared_sum = sumLanes(squared_sums);
+#endif
+  for (; i < num_vals; ++i) {
     squared_sum += square(values[i] - mean);
   }
   return sqrt(squared_sum / static_cast<float32>(num_vals));
 }
 
+// Computes the image mismatch vector b of Lucas-Kanade, the sums over the
+// window of the differences between the normalized values of I and J,
+// (vals_I[i] - mean_I) - (vals_J[i] - mean_J) * std_dev_ratio, weighted by
+// the gradients I_x[i] and I_y[i].
+inline void computeMismatch(const float32* const vals_I,
+                            const float32* const vals_J,
+                            const float32* const I_x,
+                            const float32* const I_y,
+                            const int32 num_vals,
+                            const float32 mean_I, const float32 mean_J,
+                            const float32 std_dev_ratio,
+                            float32* const b_x, float32* const b_y) {
+  float32 sum_x = 0.0f;
+  float32 sum_y = 0.0f;
+  int32 i = 0;
+#ifdef HAVE_ARMEABI_V7A
+  if (supportsNeon()) {
+    const float32x4_t means_I = vdupq_n_f32(mean_I);
+    const float32x4_t means_J = vdupq_n_f32(mean_J);
+    const float32x4_t ratios = vdupq_n_f32(std_dev_ratio);
+    float32x4_t sums_x = vdupq_n_f32(0.0f);
+    float32x4_t sums_y = vdupq_n_f32(0.0f);
+    for (; i + 4 <= num_vals; i += 4) {
+      const float32x4_t diffs = vmlsq_f32(
+          vsubq_f32(vld1q_f32(vals_I + i), means_I),
+          vsubq_f32(vld1q_f32(vals_J + i), means_J), ratios);
+      sums_x = vmlaq_f32(sums_x, diffs, vld1q_f32(I_x + i));
+      sums_y = vmlaq_f32(sums_y, diffs, vld1q_f32(I_y + i));
+    }
+    sum_x = sumLanes(sums_x);
+    sum_y = sumLanes(sums_y);
+  }
+#elif defined(__SSE2__)
+  const __m128 means_I = _mm_set1_ps(mean_I);
+  const __m128 means_J = _mm_set1_ps(mean_J);
+  const __m128 ratios = _mm_set1_ps(std_dev_ratio);
+  __m128 sums_x = _mm_setzero_ps();
+  __m128 sums_y = _mm_setzero_ps();
+  for (; i + 4 <= num_vals; i += 4) {
+    const __m128 diffs = _mm_sub_ps(
+        _mm_sub_ps(_mm_loadu_ps(vals_I + i), means_I),
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(vals_J + i), means_J), ratios));
+    sums_x = _mm_add_ps(sums_x, _mm_mul_ps(diffs, _mm_loadu_ps(I_x + i)));
+    sums_y = _mm_add_ps(sums_y, _mm_mul_ps(diffs, _mm_loadu_ps(I_y + i)));
+  }
+  sum_x = sumLanes(sums_x);
+  sum_y = sumLanes(sums_y);
+#endif
+  for (; i < num_vals; ++i) {
+    const float32 diff =
+        (vals_I[i] - mean_I) - (vals_J[i] - mean_J) * std_dev_ratio;
+    sum_x += diff * I_x[i];
+    sum_y += diff * I_y[i];
+  }
+  *b_x = sum_x;
+  *b_y = sum_y;
+}
+
 // TODO(andrewharp): Accelerate with NEON.
 inline float32 computeWeightedMean(const float32* const values,
                                    const float32* const weights,
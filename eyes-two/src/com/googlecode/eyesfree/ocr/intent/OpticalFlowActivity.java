@@ -83,7 +83,8 @@ public class OpticalFlowActivity extends CameraActivity {
         final OpticalFlowProcessor opticalFlow = new OpticalFlowProcessor();
         mPreviewLooper.addPreviewProcessor(opticalFlow, 1);
 
-        final TextDetectionProcessor textDetect = new TextDetectionProcessor();
+        final TextDetectionProcessor textDetect = new TextDetectionProcessor(
+                opticalFlow.getOpticalFlow());
         mPreviewLooper.addPreviewProcessor(textDetect, 2);
 
         final TextTrackerProcessor textTracker = new TextTrackerProcessor(
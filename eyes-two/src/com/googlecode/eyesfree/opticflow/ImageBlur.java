@@ -35,6 +35,23 @@ public class ImageBlur {
      */
     public static native boolean isBlurred(byte[] input, int width, int height);
 
+    /**
+     * Tests if a given image is blurred or not, by analyzing all of it as a
+     * grid of tiles. Safe to call from several threads at once.
+     *
+     * @param input An array of input pixels in YUV420SP format.
+     * @param width The width of the input image.
+     * @param height The height of the input image.
+     * @param tilesX The number of columns of tiles.
+     * @param tilesY The number of rows of tiles.
+     * @param tileBlurs If not null and at least tilesX * tilesY long, receives
+     *            the blur confidence of each tile in row major order. Lower
+     *            values are blurrier.
+     * @return true when input image is blurred on average over the tiles.
+     */
+    public static native boolean isBlurredTiled(byte[] input, int width, int height,
+            int tilesX, int tilesY, float[] tileBlurs);
+
     /**
      * Computes signature of a given image.
      *
@@ -22,6 +22,8 @@ import com.googlecode.eyesfree.textdetect.HydrogenTextDetector.Parameters;
 import com.googlecode.leptonica.android.Pix;
 import com.googlecode.leptonica.android.Pixa;
 
+import android.graphics.PointF;
+
 /**
  * Frame processor that runs text detection.
  *
@@ -30,7 +32,29 @@ import com.googlecode.leptonica.android.Pixa;
 public class TextDetectionProcessor extends FrameProcessor {
     private HydrogenTextDetector mHydrogen;
 
+    /** Optical flow tracker used to detect text incrementally, if any. */
+    private final OpticalFlow mOpticalFlow;
+
+    /** Timestamp of the last frame text was detected in, or -1 if none. */
+    private long mLastTimestamp;
+
+    private int mWidth;
+
+    private int mHeight;
+
     public TextDetectionProcessor() {
+        this(null);
+    }
+
+    /**
+     * @param opticalFlow Optical flow tracker of the frames, used to move
+     *            the text areas of the previous frame instead of detecting
+     *            them again, or {@code null} to detect text in each frame
+     *            from scratch.
+     */
+    public TextDetectionProcessor(OpticalFlow opticalFlow) {
+        mOpticalFlow = opticalFlow;
+        mLastTimestamp = -1;
         mHydrogen = new HydrogenTextDetector();
 
         // We're relaxing the default parameters a little here...
@@ -47,6 +71,11 @@ public class TextDetectionProcessor extends FrameProcessor {
         int width = size.width;
         int height = size.height;
 
+        mWidth = width;
+        mHeight = height;
+        mLastTimestamp = -1;
+        mHydrogen.resetIncremental();
+
         // TODO(alanv): Implement an image buffer throughout Hydrogen.
         mHydrogen.setSize(width, height);
     }
@@ -62,7 +91,15 @@ public class TextDetectionProcessor extends FrameProcessor {
         mHydrogen.setSourceImage(pixs);
         pixs.recycle();
 
-        mHydrogen.detectText();
+        if (mOpticalFlow != null && mLastTimestamp >= 0) {
+            PointF delta = mOpticalFlow.getAccumulatedDelta(mLastTimestamp, mWidth / 2.0f,
+                    mHeight / 2.0f, Math.max(mWidth, mHeight));
+            mHydrogen.detectTextIncremental(delta.x, delta.y);
+        } else {
+            mHydrogen.detectText();
+        }
+        mLastTimestamp = frame.getTimestamp();
+
         Pixa pixa = mHydrogen.getTextAreas();
         float[] conf = mHydrogen.getTextConfs();
         float angle = mHydrogen.getSkewAngle();
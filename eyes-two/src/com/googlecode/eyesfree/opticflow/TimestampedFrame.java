@@ -116,8 +116,8 @@ public class TimestampedFrame {
      */
     public synchronized Pix getPixData() {
         if (cachedPix == null) {
-            cachedPix = ReadFile.readBytes8(
-                    originalFrame.data, originalFrame.width, originalFrame.height);
+            cachedPix = ReadFile.readNv21(
+                    originalFrame.data, originalFrame.width, originalFrame.height, null, 1);
         }
 
         return cachedPix.clone();
@@ -109,6 +109,28 @@ public class HydrogenTextDetector {
         nativeDetectText(mNative);
     }
 
+    /**
+     * Detects text in a frame of a video, moving the text areas of the
+     * previous frame by the motion of the scene since then and only searching
+     * the parts of the frame that changed or came into view. Falls back to
+     * {@link #detectText()} periodically and when too much of the frame
+     * changed.
+     *
+     * @param dx The horizontal motion of the scene since the previous frame.
+     * @param dy The vertical motion of the scene since the previous frame.
+     */
+    public void detectTextIncremental(float dx, float dy) {
+        nativeDetectTextIncremental(mNative, dx, dy);
+    }
+
+    /**
+     * Forgets the previous frame, so that the next incremental detection
+     * searches the whole frame.
+     */
+    public void resetIncremental() {
+        nativeResetIncremental(mNative);
+    }
+
     public void clear() {
         nativeClear(mNative);
     }
@@ -131,6 +153,9 @@ public class HydrogenTextDetector {
 
         public int edge_avg_thresh;
 
+        /** Threads to threshold on, or 0 for one per processor */
+        public int edge_num_threads;
+
         // Skew angle correction
         public boolean skew_enabled;
 
@@ -184,6 +209,16 @@ public class HydrogenTextDetector {
 
         public int cluster_min_edge_avg;
 
+        // Incremental detection
+        /** Frames between full detections */
+        public int incremental_refresh;
+
+        /** Mean difference over which a tile of the frame changed */
+        public int incremental_diff_thresh;
+
+        /** Fraction of changed tiles over which a full detection runs */
+        public float incremental_max_changed;
+
         public Parameters() {
             debug = false;
             out_dir = Environment.getExternalStorageDirectory().toString();
@@ -193,6 +228,7 @@ public class HydrogenTextDetector {
             edge_tile_y = 64;
             edge_thresh = 64;
             edge_avg_thresh = 4;
+            edge_num_threads = 0;
 
             // Skew angle correction
             skew_enabled = true;
@@ -227,6 +263,11 @@ public class HydrogenTextDetector {
             cluster_min_fdr = 2.5f;
             cluster_min_edge = 32;
             cluster_min_edge_avg = 1;
+
+            // Incremental detection
+            incremental_refresh = 15;
+            incremental_diff_thresh = 12;
+            incremental_max_changed = 0.5f;
         }
     }
 
@@ -256,5 +297,9 @@ public class HydrogenTextDetector {
 
     private static native void nativeDetectText(int nativePtr);
 
+    private static native void nativeDetectTextIncremental(int nativePtr, float dx, float dy);
+
+    private static native void nativeResetIncremental(int nativePtr);
+
     private static native void nativeClear(int nativePtr);
 }
@@ -43,6 +43,8 @@ public class ReadFileTest extends TestCase {
     public void testReadBitmap() {
         testReadBitmap(1, 1, Bitmap.Config.ARGB_8888);
         testReadBitmap(640, 480, Bitmap.Config.ARGB_8888);
+        testReadBitmap(1, 1, Bitmap.Config.RGB_565);
+        testReadBitmap(640, 480, Bitmap.Config.RGB_565);
     }
 
     private void testReadBitmap(int width, int height, Bitmap.Config format) {
@@ -77,6 +79,84 @@ public class ReadFileTest extends TestCase {
         pix.recycle();
     }
 
+    @SmallTest
+    public void testReadBitmapCropReduce() {
+        Bitmap bmp = Bitmap.createBitmap(64, 32, Bitmap.Config.ARGB_8888);
+        Canvas canvas = new Canvas(bmp);
+        Paint paint = new Paint();
+        paint.setStyle(Style.FILL);
+
+        // Paint the left half white and the right half black
+        paint.setColor(Color.WHITE);
+        canvas.drawRect(new Rect(0, 0, 32, 32), paint);
+        paint.setColor(Color.BLACK);
+        canvas.drawRect(new Rect(32, 0, 64, 32), paint);
+
+        Pix pix = ReadFile.readBitmap(bmp, new Rect(16, 8, 48, 24), 2, ReadFile.LUMA_BT601);
+
+        assertEquals(16, pix.getWidth());
+        assertEquals(8, pix.getHeight());
+        assertEquals(Color.WHITE, pix.getPixel(7, 0));
+        assertEquals(Color.BLACK, pix.getPixel(8, 7));
+
+        bmp.recycle();
+        pix.recycle();
+    }
+
+    @SmallTest
+    public void testReadBitmapLuma() {
+        Bitmap bmp = Bitmap.createBitmap(20, 10, Bitmap.Config.ARGB_8888);
+        bmp.eraseColor(Color.RED);
+
+        Pix average = ReadFile.readBitmap(bmp, null, 1, ReadFile.LUMA_AVERAGE);
+        Pix bt601 = ReadFile.readBitmap(bmp, null, 1, ReadFile.LUMA_BT601);
+        Pix bt709 = ReadFile.readBitmap(bmp, null, 4, ReadFile.LUMA_BT709);
+
+        // Red is 1/3, 0.299 and 0.2126 of white
+        assertEquals(Color.rgb(85, 85, 85), average.getPixel(19, 9));
+        assertEquals(Color.rgb(77, 77, 77), bt601.getPixel(19, 9));
+        assertEquals(5, bt709.getWidth());
+        assertEquals(2, bt709.getHeight());
+        assertEquals(Color.rgb(54, 54, 54), bt709.getPixel(4, 1));
+
+        bmp.recycle();
+        average.recycle();
+        bt601.recycle();
+        bt709.recycle();
+    }
+
+    @SmallTest
+    public void testReadNv21() {
+        int width = 40;
+        int height = 20;
+        byte[] data = new byte[width * height * 3 / 2];
+
+        // Luma rises by 4 every 4 columns, chroma is ignored
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                data[y * width + x] = (byte) (x / 4 * 4);
+            }
+        }
+        for (int i = width * height; i < data.length; i++) {
+            data[i] = (byte) 0xFF;
+        }
+
+        Pix pix = ReadFile.readNv21(data, width, height, null, 1);
+
+        assertEquals(width, pix.getWidth());
+        assertEquals(height, pix.getHeight());
+        assertEquals(Color.rgb(36, 36, 36), pix.getPixel(39, 19));
+        pix.recycle();
+
+        pix = ReadFile.readNv21(data, width, height, new Rect(8, 4, 24, 12), 4);
+
+        assertEquals(4, pix.getWidth());
+        assertEquals(2, pix.getHeight());
+        assertEquals(Color.rgb(8, 8, 8), pix.getPixel(0, 0));
+        assertEquals(Color.rgb(20, 20, 20), pix.getPixel(3, 1));
+        pix.recycle();
+    }
+
     @SmallTest
     public void testReadFile() throws IOException {
         File file = File.createTempFile("testReadFile", "jpg");
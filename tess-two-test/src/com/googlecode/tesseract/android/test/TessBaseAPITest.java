@@ -25,11 +25,19 @@ import android.graphics.Paint.Style;
 import android.graphics.Rect;
 import android.test.suitebuilder.annotation.SmallTest;
 
+import com.googlecode.leptonica.android.Box;
+import com.googlecode.leptonica.android.Constants;
+import com.googlecode.leptonica.android.Pix;
+import com.googlecode.leptonica.android.Pixa;
+import com.googlecode.leptonica.android.ReadFile;
+import com.googlecode.tesseract.android.BatchResult;
+import com.googlecode.tesseract.android.LanguageModelBundle;
 import com.googlecode.tesseract.android.TessBaseAPI;
 
 import junit.framework.TestCase;
 
 import java.io.File;
+import java.nio.ByteBuffer;
 
 public class TessBaseAPITest extends TestCase {
     private static final String TESSBASE_PATH = "/mnt/sdcard/tesseract/";
@@ -108,4 +116,408 @@ public class TessBaseAPITest extends TestCase {
         baseApi.end();
         bmp.recycle();
     }
+
+    @SmallTest
+    public void testSetImageBuffer() {
+        // First, make sure the eng.traineddata file exists.
+        assertTrue("Make sure that you've copied " + DEFAULT_LANGUAGE + ".traineddata to "
+                + EXPECTED_FILE, new File(EXPECTED_FILE).exists());
+
+        final String inputText = "hello";
+
+        // Attempt to initialize the API.
+        final TessBaseAPI baseApi = new TessBaseAPI();
+        baseApi.init(TESSBASE_PATH, DEFAULT_LANGUAGE);
+        baseApi.setPageSegMode(TessBaseAPI.PSM_SINGLE_LINE);
+
+        // Draw "hello" into a Bitmap.
+        final Bitmap bmp = Bitmap.createBitmap(640, 480, Bitmap.Config.ARGB_8888);
+        final Paint paint = new Paint();
+        final Canvas canvas = new Canvas(bmp);
+
+        paint.setColor(Color.WHITE);
+        paint.setStyle(Style.FILL);
+        canvas.drawRect(new Rect(0, 0, 640, 480), paint);
+
+        paint.setColor(Color.BLACK);
+        paint.setStyle(Style.FILL);
+        paint.setAntiAlias(true);
+        paint.setTextAlign(Align.CENTER);
+        paint.setTextSize(24.0f);
+        canvas.drawText(inputText, 320, 240, paint);
+
+        // Set the image to a direct buffer holding the RGBA pixels.
+        final ByteBuffer buffer = ByteBuffer.allocateDirect(bmp.getRowBytes() * bmp.getHeight());
+        bmp.copyPixelsToBuffer(buffer);
+        baseApi.setImage(buffer, bmp.getWidth(), bmp.getHeight(), 4, bmp.getRowBytes());
+
+        // Ensure that the result is correct.
+        final String outputText = baseApi.getUTF8Text();
+        assertTrue("\"" + outputText + "\" != \"" + inputText + "\"", inputText.equals(outputText));
+
+        // Attempt to shut down the API.
+        baseApi.end();
+        bmp.recycle();
+    }
+
+    @SmallTest
+    public void testSetImageBufferInvalid() {
+        final TessBaseAPI baseApi = new TessBaseAPI();
+
+        // A stride too short for a row of 640 RGBA pixels must be rejected.
+        final ByteBuffer buffer = ByteBuffer.allocateDirect(640 * 4 * 480);
+        try {
+            baseApi.setImage(buffer, 640, 480, 4, 640);
+            fail("Accepted 640 bytes per line for 640 RGBA pixels");
+        } catch (IllegalArgumentException e) {
+            // Expected.
+        }
+
+        // A buffer too small to hold all the rows must be rejected.
+        try {
+            baseApi.setImage(buffer, 640, 481, 4, 640 * 4);
+            fail("Accepted a buffer of 480 lines for 481 lines");
+        } catch (IllegalArgumentException e) {
+            // Expected.
+        }
+
+        // Attempt to shut down the API.
+        baseApi.end();
+    }
+
+    @SmallTest
+    public void testParallelWordsMatchSerial() {
+        // First, make sure the eng.traineddata file exists.
+        assertTrue("Make sure that you've copied " + DEFAULT_LANGUAGE + ".traineddata to "
+                + EXPECTED_FILE, new File(EXPECTED_FILE).exists());
+
+        final String[] inputTexts = {
+                "the quick brown", "fox jumps over", "the lazy dog"
+        };
+
+        // Draw each line of words on its own line of a Bitmap.
+        final Bitmap bmp = Bitmap.createBitmap(640, 480, Bitmap.Config.ARGB_8888);
+        final Paint paint = new Paint();
+        final Canvas canvas = new Canvas(bmp);
+
+        paint.setColor(Color.WHITE);
+        paint.setStyle(Style.FILL);
+        canvas.drawRect(new Rect(0, 0, 640, 480), paint);
+
+        paint.setColor(Color.BLACK);
+        paint.setStyle(Style.FILL);
+        paint.setAntiAlias(true);
+        paint.setTextAlign(Align.CENTER);
+        paint.setTextSize(24.0f);
+
+        for (int i = 0; i < inputTexts.length; i++) {
+            canvas.drawText(inputTexts[i], 320, 120 * (i + 1), paint);
+        }
+
+        // Recognize the page one word at a time.
+        final TessBaseAPI serialApi = new TessBaseAPI();
+        serialApi.init(TESSBASE_PATH, DEFAULT_LANGUAGE);
+        serialApi.setPageSegMode(TessBaseAPI.PSM_SINGLE_BLOCK);
+        serialApi.setImage(bmp);
+        final String serialText = serialApi.getUTF8Text();
+        serialApi.end();
+
+        // Recognize the page with the words spread over several threads.
+        final TessBaseAPI parallelApi = new TessBaseAPI();
+        parallelApi.init(TESSBASE_PATH, DEFAULT_LANGUAGE);
+        parallelApi.setPageSegMode(TessBaseAPI.PSM_SINGLE_BLOCK);
+        assertTrue(parallelApi.setVariable("tessedit_parallelize_words", "1"));
+        assertTrue(parallelApi.setVariable("tessedit_parallel_threads", "4"));
+        parallelApi.setImage(bmp);
+        final String parallelText = parallelApi.getUTF8Text();
+        parallelApi.end();
+
+        // Ensure that the words are recognized the same either way.
+        assertNotNull(serialText);
+        assertEquals(serialText, parallelText);
+
+        bmp.recycle();
+    }
+
+    @SmallTest
+    public void testRecognizeBatch() {
+        // First, make sure the eng.traineddata file exists.
+        assertTrue("Make sure that you've copied " + DEFAULT_LANGUAGE + ".traineddata to "
+                + EXPECTED_FILE, new File(EXPECTED_FILE).exists());
+
+        final String[] inputTexts = {
+                "hello", "world", "quick"
+        };
+
+        // Attempt to initialize the API.
+        final TessBaseAPI baseApi = new TessBaseAPI();
+        baseApi.init(TESSBASE_PATH, DEFAULT_LANGUAGE);
+
+        // Draw each word on its own line of a Bitmap.
+        final Bitmap bmp = Bitmap.createBitmap(640, 480, Bitmap.Config.ARGB_8888);
+        final Paint paint = new Paint();
+        final Canvas canvas = new Canvas(bmp);
+
+        paint.setColor(Color.WHITE);
+        paint.setStyle(Style.FILL);
+        canvas.drawRect(new Rect(0, 0, 640, 480), paint);
+
+        paint.setColor(Color.BLACK);
+        paint.setStyle(Style.FILL);
+        paint.setAntiAlias(true);
+        paint.setTextAlign(Align.CENTER);
+        paint.setTextSize(24.0f);
+
+        for (int i = 0; i < inputTexts.length; i++) {
+            canvas.drawText(inputTexts[i], 320, 120 * (i + 1), paint);
+        }
+
+        // Make a region around each word.
+        final Pix textPix = ReadFile.readBitmap(bmp);
+        final Pixa regions = Pixa.createPixa(inputTexts.length + 1);
+        for (int i = 0; i < inputTexts.length; i++) {
+            regions.add(textPix, new Box(220, 120 * (i + 1) - 40, 200, 60), Constants.L_CLONE);
+        }
+
+        // A region too small to recognize.
+        regions.add(textPix, new Box(0, 0, 4, 4), Constants.L_CLONE);
+
+        final BatchResult result = baseApi.recognizeBatch(textPix, regions,
+                TessBaseAPI.PSM_SINGLE_LINE);
+
+        // Ensure that the results are correct and in the order of the regions.
+        assertNotNull("Failed to recognize batch", result);
+        assertEquals(inputTexts.length + 1, result.size());
+        for (int i = 0; i < inputTexts.length; i++) {
+            final String outputText = result.getText(i);
+            assertTrue("\"" + outputText + "\" != \"" + inputTexts[i] + "\"",
+                    inputTexts[i].equals(outputText));
+            assertTrue(result.getConfidence(i) >= 0);
+        }
+        assertEquals("", result.getText(inputTexts.length));
+        assertEquals(-1, result.getConfidence(inputTexts.length));
+
+        // Attempt to shut down the API.
+        baseApi.end();
+        regions.recycle();
+        textPix.recycle();
+        bmp.recycle();
+    }
+
+    @SmallTest
+    public void testSharedLanguageModel() throws InterruptedException {
+        // First, make sure the eng.traineddata file exists.
+        assertTrue("Make sure that you've copied " + DEFAULT_LANGUAGE + ".traineddata to "
+                + EXPECTED_FILE, new File(EXPECTED_FILE).exists());
+
+        final String[] inputTexts = {
+                "hello", "world", "quick", "brown", "jumps", "over", "lazy", "dog"
+        };
+        final int numThreads = inputTexts.length;
+
+        // Load the language model once for all the threads.
+        final LanguageModelBundle bundle = LanguageModelBundle.load(TESSBASE_PATH,
+                DEFAULT_LANGUAGE);
+        assertNotNull("Failed to load the language model bundle", bundle);
+
+        final String[] outputTexts = new String[numThreads];
+        final Thread[] threads = new Thread[numThreads];
+
+        for (int i = 0; i < numThreads; i++) {
+            final int index = i;
+            threads[i] = new Thread() {
+                @Override
+                public void run() {
+                    // Each thread has its own instance, sharing the bundle.
+                    final TessBaseAPI baseApi = new TessBaseAPI();
+                    if (!baseApi.init(bundle, TessBaseAPI.OEM_TESSERACT_ONLY))
+                        return;
+                    baseApi.setPageSegMode(TessBaseAPI.PSM_SINGLE_LINE);
+
+                    // Set the image to a Bitmap containing this thread's word.
+                    final Bitmap bmp = Bitmap.createBitmap(640, 480, Bitmap.Config.ARGB_8888);
+                    final Paint paint = new Paint();
+                    final Canvas canvas = new Canvas(bmp);
+
+                    paint.setColor(Color.WHITE);
+                    paint.setStyle(Style.FILL);
+                    canvas.drawRect(new Rect(0, 0, 640, 480), paint);
+
+                    paint.setColor(Color.BLACK);
+                    paint.setStyle(Style.FILL);
+                    paint.setAntiAlias(true);
+                    paint.setTextAlign(Align.CENTER);
+                    paint.setTextSize(24.0f);
+                    canvas.drawText(inputTexts[index], 320, 240, paint);
+
+                    baseApi.setImage(bmp);
+
+                    outputTexts[index] = baseApi.getUTF8Text();
+
+                    baseApi.end();
+                    bmp.recycle();
+                }
+            };
+        }
+
+        for (Thread thread : threads)
+            thread.start();
+        for (Thread thread : threads)
+            thread.join();
+
+        bundle.recycle();
+
+        // Ensure that every thread's result is correct.
+        for (int i = 0; i < numThreads; i++) {
+            assertTrue("\"" + outputTexts[i] + "\" != \"" + inputTexts[i] + "\"",
+                    inputTexts[i].equals(outputTexts[i]));
+        }
+    }
+
+    @SmallTest
+    public void testProgressListener() {
+        // First, make sure the eng.traineddata file exists.
+        assertTrue("Make sure that you've copied " + DEFAULT_LANGUAGE + ".traineddata to "
+                + EXPECTED_FILE, new File(EXPECTED_FILE).exists());
+
+        final String[] inputTexts = {
+                "hello", "world", "quick"
+        };
+
+        // Attempt to initialize the API.
+        final TessBaseAPI baseApi = new TessBaseAPI();
+        baseApi.init(TESSBASE_PATH, DEFAULT_LANGUAGE);
+        baseApi.setPageSegMode(TessBaseAPI.PSM_SINGLE_BLOCK);
+
+        // Draw each word on its own line of a Bitmap.
+        final Bitmap bmp = Bitmap.createBitmap(640, 480, Bitmap.Config.ARGB_8888);
+        final Paint paint = new Paint();
+        final Canvas canvas = new Canvas(bmp);
+
+        paint.setColor(Color.WHITE);
+        paint.setStyle(Style.FILL);
+        canvas.drawRect(new Rect(0, 0, 640, 480), paint);
+
+        paint.setColor(Color.BLACK);
+        paint.setStyle(Style.FILL);
+        paint.setAntiAlias(true);
+        paint.setTextAlign(Align.CENTER);
+        paint.setTextSize(24.0f);
+
+        for (int i = 0; i < inputTexts.length; i++) {
+            canvas.drawText(inputTexts[i], 320, 120 * (i + 1), paint);
+        }
+
+        // Collect the rows of the last pass as they are reported.
+        final String[] rowTexts = new String[inputTexts.length];
+        final Rect[] rowBoxes = new Rect[inputTexts.length];
+        baseApi.setProgressListener(new TessBaseAPI.ProgressListener() {
+            public void onRowRecognized(int pass, int progress, int rowIndex,
+                    String[] words, Rect[] boxes, int[] confidences) {
+                assertTrue(progress >= 0 && progress <= 100);
+                assertEquals(words.length, boxes.length);
+                assertEquals(words.length, confidences.length);
+                if (rowIndex < rowTexts.length && words.length == 1) {
+                    rowTexts[rowIndex] = words[0];
+                    rowBoxes[rowIndex] = boxes[0];
+                }
+            }
+        });
+
+        // Recognize just the area below the top row, so the boxes must be
+        // offset by the rectangle.
+        baseApi.setImage(bmp);
+        baseApi.setRectangle(0, 180, 640, 300);
+        final String outputText = baseApi.getUTF8Text();
+
+        // Ensure that the rows were reported in order with image coordinates.
+        assertTrue("\"" + outputText + "\" does not end with \"" + inputTexts[2] + "\"",
+                outputText.endsWith(inputTexts[2]));
+        for (int i = 1; i < inputTexts.length; i++) {
+            assertEquals(inputTexts[i], rowTexts[i - 1]);
+            assertTrue(rowBoxes[i - 1].contains(320, 120 * (i + 1) - 5));
+        }
+
+        // A stopped recognition returns whatever was recognized so far.
+        baseApi.setProgressListener(new TessBaseAPI.ProgressListener() {
+            public void onRowRecognized(int pass, int progress, int rowIndex,
+                    String[] words, Rect[] boxes, int[] confidences) {
+                baseApi.stop();
+            }
+        });
+        baseApi.setImage(bmp);
+        assertNotNull(baseApi.getUTF8Text());
+
+        // Rows are reported after the words of a parallel pass are recognized,
+        // so stopping at the first row keeps all the words of pass 1.
+        assertTrue(baseApi.setVariable("tessedit_parallelize_words", "1"));
+        baseApi.setImage(bmp);
+        final String parallelText = baseApi.getUTF8Text();
+        assertTrue("\"" + parallelText + "\" does not end with \"" + inputTexts[2] + "\"",
+                parallelText.endsWith(inputTexts[2]));
+        assertTrue(baseApi.setVariable("tessedit_parallelize_words", "0"));
+
+        // A stop requested before recognition starts is not lost, and doesn't
+        // carry over to the next image.
+        baseApi.setProgressListener(null);
+        baseApi.setImage(bmp);
+        baseApi.stop();
+        assertFalse(baseApi.getUTF8Text().endsWith(inputTexts[2]));
+        baseApi.setImage(bmp);
+        assertTrue(baseApi.getUTF8Text().endsWith(inputTexts[2]));
+
+        // Attempt to shut down the API.
+        baseApi.end();
+        bmp.recycle();
+    }
+
+    @SmallTest
+    public void testResultCacheWhitelist() {
+        // First, make sure the eng.traineddata file exists.
+        assertTrue("Make sure that you've copied " + DEFAULT_LANGUAGE + ".traineddata to "
+                + EXPECTED_FILE, new File(EXPECTED_FILE).exists());
+
+        final String inputText = "hello";
+
+        // Attempt to initialize the API, keeping the classifier results of
+        // each page for the next.
+        final TessBaseAPI baseApi = new TessBaseAPI();
+        baseApi.init(TESSBASE_PATH, DEFAULT_LANGUAGE);
+        baseApi.setPageSegMode(TessBaseAPI.PSM_SINGLE_LINE);
+        assertTrue(baseApi.setVariable("classify_result_cache_kb", "1024"));
+        assertTrue(baseApi.setVariable("classify_result_cache_per_page", "0"));
+
+        // Draw "hello" into a Bitmap.
+        final Bitmap bmp = Bitmap.createBitmap(640, 480, Bitmap.Config.ARGB_8888);
+        final Paint paint = new Paint();
+        final Canvas canvas = new Canvas(bmp);
+
+        paint.setColor(Color.WHITE);
+        paint.setStyle(Style.FILL);
+        canvas.drawRect(new Rect(0, 0, 640, 480), paint);
+
+        paint.setColor(Color.BLACK);
+        paint.setStyle(Style.FILL);
+        paint.setAntiAlias(true);
+        paint.setTextAlign(Align.CENTER);
+        paint.setTextSize(24.0f);
+        canvas.drawText(inputText, 320, 240, paint);
+
+        // Recognize it as the first page, with only its letters enabled.
+        assertTrue(baseApi.setVariable(TessBaseAPI.VAR_CHAR_WHITELIST, "ehlo"));
+        baseApi.setImage(bmp);
+        final String outputText = baseApi.getUTF8Text();
+        assertTrue("\"" + outputText + "\" != \"" + inputText + "\"", inputText.equals(outputText));
+
+        // Recognize it again as the second page, with only digits enabled.
+        // The cached results of the first page must not be used.
+        assertTrue(baseApi.setVariable(TessBaseAPI.VAR_CHAR_WHITELIST, "0123456789"));
+        baseApi.setImage(bmp);
+        final String digitsText = baseApi.getUTF8Text();
+        assertTrue("\"" + digitsText + "\" is not all digits", digitsText.matches("[0-9 ]*"));
+
+        // Attempt to shut down the API.
+        baseApi.end();
+        bmp.recycle();
+    }
 }
@@ -41,10 +41,23 @@ LOCAL_SRC_FILES += \
   pix.cpp \
   pixa.cpp \
   utilities.cpp \
+  colorconvert.cpp \
   readfile.cpp \
   writefile.cpp \
   jni.cpp
   
+# The NEON color conversion kernels are only built with NEON enabled on
+# armeabi-v7a, where they are selected at runtime if the cpu supports NEON.
+
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_SRC_FILES += \
+  colorconvertneon.cpp.neon
+LOCAL_CFLAGS += \
+  -DHAVE_ARMEABI_V7A=1
+LOCAL_STATIC_LIBRARIES += \
+  cpufeatures
+endif
+
 LOCAL_C_INCLUDES += \
   $(LOCAL_PATH) \
   $(LEPTONICA_PATH)/src
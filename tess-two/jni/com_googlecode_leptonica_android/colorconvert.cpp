@@ -0,0 +1,337 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef HAVE_ARMEABI_V7A
+#include <cpu-features.h>
+#endif
+
+#include "colorconvert.h"
+
+/* Weights of the red, green and blue components in 256ths, by luma; the
+ * average is computed exactly instead */
+static const l_uint8 kLumaWeights[3][3] = {
+  { 0, 0, 0 },
+  { 77, 150, 29 },
+  { 54, 183, 19 }
+};
+
+typedef void (*RGBA8888RowFunc)(const l_uint8 *src, l_int32 n, const l_uint8 *weights,
+                                l_uint8 *dst);
+typedef void (*RGB565RowFunc)(const l_uint16 *src, l_int32 n, const l_uint8 *weights,
+                              l_uint8 *dst);
+typedef void (*AccumulateRowFunc)(const l_uint8 *src, l_int32 n, l_uint16 *sums);
+typedef void (*PackRowFunc)(const l_uint8 *src, l_int32 n, l_uint32 *line);
+
+/*---------------------------------------------------------------------*
+ *                          Scalar row kernels                         *
+ *---------------------------------------------------------------------*/
+
+static void rgba8888ToLumaRow(const l_uint8 *src, l_int32 n, const l_uint8 *weights,
+                              l_uint8 *dst) {
+  for (l_int32 j = 0; j < n; j++, src += 4)
+    dst[j] = lumaOfRGB(src[0], src[1], src[2], weights);
+}
+
+static void rgb565ToLumaRow(const l_uint16 *src, l_int32 n, const l_uint8 *weights,
+                            l_uint8 *dst) {
+  for (l_int32 j = 0; j < n; j++) {
+    l_int32 p = src[j];
+
+    dst[j] = lumaOfRGB(expand5(p >> 11), expand6((p >> 5) & 0x3f), expand5(p & 0x1f), weights);
+  }
+}
+
+static void accumulateRow(const l_uint8 *src, l_int32 n, l_uint16 *sums) {
+  for (l_int32 j = 0; j < n; j++)
+    sums[j] += src[j];
+}
+
+/* Stores bytes of luma in pixel order into a line of an 8 bpp pix */
+static void packRow8(const l_uint8 *src, l_int32 n, l_uint32 *line) {
+#ifdef L_BIG_ENDIAN
+  memcpy(line, src, n);
+#else
+  l_int32 k;
+
+  for (k = 0; k + 4 <= n; k += 4) {
+    line[k / 4] = ((l_uint32) src[k] << 24) | ((l_uint32) src[k + 1] << 16) |
+                  ((l_uint32) src[k + 2] << 8) | (l_uint32) src[k + 3];
+  }
+
+  if (k < n) {
+    line[k / 4] = 0;
+    for (; k < n; k++)
+      SET_DATA_BYTE(line, k, src[k]);
+  }
+#endif
+}
+
+/* Averages each reduction x reduction block of summed rows */
+static void reduceRow(const l_uint16 *sums, l_int32 nd, l_int32 reduction, l_uint8 *dst) {
+  if (reduction == 2) {
+    for (l_int32 j = 0; j < nd; j++)
+      dst[j] = (l_uint8) ((sums[2 * j] + sums[2 * j + 1] + 2) >> 2);
+  } else {
+    for (l_int32 j = 0; j < nd; j++) {
+      const l_uint16 *s = sums + 4 * j;
+
+      dst[j] = (l_uint8) ((s[0] + s[1] + s[2] + s[3] + 8) >> 4);
+    }
+  }
+}
+
+/*---------------------------------------------------------------------*
+ *                           SSE2 row kernels                          *
+ *---------------------------------------------------------------------*/
+
+#ifdef __SSE2__
+/* Luma of 8 pixels from their components in 16-bit lanes */
+static inline __m128i lumaOfRGB8SSE2(__m128i r, __m128i g, __m128i b, const l_uint8 *weights) {
+  if (!weights)
+    return _mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(r, g), b),
+                           _mm_set1_epi16((short) L_ONE_THIRD_16));
+
+  __m128i y = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(weights[0])),
+                            _mm_mullo_epi16(g, _mm_set1_epi16(weights[1])));
+  y = _mm_add_epi16(y, _mm_mullo_epi16(b, _mm_set1_epi16(weights[2])));
+
+  return _mm_srli_epi16(_mm_add_epi16(y, _mm_set1_epi16(128)), 8);
+}
+
+/* Luma of the 8 RGBA_8888 pixels at src in 16-bit lanes */
+static inline __m128i rgba8888ToLuma8SSE2(const l_uint8 *src, const l_uint8 *weights) {
+  const __m128i mask = _mm_set1_epi32(0xff);
+  __m128i p0 = _mm_loadu_si128((const __m128i *) src);
+  __m128i p1 = _mm_loadu_si128((const __m128i *) (src + 16));
+
+  __m128i r = _mm_packs_epi32(_mm_and_si128(p0, mask), _mm_and_si128(p1, mask));
+  __m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask),
+                              _mm_and_si128(_mm_srli_epi32(p1, 8), mask));
+  __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask),
+                              _mm_and_si128(_mm_srli_epi32(p1, 16), mask));
+
+  return lumaOfRGB8SSE2(r, g, b, weights);
+}
+
+static void rgba8888ToLumaRowSSE2(const l_uint8 *src, l_int32 n, const l_uint8 *weights,
+                                  l_uint8 *dst) {
+  l_int32 j;
+
+  for (j = 0; j + 16 <= n; j += 16) {
+    __m128i lo = rgba8888ToLuma8SSE2(src + 4 * j, weights);
+    __m128i hi = rgba8888ToLuma8SSE2(src + 4 * j + 32, weights);
+
+    _mm_storeu_si128((__m128i *) (dst + j), _mm_packus_epi16(lo, hi));
+  }
+
+  rgba8888ToLumaRow(src + 4 * j, n - j, weights, dst + j);
+}
+
+/* Luma of the 8 RGB_565 pixels at src in 16-bit lanes */
+static inline __m128i rgb565ToLuma8SSE2(const l_uint16 *src, const l_uint8 *weights) {
+  __m128i p = _mm_loadu_si128((const __m128i *) src);
+  __m128i r = _mm_srli_epi16(p, 11);
+  __m128i g = _mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x3f));
+  __m128i b = _mm_and_si128(p, _mm_set1_epi16(0x1f));
+
+  r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+  g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+  b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+  return lumaOfRGB8SSE2(r, g, b, weights);
+}
+
+static void rgb565ToLumaRowSSE2(const l_uint16 *src, l_int32 n, const l_uint8 *weights,
+                                l_uint8 *dst) {
+  l_int32 j;
+
+  for (j = 0; j + 16 <= n; j += 16) {
+    __m128i lo = rgb565ToLuma8SSE2(src + j, weights);
+    __m128i hi = rgb565ToLuma8SSE2(src + j + 8, weights);
+
+    _mm_storeu_si128((__m128i *) (dst + j), _mm_packus_epi16(lo, hi));
+  }
+
+  rgb565ToLumaRow(src + j, n - j, weights, dst + j);
+}
+
+static void accumulateRowSSE2(const l_uint8 *src, l_int32 n, l_uint16 *sums) {
+  const __m128i zero = _mm_setzero_si128();
+  l_int32 j;
+
+  for (j = 0; j + 16 <= n; j += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) (src + j));
+    __m128i *s = (__m128i *) (sums + j);
+
+    _mm_storeu_si128(s, _mm_add_epi16(_mm_loadu_si128(s), _mm_unpacklo_epi8(v, zero)));
+    _mm_storeu_si128(s + 1, _mm_add_epi16(_mm_loadu_si128(s + 1), _mm_unpackhi_epi8(v, zero)));
+  }
+
+  accumulateRow(src + j, n - j, sums + j);
+}
+
+#ifndef L_BIG_ENDIAN
+static void packRow8SSE2(const l_uint8 *src, l_int32 n, l_uint32 *line) {
+  l_int32 j;
+
+  /* Reverse the bytes of each word: swap the bytes of each half, then the
+   * halves */
+  for (j = 0; j + 16 <= n; j += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *) (src + j));
+
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_si128((__m128i *) (line + j / 4), v);
+  }
+
+  packRow8(src + j, n - j, line + j / 4);
+}
+#endif
+#endif
+
+/*---------------------------------------------------------------------*
+ *                        Conversion of a source                       *
+ *---------------------------------------------------------------------*/
+
+/*!
+ *  pixCreateFromLumaSource()
+ *
+ *      Input:  data (first byte of the source pixels)
+ *              format (L_SOURCE_RGBA8888, L_SOURCE_RGB565 or L_SOURCE_LUMA8)
+ *              stride (bytes between the rows of the source)
+ *              x, y, w, h (area of the source to convert, in pixels)
+ *              reduction (1, 2 or 4)
+ *              luma (L_LUMA_AVERAGE, L_LUMA_BT601 or L_LUMA_BT709; ignored
+ *                    for L_SOURCE_LUMA8)
+ *      Return: pixd (8 bpp, w / reduction x h / reduction), or null on error
+ *
+ *  Notes:
+ *      (1) The area must lie in the source; the caller checks it.
+ *      (2) Each pixel of pixd is the rounded average of the luma of a
+ *          reduction x reduction block of the area. Remaining columns and
+ *          rows of the area are dropped.
+ *      (3) Each row of the source is read once and converted through small
+ *          row buffers, so that a frame reaches pixd in a single pass over
+ *          its memory.
+ */
+PIX *pixCreateFromLumaSource(const void *data, l_int32 format, l_int32 stride, l_int32 x,
+                             l_int32 y, l_int32 w, l_int32 h, l_int32 reduction,
+                             l_int32 luma) {
+  l_int32 i, k, wd, hd, wpld, bytes_per_pixel, ws;
+  l_uint32 *datad;
+  l_uint8 *buffer, *row, *out;
+  l_uint16 *sums;
+  const l_uint8 *weights;
+  PIX *pixd;
+
+  PROCNAME("pixCreateFromLumaSource");
+
+  if (!data)
+    return (PIX *) ERROR_PTR("data not defined", procName, NULL);
+  if (format != L_SOURCE_RGBA8888 && format != L_SOURCE_RGB565 && format != L_SOURCE_LUMA8)
+    return (PIX *) ERROR_PTR("invalid format", procName, NULL);
+  if (luma != L_LUMA_AVERAGE && luma != L_LUMA_BT601 && luma != L_LUMA_BT709)
+    return (PIX *) ERROR_PTR("invalid luma", procName, NULL);
+  if (reduction != 1 && reduction != 2 && reduction != 4)
+    return (PIX *) ERROR_PTR("reduction not 1, 2 or 4", procName, NULL);
+  if (x < 0 || y < 0)
+    return (PIX *) ERROR_PTR("area not in source", procName, NULL);
+
+  wd = w / reduction;
+  hd = h / reduction;
+  if (wd < 1 || hd < 1)
+    return (PIX *) ERROR_PTR("area smaller than reduction", procName, NULL);
+
+  if ((pixd = pixCreateNoInit(wd, hd, 8)) == NULL)
+    return (PIX *) ERROR_PTR("pixd not made", procName, NULL);
+
+  RGBA8888RowFunc rgba8888_row = rgba8888ToLumaRow;
+  RGB565RowFunc rgb565_row = rgb565ToLumaRow;
+  AccumulateRowFunc accumulate_row = accumulateRow;
+  PackRowFunc pack_row = packRow8;
+#ifdef __SSE2__
+  rgba8888_row = rgba8888ToLumaRowSSE2;
+  rgb565_row = rgb565ToLumaRowSSE2;
+  accumulate_row = accumulateRowSSE2;
+#ifndef L_BIG_ENDIAN
+  pack_row = packRow8SSE2;
+#endif
+#endif
+#ifdef HAVE_ARMEABI_V7A
+  if ((android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0) {
+    rgba8888_row = rgba8888ToLumaRowNEON;
+    rgb565_row = rgb565ToLumaRowNEON;
+    accumulate_row = accumulateRowNEON;
+    pack_row = packRow8NEON;
+  }
+#endif
+
+  bytes_per_pixel = format == L_SOURCE_RGBA8888 ? 4 : format == L_SOURCE_RGB565 ? 2 : 1;
+  weights = luma == L_LUMA_AVERAGE ? NULL : kLumaWeights[luma];
+  datad = pixGetData(pixd);
+  wpld = pixGetWpl(pixd);
+
+  /* Only the source columns of whole blocks are converted */
+  ws = wd * reduction;
+
+  /* A row of luma, a row of block sums and a row of block averages;
+   * allocated together */
+  buffer = (l_uint8 *) MALLOC(ws + ws * sizeof(l_uint16) + wd + 16);
+  row = buffer;
+  sums = (l_uint16 *) (buffer + ((ws + 1) & ~1));
+  out = (l_uint8 *) (sums + ws);
+
+  for (i = 0; i < hd; i++) {
+    l_uint32 *lined = datad + i * wpld;
+
+    if (reduction > 1)
+      memset(sums, 0, ws * sizeof(l_uint16));
+
+    for (k = 0; k < reduction; k++) {
+      const l_uint8 *src = (const l_uint8 *) data + (size_t) (y + i * reduction + k) * stride +
+                           x * bytes_per_pixel;
+      const l_uint8 *luma_row = row;
+
+      if (format == L_SOURCE_RGBA8888)
+        rgba8888_row(src, ws, weights, row);
+      else if (format == L_SOURCE_RGB565)
+        rgb565_row((const l_uint16 *) src, ws, weights, row);
+      else
+        luma_row = src;
+
+      if (reduction == 1)
+        pack_row(luma_row, wd, lined);
+      else
+        accumulate_row(luma_row, ws, sums);
+    }
+
+    if (reduction > 1) {
+      reduceRow(sums, wd, reduction, out);
+      pack_row(out, wd, lined);
+    }
+  }
+
+  FREE(buffer);
+
+  return pixd;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LEPTONICA_JNI_COLORCONVERT_H
+#define LEPTONICA_JNI_COLORCONVERT_H
+
+#include <allheaders.h>
+
+/* Pixel formats of the source buffers */
+enum {
+  L_SOURCE_RGBA8888 = 0,  /* bytes r, g, b, a */
+  L_SOURCE_RGB565 = 1,    /* native-endian 16-bit words, red in the high bits */
+  L_SOURCE_LUMA8 = 2      /* bytes of luma, such as the Y plane of NV21 */
+};
+
+/* Weights of the red, green and blue components of the luma of a pixel;
+ * these match the LUMA_ constants of ReadFile.java */
+enum {
+  L_LUMA_AVERAGE = 0,  /* (r + g + b) / 3 */
+  L_LUMA_BT601 = 1,    /* 0.299 r + 0.587 g + 0.114 b */
+  L_LUMA_BT709 = 2     /* 0.2126 r + 0.7152 g + 0.0722 b */
+};
+
+/* Multiplier of a sum of three components whose top 16 bits are the sum
+ * divided by 3, for every sum up to 3 * 255 */
+#define L_ONE_THIRD_16 21846
+
+/* Luma of a pixel, with weights in 256ths or null for the exact average */
+static inline l_uint8 lumaOfRGB(l_int32 r, l_int32 g, l_int32 b, const l_uint8 *weights) {
+  if (!weights)
+    return (l_uint8) ((r + g + b) / 3);
+
+  return (l_uint8) ((weights[0] * r + weights[1] * g + weights[2] * b + 128) >> 8);
+}
+
+/* Expands a 5-bit or 6-bit component to 8 bits by repeating its high bits */
+static inline l_int32 expand5(l_int32 c) {
+  return (c << 3) | (c >> 2);
+}
+
+static inline l_int32 expand6(l_int32 c) {
+  return (c << 2) | (c >> 4);
+}
+
+PIX *pixCreateFromLumaSource(const void *data, l_int32 format, l_int32 stride, l_int32 x,
+                             l_int32 y, l_int32 w, l_int32 h, l_int32 reduction,
+                             l_int32 luma);
+
+#ifdef HAVE_ARMEABI_V7A
+/* NEON row kernels, in colorconvertneon.cpp. The weights of the converters
+ * are those of the red, green and blue components in 256ths, or null for
+ * the exact average. */
+void rgba8888ToLumaRowNEON(const l_uint8 *src, l_int32 n, const l_uint8 *weights, l_uint8 *dst);
+void rgb565ToLumaRowNEON(const l_uint16 *src, l_int32 n, const l_uint8 *weights, l_uint8 *dst);
+void accumulateRowNEON(const l_uint8 *src, l_int32 n, l_uint16 *sums);
+void packRow8NEON(const l_uint8 *src, l_int32 n, l_uint32 *line);
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* NEON row kernels of colorconvert.cpp. This file is only built with NEON
+ * enabled, and the kernels are only called if the cpu supports NEON. */
+
+#include <arm_neon.h>
+
+#include "colorconvert.h"
+
+/* Luma of 8 pixels from their 8-bit components */
+static inline uint8x8_t lumaOfRGB8NEON(uint8x8_t r, uint8x8_t g, uint8x8_t b,
+                                       const l_uint8 *weights) {
+  if (!weights) {
+    const uint16x4_t third = vdup_n_u16(L_ONE_THIRD_16);
+    uint16x8_t sum = vaddw_u8(vaddl_u8(r, g), b);
+    uint32x4_t lo = vmull_u16(vget_low_u16(sum), third);
+    uint32x4_t hi = vmull_u16(vget_high_u16(sum), third);
+
+    return vmovn_u16(vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16)));
+  }
+
+  uint16x8_t y = vmull_u8(r, vdup_n_u8(weights[0]));
+  y = vmlal_u8(y, g, vdup_n_u8(weights[1]));
+  y = vmlal_u8(y, b, vdup_n_u8(weights[2]));
+
+  return vrshrn_n_u16(y, 8);
+}
+
+void rgba8888ToLumaRowNEON(const l_uint8 *src, l_int32 n, const l_uint8 *weights, l_uint8 *dst) {
+  l_int32 j;
+
+  for (j = 0; j + 8 <= n; j += 8) {
+    uint8x8x4_t p = vld4_u8(src + 4 * j);
+
+    vst1_u8(dst + j, lumaOfRGB8NEON(p.val[0], p.val[1], p.val[2], weights));
+  }
+
+  for (src += 4 * j; j < n; j++, src += 4)
+    dst[j] = lumaOfRGB(src[0], src[1], src[2], weights);
+}
+
+void rgb565ToLumaRowNEON(const l_uint16 *src, l_int32 n, const l_uint8 *weights, l_uint8 *dst) {
+  l_int32 j;
+
+  for (j = 0; j + 8 <= n; j += 8) {
+    uint16x8_t p = vld1q_u16(src + j);
+    uint8x8_t r = vmovn_u16(vshrq_n_u16(p, 11));
+    uint8x8_t g = vmovn_u16(vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f)));
+    uint8x8_t b = vmovn_u16(vandq_u16(p, vdupq_n_u16(0x1f)));
+
+    r = vorr_u8(vshl_n_u8(r, 3), vshr_n_u8(r, 2));
+    g = vorr_u8(vshl_n_u8(g, 2), vshr_n_u8(g, 4));
+    b = vorr_u8(vshl_n_u8(b, 3), vshr_n_u8(b, 2));
+    vst1_u8(dst + j, lumaOfRGB8NEON(r, g, b, weights));
+  }
+
+  for (; j < n; j++) {
+    l_int32 p = src[j];
+
+    dst[j] = lumaOfRGB(expand5(p >> 11), expand6((p >> 5) & 0x3f), expand5(p & 0x1f), weights);
+  }
+}
+
+void accumulateRowNEON(const l_uint8 *src, l_int32 n, l_uint16 *sums) {
+  l_int32 j;
+
+  for (j = 0; j + 16 <= n; j += 16) {
+    uint8x16_t v = vld1q_u8(src + j);
+
+    vst1q_u16(sums + j, vaddw_u8(vld1q_u16(sums + j), vget_low_u8(v)));
+    vst1q_u16(sums + j + 8, vaddw_u8(vld1q_u16(sums + j + 8), vget_high_u8(v)));
+  }
+
+  for (; j < n; j++)
+    sums[j] += src[j];
+}
+
+void packRow8NEON(const l_uint8 *src, l_int32 n, l_uint32 *line) {
+  l_int32 j;
+
+  /* Pixel 0 of each word is its most significant byte */
+  for (j = 0; j + 16 <= n; j += 16)
+    vst1q_u8((l_uint8 *) (line + j / 4), vrev32q_u8(vld1q_u8(src + j)));
+
+  for (; j + 4 <= n; j += 4) {
+    line[j / 4] = ((l_uint32) src[j] << 24) | ((l_uint32) src[j + 1] << 16) |
+                  ((l_uint32) src[j + 2] << 8) | (l_uint32) src[j + 3];
+  }
+
+  if (j < n) {
+    line[j / 4] = 0;
+    for (; j < n; j++)
+      SET_DATA_BYTE(line, j, src[j]);
+  }
+}
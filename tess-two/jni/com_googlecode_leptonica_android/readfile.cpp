@@ -15,6 +15,7 @@
  */
 
 #include "common.h"
+#include "colorconvert.h"
 
 #include <string.h>
 #include <android/bitmap.h>
@@ -135,19 +136,31 @@ jint Java_com_googlecode_leptonica_android_ReadFile_nativeReadFile(JNIEnv *env,
 }
 
 jint Java_com_googlecode_leptonica_android_ReadFile_nativeReadBitmap(JNIEnv *env, jclass clazz,
-                                                                     jobject bitmap) {
-  l_int32 w, h, d;
+                                                                     jobject bitmap, jint x,
+                                                                     jint y, jint w, jint h,
+                                                                     jint reduction, jint luma) {
   AndroidBitmapInfo info;
   void* pixels;
   int ret;
+  l_int32 format;
 
   if ((ret = AndroidBitmap_getInfo(env, bitmap, &info)) < 0) {
     LOGE("AndroidBitmap_getInfo() failed ! error=%d", ret);
     return JNI_FALSE;
   }
 
-  if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
-    LOGE("Bitmap format is not RGBA_8888 !");
+  if (info.format == ANDROID_BITMAP_FORMAT_RGBA_8888) {
+    format = L_SOURCE_RGBA8888;
+  } else if (info.format == ANDROID_BITMAP_FORMAT_RGB_565) {
+    format = L_SOURCE_RGB565;
+  } else {
+    LOGE("Bitmap format is not RGBA_8888 or RGB_565 !");
+    return JNI_FALSE;
+  }
+
+  if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > (jint) info.width
+      || y + h > (jint) info.height) {
+    LOGE("Area x=%d, y=%d, w=%d, h=%d is not in the bitmap", x, y, w, h);
     return JNI_FALSE;
   }
 
@@ -156,35 +169,40 @@ jint Java_com_googlecode_leptonica_android_ReadFile_nativeReadBitmap(JNIEnv *env
     return JNI_FALSE;
   }
 
-  PIX *pixd = pixCreate(info.width, info.height, 8);
+  // Android stores RGBA_8888 pixels as bytes r, g, b, a in memory.
+  PIX *pixd = pixCreateFromLumaSource(pixels, format, (l_int32) info.stride, (l_int32) x,
+                                      (l_int32) y, (l_int32) w, (l_int32) h,
+                                      (l_int32) reduction, (l_int32) luma);
 
-  l_uint32 *src = (l_uint32 *) pixels;
-  l_int32 srcWpl = (info.stride / 4);
-  l_uint32 *dst = pixGetData(pixd);
-  l_int32 dstWpl = pixGetWpl(pixd);
-  l_uint8 a, r, g, b, pixel8;
-
-  for (int y = 0; y < info.height; y++) {
-    l_uint32 *dst_line = dst + (y * dstWpl);
-    l_uint32 *src_line = src + (y * srcWpl);
+  AndroidBitmap_unlockPixels(env, bitmap);
 
-    for (int x = 0; x < info.width; x++) {
-      // Get pixel from RGBA_8888
-      r = *src_line >> SK_R32_SHIFT;
-      g = *src_line >> SK_G32_SHIFT;
-      b = *src_line >> SK_B32_SHIFT;
-      a = *src_line >> SK_A32_SHIFT;
-      pixel8 = (l_uint8)((r + g + b) / 3);
+  return (jint) pixd;
+}
 
-      // Set pixel to LUMA_8
-      SET_DATA_BYTE(dst_line, x, pixel8);
+jint Java_com_googlecode_leptonica_android_ReadFile_nativeReadNv21(JNIEnv *env, jclass clazz,
+                                                                   jbyteArray data, jint width,
+                                                                   jint height, jint x, jint y,
+                                                                   jint w, jint h,
+                                                                   jint reduction) {
+  if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > width || y + h > height
+      || env->GetArrayLength(data) < width * height) {
+    LOGE("Area x=%d, y=%d, w=%d, h=%d is not in the frame", x, y, w, h);
+    return JNI_FALSE;
+  }
 
-      // Move to the next pixel
-      src_line++;
-    }
+  // The luma plane comes first and is read directly, without copying the
+  // array. No JNI calls may be made until it is released.
+  void *frame = env->GetPrimitiveArrayCritical(data, NULL);
+  if (frame == NULL) {
+    LOGE("Could not access the frame data");
+    return JNI_FALSE;
   }
 
-  AndroidBitmap_unlockPixels(env, bitmap);
+  PIX *pixd = pixCreateFromLumaSource(frame, L_SOURCE_LUMA8, (l_int32) width, (l_int32) x,
+                                      (l_int32) y, (l_int32) w, (l_int32) h,
+                                      (l_int32) reduction, L_LUMA_AVERAGE);
+
+  env->ReleasePrimitiveArrayCritical(data, frame, JNI_ABORT);
 
   return (jint) pixd;
 }
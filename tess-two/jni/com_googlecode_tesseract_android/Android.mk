@@ -10,6 +10,16 @@ BLACKLIST_SRC_FILES := \
   %api/tesseractmain.cpp \
   %viewer/svpaint.cpp
 
+# The NEON kernels are only built with NEON enabled on armeabi-v7a, where
+# they are selected at runtime if the cpu supports NEON.
+
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+BLACKLIST_SRC_FILES += \
+  %ccmain/thresholdsimdneon.cpp \
+  %classify/intsimdmatchneon.cpp \
+  %neural_networks/runtime/dense_kernels_neon.cpp
+endif
+
 TESSERACT_SRC_FILES := \
   $(wildcard $(TESSERACT_PATH)/api/*.cpp) \
   $(wildcard $(TESSERACT_PATH)/ccmain/*.cpp) \
@@ -28,6 +38,13 @@ TESSERACT_SRC_FILES := \
 LOCAL_SRC_FILES := \
   $(filter-out $(BLACKLIST_SRC_FILES),$(subst $(LOCAL_PATH)/,,$(TESSERACT_SRC_FILES)))
 
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_SRC_FILES += \
+  src/ccmain/thresholdsimdneon.cpp.neon \
+  src/classify/intsimdmatchneon.cpp.neon \
+  src/neural_networks/runtime/dense_kernels_neon.cpp.neon
+endif
+
 LOCAL_C_INCLUDES := \
   $(TESSERACT_PATH)/api \
   $(TESSERACT_PATH)/ccmain \
@@ -54,7 +71,8 @@ LOCAL_CFLAGS := \
 # jni
 
 LOCAL_SRC_FILES += \
-  tessbaseapi.cpp
+  tessbaseapi.cpp \
+  languagemodelbundle.cpp
 
 LOCAL_C_INCLUDES += \
   $(LOCAL_PATH)
@@ -67,5 +85,8 @@ LOCAL_LDLIBS += \
 
 LOCAL_PRELINK_MODULE := false
 LOCAL_SHARED_LIBRARIES := liblept
+LOCAL_STATIC_LIBRARIES := cpufeatures
 
 include $(BUILD_SHARED_LIBRARY)
+
+$(call import-module,android/cpufeatures)
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2011, Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common.h"
+#include "langmodelbundle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+jint Java_com_googlecode_tesseract_android_LanguageModelBundle_nativeLoad(JNIEnv *env,
+                                                                          jclass clazz,
+                                                                          jstring dir,
+                                                                          jstring lang) {
+
+  const char *c_dir = env->GetStringUTFChars(dir, NULL);
+  const char *c_lang = env->GetStringUTFChars(lang, NULL);
+
+  tesseract::LanguageModelBundle *bundle =
+      tesseract::LanguageModelBundle::Load(c_dir, c_lang);
+
+  if (bundle == NULL) {
+    LOGE("Could not load language model bundle with language=%s!", c_lang);
+  } else {
+    LOGI("Loaded language model bundle with language=%s", c_lang);
+  }
+
+  env->ReleaseStringUTFChars(dir, c_dir);
+  env->ReleaseStringUTFChars(lang, c_lang);
+
+  return (jint) bundle;
+}
+
+void Java_com_googlecode_tesseract_android_LanguageModelBundle_nativeRelease(JNIEnv *env,
+                                                                             jclass clazz,
+                                                                             jint nativeBundle) {
+
+  tesseract::LanguageModelBundle *bundle = (tesseract::LanguageModelBundle *) nativeBundle;
+
+  if (bundle != NULL)
+    bundle->Release();
+}
+
+#ifdef __cplusplus
+}
+#endif
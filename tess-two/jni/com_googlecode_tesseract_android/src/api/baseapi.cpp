@@ -49,6 +49,7 @@
 #include "output.h"
 #include "globals.h"
 #include "edgblob.h"
+#include "langmodelbundle.h"
 #include "equationdetect.h"
 #include "tessbox.h"
 #include "imgs.h"
@@ -57,7 +58,9 @@
 #include "permute.h"
 #include "otsuthr.h"
 #include "osdetect.h"
+#include "pagepool.h"
 #include "params.h"
+#include "threadpool.h"
 
 #if defined(_WIN32) && !defined(VERSION)
 #include "version.h"
@@ -106,6 +109,7 @@ TessBaseAPI::TessBaseAPI()
     datapath_(NULL),
     language_(NULL),
     last_oem_requested_(OEM_DEFAULT),
+    language_model_(NULL),
     recognition_done_(false),
     truth_cb_(NULL),
     rect_left_(0), rect_top_(0), rect_width_(0), rect_height_(0),
@@ -220,6 +224,10 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
        (*language_ != language && tesseract_->lang != language))) {
     delete tesseract_;
     tesseract_ = NULL;
+    if (language_model_ != NULL) {
+      language_model_->Release();
+      language_model_ = NULL;
+    }
   }
 
   bool reset_classifier = true;
@@ -250,6 +258,49 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
   return 0;
 }
 
+/**
+ * Initializes from the datapath and language of bundle, borrowing the
+ * read-only language data of the bundle. See baseapi.h.
+ */
+int TessBaseAPI::InitShared(LanguageModelBundle* bundle, OcrEngineMode oem) {
+  if (tesseract_ != NULL) {
+    delete tesseract_;
+    tesseract_ = NULL;
+  }
+  // Take the new reference first in case bundle is the one already held.
+  bundle->AddRef();
+  if (language_model_ != NULL)
+    language_model_->Release();
+  language_model_ = bundle;
+
+  const STRING& datapath = bundle->datapath();
+  const STRING& language = bundle->language();
+  tesseract_ = new Tesseract;
+  if (tesseract_->init_tesseract(
+          datapath.string(),
+          output_file_ != NULL ? output_file_->string() : NULL,
+          language.string(), oem, NULL, 0, NULL, NULL, false,
+          bundle->tesseract()) != 0) {
+    // Don't leave a half-initialized Tesseract for later calls to use.
+    delete tesseract_;
+    tesseract_ = NULL;
+    language_model_->Release();
+    language_model_ = NULL;
+    return -1;
+  }
+  // Update datapath and language requested for the last valid initialization.
+  if (datapath_ == NULL)
+    datapath_ = new STRING(datapath);
+  else
+    *datapath_ = datapath;
+  if (language_ == NULL)
+    language_ = new STRING(language);
+  else
+    *language_ = language;
+  last_oem_requested_ = oem;
+  return 0;
+}
+
 /** 
  * Returns the languages string used in the last valid initialization.
  * If the last initialization specified "deu+hin" then that will be
@@ -735,6 +786,63 @@ int TessBaseAPI::RecognizeForChopTest(ETEXT_DESC* monitor) {
   return 0;
 }
 
+/**
+ * Recognizes each of the boxes of a Boxa in pix, as SetRectangle followed by
+ * GetUTF8Text and MeanTextConf for each box would, but thresholding the
+ * whole image only once, returning the texts concatenated and their lengths
+ * and confidences in separate arrays. Replaces the current image and
+ * rectangle.
+ */
+char* TessBaseAPI::RecognizeBatch(Pix* pix, Boxa* boxes,
+                                  PageSegMode mode,
+                                  int** text_lengths, int** confidences) {
+  if (tesseract_ == NULL || pix == NULL || boxes == NULL)
+    return NULL;
+  PageSegMode current_psm = GetPageSegMode();
+  SetPageSegMode(mode);
+  // Threshold the whole image once, and recognize each box from its part of
+  // the binary image, so the boxes only need cropping, not thresholding.
+  SetImage(pix);
+  Pix* page_binary = NULL;
+  Threshold(&page_binary);
+  pixCopyResolution(page_binary, pix);
+  SetImage(page_binary);
+  int image_width = pixGetWidth(pix);
+  int image_height = pixGetHeight(pix);
+  int num_boxes = boxaGetCount(boxes);
+  *text_lengths = new int[num_boxes];
+  *confidences = new int[num_boxes];
+  STRING text("");
+  for (int i = 0; i < num_boxes; ++i) {
+    (*text_lengths)[i] = 0;
+    (*confidences)[i] = -1;
+    l_int32 left, top, width, height;
+    if (boxaGetBoxGeometry(boxes, i, &left, &top, &width, &height) != 0)
+      continue;
+    int right = MIN(left + width, image_width);
+    int bottom = MIN(top + height, image_height);
+    left = MAX(left, 0);
+    top = MAX(top, 0);
+    if (right - left < kMinRectSize || bottom - top < kMinRectSize)
+      continue;  // Nothing worth doing.
+    SetRectangle(left, top, right - left, bottom - top);
+    char* box_text = GetUTF8Text();
+    if (box_text == NULL)
+      continue;
+    int start = text.length();
+    text += box_text;
+    delete [] box_text;
+    (*text_lengths)[i] = text.length() - start;
+    (*confidences)[i] = MeanTextConf();
+  }
+  SetImage(pix);
+  pixDestroy(&page_binary);
+  SetPageSegMode(current_psm);
+  char* result = new char[text.length() + 1];
+  strncpy(result, text.string(), text.length() + 1);
+  return result;
+}
+
 /**
  * Recognizes all the pages in the named file, as a multi-page tiff or
  * list of filenames, or single image, and gets the appropriate kind of text
@@ -1327,6 +1435,13 @@ int* TessBaseAPI::AllWordConfidences() {
   return conf;
 }
 
+/** Copies the times and counters of the current page into *stats. */
+bool TessBaseAPI::GetPageStats(PageStats* stats) const {
+  if (tesseract_ == NULL)
+    return false;
+  return tesseract_->GetPageStats(stats);
+}
+
 /**
  * Applies the given word to the adaptive classifier if possible.
  * The word must be SPACE-DELIMITED UTF-8 - l i k e t h i s , so it can
@@ -1441,6 +1556,11 @@ void TessBaseAPI::End() {
     delete osd_tesseract_;
     osd_tesseract_ = NULL;
   }
+  // Only release the shared data once nothing that borrows it is left.
+  if (language_model_ != NULL) {
+    language_model_->Release();
+    language_model_ = NULL;
+  }
   if (equ_detect_ != NULL) {
     delete equ_detect_;
     equ_detect_ = NULL;
@@ -1546,6 +1666,7 @@ bool TessBaseAPI::InternalSetImage() {
  */
 void TessBaseAPI::Threshold(Pix** pix) {
   ASSERT_HOST(pix != NULL);
+  PageStageTimer timer(&tesseract_->page_stats, PS_THRESHOLD);
   if (!thresholder_->IsBinary()) {
     tesseract_->set_pix_grey(thresholder_->GetPixRectGrey());
   }
@@ -1558,6 +1679,9 @@ void TessBaseAPI::Threshold(Pix** pix) {
     // than over-estimate resolution.
     thresholder_->SetSourceYResolution(kMinCredibleResolution);
   }
+  int num_threads = tesseract_->tessedit_threshold_threads;
+  thresholder_->SetNumThreads(num_threads > 0 ? num_threads
+                                              : ThreadPool::NumProcessors());
   thresholder_->ThresholdToPix(pix);
   thresholder_->GetImageSizes(&rect_left_, &rect_top_,
                               &rect_width_, &rect_height_,
@@ -1631,8 +1755,10 @@ int TessBaseAPI::FindLines() {
     }
   }
 
+  PageStageTimer segment_timer(&tesseract_->page_stats, PS_SEGMENT_PAGE);
   if (tesseract_->SegmentPage(input_file_, block_list_, osd_tess, &osr) < 0)
     return -1;
+  segment_timer.Stop();
   // If Devanagari is being recognized, we use different images for page seg
   // and for OCR.
   tesseract_->PrepareForTessOCR(block_list_, osd_tess, &osr);
@@ -1658,6 +1784,11 @@ void TessBaseAPI::ClearResults() {
     delete paragraph_models_;
     paragraph_models_ = NULL;
   }
+  // The blobs and outlines of the page are gone, so the pools they came from
+  // can give their memory back.
+  if (tesseract_ != NULL && tesseract_->tessedit_page_pool_stats)
+    PagePool::PrintAllStats();
+  PagePool::ReleaseAllUnused();
 }
 
 /**
@@ -1929,6 +2060,7 @@ PAGE_RES* TessBaseAPI::RecognitionPass2(BLOCK_LIST* block_list,
 }
 
 void TessBaseAPI::DetectParagraphs(bool after_text_recognition) {
+  PageStageTimer timer(&tesseract_->page_stats, PS_PARAGRAPHS);
   int debug_level = 0;
   GetIntVariable("paragraph_debug_level", &debug_level);
   if (paragraph_models_ == NULL)
@@ -74,8 +74,10 @@ class CubeRecoContext;
 class Dawg;
 class Dict;
 class EquationDetect;
+class LanguageModelBundle;
 class LTRResultIterator;
 class MutableIterator;
+class PageStats;
 class Tesseract;
 class Trie;
 class Wordrec;
@@ -212,6 +214,22 @@ class TESS_API TessBaseAPI {
     return Init(datapath, language, OEM_DEFAULT, NULL, 0, NULL, NULL, false);
   }
 
+  /**
+   * Instances of TessBaseAPI normally each load their own copy of the
+   * language data. InitShared initializes with the datapath and language of
+   * the given bundle, but takes the classifier templates and dictionaries,
+   * which are read-only and by far the largest part of the data, from the
+   * bundle instead of loading them again, so any number of instances,
+   * including instances used concurrently by different threads, can share a
+   * single copy. Only the data that is modified during recognition, such as
+   * the adaptive classifier and the params, is per-instance.
+   * The instance holds a reference to the bundle until End() or until it is
+   * initialized again for a different language, so the caller may Release
+   * its own reference as soon as InitShared returns.
+   * Returns 0 on success and -1 on initialization failure.
+   */
+  int InitShared(LanguageModelBundle* bundle, OcrEngineMode oem);
+
   /**
    * Returns the languages string used in the last valid initialization.
    * If the last initialization specified "deu+hin" then that will be
@@ -455,6 +473,29 @@ class TESS_API TessBaseAPI {
   /** Variant on Recognize used for testing chopper. */
   int RecognizeForChopTest(ETEXT_DESC* monitor);
 
+  /**
+   * Recognizes each of the boxes of a Boxa in pix, in the given page
+   * segmentation mode, as SetImage(pix) followed by SetRectangle,
+   * GetUTF8Text and MeanTextConf for each box in turn would, but
+   * thresholding the whole image only once for the whole batch. Each box
+   * is then recognized from its part of the thresholded image, so the
+   * results can differ slightly from thresholding each box on its own.
+   * Boxes are clipped to the image. Intended for many small regions of one
+   * image, such as the text areas found by a text detector.
+   * Returns the UTF8 text of all the boxes concatenated in box order, which
+   * must be freed with the delete [] operator, or NULL on error.
+   * *text_lengths is set to a new array of the byte length of the text of
+   * each box, and *confidences to a new array of the mean confidence of
+   * each box, or -1 for a box that was too small or could not be
+   * recognized. Both must be freed with the delete [] operator.
+   * Note that this calls SetImage(pix), so it replaces the image and the
+   * rectangle set by any earlier SetImage and SetRectangle, and clears
+   * their results. Afterwards the image is pix, with the rectangle and
+   * results as after SetImage, and the current PageSegMode is preserved.
+   */
+  char* RecognizeBatch(Pix* pix, Boxa* boxes, PageSegMode mode,
+                       int** text_lengths, int** confidences);
+
   /**
    * Recognizes all the pages in the named file, as a multi-page tiff or
    * list of filenames, or single image, and gets the appropriate kind of text
@@ -546,6 +587,18 @@ class TESS_API TessBaseAPI {
    */
   int* AllWordConfidences();
 
+  /**
+   * Copies into *stats the wall time and number of calls of each stage of
+   * the recognition of the current page, from thresholding to paragraph
+   * detection, and the classifier, chopper and allocation counters, as
+   * collected while the tessedit_page_stats variable is 1 or 2. A page
+   * starts with SetImage, SetRectangle or a repeated Recognize. With
+   * tessedit_page_stats 2, each call of each stage is also kept for
+   * PageStats::ToChromeTrace. Returns false if tessedit_page_stats was 0
+   * when the page was started.
+   */
+  bool GetPageStats(PageStats* stats) const;
+
   /**
    * Applies the given word to the adaptive classifier if possible.
    * The word must be SPACE-DELIMITED UTF-8 - l i k e t h i s , so it can
@@ -770,6 +823,7 @@ class TESS_API TessBaseAPI {
   STRING*           datapath_;        ///< Current location of tessdata.
   STRING*           language_;        ///< Last initialized language.
   OcrEngineMode last_oem_requested_;  ///< Last ocr language mode requested.
+  LanguageModelBundle* language_model_;  ///< Shared language data or NULL.
   bool          recognition_done_;   ///< page_res_ contains recognition data.
   TruthCallback *truth_cb_;           /// fxn for setting truth_* in WERD_RES
 
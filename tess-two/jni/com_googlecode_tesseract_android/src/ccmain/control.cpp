@@ -182,6 +182,11 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
                                 int dopasses) {
   PAGE_RES_IT page_res_it;
   inT32 word_index;              // current word
+  // Whether passes 1 and 2 recognize the words with RecogWordsInParallel, so
+  // the loops below only complete the recognition of each word.
+  bool parallel = tessedit_parallelize_words && target_word_box == NULL &&
+      tessedit_ocr_engine_mode == OEM_TESSERACT_ONLY &&
+      InitWordWorkers(page_res);
 
   if (tessedit_minimal_rej_pass1) {
     tessedit_test_adaption.set_value (TRUE);
@@ -202,6 +207,7 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
     page_res_it.restart_page();
 
     // ****************** Pass 1 *******************
+    PageStageTimer pass1_timer(&page_stats, PS_PASS1);
 
     // Clear adaptive classifier at the beginning of the page if it is full.
     // This is done only at the beginning of the page to ensure that the
@@ -237,11 +243,26 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
     stats_.good_char_count = 0;
     stats_.doc_good_char_quality = 0;
 
+    if (parallel && !RecogWordsInParallel(page_res, monitor,
+                                          &Tesseract::classify_word_pass1,
+                                          30, 50)) {
+      // Keep the words that were recognized before the cancel.
+      AdoptWorkerWords(page_res, true);
+      return false;
+    }
+
     most_recently_used_ = this;
+    ROW_RES* last_row = NULL;
+    int row_index = 0;
     while (page_res_it.word() != NULL) {
       set_global_loc_code(LOC_PASS1);
+      if (page_res_it.row() != last_row) {
+        if (last_row != NULL)
+          ReportRowResult(monitor, 1, row_index++, last_row);
+        last_row = page_res_it.row();
+      }
       word_index++;
-      if (monitor != NULL) {
+      if (monitor != NULL && !parallel) {
         monitor->ocr_alive = TRUE;
         monitor->progress = 30 + 50 * word_index / stats_.word_count;
         if (monitor->deadline_exceeded() ||
@@ -255,10 +276,14 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
         page_res_it.forward();
         continue;
       }
-      classify_word_and_language(&Tesseract::classify_word_pass1,
-                                 page_res_it.block()->block,
-                                 page_res_it.row()->row,
-                                 page_res_it.word());
+      if (parallel) {
+        AdoptWorkerWord(page_res_it.word(), true);
+      } else {
+        classify_word_and_language(&Tesseract::classify_word_pass1,
+                                   page_res_it.block()->block,
+                                   page_res_it.row()->row,
+                                   page_res_it.word());
+      }
       if (page_res_it.word()->word->flag(W_REP_CHAR)) {
         fix_rep_char(&page_res_it);
         page_res_it.forward();
@@ -303,18 +328,34 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
 
       page_res_it.forward();
     }
+    if (last_row != NULL)
+      ReportRowResult(monitor, 1, row_index, last_row);
   }
 
   if (dopasses == 1) return true;
 
   // ****************** Pass 2 *******************
+  PageStageTimer pass2_timer(&page_stats, PS_PASS2);
+  if (parallel && !tessedit_test_adaption &&
+      !RecogWordsInParallel(page_res, monitor,
+                            &Tesseract::classify_word_pass2, 80, 10)) {
+    AdoptWorkerWords(page_res, false);
+    return false;
+  }
   page_res_it.restart_page();
   word_index = 0;
   most_recently_used_ = this;
+  ROW_RES* last_row = NULL;
+  int row_index = 0;
   while (!tessedit_test_adaption && page_res_it.word() != NULL) {
     set_global_loc_code(LOC_PASS2);
+    if (page_res_it.row() != last_row) {
+      if (last_row != NULL)
+        ReportRowResult(monitor, 2, row_index++, last_row);
+      last_row = page_res_it.row();
+    }
     word_index++;
-    if (monitor != NULL) {
+    if (monitor != NULL && !parallel) {
       monitor->ocr_alive = TRUE;
       monitor->progress = 80 + 10 * word_index / stats_.word_count;
       if (monitor->deadline_exceeded() ||
@@ -333,10 +374,14 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
     }
     // end jetsoft
 
-    classify_word_and_language(&Tesseract::classify_word_pass2,
-                               page_res_it.block()->block,
-                               page_res_it.row()->row,
-                               page_res_it.word());
+    if (parallel) {
+      AdoptWorkerWord(page_res_it.word(), false);
+    } else {
+      classify_word_and_language(&Tesseract::classify_word_pass2,
+                                 page_res_it.block()->block,
+                                 page_res_it.row()->row,
+                                 page_res_it.word());
+    }
     if (page_res_it.word()->word->flag(W_REP_CHAR) &&
         !page_res_it.word()->done) {
       fix_rep_char(&page_res_it);
@@ -351,6 +396,9 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
     }
     page_res_it.forward();
   }
+  if (last_row != NULL)
+    ReportRowResult(monitor, 2, row_index, last_row);
+  pass2_timer.Stop();
 
   // The next passes can only be run if tesseract has been used, as cube
   // doesn't set all the necessary outputs in WERD_RES.
@@ -361,8 +409,10 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
     set_global_loc_code(LOC_FUZZY_SPACE);
 
     if (!tessedit_test_adaption && tessedit_fix_fuzzy_spaces
-        && !tessedit_word_for_word && !right_to_left())
+        && !tessedit_word_for_word && !right_to_left()) {
+      PageStageTimer fix_spaces_timer(&page_stats, PS_FIX_SPACES);
       fix_fuzzy_spaces(monitor, stats_.word_count, page_res);
+    }
 
     // ****************** Pass 4 *******************
     if (tessedit_enable_bigram_correction) bigram_correction_pass(page_res);
@@ -416,6 +466,37 @@ bool Tesseract::recog_all_words(PAGE_RES* page_res,
   return true;
 }
 
+void Tesseract::ReportRowResult(ETEXT_DESC* monitor, int pass, int row_index,
+                                ROW_RES* row_res) {
+  if (monitor == NULL || monitor->row_result == NULL)
+    return;
+  GenericVector<const char*> words;
+  GenericVector<int> boxes;
+  GenericVector<int> confidences;
+  int height = ImageHeight();
+  WERD_RES_IT word_it(&row_res->word_res_list);
+  for (word_it.mark_cycle_pt(); !word_it.cycled_list(); word_it.forward()) {
+    WERD_RES* word = word_it.data();
+    if (word->part_of_combo || word->best_choice == NULL)
+      continue;
+    words.push_back(word->best_choice->unichar_string().string());
+    TBOX box = word->word->bounding_box();
+    boxes.push_back(box.left());
+    boxes.push_back(height - box.top());
+    boxes.push_back(box.right());
+    boxes.push_back(height - box.bottom());
+    // The same conversion of certainty to confidence as
+    // TessBaseAPI::AllWordConfidences.
+    int conf = static_cast<int>(100 + 5 * word->best_choice->certainty());
+    confidences.push_back(ClipToRange(conf, 0, 100));
+  }
+  if (words.empty())
+    return;
+  (*monitor->row_result)(monitor->result_this, pass, monitor->progress,
+                         row_index, words.size(), &words[0], &boxes[0],
+                         &confidences[0]);
+}
+
 void Tesseract::bigram_correction_pass(PAGE_RES *page_res) {
   PAGE_RES_IT word_it(page_res);
 
@@ -808,6 +889,11 @@ void Tesseract::classify_word_and_language(WordRecognizer recognizer,
     // any more. The only need to call the classifier at all is for the
     // cube combiner and xheight fixing (which may be bogus on a done word.)
     most_recently_used_ = word->tesseract;
+    // In a word worker, that is the worker's copy of the same language.
+    int lang_index = worker_for_ != NULL
+                   ? worker_for_->LanguageIndex(word->tesseract) : -1;
+    if (lang_index >= 0)
+      most_recently_used_ = lang_index == 0 ? this : sub_langs_[lang_index - 1];
     result_type = "Already done";
   }
   (most_recently_used_->*recognizer)(block, row, word);
@@ -924,7 +1010,10 @@ void Tesseract::classify_word_pass1(BLOCK* block, ROW *row, WERD_RES *word) {
         // Send word to adaptive classifier for training.
         word->BestChoiceToCorrectText();
         set_word_fonts(word, blob_choices);
-        LearnWord(NULL, rejmap, word);
+        if (worker_for_ != NULL)
+          DeferLearnWord(rejmap, word);
+        else
+          LearnWord(NULL, rejmap, word);
         // Mark misadaptions if running blamer.
         if (word->blamer_bundle != NULL &&
             word->blamer_bundle->incorrect_result_reason != IRR_NO_TRUTH &&
@@ -942,7 +1031,7 @@ void Tesseract::classify_word_pass1(BLOCK* block, ROW *row, WERD_RES *word) {
         }
       }
 
-      if (tessedit_enable_doc_dict)
+      if (tessedit_enable_doc_dict && worker_for_ == NULL)
         tess_add_doc_word(word->best_choice);
     }
   }
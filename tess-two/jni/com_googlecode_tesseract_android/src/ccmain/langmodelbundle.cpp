@@ -0,0 +1,66 @@
+///////////////////////////////////////////////////////////////////////
+// File:        langmodelbundle.cpp
+// Description: Read-only language data shared by many Tesseract instances.
+// Created:     Fri Oct 16 15:40:12 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "langmodelbundle.h"
+
+#include "ccutil.h"
+#include "tesseractclass.h"
+#include "tprintf.h"
+
+namespace tesseract {
+
+LanguageModelBundle* LanguageModelBundle::Load(const char* datapath,
+                                               const char* language) {
+  if (language == NULL) language = "eng";
+  // The shared data is only that of the Tesseract classifier, so there is no
+  // point in loading Cube here. Instances that use Cube load it themselves.
+  Tesseract* tesseract = new Tesseract;
+  if (tesseract->init_tesseract(datapath, language, OEM_TESSERACT_ONLY) != 0) {
+    tprintf("Failed to load language model bundle for %s\n", language);
+    delete tesseract;
+    return NULL;
+  }
+  return new LanguageModelBundle(datapath, language, tesseract);
+}
+
+LanguageModelBundle::LanguageModelBundle(const char* datapath,
+                                         const char* language,
+                                         Tesseract* tesseract)
+  : datapath_(datapath), language_(language), tesseract_(tesseract),
+    ref_count_(1), ref_count_mutex_(new CCUtilMutex) {
+}
+
+LanguageModelBundle::~LanguageModelBundle() {
+  delete tesseract_;
+  delete ref_count_mutex_;
+}
+
+void LanguageModelBundle::AddRef() {
+  ref_count_mutex_->Lock();
+  ++ref_count_;
+  ref_count_mutex_->Unlock();
+}
+
+void LanguageModelBundle::Release() {
+  ref_count_mutex_->Lock();
+  int ref_count = --ref_count_;
+  ref_count_mutex_->Unlock();
+  if (ref_count == 0)
+    delete this;
+}
+
+}  // namespace tesseract.
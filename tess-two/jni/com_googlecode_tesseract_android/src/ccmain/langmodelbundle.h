@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////
+// File:        langmodelbundle.h
+// Description: Read-only language data shared by many Tesseract instances.
+// Created:     Fri Oct 16 15:40:12 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCMAIN_LANGMODELBUNDLE_H__
+#define TESSERACT_CCMAIN_LANGMODELBUNDLE_H__
+
+#include "strngs.h"
+
+namespace tesseract {
+
+class CCUtilMutex;
+class Tesseract;
+
+// A LanguageModelBundle holds the parts of the language data that are never
+// modified after loading: the pre-trained classifier templates, shape table
+// and norm protos, and the squished dawgs, of each of the languages in a
+// language string such as "eng+deu". It is loaded once and may then be
+// attached to any number of TessBaseAPI instances, in any number of threads,
+// with TessBaseAPI::InitShared, so they don't each hold their own copy.
+// Everything that is modified during recognition (the adaptive classifier,
+// the document dictionary, the params, the page results) stays per-instance.
+//
+// The bundle is reference counted. Load returns it with a count of one that
+// belongs to the caller, each TessBaseAPI initialized from it holds another
+// until it is ended, and the bundle is deleted when the last one is released.
+class LanguageModelBundle {
+ public:
+  // Loads the languages in the language string from datapath, which is
+  // given exactly as to TessBaseAPI::Init. Returns NULL on failure.
+  static LanguageModelBundle* Load(const char* datapath, const char* language);
+
+  // Increments the reference count.
+  void AddRef();
+  // Decrements the reference count and deletes this if it reaches zero.
+  void Release();
+
+  const STRING& datapath() const {
+    return datapath_;
+  }
+  const STRING& language() const {
+    return language_;
+  }
+
+  // Returns the owner of the loaded data, with the other languages as its
+  // sub-languages. It must not be used for recognition.
+  const Tesseract* tesseract() const {
+    return tesseract_;
+  }
+
+ private:
+  LanguageModelBundle(const char* datapath, const char* language,
+                      Tesseract* tesseract);
+  ~LanguageModelBundle();
+
+  STRING datapath_;
+  STRING language_;
+  // Owner of all the shared data: the main language is loaded into tesseract_
+  // and any others into its sub-languages. It is never used for recognition.
+  Tesseract* tesseract_;
+  int ref_count_;
+  CCUtilMutex* ref_count_mutex_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCMAIN_LANGMODELBUNDLE_H__
@@ -0,0 +1,301 @@
+///////////////////////////////////////////////////////////////////////
+// File:        parallelrecog.cpp
+// Description: Recognition of the blocks of a page on several threads.
+// Created:     Fri Oct 16 17:05:33 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Each word worker is a complete Tesseract, loaded for the same languages as
+// the Tesseract it works for and borrowing its read-only classifier templates
+// and dawgs. For the duration of a pass, each language of a worker also
+// borrows the adapted templates and document dictionary of the same language
+// of the Tesseract it works for, which are only read while recognizing.
+// Adaption and document dictionary updates are deferred until the words are
+// handed back in page order by AdoptWorkerWord, so the results don't depend
+// on the number of threads or on which thread gets which block.
+
+#include "ccutil.h"
+#include "ndminx.h"
+#include "ocrclass.h"
+#include "pageres.h"
+#include "params.h"
+#include "tesscallback.h"
+#include "tesseractclass.h"
+#include "threadpool.h"
+#include "tprintf.h"
+
+namespace tesseract {
+
+// The state of a RecogWordsInParallel pass shared by its threads.
+class ParallelWordPass {
+ public:
+  ParallelWordPass(PAGE_RES* page_res, const GenericVector<Tesseract*>& workers,
+                   WordRecognizer recognizer, ETEXT_DESC* monitor,
+                   int word_count, int dict_words,
+                   int progress_base, int progress_range)
+    : workers_(workers), recognizer_(recognizer), monitor_(monitor),
+      word_count_(MAX(word_count, 1)), dict_words_(dict_words),
+      progress_base_(progress_base), progress_range_(progress_range),
+      words_started_(0), cancelled_(false) {
+    BLOCK_RES_IT block_it(&page_res->block_res_list);
+    for (block_it.mark_cycle_pt(); !block_it.cycled_list();
+         block_it.forward()) {
+      blocks_.push_back(block_it.data());
+    }
+  }
+
+  int num_blocks() const {
+    return blocks_.size();
+  }
+  bool cancelled() const {
+    return cancelled_;
+  }
+
+  // ThreadPool task to recognize the block with the given index on the word
+  // worker with the same index as the thread.
+  void RecogBlock(int thread_index, int block_index) {
+    workers_[thread_index]->RecogWorkerBlock(blocks_[block_index],
+                                             recognizer_, this, thread_index);
+  }
+
+  // Called before each word is recognized. Returns false if the pass has
+  // been cancelled. Only the calling thread of the pass uses the monitor.
+  bool StartWord(int thread_index) {
+    mutex_.Lock();
+    int words_started = ++words_started_;
+    bool cancelled = cancelled_;
+    mutex_.Unlock();
+    if (thread_index == 0 && monitor_ != NULL && !cancelled) {
+      monitor_->ocr_alive = TRUE;
+      monitor_->progress = progress_base_ +
+          progress_range_ * MIN(words_started, word_count_) / word_count_;
+      if (monitor_->deadline_exceeded() ||
+          (monitor_->cancel != NULL &&
+           (*monitor_->cancel)(monitor_->cancel_this, dict_words_))) {
+        mutex_.Lock();
+        cancelled_ = true;
+        mutex_.Unlock();
+        cancelled = true;
+      }
+    }
+    return !cancelled;
+  }
+
+ private:
+  GenericVector<BLOCK_RES*> blocks_;
+  const GenericVector<Tesseract*>& workers_;
+  WordRecognizer recognizer_;
+  ETEXT_DESC* monitor_;
+  int word_count_;
+  int dict_words_;
+  int progress_base_;
+  int progress_range_;
+  // Guards words_started_ and cancelled_.
+  CCUtilMutex mutex_;
+  int words_started_;
+  bool cancelled_;
+};
+
+bool Tesseract::InitWordWorkers(PAGE_RES* page_res) {
+  int num_workers = NumWordThreads(page_res);
+  if (word_workers_.size() >= num_workers)
+    return true;
+  // Load the same languages, with the same init params, borrowing the
+  // static data from this.
+  STRING language = lang;
+  for (int i = 0; i < sub_langs_.size(); ++i) {
+    language += "+";
+    language += sub_langs_[i]->lang;
+  }
+  GenericVector<STRING> vars;
+  GenericVector<STRING> values;
+  GetInitParams(&vars, &values);
+  const char* datapath = init_datapath_.length() > 0 ? init_datapath_.string()
+                                                     : NULL;
+  while (word_workers_.size() < num_workers) {
+    Tesseract* worker = new Tesseract;
+    if (worker->init_tesseract(datapath, NULL, language.string(),
+                               OEM_TESSERACT_ONLY, NULL, 0, &vars, &values,
+                               false, this) != 0 ||
+        worker->sub_langs_.size() != sub_langs_.size()) {
+      tprintf("Failed to initialize word worker for %s\n", language.string());
+      delete worker;
+      return false;
+    }
+    worker->worker_for_ = this;
+    for (int i = 0; i < worker->sub_langs_.size(); ++i)
+      worker->sub_langs_[i]->worker_for_ = this;
+    word_workers_.push_back(worker);
+  }
+  return true;
+}
+
+void Tesseract::EndWordWorkers() {
+  word_workers_.delete_data_pointers();
+  word_workers_.clear();
+}
+
+bool Tesseract::RecogWordsInParallel(PAGE_RES* page_res, ETEXT_DESC* monitor,
+                                     WordRecognizer recognizer,
+                                     int progress_base, int progress_range) {
+  int num_threads = NumWordThreads(page_res);
+  ASSERT_HOST(word_workers_.size() >= num_threads);
+  for (int t = 0; t < num_threads; ++t)
+    PrepareWordWorker(word_workers_[t], t);
+
+  ParallelWordPass pass(page_res, word_workers_, recognizer, monitor,
+                        stats_.word_count, stats_.dict_words,
+                        progress_base, progress_range);
+  ThreadPool pool(num_threads);
+  TessCallback2<int, int>* task =
+      NewPermanentTessCallback(&pass, &ParallelWordPass::RecogBlock);
+  pool.Run(pass.num_blocks(), task);
+  delete task;
+
+  for (int t = 0; t < num_threads; ++t)
+    ReleaseWordWorker(word_workers_[t]);
+  return !pass.cancelled();
+}
+
+void Tesseract::RecogWorkerBlock(BLOCK_RES* block_res,
+                                 WordRecognizer recognizer,
+                                 ParallelWordPass* pass, int thread_index) {
+  // Start the block as a new block is started in page order, with no
+  // previous word, but also with no hyphen or language carried over from
+  // the end of whichever block this worker did last.
+  most_recently_used_ = this;
+  prev_word_best_choice_ = NULL;
+  getDict().reset_hyphen_vars(true);
+  for (int i = 0; i < sub_langs_.size(); ++i)
+    sub_langs_[i]->getDict().reset_hyphen_vars(true);
+
+  ROW_RES_IT row_it(&block_res->row_res_list);
+  for (row_it.mark_cycle_pt(); !row_it.cycled_list(); row_it.forward()) {
+    ROW_RES* row_res = row_it.data();
+    WERD_RES_IT word_it(&row_res->word_res_list);
+    for (word_it.mark_cycle_pt(); !word_it.cycled_list(); word_it.forward()) {
+      WERD_RES* word = word_it.data();
+      if (word->part_of_combo)
+        continue;  // Skipped as by PAGE_RES_IT.
+      if (!pass->StartWord(thread_index))
+        return;
+      classify_word_and_language(recognizer, block_res->block, row_res->row,
+                                 word);
+      prev_word_best_choice_ = word->best_choice;
+    }
+  }
+}
+
+void Tesseract::AdoptWorkerWord(WERD_RES* word, bool pass1) {
+  Tesseract* lang_tess = word->tesseract != NULL
+                       ? GetLanguage(word->tesseract->lang.string()) : NULL;
+  if (lang_tess == NULL)
+    return;  // Not recognized.
+  word->tesseract = lang_tess;
+  word->uch_set = &lang_tess->unicharset;
+  // Do what classify_word_pass1 deferred, in the language that gave the
+  // result.
+  if (pass1 && !word->tess_failed && !word->word->flag(W_REP_CHAR)) {
+    lang_tess->LearnDeferredWord(word);
+    if (lang_tess->tessedit_enable_doc_dict)
+      lang_tess->tess_add_doc_word(word->best_choice);
+  }
+}
+
+void Tesseract::AdoptWorkerWords(PAGE_RES* page_res, bool pass1) {
+  PAGE_RES_IT page_res_it(page_res);
+  for (page_res_it.restart_page(); page_res_it.word() != NULL;
+       page_res_it.forward()) {
+    AdoptWorkerWord(page_res_it.word(), pass1);
+  }
+}
+
+int Tesseract::NumWordThreads(PAGE_RES* page_res) const {
+  int num_threads = tessedit_parallel_threads > 0 ? tessedit_parallel_threads
+                                                  : ThreadPool::NumProcessors();
+  BLOCK_RES_IT block_it(&page_res->block_res_list);
+  return MAX(MIN(block_it.length(), num_threads), 1);
+}
+
+void Tesseract::GetInitParams(GenericVector<STRING>* vars,
+                              GenericVector<STRING>* values) {
+  ParamsVectors* vec = params();
+  GenericVector<const char*> names;
+  int i;
+  for (i = 0; i < vec->int_params.size(); ++i) {
+    if (vec->int_params[i]->is_init())
+      names.push_back(vec->int_params[i]->name_str());
+  }
+  for (i = 0; i < vec->bool_params.size(); ++i) {
+    if (vec->bool_params[i]->is_init())
+      names.push_back(vec->bool_params[i]->name_str());
+  }
+  for (i = 0; i < vec->string_params.size(); ++i) {
+    if (vec->string_params[i]->is_init())
+      names.push_back(vec->string_params[i]->name_str());
+  }
+  for (i = 0; i < vec->double_params.size(); ++i) {
+    if (vec->double_params[i]->is_init())
+      names.push_back(vec->double_params[i]->name_str());
+  }
+  for (i = 0; i < names.size(); ++i) {
+    STRING value;
+    if (ParamUtils::GetParamAsString(names[i], vec, &value)) {
+      vars->push_back(STRING(names[i]));
+      values->push_back(value);
+    }
+  }
+}
+
+void Tesseract::PrepareWordWorker(Tesseract* worker, int thread_index) {
+  for (int i = -1; i < sub_langs_.size(); ++i) {
+    Tesseract* src = i < 0 ? this : sub_langs_[i];
+    Tesseract* dest = worker->GetLanguage(src->lang.string());
+    ASSERT_HOST(dest != NULL);
+    ParamUtils::CopyParams(*src->params(), dest->params());
+    pixDestroy(&dest->pix_binary_);
+    pixDestroy(&dest->pix_grey_);
+    if (src->pix_binary_ != NULL)
+      dest->pix_binary_ = pixClone(src->pix_binary_);
+    if (src->pix_grey_ != NULL)
+      dest->pix_grey_ = pixClone(src->pix_grey_);
+    dest->source_resolution_ = src->source_resolution_;
+    dest->own_adapted_templates_ = dest->AdaptedTemplates;
+    dest->AdaptedTemplates = src->AdaptedTemplates;
+    // Look up the words src has added to its document dictionary so far,
+    // as classify_word_pass1 and classify_word_pass2 of src would.
+    dest->own_document_words_ = dest->getDict().SwapDocumentDictionary(
+        src->getDict().document_words());
+    // The results cached by the worker may be from before src adapted.
+    dest->ClearResultCache();
+    // Thread 0 in the trace is the calling thread.
+    dest->page_stats.Reset(page_stats.level(), thread_index + 1);
+  }
+  worker->SetBlackAndWhitelist();
+}
+
+void Tesseract::ReleaseWordWorker(Tesseract* worker) {
+  for (int i = -1; i < worker->sub_langs_.size(); ++i) {
+    Tesseract* lang_tess = i < 0 ? worker : worker->sub_langs_[i];
+    lang_tess->AdaptedTemplates = lang_tess->own_adapted_templates_;
+    lang_tess->own_adapted_templates_ = NULL;
+    lang_tess->getDict().SwapDocumentDictionary(
+        lang_tess->own_document_words_);
+    lang_tess->own_document_words_ = NULL;
+    page_stats.Merge(lang_tess->page_stats);
+    pixDestroy(&lang_tess->pix_binary_);
+    pixDestroy(&lang_tess->pix_grey_);
+  }
+}
+
+}  // namespace tesseract.
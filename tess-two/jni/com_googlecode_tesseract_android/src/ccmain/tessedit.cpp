@@ -118,11 +118,10 @@ bool Tesseract::init_tesseract_lang_data(
   }
 
   // If a language specific config file (lang.config) exists, load it in.
-  if (tessdata_manager.SeekToStart(TESSDATA_LANG_CONFIG)) {
-    ParamUtils::ReadParamsFromFp(
-        tessdata_manager.GetDataFilePtr(),
-        tessdata_manager.GetEndOffset(TESSDATA_LANG_CONFIG),
-        SET_PARAM_CONSTRAINT_NONE, this->params());
+  TFile fp;
+  if (tessdata_manager.GetComponent(TESSDATA_LANG_CONFIG, &fp)) {
+    ParamUtils::ReadParamsFromFp(&fp, SET_PARAM_CONSTRAINT_NONE,
+                                 this->params());
     if (tessdata_manager_debug_level) {
       tprintf("Loaded language config file\n");
     }
@@ -182,8 +181,8 @@ bool Tesseract::init_tesseract_lang_data(
   }
 
   // Load the unicharset
-  if (!tessdata_manager.SeekToStart(TESSDATA_UNICHARSET) ||
-      !unicharset.load_from_file(tessdata_manager.GetDataFilePtr())) {
+  if (!tessdata_manager.GetComponent(TESSDATA_UNICHARSET, &fp) ||
+      !unicharset.load_from_file(&fp, false)) {
     return false;
   }
   if (unicharset.size() > MAX_NUM_CLASSES) {
@@ -194,11 +193,9 @@ bool Tesseract::init_tesseract_lang_data(
   right_to_left_ = unicharset.major_right_to_left();
 
   if (!tessedit_ambigs_training &&
-      tessdata_manager.SeekToStart(TESSDATA_AMBIGS)) {
-    unichar_ambigs.LoadUnicharAmbigs(
-        tessdata_manager.GetDataFilePtr(),
-        tessdata_manager.GetEndOffset(TESSDATA_AMBIGS),
-        ambigs_debug_level, use_ambigs_for_adaption, &unicharset);
+      tessdata_manager.GetComponent(TESSDATA_AMBIGS, &fp)) {
+    unichar_ambigs.LoadUnicharAmbigs(&fp, ambigs_debug_level,
+                                     use_ambigs_for_adaption, &unicharset);
     if (tessdata_manager_debug_level) tprintf("Loaded ambigs\n");
   }
 
@@ -272,11 +269,13 @@ int Tesseract::init_tesseract(
     OcrEngineMode oem, char **configs, int configs_size,
     const GenericVector<STRING> *vars_vec,
     const GenericVector<STRING> *vars_values,
-    bool set_only_non_debug_params) {
+    bool set_only_non_debug_params, const Tesseract *shared_source) {
   GenericVector<STRING> langs_to_load;
   GenericVector<STRING> langs_not_to_load;
   ParseLanguageString(language, &langs_to_load, &langs_not_to_load);
 
+  EndWordWorkers();
+  init_datapath_ = arg0 != NULL ? arg0 : "";
   sub_langs_.delete_data_pointers();
   sub_langs_.clear();
   // Find the first loadable lang and load into this.
@@ -292,6 +291,8 @@ int Tesseract::init_tesseract(
       } else {
         tess_to_init = new Tesseract;
       }
+      if (shared_source != NULL)
+        tess_to_init->ShareStaticData(shared_source->GetLanguage(lang_str));
 
       int result = tess_to_init->init_tesseract_internal(
           arg0, textbase, lang_str, oem, configs, configs_size,
@@ -330,6 +331,11 @@ int Tesseract::init_tesseract(
   return 0;
 }
 
+void Tesseract::ShareStaticData(const Tesseract *source) {
+  ShareStaticClassifier(source);
+  getDict().ShareSquishedDawgs(source != NULL ? &source->getDict() : NULL);
+}
+
 // Common initialization for a single language.
 // arg0 is the datapath for the tessdata directory, which could be the
 // path of the tessdata directory with no trailing /, or (if tessdata
@@ -429,6 +435,7 @@ int Tesseract::init_tesseract_lm(const char *arg0,
 }
 
 void Tesseract::end_tesseract() {
+  EndWordWorkers();
   end_recog();
 }
 
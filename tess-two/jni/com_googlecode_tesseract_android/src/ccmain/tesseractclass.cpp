@@ -25,6 +25,7 @@
 #include "edgblob.h"
 #include "equationdetect.h"
 #include "globals.h"
+#include "pagepool.h"
 #include "tesseract_cube_combiner.h"
 
 // Include automatically generated configuration file if running autoconf.
@@ -377,6 +378,23 @@ Tesseract::Tesseract()
                      "for layout analysis.", this->params()),
     BOOL_MEMBER(textord_equation_detect, false, "Turn on equation detector",
                 this->params()),
+    BOOL_MEMBER(tessedit_parallelize_words, false,
+                "Recognize the blocks of a page in parallel, and adapt to the"
+                " words afterwards in page order (Tesseract engine only)",
+                this->params()),
+    INT_MEMBER(tessedit_parallel_threads, 0,
+               "Number of threads for tessedit_parallelize_words,"
+               " 0 = number of processors", this->params()),
+    BOOL_MEMBER(tessedit_page_pool_stats, false,
+                "Print the page pool allocation stats at the end of each page",
+                this->params()),
+    INT_MEMBER(tessedit_threshold_threads, 1,
+               "Number of threads to threshold the image with,"
+               " 0 = number of processors", this->params()),
+    INT_MEMBER(tessedit_page_stats, 0,
+               "Collect the time of each stage of each page, for"
+               " TessBaseAPI::GetPageStats: 0 = off, 1 = totals, 2 = trace",
+               this->params()),
     backup_config_file_(NULL),
     pix_binary_(NULL),
     cube_binary_(NULL),
@@ -392,7 +410,12 @@ Tesseract::Tesseract()
     font_table_size_(0),
     cube_cntxt_(NULL),
     tess_cube_combiner_(NULL),
-    equ_detect_(NULL) {
+    equ_detect_(NULL),
+    worker_for_(NULL),
+    own_adapted_templates_(NULL),
+    own_document_words_(NULL),
+    page_pool_allocations_(0),
+    page_pool_mallocs_(0) {
 }
 
 Tesseract::~Tesseract() {
@@ -420,8 +443,13 @@ void Tesseract::Clear() {
   splitter_.Clear();
   scaled_factor_ = -1;
   ResetFeaturesHaveBeenExtracted();
-  for (int i = 0; i < sub_langs_.size(); ++i)
+  EndPageResultCache();
+  page_stats.Reset(tessedit_page_stats, 0);
+  PagePool::GetAllTotals(&page_pool_allocations_, &page_pool_mallocs_);
+  for (int i = 0; i < sub_langs_.size(); ++i) {
     sub_langs_[i]->Clear();
+    sub_langs_[i]->page_stats.Reset(tessedit_page_stats, 0);
+  }
 }
 
 void Tesseract::SetEquationDetect(EquationDetect* detector) {
@@ -429,6 +457,31 @@ void Tesseract::SetEquationDetect(EquationDetect* detector) {
   equ_detect_->SetLangTesseract(this);
 }
 
+Tesseract* Tesseract::GetLanguage(const char* lang) {
+  return const_cast<Tesseract*>(
+      static_cast<const Tesseract*>(this)->GetLanguage(lang));
+}
+
+const Tesseract* Tesseract::GetLanguage(const char* lang) const {
+  if (strcmp(this->lang.string(), lang) == 0)
+    return this;
+  for (int i = 0; i < sub_langs_.size(); ++i) {
+    if (strcmp(sub_langs_[i]->lang.string(), lang) == 0)
+      return sub_langs_[i];
+  }
+  return NULL;
+}
+
+int Tesseract::LanguageIndex(const Tesseract* lang_tess) const {
+  if (lang_tess == this)
+    return 0;
+  for (int i = 0; i < sub_langs_.size(); ++i) {
+    if (sub_langs_[i] == lang_tess)
+      return i + 1;
+  }
+  return -1;
+}
+
 // Clear all memory of adaption for this and all subclassifiers.
 void Tesseract::ResetAdaptiveClassifier() {
   ResetAdaptiveClassifierInternal();
@@ -445,14 +498,39 @@ void Tesseract::ResetDocumentDictionary() {
   }
 }
 
+bool Tesseract::GetPageStats(PageStats* stats) const {
+  if (!page_stats.enabled())
+    return false;
+  *stats = page_stats;
+  for (int i = 0; i < sub_langs_.size(); ++i)
+    stats->Merge(sub_langs_[i]->page_stats);
+  inT64 allocations, mallocs;
+  PagePool::GetAllTotals(&allocations, &mallocs);
+  stats->Count(PC_POOL_ALLOCATIONS,
+               static_cast<int>(allocations - page_pool_allocations_));
+  stats->Count(PC_POOL_MALLOCS, static_cast<int>(mallocs - page_pool_mallocs_));
+  return true;
+}
+
 void Tesseract::SetBlackAndWhitelist() {
+  // The classifier results depend on which unichars are enabled, so the
+  // results cached with other lists must not be found.
+  bool lists_changed =
+      applied_char_blacklist_ != tessedit_char_blacklist.string() ||
+      applied_char_whitelist_ != tessedit_char_whitelist.string();
+  applied_char_blacklist_ = tessedit_char_blacklist.string();
+  applied_char_whitelist_ = tessedit_char_whitelist.string();
   // Set the white and blacklists (if any)
   unicharset.set_black_and_whitelist(tessedit_char_blacklist.string(),
                                      tessedit_char_whitelist.string());
+  if (lists_changed)
+    ClearResultCache();
   // Black and white lists should apply to all loaded classifiers.
   for (int i = 0; i < sub_langs_.size(); ++i) {
     sub_langs_[i]->unicharset.set_black_and_whitelist(
         tessedit_char_blacklist.string(), tessedit_char_whitelist.string());
+    if (lists_changed)
+      sub_langs_[i]->ClearResultCache();
   }
 }
 
@@ -102,6 +102,7 @@ class CubeLineObject;
 class CubeObject;
 class CubeRecoContext;
 class EquationDetect;
+class ParallelWordPass;
 class Tesseract;
 class TesseractCubeCombiner;
 
@@ -147,12 +148,16 @@ class Tesseract : public Wordrec {
   ~Tesseract();
 
   // Clear as much used memory as possible without resetting the adaptive
-  // classifier or losing any other classifier data.
+  // classifier or losing any other classifier data. Starts new page stats.
   void Clear();
   // Clear all memory of adaption for this and all subclassifiers.
   void ResetAdaptiveClassifier();
   // Clear the document dictionary for this and all subclassifiers.
   void ResetDocumentDictionary();
+  // Sets *stats to the page stats of this and all subclassifiers since the
+  // last Clear, with the page pool allocations made since then. Returns
+  // false if tessedit_page_stats was 0 at the last Clear.
+  bool GetPageStats(PageStats* stats) const;
 
   // Set the equation detector.
   void SetEquationDetect(EquationDetect* detector);
@@ -224,7 +229,17 @@ class Tesseract : public Wordrec {
   Tesseract* get_sub_lang(int index) const {
     return sub_langs_[index];
   }
+  // Returns this or the sub-language that was loaded for the given single
+  // language, or NULL if there is none.
+  Tesseract* GetLanguage(const char* lang);
+  const Tesseract* GetLanguage(const char* lang) const;
+  // Returns the index of lang_tess among this (0) and sub_langs_ (1 on), or
+  // -1 if it is not one of them.
+  int LanguageIndex(const Tesseract* lang_tess) const;
 
+  // Applies tessedit_char_blacklist and tessedit_char_whitelist to the
+  // unicharsets of this and the sub-languages, and empties their classifier
+  // result caches if the lists have changed since they were last applied.
   void SetBlackAndWhitelist();
 
   // Perform steps to prepare underlying binary image/other data structures for
@@ -260,6 +275,10 @@ class Tesseract : public Wordrec {
                        const TBOX* target_word_box,
                        const char* word_config,
                        int dopasses);
+  // Calls monitor->row_result, if there is one, with the words of row_res as
+  // recognized so far by the given pass.
+  void ReportRowResult(ETEXT_DESC* monitor, int pass, int row_index,
+                       ROW_RES* row_res);
   void rejection_passes(PAGE_RES* page_res,
                         ETEXT_DESC* monitor,
                         const TBOX* target_word_box,
@@ -353,13 +372,35 @@ class Tesseract : public Wordrec {
                      int configs_size,
                      const GenericVector<STRING> *vars_vec,
                      const GenericVector<STRING> *vars_values,
-                     bool set_only_init_params);
+                     bool set_only_init_params) {
+    return init_tesseract(arg0, textbase, language, oem, configs,
+                          configs_size, vars_vec, vars_values,
+                          set_only_init_params, NULL);
+  }
+  // As above, but the read-only classifier templates and dictionaries of
+  // each language that is also loaded in shared_source (as its main or a
+  // sub-language) are borrowed from there instead of being read from the
+  // traineddata file. shared_source may be NULL.
+  int init_tesseract(const char *arg0,
+                     const char *textbase,
+                     const char *language,
+                     OcrEngineMode oem,
+                     char **configs,
+                     int configs_size,
+                     const GenericVector<STRING> *vars_vec,
+                     const GenericVector<STRING> *vars_values,
+                     bool set_only_init_params,
+                     const Tesseract *shared_source);
   int init_tesseract(const char *datapath,
                      const char *language,
                      OcrEngineMode oem) {
     return init_tesseract(datapath, NULL, language, oem,
                           NULL, 0, NULL, NULL, false);
   }
+  // Makes the next initialization borrow the pre-trained classifier templates
+  // and squished dawgs of source, which must have been initialized for the
+  // same language and must outlive this. NULL restores loading them.
+  void ShareStaticData(const Tesseract *source);
   // Common initialization for a single language.
   // arg0 is the datapath for the tessdata directory, which could be the
   // path of the tessdata directory with no trailing /, or (if tessdata
@@ -903,6 +944,51 @@ class Tesseract : public Wordrec {
              "Only initialize with the config file. Useful if the instance is "
              "not going to be used for OCR but say only for layout analysis.");
   BOOL_VAR_H(textord_equation_detect, false, "Turn on equation detector");
+  BOOL_VAR_H(tessedit_parallelize_words, false,
+             "Recognize the blocks of a page in parallel, and adapt to the"
+             " words afterwards in page order (Tesseract engine only)");
+  INT_VAR_H(tessedit_parallel_threads, 0,
+            "Number of threads for tessedit_parallelize_words,"
+            " 0 = number of processors");
+  BOOL_VAR_H(tessedit_page_pool_stats, false,
+             "Print the page pool allocation stats at the end of each page");
+  INT_VAR_H(tessedit_threshold_threads, 1,
+            "Number of threads to threshold the image with,"
+            " 0 = number of processors");
+  INT_VAR_H(tessedit_page_stats, 0,
+            "Collect the time of each stage of each page, for"
+            " TessBaseAPI::GetPageStats: 0 = off, 1 = totals, 2 = trace");
+
+  //// parallelrecog.cpp ///////////////////////////////////////////////////
+  // Creates enough word workers for RecogWordsInParallel to run on page_res.
+  // Returns false if they could not be loaded.
+  bool InitWordWorkers(PAGE_RES* page_res);
+  // Runs recognizer (classify_word_pass1 or classify_word_pass2) through
+  // classify_word_and_language on every word of page_res, with the blocks
+  // shared out among copies of this Tesseract, the word workers, running on
+  // tessedit_parallel_threads threads. Words are left set up as if they
+  // had been recognized by the word workers, and pass 1 adaption is left
+  // deferred: AdoptWorkerWord must be called on each word in page order to
+  // complete the pass. progress_base and progress_range are the part of the
+  // monitor progress that the pass takes. Returns false if cancelled, in
+  // which case the words recognized before the cancel are still left to be
+  // adopted, as by AdoptWorkerWords.
+  bool RecogWordsInParallel(PAGE_RES* page_res, ETEXT_DESC* monitor,
+                            WordRecognizer recognizer,
+                            int progress_base, int progress_range);
+  // Completes the recognition of a word by RecogWordsInParallel: the word is
+  // handed over to the matching language of this, which then applies any
+  // deferred pass 1 adaption and document dictionary update.
+  void AdoptWorkerWord(WERD_RES* word, bool pass1);
+  // Calls AdoptWorkerWord on every word of page_res in page order, to keep
+  // the words recognized by a cancelled RecogWordsInParallel pass.
+  void AdoptWorkerWords(PAGE_RES* page_res, bool pass1);
+  // Deletes the word workers.
+  void EndWordWorkers();
+  // Recognizes the words of block_res in page order as one task of a
+  // RecogWordsInParallel pass, on the worker used by thread_index.
+  void RecogWorkerBlock(BLOCK_RES* block_res, WordRecognizer recognizer,
+                        ParallelWordPass* pass, int thread_index);
 
   //// ambigsrecog.cpp /////////////////////////////////////////////////////////
   FILE *init_recog_training(const STRING &fname);
@@ -919,6 +1005,17 @@ class Tesseract : public Wordrec {
   inline CubeRecoContext *GetCubeRecoContext() { return cube_cntxt_; }
 
  private:
+  // Returns the number of threads and workers to use for page_res.
+  int NumWordThreads(PAGE_RES* page_res) const;
+  // Gets the names and values of the init params of this.
+  void GetInitParams(GenericVector<STRING>* vars,
+                     GenericVector<STRING>* values);
+  // Makes the languages of worker copies of those of this, for a pass, and
+  // restores the worker after it, merging its page stats into those of this.
+  // thread_index is the thread the worker runs on.
+  void PrepareWordWorker(Tesseract* worker, int thread_index);
+  void ReleaseWordWorker(Tesseract* worker);
+
   // The filename of a backup config file. If not null, then we currently
   // have a temporary debug config file loaded, and backup_config_file_
   // will be loaded, and set to null when debug is complete.
@@ -959,6 +1056,26 @@ class Tesseract : public Wordrec {
   TesseractCubeCombiner *tess_cube_combiner_;
   // Equation detector. Note: this pointer is NOT owned by the class.
   EquationDetect* equ_detect_;
+  // The datapath given to init_tesseract, for initializing word workers.
+  STRING init_datapath_;
+  // The copies of this used by RecogWordsInParallel, created on first use.
+  GenericVector<Tesseract*> word_workers_;
+  // In word workers and their sub-languages, the Tesseract that they work
+  // for, otherwise NULL. Word workers defer their adaption and document
+  // dictionary updates in classify_word_pass1.
+  const Tesseract* worker_for_;
+  // The adapted templates of a word worker (language) while it borrows those
+  // of the Tesseract it is working for.
+  ADAPT_TEMPLATES own_adapted_templates_;
+  // The document dictionary of a word worker (language) while it borrows
+  // that of the Tesseract it is working for.
+  Trie* own_document_words_;
+  // The black and white lists last applied by SetBlackAndWhitelist.
+  STRING applied_char_blacklist_;
+  STRING applied_char_whitelist_;
+  // PagePool totals at the last Clear, for GetPageStats.
+  inT64 page_pool_allocations_;
+  inT64 page_pool_mallocs_;
 };
 
 }  // namespace tesseract
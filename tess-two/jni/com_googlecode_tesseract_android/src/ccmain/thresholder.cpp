@@ -23,8 +23,13 @@
 
 #include <string.h>
 
+#include "errcode.h"
 #include "img.h"
+#include "ndminx.h"
 #include "otsuthr.h"
+#include "tesscallback.h"
+#include "threadpool.h"
+#include "thresholdsimd.h"
 
 namespace tesseract {
 
@@ -33,7 +38,7 @@ ImageThresholder::ImageThresholder()
     image_data_(NULL),
     image_width_(0), image_height_(0),
     image_bytespp_(0), image_bytespl_(0),
-    scale_(1), yres_(300), estimated_res_(300) {
+    scale_(1), yres_(300), estimated_res_(300), num_threads_(1) {
   SetRectangle(0, 0, 0, 0);
 }
 
@@ -148,15 +153,13 @@ void ImageThresholder::ThresholdToPix(Pix** pix) {
         OtsuThresholdRectToPix(reinterpret_cast<const uinT8*>(data),
                                image_bytespp_, image_bytespl_, pix);
       } else {
-        // Convert 8-bit to IMAGE and then pass its
-        // buffer to the raw interface to complete the conversion.
-        IMAGE temp_image;
-        temp_image.FromPix(pix_);
-        OtsuThresholdRectToPix(temp_image.get_buffer(),
-                               image_bytespp_,
-                               COMPUTE_IMAGE_XDIM(temp_image.get_xsize(),
-                                                  temp_image.get_bpp()),
-                               pix);
+        // 8-bit data only needs its bytes in image order, which is
+        // a clone on big-endian machines.
+        Pix* bytes_pix = pixEndianByteSwapNew(pix_);
+        const uinT32* data = pixGetData(bytes_pix);
+        OtsuThresholdRectToPix(reinterpret_cast<const uinT8*>(data),
+                               image_bytespp_, image_bytespl_, pix);
+        pixDestroy(&bytes_pix);
       }
     }
     return;
@@ -217,55 +220,99 @@ Pix* ImageThresholder::GetPixRectGrey() {
 
 // Otsu threshold the rectangle, taking everything except the image buffer
 // pointer from the class, to the output Pix.
+// One pool of num_threads_ threads serves both the histograms and the
+// thresholding.
 void ImageThresholder::OtsuThresholdRectToPix(const unsigned char* imagedata,
                                               int bytes_per_pixel,
                                               int bytes_per_line,
                                               Pix** pix) const {
+  ThreadPool pool(num_threads_);
   int* thresholds;
   int* hi_values;
   OtsuThreshold(imagedata, bytes_per_pixel, bytes_per_line,
                 rect_left_, rect_top_, rect_width_, rect_height_,
-                &thresholds, &hi_values);
+                &thresholds, &hi_values, &pool);
 
   // Threshold the image to the given IMAGE.
   ThresholdRectToPix(imagedata, bytes_per_pixel, bytes_per_line,
-                     thresholds, hi_values, pix);
+                     thresholds, hi_values, &pool, pix);
   delete [] thresholds;
   delete [] hi_values;
 }
 
+// Number of rows in each task of a multi-threaded ThresholdRectToPix.
+const int kThresholdBandRows = 64;
+
+// ThreadPool task for ThresholdRectToPix, to threshold one band of rows.
+class ThresholdBands {
+ public:
+  ThresholdBands(const ThresholdRowParams& params, ThresholdRowKernel kernel,
+                 const uinT8* srcdata, int bytes_per_line, int width,
+                 int height, uinT32* pixdata, int wpl)
+    : params_(params), kernel_(kernel), srcdata_(srcdata),
+      bytes_per_line_(bytes_per_line), width_(width), height_(height),
+      pixdata_(pixdata), wpl_(wpl) {}
+
+  int num_bands() const {
+    return (height_ + kThresholdBandRows - 1) / kThresholdBandRows;
+  }
+
+  void ThresholdBand(int thread_index, int band) {
+    int top = band * kThresholdBandRows;
+    int bottom = MIN(top + kThresholdBandRows, height_);
+    for (int y = top; y < bottom; ++y) {
+      kernel_(params_, srcdata_ + y * bytes_per_line_, width_,
+              pixdata_ + y * wpl_);
+    }
+  }
+
+ private:
+  const ThresholdRowParams& params_;
+  ThresholdRowKernel kernel_;
+  const uinT8* srcdata_;
+  int bytes_per_line_;
+  int width_;
+  int height_;
+  uinT32* pixdata_;
+  int wpl_;
+};
+
 // Threshold the rectangle, taking everything except the image buffer pointer
 // from the class, using thresholds/hi_values to the output IMAGE.
+// Each row is thresholded a word of 32 pixels at a time by the fastest
+// kernel for the cpu, with bands of rows spread over the threads of pool,
+// or all on the calling thread if pool is NULL.
 void ImageThresholder::ThresholdRectToPix(const unsigned char* imagedata,
                                           int bytes_per_pixel,
                                           int bytes_per_line,
                                           const int* thresholds,
                                           const int* hi_values,
+                                          ThreadPool* pool,
                                           Pix** pix) const {
+  ASSERT_HOST(bytes_per_pixel <= kMaxThresholdChannels);
   *pix = pixCreate(rect_width_, rect_height_, 1);
   uinT32* pixdata = pixGetData(*pix);
   int wpl = pixGetWpl(*pix);
   const unsigned char* srcdata = imagedata + rect_top_* bytes_per_line +
                                  rect_left_ * bytes_per_pixel;
-  for (int y = 0; y < rect_height_; ++y) {
-    const uinT8* linedata = srcdata;
-    uinT32* pixline = pixdata + y * wpl;
-    for (int x = 0; x < rect_width_; ++x, linedata += bytes_per_pixel) {
-      bool white_result = true;
-      for (int ch = 0; ch < bytes_per_pixel; ++ch) {
-        if (hi_values[ch] >= 0 &&
-            (linedata[ch] > thresholds[ch]) == (hi_values[ch] == 0)) {
-          white_result = false;
-          break;
-        }
-      }
-      if (white_result)
-        CLEAR_DATA_BIT(pixline, x);
-      else
-        SET_DATA_BIT(pixline, x);
-    }
-    srcdata += bytes_per_line;
+  ThresholdRowParams params;
+  params.bytes_per_pixel = bytes_per_pixel;
+  for (int ch = 0; ch < bytes_per_pixel; ++ch) {
+    params.thresholds[ch] = thresholds[ch];
+    params.hi_values[ch] = hi_values[ch];
+  }
+  ThresholdRowKernel kernel = ThresholdRowKernelForCpu(params);
+  ThresholdBands bands(params, kernel, srcdata, bytes_per_line,
+                       rect_width_, rect_height_, pixdata, wpl);
+  if (pool == NULL || pool->num_threads() <= 1 || bands.num_bands() <= 1) {
+    for (int band = 0; band < bands.num_bands(); ++band)
+      bands.ThresholdBand(0, band);
+    return;
   }
+  TessCallback2<int, int>* task =
+      NewPermanentTessCallback(&bands, &ThresholdBands::ThresholdBand);
+  pool->Run(bands.num_bands(), task);
+  delete task;
 }
 
 // Copy the raw image rectangle, taking all data from the class, to the Pix.
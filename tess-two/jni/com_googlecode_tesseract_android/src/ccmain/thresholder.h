@@ -25,6 +25,8 @@ struct Pix;
 
 namespace tesseract {
 
+class ThreadPool;
+
 /// Base class for all tesseract image thresholding classes.
 /// Specific classes can add new thresholding methods by
 /// overriding ThresholdToPix.
@@ -80,6 +82,14 @@ class ImageThresholder {
     return scale_;
   }
 
+  // Set the number of threads used to threshold the image. The default is 1.
+  void SetNumThreads(int num_threads) {
+    num_threads_ = num_threads;
+  }
+  int GetNumThreads() const {
+    return num_threads_;
+  }
+
   // Set the resolution of the source image in pixels per inch.
   // This should be called right after SetImage(), and will let us return
   // appropriate font sizes for the text.
@@ -157,10 +167,11 @@ class ImageThresholder {
 
   /// Threshold the rectangle, taking everything except the image buffer pointer
   /// from the class, using thresholds/hi_values to the output IMAGE.
+  /// Bands of rows run on pool, or on the calling thread if pool is NULL.
   void ThresholdRectToPix(const unsigned char* imagedata,
                           int bytes_per_pixel, int bytes_per_line,
                           const int* thresholds, const int* hi_values,
-                          Pix** pix) const;
+                          ThreadPool* pool, Pix** pix) const;
 
   /// Copy the raw image rectangle, taking all data from the class, to the Pix.
   void RawRectToPix(Pix** pix) const;
@@ -184,6 +195,7 @@ class ImageThresholder {
   int                  rect_top_;
   int                  rect_width_;
   int                  rect_height_;
+  int                  num_threads_;    //< Threads used by ThresholdToPix.
 };
 
 }  // namespace tesseract.
@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////////////////
+// File:        thresholdsimd.cpp
+// Description: Vectorized kernels for ImageThresholder::ThresholdRectToPix.
+// Created:     Fri Oct 16 20:37:52 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "thresholdsimd.h"
+#include "simddetect.h"
+
+namespace tesseract {
+
+// The scalar row kernel, available on all architectures. Each word is
+// built up in a register and stored once.
+void ThresholdRowScalar(const ThresholdRowParams& params,
+                        const uinT8* src, int width, uinT32* dst) {
+  int bytes_per_pixel = params.bytes_per_pixel;
+  for (int x = 0; x < width; x += 32) {
+    int num_pixels = width - x < 32 ? width - x : 32;
+    uinT32 word = 0;
+    for (int i = 0; i < num_pixels; ++i, src += bytes_per_pixel)
+      word = (word << 1) | IsBlackPixel(params, src);
+    *dst++ = word << (32 - num_pixels);
+  }
+}
+
+// Returns the fastest row kernel for params that is both compiled into this
+// library and supported by the running cpu.
+ThresholdRowKernel ThresholdRowKernelForCpu(const ThresholdRowParams& params) {
+  ThresholdRowKernel kernel = NULL;
+  if (SIMDDetect::IsSSE2Available())
+    kernel = ThresholdRowKernelSSE2(params);
+  if (kernel == NULL && SIMDDetect::IsNEONAvailable())
+    kernel = ThresholdRowKernelNEON(params);
+  if (kernel == NULL)
+    kernel = ThresholdRowScalar;
+  return kernel;
+}
+
+}  // namespace tesseract.
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////
+// File:        thresholdsimd.h
+// Description: Vectorized kernels for ImageThresholder::ThresholdRectToPix.
+// Created:     Fri Oct 16 20:37:52 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCMAIN_THRESHOLDSIMD_H_
+#define TESSERACT_CCMAIN_THRESHOLDSIMD_H_
+
+#include "host.h"
+
+namespace tesseract {
+
+// The largest number of bytes per pixel that the kernels handle.
+const int kMaxThresholdChannels = 4;
+
+// The thresholds of each channel, as made by OtsuThreshold.
+struct ThresholdRowParams {
+  int bytes_per_pixel;
+  // A pixel is black if, for any channel ch with hi_values[ch] >= 0, its
+  // value is > thresholds[ch] and hi_values[ch] is 0, or is <= thresholds[ch]
+  // and hi_values[ch] is 1.
+  int thresholds[kMaxThresholdChannels];
+  int hi_values[kMaxThresholdChannels];
+};
+
+// A row kernel thresholds width pixels of bytes_per_pixel bytes, starting at
+// src, to the 1 bpp Pix words at dst, with a set bit for black, MSB first.
+// All the words that hold any of the pixels are written in full, with the
+// bits after the last pixel cleared.
+typedef void (*ThresholdRowKernel)(const ThresholdRowParams& params,
+                                   const uinT8* src, int width, uinT32* dst);
+
+// Returns true if the pixel at src is black.
+inline bool IsBlackPixel(const ThresholdRowParams& params, const uinT8* src) {
+  for (int ch = 0; ch < params.bytes_per_pixel; ++ch) {
+    if (params.hi_values[ch] >= 0 &&
+        (src[ch] > params.thresholds[ch]) == (params.hi_values[ch] == 0))
+      return true;
+  }
+  return false;
+}
+
+// The scalar row kernel, available on all architectures. It is the
+// reference that the other kernels must match, and they use it for the
+// pixels that don't fill a whole word.
+void ThresholdRowScalar(const ThresholdRowParams& params,
+                        const uinT8* src, int width, uinT32* dst);
+
+// Returns the fastest row kernel for params that is both compiled into this
+// library and supported by the running cpu. Never returns NULL, as the
+// scalar kernel handles any params.
+ThresholdRowKernel ThresholdRowKernelForCpu(const ThresholdRowParams& params);
+
+// The row kernels for each instruction set. Each returns NULL if the kernel
+// is not compiled in for the target architecture, or can't handle params.
+ThresholdRowKernel ThresholdRowKernelSSE2(const ThresholdRowParams& params);
+ThresholdRowKernel ThresholdRowKernelNEON(const ThresholdRowParams& params);
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCMAIN_THRESHOLDSIMD_H_
@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////
+// File:        thresholdsimdneon.cpp
+// Description: NEON kernels for ImageThresholder::ThresholdRectToPix.
+// Created:     Fri Oct 16 20:37:52 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// On armeabi-v7a this file is built with -mfpu=neon (see Android.mk) and
+// the kernels are only called when the cpu reports NEON at runtime.
+
+#include "thresholdsimd.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NEON_KERNELS_AVAILABLE
+#endif
+
+namespace tesseract {
+
+#ifdef NEON_KERNELS_AVAILABLE
+// The per-channel constants of the comparisons.
+struct ThresholdVectorsNEON {
+  uint8x16_t thresholds[kMaxThresholdChannels];
+  // All ones in channels with a hi_value of 1.
+  uint8x16_t invert[kMaxThresholdChannels];
+  // All ones in channels with a hi_value >= 0.
+  uint8x16_t enable[kMaxThresholdChannels];
+};
+
+static void MakeThresholdVectors(const ThresholdRowParams& params,
+                                 ThresholdVectorsNEON* vectors) {
+  for (int ch = 0; ch < params.bytes_per_pixel; ++ch) {
+    vectors->thresholds[ch] =
+        vdupq_n_u8(static_cast<uinT8>(params.thresholds[ch]));
+    vectors->invert[ch] = vdupq_n_u8(params.hi_values[ch] == 1 ? 0xff : 0);
+    vectors->enable[ch] = vdupq_n_u8(params.hi_values[ch] >= 0 ? 0xff : 0);
+  }
+}
+
+// Returns all ones in the bytes of the 16 values of channel ch that make
+// their pixels black.
+static inline uint8x16_t BlackBytes(const ThresholdVectorsNEON& vectors,
+                                    int ch, uint8x16_t values) {
+  uint8x16_t above = vcgtq_u8(values, vectors.thresholds[ch]);
+  return vandq_u8(veorq_u8(above, vectors.invert[ch]), vectors.enable[ch]);
+}
+
+// Returns the 16 pixels at src, deinterleaved as needed, with all ones in
+// the byte of each black pixel.
+static inline uint8x16_t BlackPixels16(const ThresholdVectorsNEON& vectors,
+                                       int bytes_per_pixel, const uinT8* src) {
+  if (bytes_per_pixel == 1)
+    return BlackBytes(vectors, 0, vld1q_u8(src));
+  if (bytes_per_pixel == 3) {
+    uint8x16x3_t values = vld3q_u8(src);
+    return vorrq_u8(vorrq_u8(BlackBytes(vectors, 0, values.val[0]),
+                             BlackBytes(vectors, 1, values.val[1])),
+                    BlackBytes(vectors, 2, values.val[2]));
+  }
+  uint8x16x4_t values = vld4q_u8(src);
+  return vorrq_u8(vorrq_u8(BlackBytes(vectors, 0, values.val[0]),
+                           BlackBytes(vectors, 1, values.val[1])),
+                  vorrq_u8(BlackBytes(vectors, 2, values.val[2]),
+                           BlackBytes(vectors, 3, values.val[3])));
+}
+
+// NEON kernel for 1, 3 or 4 bytes per pixel, 16 pixels per comparison.
+// The black bytes are masked with the weight of each pixel's bit in its
+// byte of the word, and summed by pairwise additions into the 4 bytes.
+static void ThresholdRowNEON(const ThresholdRowParams& params,
+                             const uinT8* src, int width, uinT32* dst) {
+  static const uinT8 kBitWeights[16] = {
+    128, 64, 32, 16, 8, 4, 2, 1, 128, 64, 32, 16, 8, 4, 2, 1
+  };
+  ThresholdVectorsNEON vectors;
+  MakeThresholdVectors(params, &vectors);
+  uint8x16_t weights = vld1q_u8(kBitWeights);
+  int bytes_per_pixel = params.bytes_per_pixel;
+  int x = 0;
+  for (; x + 32 <= width; x += 32) {
+    const uinT8* pixels = src + x * bytes_per_pixel;
+    uint8x16_t black0 = vandq_u8(
+        BlackPixels16(vectors, bytes_per_pixel, pixels), weights);
+    uint8x16_t black1 = vandq_u8(
+        BlackPixels16(vectors, bytes_per_pixel, pixels + 16 * bytes_per_pixel),
+        weights);
+    uint8x8_t sums = vpadd_u8(
+        vpadd_u8(vget_low_u8(black0), vget_high_u8(black0)),
+        vpadd_u8(vget_low_u8(black1), vget_high_u8(black1)));
+    sums = vpadd_u8(sums, sums);
+    // The first 4 bytes are the word in big-endian order.
+    *dst++ = vget_lane_u32(vreinterpret_u32_u8(vrev32_u8(sums)), 0);
+  }
+  if (x < width)
+    ThresholdRowScalar(params, src + x * bytes_per_pixel, width - x, dst);
+}
+#endif  // NEON_KERNELS_AVAILABLE
+
+ThresholdRowKernel ThresholdRowKernelNEON(const ThresholdRowParams& params) {
+#ifdef NEON_KERNELS_AVAILABLE
+  // The thresholds must fit the byte comparison.
+  for (int ch = 0; ch < params.bytes_per_pixel; ++ch) {
+    if (params.hi_values[ch] >= 0 &&
+        (params.thresholds[ch] < 0 || params.thresholds[ch] > 255))
+      return NULL;
+  }
+  if (params.bytes_per_pixel == 1 || params.bytes_per_pixel == 3 ||
+      params.bytes_per_pixel == 4)
+    return ThresholdRowNEON;
+#endif
+  return NULL;
+}
+
+}  // namespace tesseract.
@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////
+// File:        thresholdsimdsse.cpp
+// Description: SSE2 kernels for ImageThresholder::ThresholdRectToPix.
+// Created:     Fri Oct 16 20:37:52 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "thresholdsimd.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SSE2_KERNELS_AVAILABLE
+#endif
+
+namespace tesseract {
+
+#ifdef SSE2_KERNELS_AVAILABLE
+// The per-channel constants of the comparisons, with byte i of each vector
+// for channel i % bytes_per_pixel, so they line up with 16 bytes of pixels.
+struct ThresholdVectorsSSE2 {
+  // Threshold with the sign bit flipped, for a signed comparison.
+  __m128i biased_thresholds;
+  // All ones in channels with a hi_value of 1.
+  __m128i invert;
+  // All ones in channels with a hi_value >= 0.
+  __m128i enable;
+};
+
+static void MakeThresholdVectors(const ThresholdRowParams& params,
+                                 ThresholdVectorsSSE2* vectors) {
+  uinT8 thresholds[16], invert[16], enable[16];
+  for (int i = 0; i < 16; ++i) {
+    int ch = i % params.bytes_per_pixel;
+    thresholds[i] = static_cast<uinT8>(params.thresholds[ch] ^ 0x80);
+    invert[i] = params.hi_values[ch] == 1 ? 0xff : 0;
+    enable[i] = params.hi_values[ch] >= 0 ? 0xff : 0;
+  }
+  vectors->biased_thresholds =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(thresholds));
+  vectors->invert = _mm_loadu_si128(reinterpret_cast<const __m128i*>(invert));
+  vectors->enable = _mm_loadu_si128(reinterpret_cast<const __m128i*>(enable));
+}
+
+// Returns all ones in each byte of the 16 at src that makes its pixel black.
+static inline __m128i BlackBytes(const ThresholdVectorsSSE2& vectors,
+                                 const uinT8* src) {
+  __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  values = _mm_xor_si128(values, _mm_set1_epi8(static_cast<char>(0x80)));
+  __m128i above = _mm_cmpgt_epi8(values, vectors.biased_thresholds);
+  return _mm_and_si128(_mm_xor_si128(above, vectors.invert), vectors.enable);
+}
+
+// Reverses the order of the bits of a movemask result, to put the first
+// pixel in the MSB as a Pix word needs.
+static inline uinT32 ReverseBits(uinT32 bits) {
+  bits = ((bits >> 1) & 0x55555555) | ((bits & 0x55555555) << 1);
+  bits = ((bits >> 2) & 0x33333333) | ((bits & 0x33333333) << 2);
+  bits = ((bits >> 4) & 0x0f0f0f0f) | ((bits & 0x0f0f0f0f) << 4);
+  bits = ((bits >> 8) & 0x00ff00ff) | ((bits & 0x00ff00ff) << 8);
+  return (bits >> 16) | (bits << 16);
+}
+
+// SSE2 kernel for greyscale: 16 pixels per comparison.
+static void ThresholdRowGreySSE2(const ThresholdRowParams& params,
+                                 const uinT8* src, int width, uinT32* dst) {
+  ThresholdVectorsSSE2 vectors;
+  MakeThresholdVectors(params, &vectors);
+  int x = 0;
+  for (; x + 32 <= width; x += 32) {
+    uinT32 bits = _mm_movemask_epi8(BlackBytes(vectors, src + x)) |
+        (_mm_movemask_epi8(BlackBytes(vectors, src + x + 16)) << 16);
+    *dst++ = ReverseBits(bits);
+  }
+  if (x < width)
+    ThresholdRowScalar(params, src + x, width - x, dst);
+}
+
+// Returns a bit for each of the 16 pixels of 4 bytes at src, set for black,
+// with the first pixel in bit 0.
+static inline uinT32 BlackPixels16(const ThresholdVectorsSSE2& vectors,
+                                   const uinT8* src) {
+  __m128i zero = _mm_setzero_si128();
+  // A pixel is white if none of its channels make it black.
+  __m128i white0 = _mm_cmpeq_epi32(BlackBytes(vectors, src), zero);
+  __m128i white1 = _mm_cmpeq_epi32(BlackBytes(vectors, src + 16), zero);
+  __m128i white2 = _mm_cmpeq_epi32(BlackBytes(vectors, src + 32), zero);
+  __m128i white3 = _mm_cmpeq_epi32(BlackBytes(vectors, src + 48), zero);
+  __m128i white = _mm_packs_epi16(_mm_packs_epi32(white0, white1),
+                                  _mm_packs_epi32(white2, white3));
+  return ~_mm_movemask_epi8(white) & 0xffff;
+}
+
+// SSE2 kernel for 4 bytes per pixel: 4 pixels per comparison.
+static void ThresholdRowColorSSE2(const ThresholdRowParams& params,
+                                  const uinT8* src, int width, uinT32* dst) {
+  ThresholdVectorsSSE2 vectors;
+  MakeThresholdVectors(params, &vectors);
+  int x = 0;
+  for (; x + 32 <= width; x += 32) {
+    uinT32 bits = BlackPixels16(vectors, src + x * 4) |
+        (BlackPixels16(vectors, src + x * 4 + 64) << 16);
+    *dst++ = ReverseBits(bits);
+  }
+  if (x < width)
+    ThresholdRowScalar(params, src + x * 4, width - x, dst);
+}
+#endif  // SSE2_KERNELS_AVAILABLE
+
+ThresholdRowKernel ThresholdRowKernelSSE2(const ThresholdRowParams& params) {
+#ifdef SSE2_KERNELS_AVAILABLE
+  // The thresholds must fit the byte comparison.
+  for (int ch = 0; ch < params.bytes_per_pixel; ++ch) {
+    if (params.hi_values[ch] >= 0 &&
+        (params.thresholds[ch] < 0 || params.thresholds[ch] > 255))
+      return NULL;
+  }
+  if (params.bytes_per_pixel == 1)
+    return ThresholdRowGreySSE2;
+  if (params.bytes_per_pixel == 4)
+    return ThresholdRowColorSSE2;
+#endif
+  return NULL;
+}
+
+}  // namespace tesseract.
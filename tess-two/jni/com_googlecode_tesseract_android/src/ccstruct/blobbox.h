@@ -24,6 +24,7 @@
 #include          "elst2.h"
 #include          "werd.h"
 #include          "ocrblock.h"
+#include          "pagepool.h"
 #include          "statistc.h"
 
 enum PITCH_TYPE
@@ -127,6 +128,7 @@ class BLOBNBOX;
 ELISTIZEH (BLOBNBOX)
 class BLOBNBOX:public ELIST_LINK
 {
+  PAGE_POOL_NEW_DELETE(BLOBNBOX)
   public:
     BLOBNBOX() {
       ConstructionInit();
@@ -25,6 +25,7 @@
 #include          "bits16.h"
 #include          "rect.h"
 #include          "blckerr.h"
+#include          "pagepool.h"
 #include          "scrollview.h"
 
 #define INTERSECTING    MAX_INT16//no winding number
@@ -43,6 +44,7 @@ struct Pix;
 ELISTIZEH (C_OUTLINE)
 class DLLSYM C_OUTLINE:public ELIST_LINK
 {
+  PAGE_POOL_NEW_DELETE(C_OUTLINE)
   public:
     C_OUTLINE() {  //empty constructor
       steps = NULL;
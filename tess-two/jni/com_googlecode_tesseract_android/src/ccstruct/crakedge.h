@@ -22,8 +22,10 @@
 
 #include          "points.h"
 #include          "mod128.h"
+#include          "pagepool.h"
 
 class CRACKEDGE {
+  PAGE_POOL_NEW_DELETE(CRACKEDGE)
  public:
   CRACKEDGE() {}
 
@@ -52,18 +52,40 @@ void FontSetDeleteCallback(FontSet fs) {
   delete[] fs.configs;
 }
 
+// Deep copies of FontInfo/FontSet structures.
+FontInfo CopyFontInfo(const FontInfo& fi) {
+  FontInfo copy = fi;
+  copy.name = new char[strlen(fi.name) + 1];
+  strcpy(copy.name, fi.name);
+  if (fi.spacing_vec != NULL) {
+    copy.spacing_vec = new GenericVector<FontSpacingInfo *>();
+    copy.spacing_vec->init_to_size(fi.spacing_vec->size(), NULL);
+    for (int i = 0; i < fi.spacing_vec->size(); ++i) {
+      if ((*fi.spacing_vec)[i] != NULL)
+        (*copy.spacing_vec)[i] = new FontSpacingInfo(*(*fi.spacing_vec)[i]);
+    }
+  }
+  return copy;
+}
+FontSet CopyFontSet(const FontSet& fs) {
+  FontSet copy = fs;
+  copy.configs = new int[fs.size];
+  memcpy(copy.configs, fs.configs, fs.size * sizeof(*fs.configs));
+  return copy;
+}
+
 /*---------------------------------------------------------------------------*/
 // Callbacks used by UnicityTable to read/write FontInfo/FontSet structures.
-bool read_info(FILE* f, FontInfo* fi, bool swap) {
+bool read_info(TFile* f, FontInfo* fi, bool swap) {
   inT32 size;
-  if (fread(&size, sizeof(size), 1, f) != 1) return false;
+  if (f->FRead(&size, sizeof(size), 1) != 1) return false;
   if (swap)
     Reverse32(&size);
   char* font_name = new char[size + 1];
   fi->name = font_name;
-  if (fread(font_name, sizeof(*font_name), size, f) != size) return false;
+  if (f->FRead(font_name, sizeof(*font_name), size) != size) return false;
   font_name[size] = '\0';
-  if (fread(&fi->properties, sizeof(fi->properties), 1, f) != 1) return false;
+  if (f->FRead(&fi->properties, sizeof(fi->properties), 1) != 1) return false;
   if (swap)
     Reverse32(&fi->properties);
   return true;
@@ -77,18 +99,18 @@ bool write_info(FILE* f, const FontInfo& fi) {
   return true;
 }
 
-bool read_spacing_info(FILE *f, FontInfo* fi, bool swap) {
+bool read_spacing_info(TFile *f, FontInfo* fi, bool swap) {
   inT32 vec_size, kern_size;
-  if (fread(&vec_size, sizeof(vec_size), 1, f) != 1) return false;
+  if (f->FRead(&vec_size, sizeof(vec_size), 1) != 1) return false;
   if (swap) Reverse32(&vec_size);
   ASSERT_HOST(vec_size >= 0);
   if (vec_size == 0) return true;
   fi->init_spacing(vec_size);
   for (int i = 0; i < vec_size; ++i) {
     FontSpacingInfo *fs = new FontSpacingInfo();
-    if (fread(&fs->x_gap_before, sizeof(fs->x_gap_before), 1, f) != 1 ||
-        fread(&fs->x_gap_after, sizeof(fs->x_gap_after), 1, f) != 1 ||
-        fread(&kern_size, sizeof(kern_size), 1, f) != 1) {
+    if (f->FRead(&fs->x_gap_before, sizeof(fs->x_gap_before), 1) != 1 ||
+        f->FRead(&fs->x_gap_after, sizeof(fs->x_gap_after), 1) != 1 ||
+        f->FRead(&kern_size, sizeof(kern_size), 1) != 1) {
       return false;
     }
     if (swap) {
@@ -137,13 +159,13 @@ bool write_spacing_info(FILE* f, const FontInfo& fi) {
   return true;
 }
 
-bool read_set(FILE* f, FontSet* fs, bool swap) {
-  if (fread(&fs->size, sizeof(fs->size), 1, f) != 1) return false;
+bool read_set(TFile* f, FontSet* fs, bool swap) {
+  if (f->FRead(&fs->size, sizeof(fs->size), 1) != 1) return false;
   if (swap)
     Reverse32(&fs->size);
   fs->configs = new int[fs->size];
   for (int i = 0; i < fs->size; ++i) {
-    if (fread(&fs->configs[i], sizeof(fs->configs[i]), 1, f) != 1) return false;
+    if (f->FRead(&fs->configs[i], sizeof(fs->configs[i]), 1) != 1) return false;
     if (swap)
       Reverse32(&fs->configs[i]);
   }
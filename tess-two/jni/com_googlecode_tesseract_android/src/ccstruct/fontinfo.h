@@ -119,13 +119,17 @@ bool CompareFontSet(const FontSet& fs1, const FontSet& fs2);
 // Deletion callbacks for GenericVector.
 void FontInfoDeleteCallback(FontInfo f);
 void FontSetDeleteCallback(FontSet fs);
+// Deep copies that own their own memory, for filling another table that
+// will free its contents with the deletion callbacks above.
+FontInfo CopyFontInfo(const FontInfo& fi);
+FontSet CopyFontSet(const FontSet& fs);
 
 // Callbacks used by UnicityTable to read/write FontInfo/FontSet structures.
-bool read_info(FILE* f, FontInfo* fi, bool swap);
+bool read_info(TFile* f, FontInfo* fi, bool swap);
 bool write_info(FILE* f, const FontInfo& fi);
-bool read_spacing_info(FILE *f, FontInfo* fi, bool swap);
+bool read_spacing_info(TFile *f, FontInfo* fi, bool swap);
 bool write_spacing_info(FILE* f, const FontInfo& fi);
-bool read_set(FILE* f, FontSet* fs, bool swap);
+bool read_set(TFile* f, FontSet* fs, bool swap);
 bool write_set(FILE* f, const FontSet& fs);
 
 }  // namespace tesseract.
@@ -19,9 +19,132 @@
 
 #include <string.h>
 #include "otsuthr.h"
+#include "ndminx.h"
+#include "tesscallback.h"
+#include "threadpool.h"
 
 namespace tesseract {
 
+// Number of interleaved sets of counters in a histogram of a band of rows.
+// Runs of equal pixels, which are most of a page, would otherwise make every
+// increment wait on the previous one to the same counter.
+const int kNumHistogramCopies = 4;
+// Number of rows in each task of a multi-threaded HistogramChannels.
+const int kHistogramBandRows = 64;
+
+// Adds to histogram the counts of the given channel of height rows of width
+// pixels, starting at pixels.
+static void AddRowsToHistogram(const unsigned char* pixels,
+                               int bytes_per_pixel, int bytes_per_line,
+                               int width, int height, int* histogram) {
+  int counts[kNumHistogramCopies][kHistogramSize];
+  memset(counts, 0, sizeof(counts));
+  int step = bytes_per_pixel * kNumHistogramCopies;
+  for (int y = 0; y < height; ++y) {
+    const unsigned char* pixel = pixels;
+    int x = 0;
+    for (; x + kNumHistogramCopies <= width; x += kNumHistogramCopies) {
+      ++counts[0][pixel[0]];
+      ++counts[1][pixel[bytes_per_pixel]];
+      ++counts[2][pixel[2 * bytes_per_pixel]];
+      ++counts[3][pixel[3 * bytes_per_pixel]];
+      pixel += step;
+    }
+    for (; x < width; ++x, pixel += bytes_per_pixel)
+      ++counts[0][*pixel];
+    pixels += bytes_per_line;
+  }
+  for (int i = 0; i < kHistogramSize; ++i)
+    histogram[i] += counts[0][i] + counts[1][i] + counts[2][i] + counts[3][i];
+}
+
+// ThreadPool task for HistogramChannels, to count one band of rows of each
+// channel into the histograms of the thread that runs it.
+class HistogramBands {
+ public:
+  HistogramBands(const unsigned char* pixels, int bytes_per_pixel,
+                 int num_channels, int bytes_per_line, int width, int height,
+                 int num_threads)
+    : pixels_(pixels), bytes_per_pixel_(bytes_per_pixel),
+      num_channels_(num_channels), bytes_per_line_(bytes_per_line),
+      width_(width), height_(height), num_threads_(num_threads) {
+    int size = num_threads * num_channels * kHistogramSize;
+    histograms_ = new int[size];
+    memset(histograms_, 0, sizeof(*histograms_) * size);
+  }
+  ~HistogramBands() {
+    delete [] histograms_;
+  }
+
+  int num_bands() const {
+    return (height_ + kHistogramBandRows - 1) / kHistogramBandRows;
+  }
+
+  void CountBand(int thread_index, int band) {
+    int top = band * kHistogramBandRows;
+    int height = MIN(kHistogramBandRows, height_ - top);
+    int* thread_histograms =
+        histograms_ + thread_index * num_channels_ * kHistogramSize;
+    for (int ch = 0; ch < num_channels_; ++ch) {
+      AddRowsToHistogram(pixels_ + top * bytes_per_line_ + ch,
+                         bytes_per_pixel_, bytes_per_line_, width_, height,
+                         thread_histograms + ch * kHistogramSize);
+    }
+  }
+
+  // Adds the histograms of all the threads into histograms.
+  void SumHistograms(int* histograms) const {
+    int size = num_channels_ * kHistogramSize;
+    for (int t = 0; t < num_threads_; ++t) {
+      const int* thread_histograms = histograms_ + t * size;
+      for (int i = 0; i < size; ++i)
+        histograms[i] += thread_histograms[i];
+    }
+  }
+
+ private:
+  const unsigned char* pixels_;
+  int bytes_per_pixel_;
+  int num_channels_;
+  int bytes_per_line_;
+  int width_;
+  int height_;
+  int num_threads_;
+  // num_channels_ histograms for each thread.
+  int* histograms_;
+};
+
+// Computes the histograms of the first num_channels channels of the given
+// image rectangle into histograms, which must hold num_channels histograms
+// of kHistogramSize. If pool is not NULL, bands of rows of all the channels
+// are counted in a single Run of the pool.
+static void HistogramChannels(const unsigned char* imagedata,
+                              int bytes_per_pixel, int num_channels,
+                              int bytes_per_line,
+                              int left, int top, int width, int height,
+                              int* histograms, ThreadPool* pool) {
+  memset(histograms, 0,
+         sizeof(*histograms) * num_channels * kHistogramSize);
+  const unsigned char* pixels = imagedata +
+                                top * bytes_per_line +
+                                left * bytes_per_pixel;
+  if (pool == NULL || pool->num_threads() <= 1 ||
+      height <= kHistogramBandRows) {
+    for (int ch = 0; ch < num_channels; ++ch) {
+      AddRowsToHistogram(pixels + ch, bytes_per_pixel, bytes_per_line,
+                         width, height, histograms + ch * kHistogramSize);
+    }
+    return;
+  }
+  HistogramBands bands(pixels, bytes_per_pixel, num_channels, bytes_per_line,
+                       width, height, pool->num_threads());
+  TessCallback2<int, int>* task =
+      NewPermanentTessCallback(&bands, &HistogramBands::CountBand);
+  pool->Run(bands.num_bands(), task);
+  delete task;
+  bands.SumHistograms(histograms);
+}
+
 // Compute the Otsu threshold(s) for the given image rectangle, making one
 // for each channel. Each channel is always one byte per pixel.
 // Returns an array of threshold values and an array of hi_values, such
@@ -29,10 +152,12 @@ namespace tesseract {
 // hi_values[channel] is 0 or background if 1. A hi_value of -1 indicates
 // that there is no apparent foreground. At least one hi_value will not be -1.
 // Delete thresholds and hi_values with delete [] after use.
+// If pool is not NULL, the histograms of all the channels are computed on it
+// in parallel bands of rows.
 void OtsuThreshold(const unsigned char* imagedata,
                    int bytes_per_pixel, int bytes_per_line,
                    int left, int top, int width, int height,
-                   int** thresholds, int** hi_values) {
+                   int** thresholds, int** hi_values, ThreadPool* pool) {
   // Of all channels with no good hi_value, keep the best so we can always
   // produce at least one answer.
   int best_hi_value = 1;
@@ -41,14 +166,16 @@ void OtsuThreshold(const unsigned char* imagedata,
   double best_hi_dist = 0.0;
   *thresholds = new int[bytes_per_pixel];
   *hi_values = new int[bytes_per_pixel];
+  // Compute the histograms of the image rectangle.
+  int* histograms = new int[bytes_per_pixel * kHistogramSize];
+  HistogramChannels(imagedata, bytes_per_pixel, bytes_per_pixel,
+                    bytes_per_line, left, top, width, height,
+                    histograms, pool);
 
   for (int ch = 0; ch < bytes_per_pixel; ++ch) {
     (*thresholds)[ch] = -1;
     (*hi_values)[ch] = -1;
-    // Compute the histogram of the image rectangle.
-    int histogram[kHistogramSize];
-    HistogramRect(imagedata + ch, bytes_per_pixel, bytes_per_line,
-                  left, top, width, height, histogram);
+    const int* histogram = histograms + ch * kHistogramSize;
     int H;
     int best_omega_0;
     int best_t = OtsuStats(histogram, &H, &best_omega_0);
@@ -81,6 +208,7 @@ void OtsuThreshold(const unsigned char* imagedata,
     // Use the best of the ones that were not good enough.
     (*hi_values)[best_hi_index] = best_hi_value;
   }
+  delete [] histograms;
 }
 
 // Compute the histogram for the given image rectangle, and the given
@@ -90,21 +218,13 @@ void OtsuThreshold(const unsigned char* imagedata,
 // counted with this call in a multi-channel (pixel-major) image.
 // Histogram is always a kHistogramSize(256) element array to count
 // occurrences of each pixel value.
+// If pool is not NULL, bands of rows are counted on it in parallel.
 void HistogramRect(const unsigned char* imagedata,
                    int bytes_per_pixel, int bytes_per_line,
                    int left, int top, int width, int height,
-                   int* histogram) {
-  int bottom = top + height;
-  memset(histogram, 0, sizeof(*histogram) * kHistogramSize);
-  const unsigned char* pixels = imagedata +
-                                top * bytes_per_line +
-                                left * bytes_per_pixel;
-  for (int y = top; y < bottom; ++y) {
-    for (int x = 0; x < width; ++x) {
-      ++histogram[pixels[x * bytes_per_pixel]];
-    }
-    pixels += bytes_per_line;
-  }
+                   int* histogram, ThreadPool* pool) {
+  HistogramChannels(imagedata, bytes_per_pixel, 1, bytes_per_line,
+                    left, top, width, height, histogram, pool);
 }
 
 // Compute the Otsu threshold(s) for the given histogram.
@@ -20,8 +20,12 @@
 #ifndef TESSERACT_CCMAIN_OTSUTHR_H__
 #define TESSERACT_CCMAIN_OTSUTHR_H__
 
+#include <stddef.h>
+
 namespace tesseract {
 
+class ThreadPool;
+
 const int kHistogramSize = 256;  // The size of a histogram of pixel values.
 
 // Compute the Otsu threshold(s) for the given image rectangle, making one
@@ -31,10 +35,12 @@ const int kHistogramSize = 256;  // The size of a histogram of pixel values.
 // hi_values[channel] is 0 or background if 1. A hi_value of -1 indicates
 // that there is no apparent foreground. At least one hi_value will not be -1.
 // Delete thresholds and hi_values with delete [] after use.
+// If pool is not NULL, the histograms of all the channels are computed on it
+// in parallel bands of rows.
 void OtsuThreshold(const unsigned char* imagedata,
                    int bytes_per_pixel, int bytes_per_line,
                    int left, int top, int width, int height,
-                   int** thresholds, int** hi_values);
+                   int** thresholds, int** hi_values, ThreadPool* pool = NULL);
 
 // Compute the histogram for the given image rectangle, and the given
 // channel. (Channel pointed to by imagedata.) Each channel is always
@@ -43,10 +49,11 @@ void OtsuThreshold(const unsigned char* imagedata,
 // counted with this call in a multi-channel (pixel-major) image.
 // Histogram is always a 256 element array to count occurrences of
 // each pixel value.
+// If pool is not NULL, bands of rows are counted on it in parallel.
 void HistogramRect(const unsigned char* imagedata,
                    int bytes_per_pixel, int bytes_per_line,
                    int left, int top, int width, int height,
-                   int* histogram);
+                   int* histogram, ThreadPool* pool = NULL);
 
 // Compute the Otsu threshold(s) for the given histogram.
 // Also returns H = total count in histogram, and
@@ -222,6 +222,9 @@ WERD_RES& WERD_RES::operator=(const WERD_RES & source) {
   reject_map = source.reject_map;
   combination = source.combination;
   part_of_combo = source.part_of_combo;
+  adapt_deferred = source.adapt_deferred;
+  adapt_rejmap = source.adapt_rejmap;
+  adapt_thresholds = source.adapt_thresholds;
   CopySimpleFields(source);
   if (source.blamer_bundle != NULL) {
     blamer_bundle =  new BlamerBundle(*(source.blamer_bundle));
@@ -425,6 +428,9 @@ void WERD_RES::ConsumeWordResults(WERD_RES* word) {
   alt_choices.move(&word->alt_choices);
   alt_states.move(&word->alt_states);
   reject_map = word->reject_map;
+  adapt_deferred = word->adapt_deferred;
+  adapt_rejmap = word->adapt_rejmap;
+  adapt_thresholds.move(&word->adapt_thresholds);
   if (word->blamer_bundle != NULL) {
     assert(blamer_bundle != NULL);
     blamer_bundle->CopyResults(*(word->blamer_bundle));
@@ -770,6 +776,7 @@ void WERD_RES::InitNonPointers() {
   combination = FALSE;
   part_of_combo = FALSE;
   reject_spaces = FALSE;
+  adapt_deferred = FALSE;
 }
 
 void WERD_RES::InitPointers() {
@@ -835,6 +842,9 @@ void WERD_RES::ClearResults() {
     alt_choices.clear();
   }
   alt_states.clear();
+  adapt_deferred = FALSE;
+  adapt_rejmap = "";
+  adapt_thresholds.clear();
   if (ep_choice != NULL) {
     delete ep_choice;
     ep_choice = NULL;
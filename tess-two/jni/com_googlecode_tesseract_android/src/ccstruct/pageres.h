@@ -452,6 +452,11 @@ class WERD_RES : public ELIST_LINK {
   BOOL8 reject_spaces;         //Reject spacing?
   // FontInfo ids for each unichar in best_choice.
   GenericVector<inT8> best_choice_fontinfo_ids;
+  // Adaption that was deferred by a word worker of a parallel recognition
+  // pass, to be applied later in page order. See Classify::DeferLearnWord.
+  BOOL8 adapt_deferred;
+  STRING adapt_rejmap;                    // LearnWord rejmap, empty for none.
+  GenericVector<float> adapt_thresholds;  // One per entry of correct_text.
 
   WERD_RES() {
     InitNonPointers();
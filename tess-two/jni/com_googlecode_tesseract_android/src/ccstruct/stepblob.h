@@ -21,12 +21,14 @@
 #define           STEPBLOB_H
 
 #include          "coutln.h"
+#include          "pagepool.h"
 #include          "rect.h"
 
 struct Pix;
 
 class C_BLOB:public ELIST_LINK
 {
+  PAGE_POOL_NEW_DELETE(C_BLOB)
   public:
     C_BLOB() {
     }
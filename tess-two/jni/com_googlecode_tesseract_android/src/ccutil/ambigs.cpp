@@ -46,6 +46,16 @@ void UnicharAmbigs::LoadUnicharAmbigs(FILE *AmbigFile,
                                       int debug_level,
                                       bool use_ambigs_for_adaption,
                                       UNICHARSET *unicharset) {
+  TFile ambig_file;
+  ambig_file.Open(AmbigFile, end_offset);
+  LoadUnicharAmbigs(&ambig_file, debug_level, use_ambigs_for_adaption,
+                    unicharset);
+}
+
+void UnicharAmbigs::LoadUnicharAmbigs(TFile *AmbigFile,
+                                      int debug_level,
+                                      bool use_ambigs_for_adaption,
+                                      UNICHARSET *unicharset) {
   int i, j;
   UnicharIdVector *adaption_ambigs_entry;
   for (i = 0; i < unicharset->size(); ++i) {
@@ -76,16 +86,15 @@ void UnicharAmbigs::LoadUnicharAmbigs(FILE *AmbigFile,
 
   // Determine the version of the ambigs file.
   int version = 0;
-  ASSERT_HOST(fgets(buffer, kBufferSize, AmbigFile) != NULL &&
+  ASSERT_HOST(AmbigFile->FGets(buffer, kBufferSize) != NULL &&
               strlen(buffer) > 0);
   if (*buffer == 'v') {
     version = static_cast<int>(strtol(buffer+1, NULL, 10));
     ++line_num;
   } else {
-    rewind(AmbigFile);
+    AmbigFile->Rewind();
   }
-  while ((end_offset < 0 || ftell(AmbigFile) < end_offset) &&
-         fgets(buffer, kBufferSize, AmbigFile) != NULL) {
+  while (AmbigFile->FGets(buffer, kBufferSize) != NULL) {
     chomp_string(buffer);
     if (debug_level > 2) tprintf("read line %s\n", buffer);
     ++line_num;
@@ -26,6 +26,7 @@
 #include "unichar.h"
 #include "unicharset.h"
 #include "genericvector.h"
+#include "serialis.h"
 
 #define MAX_AMBIG_SIZE    10
 
@@ -162,6 +163,9 @@ class UnicharAmbigs {
   // unichar ids that are ambiguous to it.
   void LoadUnicharAmbigs(FILE *ambigs_file, inT64 end_offset, int debug_level,
                          bool use_ambigs_for_adaption, UNICHARSET *unicharset);
+  // As above, but reads the ambigs from the given TFile, up to its end.
+  void LoadUnicharAmbigs(TFile *ambigs_file, int debug_level,
+                         bool use_ambigs_for_adaption, UNICHARSET *unicharset);
 
   // Returns definite 1-1 ambigs for the given unichar id.
   inline const UnicharIdVector *OneToOneDefiniteAmbigs(
@@ -21,6 +21,7 @@
 
 #include "ambigs.h"
 #include "errcode.h"
+#include "pagestats.h"
 #include "strngs.h"
 #include "tessdatamanager.h"
 #include "params.h"
@@ -73,6 +74,7 @@ class CCUtil {
   UnicharAmbigs unichar_ambigs;
   STRING imagefile;  // image file name
   STRING directory;  // main directory
+  PageStats page_stats;  // times and counters of the current page
 
  private:
   ParamsVectors params_;
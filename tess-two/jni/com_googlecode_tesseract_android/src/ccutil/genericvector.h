@@ -27,6 +27,7 @@
 #include "errcode.h"
 #include "helpers.h"
 #include "ndminx.h"
+#include "serialis.h"
 
 // Use PointerVector<T> below in preference to GenericVector<T*>, as that
 // provides automatic deletion of pointers, [De]Serialize that works, and
@@ -145,6 +146,9 @@ class GenericVector {
   // DEPRECATED. Use [De]Serialize[Classes] instead.
   bool write(FILE* f, TessResultCallback2<bool, FILE*, T const &>* cb) const;
   bool read(FILE* f, TessResultCallback3<bool, FILE*, T*, bool>* cb, bool swap);
+  bool read(tesseract::TFile* f,
+            TessResultCallback3<bool, tesseract::TFile*, T*, bool>* cb,
+            bool swap);
   // Writes a vector of simple types to the given file. Assumes that bitwise
   // read/write of T will work. Returns false in case of error.
   virtual bool Serialize(FILE* fp) const;
@@ -153,6 +157,7 @@ class GenericVector {
   // Returns false in case of error.
   // If swap is true, assumes a big/little-endian swap is needed.
   virtual bool DeSerialize(bool swap, FILE* fp);
+  bool DeSerialize(bool swap, tesseract::TFile* fp);
   // Writes a vector of classes to the given file. Assumes the existence of
   // bool T::Serialize(FILE* fp) const that returns false in case of error.
   // Returns false in case of error.
@@ -163,6 +168,7 @@ class GenericVector {
   // this function. Returns false in case of error.
   // If swap is true, assumes a big/little-endian swap is needed.
   bool DeSerializeClasses(bool swap, FILE* fp);
+  bool DeSerializeClasses(bool swap, tesseract::TFile* fp);
 
   // Allocates a new array of double the current_size, copies over the
   // information from data to the new location, deletes data and returns
@@ -433,6 +439,24 @@ class PointerVector : public GenericVector<T*> {
     }
     return true;
   }
+  // As above, but reads from a TFile. Needs T::DeSerialize(bool, TFile*).
+  bool DeSerialize(bool swap, tesseract::TFile* fp) {
+    inT32 reserved;
+    if (fp->FRead(&reserved, sizeof(reserved), 1) != 1) return false;
+    if (swap) Reverse32(&reserved);
+    GenericVector<T*>::reserve(reserved);
+    for (int i = 0; i < reserved; ++i) {
+      inT8 non_null;
+      if (fp->FRead(&non_null, sizeof(non_null), 1) != 1) return false;
+      T* item = NULL;
+      if (non_null) {
+        item = new T;
+        if (!item->DeSerialize(swap, fp)) return false;
+      }
+      this->push_back(item);
+    }
+    return true;
+  }
 
   // Sorts the items pointed to by the members of this vector using
   // t::operator<().
@@ -724,6 +748,35 @@ bool GenericVector<T>::read(FILE* f,
   return true;
 }
 
+template <typename T>
+bool GenericVector<T>::read(
+    tesseract::TFile* f,
+    TessResultCallback3<bool, tesseract::TFile*, T*, bool>* cb,
+    bool swap) {
+  inT32 reserved;
+  if (f->FRead(&reserved, sizeof(reserved), 1) != 1) return false;
+  if (swap) Reverse32(&reserved);
+  reserve(reserved);
+  if (f->FRead(&size_used_, sizeof(size_used_), 1) != 1) return false;
+  if (swap) Reverse32(&size_used_);
+  if (cb != NULL) {
+    for (int i = 0; i < size_used_; ++i) {
+      if (!cb->Run(f, data_ + i, swap)) {
+        delete cb;
+        return false;
+      }
+    }
+    delete cb;
+  } else {
+    if (f->FRead(data_, sizeof(T), size_used_) != size_used_) return false;
+    if (swap) {
+      for (int i = 0; i < size_used_; ++i)
+        ReverseN(&data_[i], sizeof(T));
+    }
+  }
+  return true;
+}
+
 // Writes a vector of simple types to the given file. Assumes that bitwise
 // read/write of T will work. Returns false in case of error.
 template <typename T>
@@ -751,6 +804,20 @@ bool GenericVector<T>::DeSerialize(bool swap, FILE* fp) {
   }
   return true;
 }
+template <typename T>
+bool GenericVector<T>::DeSerialize(bool swap, tesseract::TFile* fp) {
+  inT32 reserved;
+  if (fp->FRead(&reserved, sizeof(reserved), 1) != 1) return false;
+  if (swap) Reverse32(&reserved);
+  reserve(reserved);
+  size_used_ = reserved;
+  if (fp->FRead(data_, sizeof(T), size_used_) != size_used_) return false;
+  if (swap) {
+    for (int i = 0; i < size_used_; ++i)
+      ReverseN(&data_[i], sizeof(data_[i]));
+  }
+  return true;
+}
 
 // Writes a vector of classes to the given file. Assumes the existence of
 // bool T::Serialize(FILE* fp) const that returns false in case of error.
@@ -781,6 +848,18 @@ bool GenericVector<T>::DeSerializeClasses(bool swap, FILE* fp) {
   }
   return true;
 }
+template <typename T>
+bool GenericVector<T>::DeSerializeClasses(bool swap, tesseract::TFile* fp) {
+  uinT32 reserved;
+  if (fp->FRead(&reserved, sizeof(reserved), 1) != 1) return false;
+  if (swap) Reverse32(&reserved);
+  T empty;
+  init_to_size(reserved, empty);
+  for (int i = 0; i < reserved; ++i) {
+    if (!data_[i].DeSerialize(swap, fp)) return false;
+  }
+  return true;
+}
 
 // This method clear the current object, then, does a shallow copy of
 // its argument, and finally invalidates its argument.
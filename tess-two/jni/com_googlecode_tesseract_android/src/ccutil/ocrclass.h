@@ -109,6 +109,21 @@ typedef struct {                  /*single character */
  **********************************************************************/
 typedef bool (*CANCEL_FUNC)(void* cancel_this, int words);
 
+/**********************************************************************
+ * If the row result function is not null then it is called as soon as
+ * each recognition pass (1 or 2) has finished a row of text, with the
+ * progress at that point, the index of the row in the page, and the
+ * num_words words of the row: their UTF-8 text, their bounding boxes as
+ * left, top, right, bottom (4 ints per word) in pixels from the top left of
+ * the image or rectangle being recognized, and their confidences (0-100).
+ * The results of pass 1 may still be changed by pass 2, and those of pass 2
+ * by the later passes. The arrays are only valid during the call.
+ **********************************************************************/
+typedef void (*ROW_RESULT_FUNC)(void* result_this, int pass, int progress,
+                                int row_index, int num_words,
+                                const char* const* words, const int* boxes,
+                                const int* confidences);
+
 class ETEXT_DESC {             // output header
  public:
   inT16 count;                 // chars in this buffer(0)
@@ -120,10 +135,13 @@ class ETEXT_DESC {             // output header
   void* cancel_this;           // this or other data for cancel
   struct timeval end_time;     // time to stop. expected to be set only by call
                                // to set_deadline_msecs()
+  ROW_RESULT_FUNC row_result;  // called with the words of each row
+  void* result_this;           // this or other data for row_result
   EANYCODE_CHAR text[1];       // character data
 
   ETEXT_DESC() : count(0), progress(0), more_to_come(0), ocr_alive(0),
-                   err_code(0), cancel(NULL), cancel_this(NULL) {
+                   err_code(0), cancel(NULL), cancel_this(NULL),
+                   row_result(NULL), result_this(NULL) {
     end_time.tv_sec = 0;
     end_time.tv_usec = 0;
   }
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagepool.cpp
+// Description: Pools for the small objects made in bulk for each page.
+// Created:     Fri Oct 16 19:41:08 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pagepool.h"
+
+#include <stdlib.h>
+
+#include "ccutil.h"
+#include "errcode.h"
+#include "tprintf.h"
+
+namespace tesseract {
+
+// Approximate size of each chunk in bytes.
+const size_t kChunkBytes = 32768;
+// Objects are rounded up to a multiple of this size to keep them aligned.
+const size_t kObjectAlignment = 8;
+// Offset of the first object in a chunk, after the header.
+const size_t kChunkHeaderBytes = kObjectAlignment;
+
+// The list of all the pools, and its lock.
+static PagePool* all_pools = NULL;
+static CCUtilMutex* AllPoolsMutex() {
+  static CCUtilMutex* mutex = new CCUtilMutex;
+  return mutex;
+}
+
+PagePool::PagePool(const char* name, size_t object_size)
+  : name_(name), mutex_(new CCUtilMutex), chunks_(NULL), num_chunks_(0),
+    free_list_(NULL), unused_start_(NULL), unused_end_(NULL),
+    live_objects_(0), allocations_(0), chunk_allocations_(0),
+    peak_live_objects_(0), peak_chunks_(0), total_allocations_(0),
+    total_chunk_allocations_(0) {
+  if (object_size < sizeof(FreeObject))
+    object_size = sizeof(FreeObject);
+  object_size_ = (object_size + kObjectAlignment - 1) &
+      ~(kObjectAlignment - 1);
+  chunk_objects_ = (kChunkBytes - kChunkHeaderBytes) / object_size_;
+  if (chunk_objects_ < 1)
+    chunk_objects_ = 1;
+  CCUtilMutex* all_pools_mutex = AllPoolsMutex();
+  all_pools_mutex->Lock();
+  next_pool_ = all_pools;
+  all_pools = this;
+  all_pools_mutex->Unlock();
+}
+
+void* PagePool::Allocate(size_t size) {
+  if (size > object_size_)
+    return ::operator new(size);
+  mutex_->Lock();
+  void* ptr;
+  if (free_list_ != NULL) {
+    ptr = free_list_;
+    free_list_ = free_list_->next;
+  } else {
+    if (unused_start_ == unused_end_)
+      AddChunk();
+    ptr = unused_start_;
+    unused_start_ += object_size_;
+  }
+  ++allocations_;
+  ++total_allocations_;
+  if (++live_objects_ > peak_live_objects_)
+    peak_live_objects_ = live_objects_;
+  mutex_->Unlock();
+  return ptr;
+}
+
+void PagePool::Free(void* ptr, size_t size) {
+  if (ptr == NULL)
+    return;
+  if (size > object_size_) {
+    ::operator delete(ptr);
+    return;
+  }
+  mutex_->Lock();
+  FreeObject* object = static_cast<FreeObject*>(ptr);
+  object->next = free_list_;
+  free_list_ = object;
+  --live_objects_;
+  mutex_->Unlock();
+}
+
+bool PagePool::ReleaseIfUnused() {
+  mutex_->Lock();
+  bool empty = live_objects_ == 0;
+  if (empty) {
+    while (chunks_ != NULL) {
+      Chunk* next = chunks_->next;
+      free(chunks_);
+      chunks_ = next;
+    }
+    num_chunks_ = 0;
+    free_list_ = NULL;
+    unused_start_ = unused_end_ = NULL;
+  }
+  mutex_->Unlock();
+  return empty;
+}
+
+void PagePool::PrintStats() {
+  mutex_->Lock();
+  tprintf("%s: %d allocations in %d mallocs, peak %d bytes in %d objects,"
+          " %d in chunks\n",
+          name_, allocations_, chunk_allocations_,
+          static_cast<int>(peak_live_objects_ * object_size_),
+          peak_live_objects_,
+          static_cast<int>(peak_chunks_ *
+                           (kChunkHeaderBytes + chunk_objects_ * object_size_)));
+  allocations_ = 0;
+  chunk_allocations_ = 0;
+  peak_live_objects_ = live_objects_;
+  peak_chunks_ = num_chunks_;
+  mutex_->Unlock();
+}
+
+void PagePool::ReleaseAllUnused() {
+  CCUtilMutex* all_pools_mutex = AllPoolsMutex();
+  all_pools_mutex->Lock();
+  for (PagePool* pool = all_pools; pool != NULL; pool = pool->next_pool_)
+    pool->ReleaseIfUnused();
+  all_pools_mutex->Unlock();
+}
+
+void PagePool::PrintAllStats() {
+  CCUtilMutex* all_pools_mutex = AllPoolsMutex();
+  all_pools_mutex->Lock();
+  for (PagePool* pool = all_pools; pool != NULL; pool = pool->next_pool_)
+    pool->PrintStats();
+  all_pools_mutex->Unlock();
+}
+
+void PagePool::GetAllTotals(inT64* allocations, inT64* chunk_allocations) {
+  *allocations = 0;
+  *chunk_allocations = 0;
+  CCUtilMutex* all_pools_mutex = AllPoolsMutex();
+  all_pools_mutex->Lock();
+  for (PagePool* pool = all_pools; pool != NULL; pool = pool->next_pool_) {
+    pool->mutex_->Lock();
+    *allocations += pool->total_allocations_;
+    *chunk_allocations += pool->total_chunk_allocations_;
+    pool->mutex_->Unlock();
+  }
+  all_pools_mutex->Unlock();
+}
+
+void PagePool::AddChunk() {
+  Chunk* chunk = static_cast<Chunk*>(
+      malloc(kChunkHeaderBytes + chunk_objects_ * object_size_));
+  ASSERT_HOST(chunk != NULL);
+  chunk->next = chunks_;
+  chunks_ = chunk;
+  unused_start_ = reinterpret_cast<char*>(chunk) + kChunkHeaderBytes;
+  unused_end_ = unused_start_ + chunk_objects_ * object_size_;
+  ++chunk_allocations_;
+  ++total_chunk_allocations_;
+  if (++num_chunks_ > peak_chunks_)
+    peak_chunks_ = num_chunks_;
+}
+
+}  // namespace tesseract.
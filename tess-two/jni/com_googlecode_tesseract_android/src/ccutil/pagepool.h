@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagepool.h
+// Description: Pools for the small objects made in bulk for each page.
+// Created:     Fri Oct 16 19:41:08 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_PAGEPOOL_H_
+#define TESSERACT_CCUTIL_PAGEPOOL_H_
+
+#include <stddef.h>
+
+#include "host.h"
+
+namespace tesseract {
+
+class CCUtilMutex;
+
+// Allocator for one type of small object, such as the crack edges, outlines
+// and blobs, that are made and destroyed by the hundred thousand on every
+// page. Objects are carved out of large chunks and recycled through a free
+// list, so the system allocator only sees one call per chunk. The chunks are
+// given back all together by ReleaseIfUnused, which the api calls for all
+// the pools at the end of each page, when none of the objects are left.
+// A class uses a pool by putting PAGE_POOL_NEW_DELETE in its declaration.
+// All the methods are thread-safe.
+class PagePool {
+ public:
+  // Creates a pool of objects of object_size bytes, named name in the stats.
+  // name must outlive the pool. Pools are never deleted.
+  PagePool(const char* name, size_t object_size);
+
+  // Returns memory for an object of size bytes. Objects that are not of the
+  // pool's size, ie of a derived class, come from operator new.
+  void* Allocate(size_t size);
+  // Frees ptr, which Allocate returned for an object of size bytes.
+  void Free(void* ptr, size_t size);
+
+  // Gives the chunks back to the system if no objects are allocated.
+  // Returns true if the pool is now empty.
+  bool ReleaseIfUnused();
+  // Prints the allocation stats since the last call and resets them.
+  void PrintStats();
+
+  // ReleaseIfUnused on every pool.
+  static void ReleaseAllUnused();
+  // PrintStats on every pool.
+  static void PrintAllStats();
+  // Sets *allocations and *chunk_allocations to the totals over every pool
+  // since the pools were made. Unlike the printed stats, they are never
+  // reset, so callers measure an interval by the difference.
+  static void GetAllTotals(inT64* allocations, inT64* chunk_allocations);
+
+ private:
+  // Header of a chunk. The objects follow it.
+  struct Chunk {
+    Chunk* next;
+  };
+  // A freed object, linked into the free list.
+  struct FreeObject {
+    FreeObject* next;
+  };
+
+  // Adds a new chunk to carve objects from. Called with mutex_ held.
+  void AddChunk();
+
+  const char* name_;
+  // Size of each object, rounded up to keep them all aligned.
+  size_t object_size_;
+  // Number of objects in each chunk.
+  int chunk_objects_;
+  CCUtilMutex* mutex_;
+  // All the chunks, newest first.
+  Chunk* chunks_;
+  int num_chunks_;
+  // Objects that have been freed.
+  FreeObject* free_list_;
+  // Part of the newest chunk that has never been allocated.
+  char* unused_start_;
+  char* unused_end_;
+  int live_objects_;
+  // Stats since the last PrintStats.
+  int allocations_;
+  int chunk_allocations_;
+  int peak_live_objects_;
+  int peak_chunks_;
+  // Totals since the pool was made.
+  inT64 total_allocations_;
+  inT64 total_chunk_allocations_;
+  // Next pool in the list of all pools.
+  PagePool* next_pool_;
+};
+
+}  // namespace tesseract.
+
+// Makes new and delete of CLASSNAME use a PagePool of its own.
+#define PAGE_POOL_NEW_DELETE(CLASSNAME)                                   \
+ public:                                                                  \
+  static void* operator new(size_t size) {                                \
+    return page_pool()->Allocate(size);                                   \
+  }                                                                       \
+  static void operator delete(void* ptr, size_t size) {                   \
+    page_pool()->Free(ptr, size);                                         \
+  }                                                                       \
+  static tesseract::PagePool* page_pool() {                               \
+    static tesseract::PagePool* pool =                                    \
+        new tesseract::PagePool(#CLASSNAME, sizeof(CLASSNAME));           \
+    return pool;                                                          \
+  }
+
+#endif  // TESSERACT_CCUTIL_PAGEPOOL_H_
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagestats.cpp
+// Description: Per-stage times and counters of the recognition of a page.
+// Created:     Fri Oct 16 22:51:40 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pagestats.h"
+
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include "platform.h"
+
+namespace tesseract {
+
+static const char* const kStageNames[PS_COUNT] = {
+  "threshold", "segment_page", "pass1", "pass2", "chopper", "seg_search",
+  "adaptive_classifier", "fix_spaces", "paragraphs"
+};
+
+static const char* const kCounterNames[PC_COUNT] = {
+  "classifier_calls", "chops", "pain_points", "pool_allocations",
+  "pool_mallocs"
+};
+
+// Big enough for any one formatted item of the output.
+const int kMaxItemSize = 256;
+
+PageStats::PageStats() {
+  Reset(PSL_OFF, 0);
+}
+
+void PageStats::Reset(int level, int thread_id) {
+  level_ = level;
+  thread_id_ = thread_id;
+  page_start_usecs_ = level > PSL_OFF ? NowMicros() : 0;
+  page_end_usecs_ = page_start_usecs_;
+  memset(stage_usecs_, 0, sizeof(stage_usecs_));
+  memset(stage_calls_, 0, sizeof(stage_calls_));
+  memset(counts_, 0, sizeof(counts_));
+  events_.truncate(0);
+}
+
+void PageStats::AddStageTime(PageStage stage, inT64 start_usecs,
+                             inT64 end_usecs) {
+  if (!enabled())
+    return;
+  stage_usecs_[stage] += end_usecs - start_usecs;
+  ++stage_calls_[stage];
+  if (end_usecs > page_end_usecs_)
+    page_end_usecs_ = end_usecs;
+  if (level_ >= PSL_TRACE) {
+    Event event = {start_usecs, end_usecs, stage, thread_id_};
+    events_.push_back(event);
+  }
+}
+
+void PageStats::Merge(const PageStats& other) {
+  if (!enabled() || !other.enabled())
+    return;
+  for (int s = 0; s < PS_COUNT; ++s) {
+    stage_usecs_[s] += other.stage_usecs_[s];
+    stage_calls_[s] += other.stage_calls_[s];
+  }
+  for (int c = 0; c < PC_COUNT; ++c)
+    counts_[c] += other.counts_[c];
+  if (other.page_end_usecs_ > page_end_usecs_)
+    page_end_usecs_ = other.page_end_usecs_;
+  if (level_ >= PSL_TRACE)
+    events_ += other.events_;
+}
+
+const char* PageStats::StageName(PageStage stage) {
+  return kStageNames[stage];
+}
+
+const char* PageStats::CounterName(PageCounter counter) {
+  return kCounterNames[counter];
+}
+
+void PageStats::ToJSON(STRING* json) const {
+  char item[kMaxItemSize];
+  snprintf(item, kMaxItemSize, "{\"page_usecs\":%lld,\"stages\":{",
+           page_usecs());
+  *json += item;
+  for (int s = 0; s < PS_COUNT; ++s) {
+    snprintf(item, kMaxItemSize, "%s\"%s\":{\"usecs\":%lld,\"calls\":%d}",
+             s > 0 ? "," : "", kStageNames[s], stage_usecs_[s],
+             stage_calls_[s]);
+    *json += item;
+  }
+  *json += "},\"counters\":{";
+  for (int c = 0; c < PC_COUNT; ++c) {
+    snprintf(item, kMaxItemSize, "%s\"%s\":%lld",
+             c > 0 ? "," : "", kCounterNames[c], counts_[c]);
+    *json += item;
+  }
+  *json += "}}";
+}
+
+void PageStats::ToChromeTrace(STRING* trace) const {
+  char item[kMaxItemSize];
+  *trace += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  if (level_ >= PSL_TRACE) {
+    for (int e = 0; e < events_.size(); ++e) {
+      const Event& event = events_[e];
+      snprintf(item, kMaxItemSize,
+               "%s{\"name\":\"%s\",\"cat\":\"tesseract\",\"ph\":\"X\","
+               "\"ts\":%lld,\"dur\":%lld,\"pid\":0,\"tid\":%d}",
+               e > 0 ? "," : "", kStageNames[event.stage],
+               event.start_usecs - page_start_usecs_,
+               event.end_usecs - event.start_usecs, event.thread_id);
+      *trace += item;
+    }
+  } else {
+    // Only the totals are known, so lay the stages out end to end.
+    inT64 ts = 0;
+    for (int s = 0; s < PS_COUNT; ++s) {
+      snprintf(item, kMaxItemSize,
+               "%s{\"name\":\"%s\",\"cat\":\"tesseract\",\"ph\":\"X\","
+               "\"ts\":%lld,\"dur\":%lld,\"pid\":0,\"tid\":%d,"
+               "\"args\":{\"calls\":%d}}",
+               s > 0 ? "," : "", kStageNames[s], ts, stage_usecs_[s],
+               thread_id_, stage_calls_[s]);
+      *trace += item;
+      ts += stage_usecs_[s];
+    }
+  }
+  bool any_events = level_ < PSL_TRACE || !events_.empty();
+  snprintf(item, kMaxItemSize,
+           "%s{\"name\":\"counters\",\"ph\":\"C\",\"ts\":%lld,\"pid\":0,"
+           "\"args\":{", any_events ? "," : "", page_usecs());
+  *trace += item;
+  for (int c = 0; c < PC_COUNT; ++c) {
+    snprintf(item, kMaxItemSize, "%s\"%s\":%lld",
+             c > 0 ? "," : "", kCounterNames[c], counts_[c]);
+    *trace += item;
+  }
+  *trace += "}}]}";
+}
+
+inT64 PageStats::NowMicros() {
+#ifdef _WIN32
+  FILETIME now;
+  GetSystemTimeAsFileTime(&now);
+  return ((static_cast<inT64>(now.dwHighDateTime) << 32) |
+          now.dwLowDateTime) / 10;
+#else
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return static_cast<inT64>(now.tv_sec) * 1000000 + now.tv_usec;
+#endif
+}
+
+}  // namespace tesseract.
@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagestats.h
+// Description: Per-stage times and counters of the recognition of a page.
+// Created:     Fri Oct 16 22:51:40 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_PAGESTATS_H_
+#define TESSERACT_CCUTIL_PAGESTATS_H_
+
+#include "genericvector.h"
+#include "host.h"
+#include "strngs.h"
+
+namespace tesseract {
+
+// The timed stages of recognizing a page. The stages nest, eg the chopper
+// runs within pass 1 and pass 2, so the time of a stage includes the time of
+// the stages that ran within it.
+enum PageStage {
+  PS_THRESHOLD,            // TessBaseAPI::Threshold.
+  PS_SEGMENT_PAGE,         // Tesseract::SegmentPage, ie FindLines.
+  PS_PASS1,                // Pass 1 of recog_all_words.
+  PS_PASS2,                // Pass 2 of recog_all_words.
+  PS_CHOPPER,              // Wordrec::improve_by_chopping.
+  PS_SEG_SEARCH,           // Wordrec::SegSearch.
+  PS_ADAPTIVE_CLASSIFIER,  // Classify::AdaptiveClassifier.
+  PS_FIX_SPACES,           // Tesseract::fix_fuzzy_spaces.
+  PS_PARAGRAPHS,           // TessBaseAPI::DetectParagraphs.
+  PS_COUNT
+};
+
+// The counted events of recognizing a page.
+enum PageCounter {
+  PC_CLASSIFIER_CALLS,     // Blobs classified by AdaptiveClassifier.
+  PC_CHOPS,                // Blobs split by the chopper.
+  PC_PAIN_POINTS,          // Pain points classified by SegSearch.
+  PC_POOL_ALLOCATIONS,     // Objects allocated from the PagePools.
+  PC_POOL_MALLOCS,         // Chunks allocated by the PagePools.
+  PC_COUNT
+};
+
+// How much PageStats records.
+enum PageStatsLevel {
+  PSL_OFF,     // Nothing.
+  PSL_TOTALS,  // Total time and number of calls of each stage, and counters.
+  PSL_TRACE    // Also each call of each stage, for ToChromeTrace.
+};
+
+// Times and counters of the recognition of a page, collected when the
+// tessedit_page_stats param is set, and returned by
+// TessBaseAPI::GetPageStats. Each Tesseract has its own, and each is only
+// used by one thread at a time. The word workers' stats are merged into
+// those of the Tesseract they work for at the end of each parallel pass.
+// When off, each timed stage only costs a test of enabled().
+class PageStats {
+ public:
+  PageStats();
+
+  // Discards everything recorded and starts a new page at the given level.
+  // Events recorded by this are labeled with thread_id in the trace.
+  void Reset(int level, int thread_id);
+
+  bool enabled() const {
+    return level_ > PSL_OFF;
+  }
+  int level() const {
+    return level_;
+  }
+
+  // Records a call of stage that ran from start_usecs to end_usecs.
+  void AddStageTime(PageStage stage, inT64 start_usecs, inT64 end_usecs);
+  // Adds n to counter.
+  void Count(PageCounter counter, int n) {
+    if (enabled())
+      counts_[counter] += n;
+  }
+  void Count(PageCounter counter) {
+    Count(counter, 1);
+  }
+  // Adds the times, calls, counts and events of other to this.
+  void Merge(const PageStats& other);
+
+  inT64 stage_usecs(PageStage stage) const {
+    return stage_usecs_[stage];
+  }
+  int stage_calls(PageStage stage) const {
+    return stage_calls_[stage];
+  }
+  inT64 count(PageCounter counter) const {
+    return counts_[counter];
+  }
+  // Time from the Reset to the end of the last recorded stage call.
+  inT64 page_usecs() const {
+    return page_end_usecs_ - page_start_usecs_;
+  }
+
+  // Names of the stages and counters as used in the output.
+  static const char* StageName(PageStage stage);
+  static const char* CounterName(PageCounter counter);
+
+  // Appends the totals to json, as an object with "stages" and "counters".
+  void ToJSON(STRING* json) const;
+  // Appends the stage calls and the counters to trace, in the Chrome trace
+  // event format, as read by chrome://tracing. Without PSL_TRACE, each stage
+  // is shown as a single call of its total time.
+  void ToChromeTrace(STRING* trace) const;
+
+  // Current wall time in microseconds.
+  static inT64 NowMicros();
+
+ private:
+  // A call of a stage, recorded with PSL_TRACE.
+  struct Event {
+    inT64 start_usecs;
+    inT64 end_usecs;
+    int stage;
+    int thread_id;
+  };
+
+  int level_;
+  int thread_id_;
+  inT64 page_start_usecs_;
+  inT64 page_end_usecs_;
+  inT64 stage_usecs_[PS_COUNT];
+  int stage_calls_[PS_COUNT];
+  inT64 counts_[PC_COUNT];
+  GenericVector<Event> events_;
+};
+
+// Records the time from its construction to Stop or its destruction as a
+// call of stage in stats, if stats is enabled.
+class PageStageTimer {
+ public:
+  PageStageTimer(PageStats* stats, PageStage stage)
+    : stats_(stats->enabled() ? stats : NULL), stage_(stage), start_usecs_(0) {
+    if (stats_ != NULL)
+      start_usecs_ = PageStats::NowMicros();
+  }
+  ~PageStageTimer() {
+    Stop();
+  }
+  // Ends the timed call. Does nothing if already stopped.
+  void Stop() {
+    if (stats_ != NULL) {
+      stats_->AddStageTime(stage_, start_usecs_, PageStats::NowMicros());
+      stats_ = NULL;
+    }
+  }
+
+ private:
+  PageStats* stats_;
+  PageStage stage_;
+  inT64 start_usecs_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCUTIL_PAGESTATS_H_
@@ -71,14 +71,20 @@ bool ParamUtils::ReadParamsFile(const char *file,
 bool ParamUtils::ReadParamsFromFp(FILE *fp, inT64 end_offset,
                                   SetParamConstraint constraint,
                                   ParamsVectors *member_params) {
+  TFile file;
+  file.Open(fp, end_offset);
+  return ReadParamsFromFp(&file, constraint, member_params);
+}
+
+bool ParamUtils::ReadParamsFromFp(TFile *fp, SetParamConstraint constraint,
+                                  ParamsVectors *member_params) {
   char line[MAX_PATH];           // input line
   bool anyerr = false;           // true if any error
   bool foundit;                  // found parameter
   inT16 length;                  // length of line
   char *valptr;                  // value field
 
-  while ((end_offset < 0 || ftell(fp) < end_offset) &&
-         fgets(line, MAX_PATH, fp)) {
+  while (fp->FGets(line, MAX_PATH) != NULL) {
     if (line[0] != '\n' && line[0] != '#') {
       length = strlen (line);
       if (line[length - 1] == '\n')
@@ -209,4 +215,30 @@ void ParamUtils::PrintParams(FILE *fp, const ParamsVectors *member_params) {
   }
 }
 
+// Helper to copy the values of one type of param for CopyParams.
+template<class T>
+static void CopyParamValues(const GenericVector<T *> &src,
+                            const GenericVector<T *> &dst) {
+  for (int i = 0; i < dst.size(); ++i) {
+    const char *name = dst[i]->name_str();
+    // Instances of the same class list their params in the same order, so
+    // look in the same place first.
+    T *src_param = i < src.size() && strcmp(src[i]->name_str(), name) == 0
+                 ? src[i] : NULL;
+    for (int j = 0; src_param == NULL && j < src.size(); ++j) {
+      if (strcmp(src[j]->name_str(), name) == 0)
+        src_param = src[j];
+    }
+    if (src_param != NULL)
+      dst[i]->set_value(*src_param);
+  }
+}
+
+void ParamUtils::CopyParams(const ParamsVectors &src, ParamsVectors *dst) {
+  CopyParamValues(src.int_params, dst->int_params);
+  CopyParamValues(src.bool_params, dst->bool_params);
+  CopyParamValues(src.string_params, dst->string_params);
+  CopyParamValues(src.double_params, dst->double_params);
+}
+
 }  // namespace tesseract
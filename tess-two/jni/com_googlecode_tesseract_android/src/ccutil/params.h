@@ -23,6 +23,7 @@
 #include          <stdio.h>
 
 #include          "genericvector.h"
+#include          "serialis.h"
 #include          "strngs.h"
 
 namespace tesseract {
@@ -64,6 +65,9 @@ class ParamUtils {
   static bool ReadParamsFromFp(FILE *fp, inT64 end_offset,
                                SetParamConstraint constraint,
                                ParamsVectors *member_params);
+  // Read parameters from the given TFile (stop at its end).
+  static bool ReadParamsFromFp(TFile *fp, SetParamConstraint constraint,
+                               ParamsVectors *member_params);
 
   // Set a parameters to have the given value.
   static bool SetParam(const char *name, const char* value,
@@ -104,6 +108,10 @@ class ParamUtils {
 
   // Print parameters to the given file.
   static void PrintParams(FILE *fp, const ParamsVectors *member_params);
+
+  // Sets each of the dst params to the value of the src param of the same
+  // name, if there is one. Used to keep instances of the same class in step.
+  static void CopyParams(const ParamsVectors &src, ParamsVectors *dst);
 };
 
 // Definition of various parameter types.
@@ -19,6 +19,7 @@
 
 #include          "mfcpch.h"     //precompiled headers
 #include "serialis.h"
+#include <stdint.h>
 #include "scanutils.h"
 
 // Byte swap an inT64 or uinT64.
@@ -52,3 +53,91 @@ DLLSYM uinT16 reverse16(            //switch endian
                        ) {
   return ((num & 0xff) << 8) | ((num >> 8) & 0xff);
 }
+
+namespace tesseract {
+
+TFile::TFile()
+  : fp_(NULL), start_offset_(0), end_offset_(-1),
+    data_(NULL), size_(0), offset_(0) {
+}
+
+TFile::~TFile() {
+}
+
+void TFile::Open(FILE* fp, inT64 end_offset) {
+  fp_ = fp;
+  start_offset_ = ftell(fp);
+  end_offset_ = end_offset;
+  data_ = NULL;
+  size_ = 0;
+  offset_ = 0;
+}
+
+void TFile::Open(const char* data, int size) {
+  fp_ = NULL;
+  start_offset_ = 0;
+  end_offset_ = -1;
+  data_ = data;
+  size_ = size;
+  offset_ = 0;
+}
+
+char* TFile::FGets(char* buffer, int buffer_size) {
+  inT64 left = BytesLeft();
+  if (left == 0 || buffer_size < 2)
+    return NULL;
+  if (left > 0 && buffer_size > left + 1)
+    buffer_size = static_cast<int>(left + 1);
+  if (fp_ != NULL)
+    return fgets(buffer, buffer_size, fp_);
+  int length = 0;
+  while (length < buffer_size - 1 && offset_ < size_) {
+    char ch = data_[offset_++];
+    buffer[length++] = ch;
+    if (ch == '\n')
+      break;
+  }
+  buffer[length] = '\0';
+  return buffer;
+}
+
+int TFile::FRead(void* buffer, int size, int count) {
+  if (size <= 0 || count <= 0)
+    return 0;
+  inT64 left = BytesLeft();
+  if (left >= 0 && static_cast<inT64>(size) * count > left)
+    count = static_cast<int>(left / size);
+  if (fp_ != NULL)
+    return static_cast<int>(fread(buffer, size, count, fp_));
+  memcpy(buffer, data_ + offset_, size * count);
+  offset_ += size * count;
+  return count;
+}
+
+const char* TFile::FReadInPlace(int size, int alignment) {
+  if (fp_ != NULL || size < 0 || size > size_ - offset_)
+    return NULL;
+  const char* result = data_ + offset_;
+  if (reinterpret_cast<uintptr_t>(result) % alignment != 0)
+    return NULL;
+  offset_ += size;
+  return result;
+}
+
+void TFile::Rewind() {
+  if (fp_ != NULL)
+    fseek(fp_, start_offset_, SEEK_SET);
+  else
+    offset_ = 0;
+}
+
+inT64 TFile::BytesLeft() const {
+  if (fp_ == NULL)
+    return size_ - offset_;
+  if (end_offset_ < 0)
+    return -1;
+  inT64 left = end_offset_ + 1 - ftell(fp_);
+  return left > 0 ? left : 0;
+}
+
+}  // namespace tesseract.
@@ -40,4 +40,55 @@ Replace <parm> with "<parm>".  <parm> may be an arbitrary number of tokens
 
 #define QUOTE_IT( parm ) #parm
 
+namespace tesseract {
+
+// Simple file class that reads either from a FILE or from a region of
+// memory, such as a component of a memory-mapped traineddata file, so that
+// the same deserialization code can be used for both.
+class TFile {
+ public:
+  TFile();
+  ~TFile();
+
+  // Reads from fp, starting at its current position and ending at
+  // end_offset, the offset of the last byte to read, or at the end of the
+  // file if end_offset is negative. fp is not owned, and reads go straight
+  // to it, so they may be mixed with direct reads of fp.
+  void Open(FILE* fp, inT64 end_offset);
+  // Reads from the size bytes at data, which are not copied, so they must
+  // outlive the TFile and anything that uses them in place.
+  void Open(const char* data, int size);
+
+  // Reads a line, as fgets. Returns NULL at the end of the data.
+  char* FGets(char* buffer, int buffer_size);
+  // Reads up to count items of size bytes, as fread, returning the number of
+  // complete items read.
+  int FRead(void* buffer, int size, int count);
+  // If the TFile reads from memory, skips size bytes and returns a pointer
+  // to them, so they can be used in place. Returns NULL without skipping if
+  // the TFile reads from a FILE, there are fewer than size bytes left, or
+  // they are not aligned to a multiple of alignment.
+  const char* FReadInPlace(int size, int alignment);
+  // Goes back to where the TFile was opened.
+  void Rewind();
+
+  // Returns true if the TFile reads from memory.
+  bool in_memory() const {
+    return fp_ == NULL;
+  }
+
+ private:
+  // Returns the number of bytes left to read, or -1 if unlimited.
+  inT64 BytesLeft() const;
+
+  FILE* fp_;
+  inT64 start_offset_;
+  inT64 end_offset_;
+  const char* data_;
+  int size_;
+  int offset_;
+};
+
+}  // namespace tesseract.
+
 #endif
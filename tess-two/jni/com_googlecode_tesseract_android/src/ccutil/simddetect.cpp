@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////
+// File:        simddetect.cpp
+// Description: Runtime detection of the SIMD instruction sets available
+//              to the vectorized classifier kernels.
+// Created:     Fri Oct 16 10:12:41 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "simddetect.h"
+
+#include <stddef.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#if defined(__GNUC__)
+#include <cpuid.h>
+#define X86_CPUID_AVAILABLE
+#endif
+#elif defined(__arm__) || defined(__aarch64__)
+#if defined(__ANDROID__)
+#include <cpu-features.h>
+#endif
+#endif
+
+namespace tesseract {
+
+#ifdef X86_CPUID_AVAILABLE
+// Reads the extended control register 0 to check that the OS saves the
+// ymm registers on a context switch. The xgetbv instruction is emitted as
+// raw bytes, as old assemblers don't know the mnemonic.
+static unsigned int ReadXCR0() {
+  unsigned int eax, edx;
+  __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0"
+                       : "=a" (eax), "=d" (edx) : "c" (0));
+  return eax;
+}
+#endif
+
+SIMDDetect::SIMDDetect()
+  : sse2_available_(false), avx2_available_(false), neon_available_(false) {
+#if defined(X86_CPUID_AVAILABLE)
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    sse2_available_ = (edx & bit_SSE2) != 0;
+    // AVX2 needs both the cpu feature and OS support for the ymm state.
+    bool os_saves_ymm = (ecx & bit_OSXSAVE) != 0 && (ecx & bit_AVX) != 0 &&
+                        (ReadXCR0() & 6) == 6;
+    if (os_saves_ymm && __get_cpuid_max(0, NULL) >= 7) {
+      __cpuid_count(7, 0, eax, ebx, ecx, edx);
+      avx2_available_ = (ebx & (1 << 5)) != 0;
+    }
+  }
+#elif defined(__aarch64__)
+  // NEON is a mandatory part of ARMv8.
+  neon_available_ = true;
+#elif defined(__arm__) && defined(__ANDROID__)
+  neon_available_ = android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM &&
+      (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0;
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+  // Without a way to probe the cpu, trust the compiler target.
+  neon_available_ = true;
+#endif
+}
+
+const SIMDDetect& SIMDDetect::Get() {
+  static SIMDDetect detector;
+  return detector;
+}
+
+}  // namespace tesseract.
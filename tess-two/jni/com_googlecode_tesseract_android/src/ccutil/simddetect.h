@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////
+// File:        simddetect.h
+// Description: Runtime detection of the SIMD instruction sets available
+//              to the vectorized classifier kernels.
+// Created:     Fri Oct 16 10:12:41 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_SIMDDETECT_H_
+#define TESSERACT_CCUTIL_SIMDDETECT_H_
+
+namespace tesseract {
+
+// Simple detector of the SIMD features of the cpu we are running on.
+// The features are probed once, on first use, so it is cheap to query them
+// from inner loops. A feature is only reported as available if the running
+// cpu supports it, regardless of what the library was compiled for, so
+// callers must still check that the matching kernel was compiled in.
+class SIMDDetect {
+ public:
+  // Returns true if SSE2 (x86) is available on this system.
+  static bool IsSSE2Available() {
+    return Get().sse2_available_;
+  }
+  // Returns true if AVX2 (x86) is available on this system, including the
+  // operating system support for saving the ymm registers.
+  static bool IsAVX2Available() {
+    return Get().avx2_available_;
+  }
+  // Returns true if NEON (ARM) is available on this system.
+  static bool IsNEONAvailable() {
+    return Get().neon_available_;
+  }
+
+ private:
+  // Probes the cpu. Only called by Get.
+  SIMDDetect();
+  // Returns the singleton detector, constructing it on first use.
+  static const SIMDDetect& Get();
+
+  bool sse2_available_;
+  bool avx2_available_;
+  bool neon_available_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCUTIL_SIMDDETECT_H_
@@ -24,6 +24,10 @@
 #include "tessdatamanager.h"
 
 #include <stdio.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include "serialis.h"
 #include "strngs.h"
@@ -35,6 +39,8 @@ namespace tesseract {
 bool TessdataManager::Init(const char *data_file_name, int debug_level) {
   int i;
   debug_level_ = debug_level;
+  End();
+  Unmap();
   data_file_ = fopen(data_file_name, "rb");
   if (data_file_ == NULL) {
     tprintf("Error opening data file %s\n", data_file_name);
@@ -62,9 +68,57 @@ bool TessdataManager::Init(const char *data_file_name, int debug_level) {
       tprintf("Offset for type %d is %lld\n", i, offset_table_[i]);
     }
   }
+  Map();
   return true;
 }
 
+bool TessdataManager::GetComponent(TessdataType tessdata_type, TFile *fp) {
+  if (mapped_data_ == NULL) {
+    if (!SeekToStart(tessdata_type)) return false;
+    fp->Open(data_file_, GetEndOffset(tessdata_type));
+    return true;
+  }
+  inT64 start_offset = offset_table_[tessdata_type];
+  if (start_offset < 0) return false;
+  inT64 end_offset = GetEndOffset(tessdata_type);
+  if (end_offset < 0) end_offset = mapped_size_ - 1;
+  if (debug_level_) {
+    tprintf("TessdataManager: mapped tessdata type %d (%s) at offset %lld\n",
+            tessdata_type, kTessdataFileSuffixes[tessdata_type],
+            start_offset);
+  }
+  ASSERT_HOST(start_offset <= end_offset + 1 && end_offset < mapped_size_);
+  fp->Open(mapped_data_ + start_offset,
+           static_cast<int>(end_offset + 1 - start_offset));
+  return true;
+}
+
+void TessdataManager::Map() {
+#ifndef _WIN32
+  struct stat file_stat;
+  if (fstat(fileno(data_file_), &file_stat) != 0 || file_stat.st_size <= 0)
+    return;
+  void *data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE,
+                    fileno(data_file_), 0);
+  if (data == MAP_FAILED) {
+    if (debug_level_)
+      tprintf("TessdataManager: mmap failed, reading the data file\n");
+    return;
+  }
+  mapped_data_ = static_cast<char *>(data);
+  mapped_size_ = file_stat.st_size;
+#endif
+}
+
+void TessdataManager::Unmap() {
+#ifndef _WIN32
+  if (mapped_data_ != NULL)
+    munmap(mapped_data_, mapped_size_);
+#endif
+  mapped_data_ = NULL;
+  mapped_size_ = 0;
+}
+
 void TessdataManager::CopyFile(FILE *input_file, FILE *output_file,
                                bool newline_end, inT64 num_bytes_to_copy) {
   if (num_bytes_to_copy == 0) return;
@@ -92,6 +146,15 @@ void TessdataManager::CopyFile(FILE *input_file, FILE *output_file,
   delete[] chunk;
 }
 
+void TessdataManager::AlignComponent(TessdataType type, FILE *output_file) {
+  if (kTessdataFileIsText[type]) return;
+  long offset = ftell(output_file);
+  while (offset % kTessdataComponentAlignment != 0) {
+    fputc('\n', output_file);
+    ++offset;
+  }
+}
+
 void TessdataManager::WriteMetadata(inT64 *offset_table, FILE *output_file) {
   fseek(output_file, 0, SEEK_SET);
   inT32 num_entries = TESSDATA_NUM_ENTRIES;
@@ -132,6 +195,7 @@ bool TessdataManager::CombineDataFiles(
     filename += kTessdataFileSuffixes[i];
     file_ptr[i] =  fopen(filename.string(), "rb");
     if (file_ptr[i] != NULL) {
+      AlignComponent(type, output_file);
       offset_table[type] = ftell(output_file);
       CopyFile(file_ptr[i], output_file, text_file, -1);
       fclose(file_ptr[i]);
@@ -190,12 +254,14 @@ bool TessdataManager::OverwriteComponents(
   for (i = 0; i < TESSDATA_NUM_ENTRIES; ++i) {
     if (file_ptr[i] != NULL) {
       // Get the data from the opened component file.
+      AlignComponent(static_cast<TessdataType>(i), output_file);
       offset_table[i] = ftell(output_file);
       CopyFile(file_ptr[i], output_file, kTessdataFileIsText[i], -1);
       fclose(file_ptr[i]);
     } else {
       // Get this data component from the loaded data file.
       if (SeekToStart(static_cast<TessdataType>(i))) {
+        AlignComponent(static_cast<TessdataType>(i), output_file);
         offset_table[i] = ftell(output_file);
         CopyFile(data_file_, output_file, kTessdataFileIsText[i],
                  GetEndOffset(static_cast<TessdataType>(i)) -
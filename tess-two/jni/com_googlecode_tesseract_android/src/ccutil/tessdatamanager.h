@@ -22,6 +22,7 @@
 
 #include <stdio.h>
 #include "host.h"
+#include "serialis.h"
 #include "tprintf.h"
 
 static const char kTrainedDataSuffix[] = "traineddata";
@@ -127,21 +128,36 @@ static const bool kTessdataFileIsText[] = {
  */
 static const int kMaxNumTessdataEntries = 1000;
 
+/**
+ * Binary components are written at offsets that are a multiple of
+ * kTessdataComponentAlignment, so that their data can be used in place
+ * when the traineddata file is memory mapped (e.g. the edges of flat dawgs).
+ */
+static const int kTessdataComponentAlignment = 8;
+
 
 class TessdataManager {
  public:
   TessdataManager() {
     data_file_ = NULL;
+    mapped_data_ = NULL;
+    mapped_size_ = 0;
     actual_tessdata_num_entries_ = 0;
     for (int i = 0; i < TESSDATA_NUM_ENTRIES; ++i) {
       offset_table_[i] = -1;
     }
   }
-  ~TessdataManager() {}
+  ~TessdataManager() {
+    End();
+    Unmap();
+  }
   int DebugLevel() { return debug_level_; }
 
   /**
    * Opens the given data file and reads the offset table.
+   * Where the platform allows, the file is also mapped into memory, so that
+   * GetComponent can read from the mapping. Nothing read in place from a
+   * previous data file may still be in use.
    * Returns true on success.
    */
   bool Init(const char *data_file_name, int debug_level);
@@ -149,6 +165,20 @@ class TessdataManager {
   /** Returns data file pointer. */
   inline FILE *GetDataFilePtr() const { return data_file_; }
 
+  /**
+   * Returns true if the data file is mapped into memory, in which case the
+   * mapping lasts until the TessdataManager is destroyed or re-initialized,
+   * and components may be used in place (see TFile::FReadInPlace).
+   */
+  bool IsMapped() const { return mapped_data_ != NULL; }
+
+  /**
+   * Opens fp on the data of the given type: on the mapping if the data file
+   * is mapped, otherwise on the data file, bounded by the end of the data.
+   * Returns false if there is no data of the given type.
+   */
+  bool GetComponent(TessdataType tessdata_type, TFile *fp);
+
   /**
    * Returns false if there is no data of the given type.
    * Otherwise does a seek on the data_file_ to position the pointer
@@ -183,7 +213,10 @@ class TessdataManager {
     }
     return (index == actual_tessdata_num_entries_) ? -1 : offset_table_[index] - 1;
   }
-  /** Closes data_file_ (if it was opened by Init()). */
+  /**
+   * Closes data_file_ (if it was opened by Init()). The mapping, if any, is
+   * kept, as components may still be in use in place.
+   */
   inline void End() {
     if (data_file_ != NULL) {
       fclose(data_file_);
@@ -234,6 +267,14 @@ class TessdataManager {
   static void CopyFile(FILE *input_file, FILE *output_file,
                        bool newline_end, inT64 num_bytes_to_copy);
 
+  /**
+   * If the next component to be written to output_file is binary, pads
+   * output_file to a multiple of kTessdataComponentAlignment. The padding
+   * is newlines, which end up at the end of the previous component, where
+   * they are ignored by the readers of both text and binary components.
+   */
+  static void AlignComponent(TessdataType type, FILE *output_file);
+
   /**
    * Fills type with TessdataType of the tessdata component represented by the
    * given file name. E.g. tessdata/eng.unicharset -> TESSDATA_UNICHARSET.
@@ -263,6 +304,11 @@ class TessdataManager {
   static FILE *GetFilePtr(const char *language_data_path_prefix,
                           const char *file_suffix, bool text_file);
 
+  /** Maps data_file_ into memory if possible. */
+  void Map();
+  /** Releases the mapping made by Map(), if any. */
+  void Unmap();
+
   /**
    * Each offset_table_[i] contains a file offset in the combined data file
    * where the data of TessdataFileType i is stored.
@@ -278,6 +324,8 @@ class TessdataManager {
    */
   inT32 actual_tessdata_num_entries_;
   FILE *data_file_;  ///< pointer to the data file.
+  char *mapped_data_;  ///< the mapped data file, or NULL.
+  inT64 mapped_size_;  ///< size of the mapping.
   int debug_level_;
   // True if the bytes need swapping.
   bool swap_;
@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////
+// File:        threadpool.cpp
+// Description: Work-stealing pool of threads for running independent tasks.
+// Created:     Fri Oct 16 17:05:33 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "threadpool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "ccutil.h"
+#include "ndminx.h"
+#include "tprintf.h"
+
+namespace tesseract {
+
+ThreadPool::TaskQueue::TaskQueue() : head(0), tail(0), mutex(new CCUtilMutex) {
+}
+
+ThreadPool::TaskQueue::~TaskQueue() {
+  delete mutex;
+}
+
+ThreadPool::ThreadPool(int num_threads)
+  : num_threads_(num_threads < 1 ? 1 : num_threads), task_(NULL) {
+  queues_ = new TaskQueue[num_threads_];
+}
+
+ThreadPool::~ThreadPool() {
+  delete [] queues_;
+}
+
+void ThreadPool::Run(int num_tasks, TessCallback2<int, int>* task) {
+  task_ = task;
+  // Deal the tasks out round-robin, so each queue starts with a spread of
+  // the task indices.
+  for (int t = 0; t < num_threads_; ++t) {
+    queues_[t].tasks.truncate(0);
+    queues_[t].head = 0;
+  }
+  for (int i = 0; i < num_tasks; ++i)
+    queues_[i % num_threads_].tasks.push_back(i);
+  for (int t = 0; t < num_threads_; ++t)
+    queues_[t].tail = queues_[t].tasks.size();
+
+  // There is no point starting more threads than there are tasks.
+  int num_extra_threads = MIN(num_threads_, num_tasks) - 1;
+  ThreadArgs* args = new ThreadArgs[num_threads_];
+#ifdef _WIN32
+  HANDLE* threads = new HANDLE[num_threads_];
+#else
+  pthread_t* threads = new pthread_t[num_threads_];
+#endif
+  int num_started = 0;
+  for (int t = 1; t <= num_extra_threads; ++t) {
+    args[t].pool = this;
+    args[t].thread_index = t;
+#ifdef _WIN32
+    threads[num_started] = CreateThread(NULL, 0,
+        reinterpret_cast<LPTHREAD_START_ROUTINE>(&ThreadMain), &args[t],
+        0, NULL);
+    bool started = threads[num_started] != NULL;
+#else
+    bool started = pthread_create(&threads[num_started], NULL, &ThreadMain,
+                                  &args[t]) == 0;
+#endif
+    if (!started) {
+      // The tasks of the missing thread are stolen by the others.
+      tprintf("Failed to start thread %d of the thread pool\n", t);
+      continue;
+    }
+    ++num_started;
+  }
+  RunTasks(0);
+  for (int i = 0; i < num_started; ++i) {
+#ifdef _WIN32
+    WaitForSingleObject(threads[i], INFINITE);
+    CloseHandle(threads[i]);
+#else
+    pthread_join(threads[i], NULL);
+#endif
+  }
+  delete [] threads;
+  delete [] args;
+  task_ = NULL;
+}
+
+int ThreadPool::NumProcessors() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  int num_processors = info.dwNumberOfProcessors;
+#else
+  int num_processors = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+  return num_processors > 0 ? num_processors : 1;
+}
+
+void* ThreadPool::ThreadMain(void* arg) {
+  ThreadArgs* args = static_cast<ThreadArgs*>(arg);
+  args->pool->RunTasks(args->thread_index);
+  return NULL;
+}
+
+void ThreadPool::RunTasks(int thread_index) {
+  int task_index;
+  while (NextTask(thread_index, &task_index))
+    task_->Run(thread_index, task_index);
+}
+
+bool ThreadPool::NextTask(int thread_index, int* task_index) {
+  // Take from the front of our own queue first.
+  TaskQueue* queue = &queues_[thread_index];
+  queue->mutex->Lock();
+  bool found = queue->head < queue->tail;
+  if (found)
+    *task_index = queue->tasks[queue->head++];
+  queue->mutex->Unlock();
+  // Otherwise steal from the back of the next non-empty queue. Once all the
+  // queues are empty they stay empty, so one pass over them is enough.
+  for (int i = 1; !found && i < num_threads_; ++i) {
+    queue = &queues_[(thread_index + i) % num_threads_];
+    queue->mutex->Lock();
+    found = queue->head < queue->tail;
+    if (found)
+      *task_index = queue->tasks[--queue->tail];
+    queue->mutex->Unlock();
+  }
+  return found;
+}
+
+}  // namespace tesseract.
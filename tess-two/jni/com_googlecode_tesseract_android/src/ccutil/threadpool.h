@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////
+// File:        threadpool.h
+// Description: Work-stealing pool of threads for running independent tasks.
+// Created:     Fri Oct 16 17:05:33 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_THREADPOOL_H_
+#define TESSERACT_CCUTIL_THREADPOOL_H_
+
+#include "genericvector.h"
+#include "tesscallback.h"
+
+namespace tesseract {
+
+class CCUtilMutex;
+
+// Runs a batch of independent tasks on a fixed number of threads, one of
+// which is the calling thread. The tasks are dealt out to per-thread queues
+// up front, each thread runs the tasks in its own queue from the front, and
+// a thread whose queue is empty steals from the back of the other queues, so
+// that the threads stay busy when the tasks vary a lot in size.
+// The extra threads only exist for the duration of each Run.
+class ThreadPool {
+ public:
+  // Creates a pool of num_threads threads, including the calling thread.
+  // num_threads < 1 is treated as 1.
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  int num_threads() const {
+    return num_threads_;
+  }
+
+  // Calls task->Run(thread_index, task_index) once for every task_index in
+  // [0, num_tasks) and returns when all the calls have returned. The calls
+  // with a given thread_index are all made on the same thread, one at a time,
+  // and thread_index 0 is the calling thread. The order in which the tasks
+  // are run is not defined. task is not deleted.
+  void Run(int num_tasks, TessCallback2<int, int>* task);
+
+  // Returns the number of processors available, or 1 if it is unknown.
+  static int NumProcessors();
+
+ private:
+  // A queue of task indices with its own lock.
+  struct TaskQueue {
+    TaskQueue();
+    ~TaskQueue();
+
+    GenericVector<int> tasks;
+    // The queue holds tasks[head, tail).
+    int head;
+    int tail;
+    CCUtilMutex* mutex;
+  };
+
+  // Arguments of ThreadMain.
+  struct ThreadArgs {
+    ThreadPool* pool;
+    int thread_index;
+  };
+
+  // Entry point of the extra threads.
+  static void* ThreadMain(void* arg);
+  // Runs tasks on the thread with the given index until all the queues are
+  // empty.
+  void RunTasks(int thread_index);
+  // Takes the next task for thread_index to run into *task_index. Returns
+  // false if there are none left.
+  bool NextTask(int thread_index, int* task_index);
+
+  int num_threads_;
+  TaskQueue* queues_;
+  // The task of the current Run.
+  TessCallback2<int, int>* task_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCUTIL_THREADPOOL_H_
@@ -25,6 +25,7 @@
 #include "unichar.h"
 #include "unicharmap.h"
 #include "params.h"
+#include "serialis.h"
 
 enum StrongScriptDirection {
   DIR_NEUTRAL = 0,        // Text contains only neutral characters.
@@ -318,6 +319,9 @@ class UNICHARSET {
   // Returns true if the operation is successful.
   bool load_from_file(FILE *file, bool skip_fragments);
   bool load_from_file(FILE *file) { return load_from_file(file, false); }
+  // Loads the UNICHARSET from the given TFile. The previous data is lost.
+  // Returns true if the operation is successful.
+  bool load_from_file(tesseract::TFile *file, bool skip_fragments);
 
   // Sets up internal data after loading the file, based on the char
   // properties. Called from load_from_file, but also needs to be run
@@ -88,6 +88,9 @@ class UnicityTable {
   bool write(FILE* f, TessResultCallback2<bool, FILE*, T const &>* cb) const;
   /// swap is used to switch the endianness.
   bool read(FILE* f, TessResultCallback3<bool, FILE*, T*, bool>* cb, bool swap);
+  bool read(tesseract::TFile* f,
+            TessResultCallback3<bool, tesseract::TFile*, T*, bool>* cb,
+            bool swap);
 
  private:
   GenericVector<T> table_;
@@ -198,6 +201,13 @@ bool UnicityTable<T>::read(
   return table_.read(f, cb, swap);
 }
 
+template <typename T>
+bool UnicityTable<T>::read(
+    tesseract::TFile* f,
+    TessResultCallback3<bool, tesseract::TFile*, T*, bool>* cb, bool swap) {
+  return table_.read(f, cb, swap);
+}
+
 // This method clear the current object, then, does a shallow copy of
 // its argument, and finally invalidate its argument.
 template <typename T>
@@ -43,6 +43,7 @@
 #include "callcpp.h"
 #include "pageres.h"
 #include "params.h"
+#include "resultcache.h"
 #include "classify.h"
 #include "shapetable.h"
 #include "tessclassifier.h"
@@ -78,16 +79,6 @@
 
 #define WORST_POSSIBLE_RATING (1.0)
 
-struct ScoredClass {
-  CLASS_ID unichar_id;
-  int shape_id;
-  FLOAT32 rating;
-  bool adapted;
-  inT16 config;
-  inT16 fontinfo_id;
-  inT16 fontinfo_id2;
-};
-
 struct ADAPT_RESULTS {
   inT32 BlobLength;
   int NumMatches;
@@ -180,22 +171,49 @@ void Classify::AdaptiveClassifier(TBLOB *Blob,
                                   BLOB_CHOICE_LIST *Choices,
                                   CLASS_PRUNER_RESULTS CPResults) {
   assert(Choices != NULL);
+  PageStageTimer timer(&page_stats, PS_ADAPTIVE_CLASSIFIER);
+  page_stats.Count(PC_CLASSIFIER_CALLS);
   ADAPT_RESULTS *Results = new ADAPT_RESULTS();
 
   if (AdaptedTemplates == NULL)
     AdaptedTemplates = NewAdaptedTemplates (true);
 
   Results->Initialize();
+  InitIntFX();
 
-  DoAdaptiveMatch(Blob, denorm, Results);
-  if (CPResults != NULL)
-    memcpy(CPResults, Results->CPResults,
-           sizeof(CPResults[0]) * Results->NumMatches);
-
-  RemoveBadMatches(Results);
-  qsort((void *)Results->match, Results->NumMatches,
-        sizeof(ScoredClass), CompareByRating);
-  RemoveExtraPuncs(Results);
+  // The class pruner results are not cached, so callers that want them
+  // always run the matchers.
+  result_cache_.set_max_bytes(classify_result_cache_kb * 1024);
+  bool use_cache = result_cache_.enabled() && CPResults == NULL;
+  GenericVector<inT32> cache_key;
+  const GenericVector<ScoredClass>* cached_matches = NULL;
+  if (use_cache) {
+    FeaturesOK = ExtractIntFeat(Blob, denorm, BaselineFeatures,
+                                CharNormFeatures, &FXInfo, NULL);
+    FeaturesHaveBeenExtracted = TRUE;
+    MakeResultCacheKey(Blob->bounding_box(), &cache_key);
+    cached_matches = result_cache_.Lookup(cache_key, &Results->BlobLength);
+  }
+  if (cached_matches != NULL) {
+    AdaptiveMatcherCalls++;
+    Results->NumMatches = cached_matches->size();
+    for (int i = 0; i < Results->NumMatches; ++i)
+      Results->match[i] = (*cached_matches)[i];
+  } else {
+    DoAdaptiveMatch(Blob, denorm, Results);
+    if (CPResults != NULL)
+      memcpy(CPResults, Results->CPResults,
+             sizeof(CPResults[0]) * Results->NumMatches);
+
+    RemoveBadMatches(Results);
+    qsort((void *)Results->match, Results->NumMatches,
+          sizeof(ScoredClass), CompareByRating);
+    RemoveExtraPuncs(Results);
+    if (use_cache) {
+      result_cache_.Insert(cache_key, Results->BlobLength, Results->match,
+                           Results->NumMatches);
+    }
+  }
   ConvertMatchesToChoices(denorm, Blob->bounding_box(), Results, Choices);
 
   if (matcher_debug_level >= 1) {
@@ -225,6 +243,47 @@ void Classify::AdaptiveClassifier(TBLOB *Blob,
   delete Results;
 }                                /* AdaptiveClassifier */
 
+void Classify::EndPageResultCache() {
+  if (classify_result_cache_stats && result_cache_.enabled()) {
+    result_cache_.PrintStats();
+    result_cache_.ResetStats();
+  }
+  if (classify_result_cache_per_page)
+    result_cache_.Clear();
+}
+
+// Returns the fields of feature packed into one word.
+static inT32 PackIntFeature(const INT_FEATURE_STRUCT& feature) {
+  return (feature.X << 24) | (feature.Y << 16) | (feature.Theta << 8) |
+      static_cast<uinT8>(feature.CP_misses);
+}
+
+// The key holds everything that DoAdaptiveMatch and the result filters
+// read from the blob, which is only its extracted features and the top and
+// bottom of its box, and the generation of the adapted templates and the
+// numeric mode. Xmean and Width are left out, as they depend on where the
+// blob is in its word and the matchers don't use them. The enabled unichars
+// are not in the key, so Tesseract::SetBlackAndWhitelist empties the cache
+// when they change.
+void Classify::MakeResultCacheKey(const TBOX& blob_box,
+                                  GenericVector<inT32>* key) {
+  key->push_back(templates_generation_);
+  key->push_back(classify_bln_numeric_mode);
+  key->push_back(FeaturesOK);
+  key->push_back(blob_box.top());
+  key->push_back(blob_box.bottom());
+  key->push_back(FXInfo.Length);
+  key->push_back(FXInfo.Ymean);
+  key->push_back(FXInfo.Rx);
+  key->push_back(FXInfo.Ry);
+  key->push_back(FXInfo.NumBL);
+  key->push_back(FXInfo.NumCN);
+  for (int i = 0; i < FXInfo.NumBL; ++i)
+    key->push_back(PackIntFeature(BaselineFeatures[i]));
+  for (int i = 0; i < FXInfo.NumCN; ++i)
+    key->push_back(PackIntFeature(CharNormFeatures[i]));
+}
+
 // If *win is NULL, sets it to a new ScrollView() object with title msg.
 // Clears the window and draws baselines.
 void Classify::RefreshDebugWindow(ScrollView **win, const char *msg,
@@ -276,6 +335,49 @@ void Classify::LearnWord(const char* filename, const char *rejmap,
     GetAdaptThresholds(word->rebuild_word, word->denorm, *word->best_choice,
                        *word->raw_choice, thresholds);
   }
+  LearnWordWithThresholds(filename, rejmap, thresholds, word);
+  delete [] thresholds;
+}  // LearnWord.
+
+// Saves the adaption thresholds and rejmap of the word in word, so it can be
+// learned later with LearnDeferredWord, or clears word->adapt_deferred if
+// LearnWord would not adapt to it for reasons other than EnableLearning.
+void Classify::DeferLearnWord(const char *rejmap, WERD_RES *word) {
+  word->adapt_deferred = false;
+  int word_len = word->correct_text.size();
+  if (word_len == 0 || word->best_choice == NULL ||
+      !getDict().CurrentBestChoiceIs(*(word->best_choice)))
+    return;  // Can't adapt.
+
+  word->adapt_thresholds.init_to_size(word_len, 0.0f);
+  GetAdaptThresholds(word->rebuild_word, word->denorm, *word->best_choice,
+                     *word->raw_choice, &word->adapt_thresholds[0]);
+  word->adapt_rejmap = rejmap != NULL ? rejmap : "";
+  word->adapt_deferred = true;
+}
+
+// Adapts to a word saved by DeferLearnWord, if learning is enabled.
+void Classify::LearnDeferredWord(WERD_RES *word) {
+  if (!word->adapt_deferred) return;
+  word->adapt_deferred = false;
+  if (!EnableLearning || word->adapt_thresholds.size() !=
+      word->correct_text.size())
+    return;  // Won't adapt.
+
+  NumWordsAdaptedTo++;
+  if (classify_learning_debug_level >= 1)
+    tprintf("\n\nAdapting to word = %s\n",
+            word->best_choice->debug_string().string());
+  const char* rejmap = word->adapt_rejmap.length() > 0
+                     ? word->adapt_rejmap.string() : NULL;
+  LearnWordWithThresholds(NULL, rejmap, &word->adapt_thresholds[0], word);
+}
+
+void Classify::LearnWordWithThresholds(const char* filename,
+                                       const char *rejmap,
+                                       const float* thresholds,
+                                       WERD_RES *word) {
+  int word_len = word->correct_text.size();
   int start_blob = 0;
   char prev_map_char = '0';
 
@@ -381,8 +483,7 @@ void Classify::LearnWord(const char* filename, const char *rejmap,
     start_blob += word->best_state[ch];
     prev_map_char = rej_map_char;
   }
-  delete [] thresholds;
-}  // LearnWord.
+}  // LearnWordWithThresholds.
 
 // Builds a blob of length fragments, from the word, starting at start,
 // and then learns it, as having the given correct_text.
@@ -500,7 +601,14 @@ void Classify::EndAdaptiveClassifier() {
     free_adapted_templates(AdaptedTemplates);
     AdaptedTemplates = NULL;
   }
+  ClearResultCache();
 
+  if (shared_classifier_ != NULL) {
+    // The static classifier is borrowed from shared_classifier_.
+    PreTrainedTemplates = NULL;
+    NormProtos = NULL;
+    shape_table_ = NULL;
+  }
   if (PreTrainedTemplates != NULL) {
     free_int_templates(PreTrainedTemplates);
     PreTrainedTemplates = NULL;
@@ -552,17 +660,18 @@ void Classify::InitAdaptiveClassifier(bool load_pre_trained_templates) {
 
   // If there is no language_data_path_prefix, the classifier will be
   // adaptive only.
-  if (language_data_path_prefix.length() > 0 &&
-      load_pre_trained_templates) {
-    ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_INTTEMP));
-    PreTrainedTemplates =
-      ReadIntTemplates(tessdata_manager.GetDataFilePtr());
+  if (shared_classifier_ != NULL && load_pre_trained_templates) {
+    ShareStaticClassifierData();
+  } else if (language_data_path_prefix.length() > 0 &&
+             load_pre_trained_templates) {
+    TFile fp;
+    ASSERT_HOST(tessdata_manager.GetComponent(TESSDATA_INTTEMP, &fp));
+    PreTrainedTemplates = ReadIntTemplates(&fp);
     if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded inttemp\n");
 
-    if (tessdata_manager.SeekToStart(TESSDATA_SHAPE_TABLE)) {
+    if (tessdata_manager.GetComponent(TESSDATA_SHAPE_TABLE, &fp)) {
       shape_table_ = new ShapeTable(unicharset);
-      if (!shape_table_->DeSerialize(tessdata_manager.swap(),
-                                     tessdata_manager.GetDataFilePtr())) {
+      if (!shape_table_->DeSerialize(tessdata_manager.swap(), &fp)) {
         tprintf("Error loading shape table!\n");
         delete shape_table_;
         shape_table_ = NULL;
@@ -571,17 +680,12 @@ void Classify::InitAdaptiveClassifier(bool load_pre_trained_templates) {
       }
     }
 
-    ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_PFFMTABLE));
-    ReadNewCutoffs(tessdata_manager.GetDataFilePtr(),
-                   tessdata_manager.swap(),
-                   tessdata_manager.GetEndOffset(TESSDATA_PFFMTABLE),
-                   CharNormCutoffs);
+    ASSERT_HOST(tessdata_manager.GetComponent(TESSDATA_PFFMTABLE, &fp));
+    ReadNewCutoffs(&fp, tessdata_manager.swap(), CharNormCutoffs);
     if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded pffmtable\n");
 
-    ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_NORMPROTO));
-    NormProtos =
-      ReadNormProtos(tessdata_manager.GetDataFilePtr(),
-                     tessdata_manager.GetEndOffset(TESSDATA_NORMPROTO));
+    ASSERT_HOST(tessdata_manager.GetComponent(TESSDATA_NORMPROTO, &fp));
+    NormProtos = ReadNormProtos(&fp);
     if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded normproto\n");
   }
 
@@ -635,6 +739,27 @@ void Classify::InitAdaptiveClassifier(bool load_pre_trained_templates) {
   }
 }                                /* InitAdaptiveClassifier */
 
+// Borrows the pre-trained templates, shape table and norm protos of
+// shared_classifier_ in place of reading them from the traineddata file, and
+// takes copies of the cutoffs and font tables that would be read with them.
+void Classify::ShareStaticClassifierData() {
+  const Classify* source = shared_classifier_;
+  ASSERT_HOST(source->PreTrainedTemplates != NULL);
+  PreTrainedTemplates = source->PreTrainedTemplates;
+  shape_table_ = source->shape_table_;
+  NormProtos = source->NormProtos;
+  memcpy(CharNormCutoffs, source->CharNormCutoffs,
+         MAX_NUM_CLASSES * sizeof(*CharNormCutoffs));
+  shapetable_cutoffs_ = source->shapetable_cutoffs_;
+  for (int i = 0; i < source->fontinfo_table_.size(); ++i)
+    fontinfo_table_.push_back(CopyFontInfo(source->fontinfo_table_.get(i)));
+  for (int i = 0; i < source->fontset_table_.size(); ++i)
+    fontset_table_.push_back(CopyFontSet(source->fontset_table_.get(i)));
+  if (tessdata_manager.DebugLevel() > 0)
+    tprintf("Shared pre-trained templates of language %s\n",
+            source->lang.string());
+}
+
 void Classify::ResetAdaptiveClassifierInternal() {
   if (classify_learning_debug_level > 0) {
     tprintf("Resetting adaptive classifier (NumAdaptationsFailed=%d)\n",
@@ -643,6 +768,7 @@ void Classify::ResetAdaptiveClassifierInternal() {
   free_adapted_templates(AdaptedTemplates);
   AdaptedTemplates = NULL;
   NumAdaptationsFailed = 0;
+  ClearResultCache();
 }
 
 
@@ -944,6 +1070,7 @@ void Classify::AdaptToChar(TBLOB *Blob,
   if (!LegalClassId (ClassId))
     return;
 
+  ++templates_generation_;
   Class = AdaptedTemplates->Class[ClassId];
   assert(Class != NULL);
   if (IsEmptyAdaptedClass(Class)) {
@@ -1806,7 +1933,6 @@ void Classify::DoAdaptiveMatch(TBLOB *Blob,
   UNICHAR_ID *Ambiguities;
 
   AdaptiveMatcherCalls++;
-  InitIntFX();
 
   if (AdaptedTemplates->NumPermClasses < matcher_permanent_classes_min ||
       tess_cn_matching) {
@@ -115,6 +115,15 @@ Classify::Classify()
                 "One for the protos and one for the features.", this->params()),
     STRING_MEMBER(classify_learn_debug_str, "", "Class str to debug learning",
                   this->params()),
+    INT_MEMBER(classify_result_cache_kb, 0,
+               "Max KB of memory for cached classifier results (0 = no cache)",
+               this->params()),
+    BOOL_MEMBER(classify_result_cache_per_page, true,
+                "Empty the classifier result cache at the end of each page",
+                this->params()),
+    BOOL_MEMBER(classify_result_cache_stats, false,
+                "Print the classifier result cache hit rate after each page",
+                this->params()),
     INT_MEMBER(classify_class_pruner_threshold, 229,
                "Class Pruner Threshold 0-255", this->params()),
     INT_MEMBER(classify_class_pruner_multiplier, 30,
@@ -162,12 +171,14 @@ Classify::Classify()
 
   FeaturesHaveBeenExtracted = false;
   FeaturesOK = true;
+  templates_generation_ = 0;
   learn_debug_win_ = NULL;
   learn_fragmented_word_debug_win_ = NULL;
   learn_fragments_debug_win_ = NULL;
 
   CharNormCutoffs = new uinT16[MAX_NUM_CLASSES];
   BaselineCutoffs = new uinT16[MAX_NUM_CLASSES];
+  shared_classifier_ = NULL;
 }
 
 Classify::~Classify() {
@@ -30,6 +30,7 @@
 #include "normalis.h"
 #include "ratngs.h"
 #include "ocrfeatures.h"
+#include "resultcache.h"
 #include "unicity_table.h"
 
 class ScrollView;
@@ -62,11 +63,25 @@ class Classify : public CCStruct {
   Dict& getDict() {
     return dict_;
   }
+  const Dict& getDict() const {
+    return dict_;
+  }
 
   const ShapeTable* shape_table() const {
     return shape_table_;
   }
 
+  // Makes InitAdaptiveClassifier take the pre-trained templates, shape table,
+  // cutoffs and norm protos from source instead of reading them from the
+  // traineddata file. The templates are only read once loaded, so a single
+  // copy may be shared by any number of Classify instances, but source must
+  // have been initialized for the same language and must outlive this.
+  // The font tables are copied, as they are modified after loading.
+  // Must be called before InitAdaptiveClassifier. NULL restores loading.
+  void ShareStaticClassifier(const Classify* source) {
+    shared_classifier_ = source;
+  }
+
   /* adaptive.cpp ************************************************************/
   ADAPT_TEMPLATES NewAdaptedTemplates(bool InitFromUnicharset);
   int GetFontinfoId(ADAPT_CLASS Class, uinT8 ConfigId);
@@ -90,7 +105,7 @@ class Classify : public CCStruct {
                    const uinT8* normalization_factors,
                    const uinT16* expected_num_features,
                    CP_RESULT_STRUCT* results);
-  void ReadNewCutoffs(FILE *CutoffFile, bool swap, inT64 end_offset,
+  void ReadNewCutoffs(TFile *CutoffFile, bool swap,
                       CLASS_CUTOFF_ARRAY Cutoffs);
   void PrintAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates);
   void WriteAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates);
@@ -99,7 +114,7 @@ class Classify : public CCStruct {
   FLOAT32 ComputeNormMatch(CLASS_ID ClassId,
                            const FEATURE_STRUCT& feature, BOOL8 DebugMatch);
   void FreeNormProtos();
-  NORM_PROTOS *ReadNormProtos(FILE *File, inT64 end_offset);
+  NORM_PROTOS *ReadNormProtos(TFile *File);
   /* protos.cpp ***************************************************************/
   void ReadClassFile();
   void ConvertProto(PROTO Proto, int ProtoId, INT_CLASS Class);
@@ -115,6 +130,14 @@ class Classify : public CCStruct {
   // If rejmap is not NULL, then only chars with a rejmap entry of '1' will
   // be learned, otherwise all chars with good correct_text are learned.
   void LearnWord(const char* filename, const char *rejmap, WERD_RES *word);
+  // Adaption-mode LearnWord in two halves, for a word recognized by a word
+  // worker of a parallel recognition pass. DeferLearnWord is called by the
+  // worker in place of LearnWord(NULL, rejmap, word) and saves in word what
+  // is needed from the worker's dictionary state at the time. Later,
+  // LearnDeferredWord, called on the classifier that is to adapt (of the
+  // same language), learns the word as LearnWord would have.
+  void DeferLearnWord(const char *rejmap, WERD_RES *word);
+  void LearnDeferredWord(WERD_RES *word);
 
   // Builds a blob of length fragments, from the word, starting at start,
   // and then learn it, as having the given correct_text.
@@ -129,6 +152,7 @@ class Classify : public CCStruct {
                    float threshold, CharSegmentationType segmentation,
                    const char* correct_text, WERD_RES *word);
   void InitAdaptiveClassifier(bool load_pre_trained_templates);
+  void ShareStaticClassifierData();
   void InitAdaptedClass(TBLOB *Blob,
                         const DENORM& denorm,
                         CLASS_ID ClassId,
@@ -289,6 +313,14 @@ class Classify : public CCStruct {
                           CLASS_PRUNER_RESULTS cp_results);
   void ClassifyAsNoise(ADAPT_RESULTS *Results);
   void ResetAdaptiveClassifierInternal();
+  // Prints the hit and miss counts of the result cache if
+  // classify_result_cache_stats, and empties it if
+  // classify_result_cache_per_page. Called at the end of each page.
+  void EndPageResultCache();
+  // Empties the result cache.
+  void ClearResultCache() {
+    result_cache_.Clear();
+  }
 
   int GetBaselineFeatures(TBLOB *Blob,
                           const DENORM& denorm,
@@ -327,6 +359,7 @@ class Classify : public CCStruct {
   void ComputeIntFeatures(FEATURE_SET Features, INT_FEATURE_ARRAY IntFeatures);
   /* intproto.cpp *************************************************************/
   INT_TEMPLATES ReadIntTemplates(FILE *File);
+  INT_TEMPLATES ReadIntTemplates(TFile *File);
   void WriteIntTemplates(FILE *File, INT_TEMPLATES Templates,
                          const UNICHARSET& target_unicharset);
   CLASS_ID GetClassToDebug(const char *Prompt, bool* adaptive_on,
@@ -414,6 +447,12 @@ class Classify : public CCStruct {
              "Use two different windows for debugging the matching: "
              "One for the protos and one for the features.");
   STRING_VAR_H(classify_learn_debug_str, "", "Class str to debug learning");
+  INT_VAR_H(classify_result_cache_kb, 0,
+            "Max KB of memory for cached classifier results (0 = no cache)");
+  BOOL_VAR_H(classify_result_cache_per_page, true,
+             "Empty the classifier result cache at the end of each page");
+  BOOL_VAR_H(classify_result_cache_stats, false,
+             "Print the classifier result cache hit rate after each page");
 
   /* intmatcher.cpp **********************************************************/
   INT_VAR_H(classify_class_pruner_threshold, 229,
@@ -464,6 +503,14 @@ class Classify : public CCStruct {
   ShapeTable* shape_table_;
 
  private:
+  // The part of LearnWord that follows the adaption checks. thresholds has
+  // an entry for each entry of word->correct_text, or may be NULL if
+  // filename is not NULL.
+  void LearnWordWithThresholds(const char* filename, const char *rejmap,
+                               const float* thresholds, WERD_RES *word);
+  // Sets key to the fingerprint of the features extracted from a blob with
+  // the given bounding box, for looking up its results in result_cache_.
+  void MakeResultCacheKey(const TBOX& blob_box, GenericVector<inT32>* key);
 
   Dict dict_;
 
@@ -490,6 +537,12 @@ class Classify : public CCStruct {
   INT_FEATURE_ARRAY CharNormFeatures;
   INT_FX_RESULT_STRUCT FXInfo;
 
+  // Results of AdaptiveClassifier, keyed by the extracted features.
+  ClassifierResultCache result_cache_;
+  // Incremented whenever AdaptedTemplates may have changed, so the results
+  // cached with the previous templates are no longer found.
+  int templates_generation_;
+
   // Expected number of features in the class pruner, used to penalize
   // unknowns that have too few features (like a c being classified as e) so
   // it doesn't recognize everything as '@' or '#'.
@@ -501,6 +554,9 @@ class Classify : public CCStruct {
   uinT16* CharNormCutoffs;
   uinT16* BaselineCutoffs;
   GenericVector<uinT16> shapetable_cutoffs_;
+  // If not NULL, the owner of PreTrainedTemplates, shape_table_ and
+  // NormProtos, which are borrowed rather than owned by this.
+  const Classify* shared_classifier_;
   ScrollView* learn_debug_win_;
   ScrollView* learn_fragmented_word_debug_win_;
   ScrollView* learn_fragments_debug_win_;
@@ -22,6 +22,7 @@
 #include "danerror.h"
 #include "emalloc.h"
 #include "scanutils.h"
+#include <ctype.h>
 #include <stdio.h>
 #include <math.h>
 
@@ -30,9 +31,42 @@
 #define MAXSAMPLESIZE 65535      //max num of dimensions in feature space
 //#define MAXBLOCKSIZE  65535   //max num of samples in a character (block size)
 
+//---------------Private Function Prototypes--------------------------------
+static int ReadInt(tesseract::TFile *File, int *Value);
+static int ReadFloat(tesseract::TFile *File, FLOAT32 *Value);
+
 /*---------------------------------------------------------------------------
           Public Code
 -----------------------------------------------------------------------------*/
+/** ReadToken ****************************************************************
+Parameters:	File	open text file to read a token from
+      Token	buffer to place the token into
+      TokenSize	size of Token, including the terminating null
+Globals:	None
+Operation:	This routine skips white space and reads the following
+      characters up to the next white space, as fscanf "%s" does,
+      keeping as many of them as fit in Token.
+Return:		FALSE if the end of the file was reached before a token
+Exceptions:	None
+******************************************************************************/
+bool ReadToken(tesseract::TFile *File, char *Token, int TokenSize) {
+  char Ch;
+
+  do {
+    if (File->FRead(&Ch, 1, 1) != 1)
+      return false;
+  } while (isspace(static_cast<unsigned char>(Ch)));
+  int Length = 0;
+  do {
+    if (Length < TokenSize - 1)
+      Token[Length++] = Ch;
+  } while (File->FRead(&Ch, 1, 1) == 1 &&
+           !isspace(static_cast<unsigned char>(Ch)));
+  Token[Length] = '\0';
+  return true;
+}                                // ReadToken
+
+
 /** ReadSampleSize ***********************************************************
 Parameters:	File	open text file to read sample size from
 Globals:	None
@@ -43,10 +77,10 @@ Return:		Sample size
 Exceptions:	ILLEGALSAMPLESIZE	illegal format or range
 History:	6/6/89, DSJ, Created.
 ******************************************************************************/
-uinT16 ReadSampleSize(FILE *File) {
+uinT16 ReadSampleSize(tesseract::TFile *File) {
   int SampleSize;
 
-  if ((fscanf (File, "%d", &SampleSize) != 1) ||
+  if ((ReadInt (File, &SampleSize) != 1) ||
     (SampleSize < 0) || (SampleSize > MAXSAMPLESIZE))
     DoError (ILLEGALSAMPLESIZE, "Illegal sample size");
   return (SampleSize);
@@ -65,14 +99,14 @@ Exceptions:	ILLEGALCIRCULARSPEC
       ILLEGALMINMAXSPEC
 History:	6/6/89, DSJ, Created.
 ******************************************************************************/
-PARAM_DESC *ReadParamDesc(FILE *File, uinT16 N) {
+PARAM_DESC *ReadParamDesc(tesseract::TFile *File, uinT16 N) {
   int i;
   PARAM_DESC *ParamDesc;
   char Token[TOKENSIZE];
 
   ParamDesc = (PARAM_DESC *) Emalloc (N * sizeof (PARAM_DESC));
   for (i = 0; i < N; i++) {
-    if (fscanf (File, "%s", Token) != 1)
+    if (!ReadToken (File, Token, TOKENSIZE))
       DoError (ILLEGALCIRCULARSPEC,
         "Illegal circular/linear specification");
     if (Token[0] == 'c')
@@ -80,15 +114,15 @@ PARAM_DESC *ReadParamDesc(FILE *File, uinT16 N) {
     else
       ParamDesc[i].Circular = FALSE;
 
-    if (fscanf (File, "%s", Token) != 1)
+    if (!ReadToken (File, Token, TOKENSIZE))
       DoError (ILLEGALESSENTIALSPEC,
         "Illegal essential/non-essential spec");
     if (Token[0] == 'e')
       ParamDesc[i].NonEssential = FALSE;
     else
       ParamDesc[i].NonEssential = TRUE;
-    if (fscanf (File, "%f%f", &(ParamDesc[i].Min), &(ParamDesc[i].Max)) !=
-      2)
+    if (ReadFloat (File, &(ParamDesc[i].Min)) != 1 ||
+      ReadFloat (File, &(ParamDesc[i].Max)) != 1)
       DoError (ILLEGALMINMAXSPEC, "Illegal min or max specification");
     ParamDesc[i].Range = ParamDesc[i].Max - ParamDesc[i].Min;
     ParamDesc[i].HalfRange = ParamDesc[i].Range / 2;
@@ -112,14 +146,13 @@ Exceptions:	ILLEGALSIGNIFICANCESPEC
       ILLEGALDISTRIBUTION
 History:	6/6/89, DSJ, Created.
 ******************************************************************************/
-PROTOTYPE *ReadPrototype(FILE *File, uinT16 N) {
+PROTOTYPE *ReadPrototype(tesseract::TFile *File, uinT16 N) {
   char Token[TOKENSIZE];
-  int Status;
   PROTOTYPE *Proto;
   int SampleCount;
   int i;
 
-  if ((Status = fscanf (File, "%s", Token)) == 1) {
+  if (ReadToken (File, Token, TOKENSIZE)) {
     Proto = (PROTOTYPE *) Emalloc (sizeof (PROTOTYPE));
     Proto->Cluster = NULL;
     if (Token[0] == 's')
@@ -129,7 +162,7 @@ PROTOTYPE *ReadPrototype(FILE *File, uinT16 N) {
 
     Proto->Style = ReadProtoStyle (File);
 
-    if ((fscanf (File, "%d", &SampleCount) != 1) || (SampleCount < 0))
+    if ((ReadInt (File, &SampleCount) != 1) || (SampleCount < 0))
       DoError (ILLEGALSAMPLECOUNT, "Illegal sample count");
     Proto->NumSamples = SampleCount;
 
@@ -173,7 +206,7 @@ PROTOTYPE *ReadPrototype(FILE *File, uinT16 N) {
         Proto->Distrib =
           (DISTRIBUTION *) Emalloc (N * sizeof (DISTRIBUTION));
         for (i = 0; i < N; i++) {
-          if (fscanf (File, "%s", Token) != 1)
+          if (!ReadToken (File, Token, TOKENSIZE))
             DoError (ILLEGALDISTRIBUTION,
               "Illegal prototype distribution");
           switch (Token[0]) {
@@ -223,12 +256,8 @@ PROTOTYPE *ReadPrototype(FILE *File, uinT16 N) {
     }
     return (Proto);
   }
-  else if (Status == EOF)
-    return (NULL);
-  else {
-    DoError (ILLEGALSIGNIFICANCESPEC, "Illegal significance specification");
+  else
     return (NULL);
-  }
 }                                // ReadPrototype
 
 
@@ -241,11 +270,11 @@ Return:		Prototype style read from text file
 Exceptions:	ILLEGALSTYLESPEC	illegal prototype style specification
 History:	6/8/89, DSJ, Created.
 *******************************************************************************/
-PROTOSTYLE ReadProtoStyle(FILE *File) {
+PROTOSTYLE ReadProtoStyle(tesseract::TFile *File) {
   char Token[TOKENSIZE];
   PROTOSTYLE Style;
 
-  if (fscanf (File, "%s", Token) != 1)
+  if (!ReadToken (File, Token, TOKENSIZE))
     DoError (ILLEGALSTYLESPEC, "Illegal prototype style specification");
   switch (Token[0]) {
     case 's':
@@ -283,7 +312,7 @@ Exceptions:	ILLEGALFLOAT
 History:	6/6/89, DSJ, Created.
 ******************************************************************************/
 FLOAT32 *
-ReadNFloats (FILE * File, uinT16 N, FLOAT32 Buffer[]) {
+ReadNFloats (tesseract::TFile * File, uinT16 N, FLOAT32 Buffer[]) {
   int i;
   int NumFloatsRead;
 
@@ -291,7 +320,7 @@ ReadNFloats (FILE * File, uinT16 N, FLOAT32 Buffer[]) {
     Buffer = (FLOAT32 *) Emalloc (N * sizeof (FLOAT32));
 
   for (i = 0; i < N; i++) {
-    NumFloatsRead = fscanf (File, "%f", &(Buffer[i]));
+    NumFloatsRead = ReadFloat (File, &(Buffer[i]));
     if (NumFloatsRead != 1) {
       if ((NumFloatsRead == EOF) && (i == 0))
         return (NULL);
@@ -480,3 +509,42 @@ void WriteProtoList(
     }
 }	/* WriteProtoList */
 
+
+
+/*---------------------------------------------------------------------------
+          Private Code
+-----------------------------------------------------------------------------*/
+/** ReadInt ******************************************************************
+Parameters:	File	open text file to read an integer from
+      Value	place to put the integer
+Globals:	None
+Operation:	This routine reads the next token of the file as an integer.
+Return:		1 if an integer was read, 0 if the token is not an integer
+      and EOF at the end of the file, as fscanf "%d" does
+Exceptions:	None
+******************************************************************************/
+static int ReadInt(tesseract::TFile *File, int *Value) {
+  char Token[TOKENSIZE];
+
+  if (!ReadToken (File, Token, TOKENSIZE))
+    return (EOF);
+  return (sscanf (Token, "%d", Value) == 1 ? 1 : 0);
+}                                // ReadInt
+
+
+/** ReadFloat ****************************************************************
+Parameters:	File	open text file to read a float from
+      Value	place to put the float
+Globals:	None
+Operation:	This routine reads the next token of the file as a float.
+Return:		1 if a float was read, 0 if the token is not a float
+      and EOF at the end of the file, as fscanf "%f" does
+Exceptions:	None
+******************************************************************************/
+static int ReadFloat(tesseract::TFile *File, FLOAT32 *Value) {
+  char Token[TOKENSIZE];
+
+  if (!ReadToken (File, Token, TOKENSIZE))
+    return (EOF);
+  return (sscanf (Token, "%f", Value) == 1 ? 1 : 0);
+}                                // ReadFloat
@@ -21,20 +21,23 @@
 //--------------------------Include Files---------------------------------------
 #include "host.h"
 #include "cluster.h"
+#include "serialis.h"
 #include <stdio.h>
 
 /*-------------------------------------------------------------------------
         Public Funtion Prototype
 --------------------------------------------------------------------------*/
-uinT16 ReadSampleSize(FILE *File);
+bool ReadToken(tesseract::TFile *File, char *Token, int TokenSize);
 
-PARAM_DESC *ReadParamDesc(FILE *File, uinT16 N);
+uinT16 ReadSampleSize(tesseract::TFile *File);
 
-PROTOTYPE *ReadPrototype(FILE *File, uinT16 N);
+PARAM_DESC *ReadParamDesc(tesseract::TFile *File, uinT16 N);
 
-PROTOSTYLE ReadProtoStyle(FILE *File);
+PROTOTYPE *ReadPrototype(tesseract::TFile *File, uinT16 N);
 
-FLOAT32 *ReadNFloats (FILE * File, uinT16 N, FLOAT32 Buffer[]);
+PROTOSTYLE ReadProtoStyle(tesseract::TFile *File);
+
+FLOAT32 *ReadNFloats (tesseract::TFile * File, uinT16 N, FLOAT32 Buffer[]);
 
 void WriteParamDesc (FILE * File, uinT16 N, PARAM_DESC ParamDesc[]);
 
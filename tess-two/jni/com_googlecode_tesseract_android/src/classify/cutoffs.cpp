@@ -39,11 +39,11 @@
 ----------------------------------------------------------------------------**/
 /*---------------------------------------------------------------------------*/
 namespace tesseract {
-void Classify::ReadNewCutoffs(FILE *CutoffFile, bool swap, inT64 end_offset,
+void Classify::ReadNewCutoffs(TFile *CutoffFile, bool swap,
                               CLASS_CUTOFF_ARRAY Cutoffs) {
 /*
  **	Parameters:
- **		Filename	name of file containing cutoff definitions
+ **		CutoffFile	file containing cutoff definitions
  **		Cutoffs		array to put cutoffs into
  **	Globals: none
  **	Operation: Open Filename, read in all of the class-id/cutoff pairs
@@ -54,6 +54,7 @@ void Classify::ReadNewCutoffs(FILE *CutoffFile, bool swap, inT64 end_offset,
  **	Exceptions: none
  **	History: Wed Feb 20 09:38:26 1991, DSJ, Created.
  */
+  char line[UNICHAR_LEN + 64];
   char Class[UNICHAR_LEN + 1];
   CLASS_ID ClassId;
   int Cutoff;
@@ -67,8 +68,8 @@ void Classify::ReadNewCutoffs(FILE *CutoffFile, bool swap, inT64 end_offset,
   for (i = 0; i < MAX_NUM_CLASSES; i++)
     Cutoffs[i] = MAX_CUTOFF;
 
-  while ((end_offset < 0 || ftell(CutoffFile) < end_offset) &&
-         fscanf(CutoffFile, "%" REALLY_QUOTE_IT(UNICHAR_LEN) "s %d",
+  while (CutoffFile->FGets(line, sizeof(line)) != NULL &&
+         sscanf(line, "%" REALLY_QUOTE_IT(UNICHAR_LEN) "s %d",
                 Class, &Cutoff) == 2) {
     if (strcmp(Class, "NULL") == 0) {
       ClassId = unicharset.unichar_to_id(" ");
@@ -76,7 +77,6 @@ void Classify::ReadNewCutoffs(FILE *CutoffFile, bool swap, inT64 end_offset,
       ClassId = unicharset.unichar_to_id(Class);
     }
     Cutoffs[ClassId] = Cutoff;
-    SkipNewline(CutoffFile);
   }
 }                                /* ReadNewCutoffs */
 
@@ -99,6 +99,12 @@ static const uinT8 next_table[256] = {
 
 namespace tesseract {
 
+// Number of pruner words that ClassPruner::ComputeScoresWithKernel gathers
+// on the stack at a time. Enough for 5 features of the largest character
+// set, MAX_NUM_CLASSES / CLASSES_PER_CP_WERD words each, and for all the
+// features of a blob of typical character sets.
+const int kClassPrunerGatherWords = 4096;
+
 // Encapsulation of the intermediate data and computations made by the class
 // pruner. The class pruner implements a simple linear classifier on binary
 // features by heavily quantizing the feature space, and applying
@@ -112,11 +118,12 @@ class ClassPruner {
     // be rounded up so that the array is big enough to accommodate the extra
     // entries accessed by the unrolling. Each pruner word is of sized
     // BITS_PER_WERD and each entry is NUM_BITS_PER_CLASS, so there are
-    // BITS_PER_WERD / NUM_BITS_PER_CLASS entries.
+    // BITS_PER_WERD / NUM_BITS_PER_CLASS entries. The SIMD kernels process
+    // kClassPrunerWordGroup words at a time, which is the larger block.
     // See ComputeScores.
     max_classes_ = max_classes;
     rounded_classes_ = RoundUp(
-        max_classes, WERDS_PER_CP_VECTOR * BITS_PER_WERD / NUM_BITS_PER_CLASS);
+        max_classes, kClassPrunerWordGroup * BITS_PER_WERD / NUM_BITS_PER_CLASS);
     class_count_ = new int[rounded_classes_];
     norm_count_ = new int[rounded_classes_];
     sort_key_ = new int[rounded_classes_ + 1];
@@ -127,6 +134,7 @@ class ClassPruner {
     pruning_threshold_ = 0;
     num_features_ = 0;
     num_classes_ = 0;
+    kernel_ = ClassPrunerKernelForCpu();
   }
 
   ~ClassPruner() {
@@ -141,6 +149,10 @@ class ClassPruner {
   void ComputeScores(const INT_TEMPLATES_STRUCT* int_templates,
                      int num_features, const INT_FEATURE_STRUCT* features) {
     num_features_ = num_features;
+    if (kernel_ != NULL) {
+      ComputeScoresWithKernel(int_templates, num_features, features);
+      return;
+    }
     int num_pruners = int_templates->NumClassPruners;
     for (int f = 0; f < num_features; ++f) {
       const INT_FEATURE_STRUCT* feature = &features[f];
@@ -204,6 +216,45 @@ class ClassPruner {
     }
   }
 
+  // Computes the same scores as ComputeScores, using the SIMD kernel_.
+  // The pruner words of each feature are gathered from the class pruners
+  // into one contiguous zero-padded vector, so the kernel can sum the
+  // weights of many classes in parallel. The features are gathered into a
+  // fixed stack buffer, as many at a time as fit. The result is bit-exact
+  // with the scalar code, as the sums are all integer.
+  void ComputeScoresWithKernel(const INT_TEMPLATES_STRUCT* int_templates,
+                               int num_features,
+                               const INT_FEATURE_STRUCT* features) {
+    int num_pruners = int_templates->NumClassPruners;
+    int words_per_feature = RoundUp(num_pruners * WERDS_PER_CP_VECTOR,
+                                    kClassPrunerWordGroup);
+    int features_per_gather = kClassPrunerGatherWords / words_per_feature;
+    uinT32 words[kClassPrunerGatherWords];
+    for (int first = 0; first < num_features; first += features_per_gather) {
+      int gather_features = MIN(features_per_gather, num_features - first);
+      uinT32* word_ptr = words;
+      for (int f = first; f < first + gather_features; ++f) {
+        const INT_FEATURE_STRUCT* feature = &features[f];
+        // Quantize the feature to
+        // NUM_CP_BUCKETS*NUM_CP_BUCKETS*NUM_CP_BUCKETS.
+        int x = feature->X * NUM_CP_BUCKETS >> 8;
+        int y = feature->Y * NUM_CP_BUCKETS >> 8;
+        int theta = feature->Theta * NUM_CP_BUCKETS >> 8;
+        for (int pruner_set = 0; pruner_set < num_pruners; ++pruner_set) {
+          const uinT32* pruner_word_ptr =
+              int_templates->ClassPruners[pruner_set]->p[x][y][theta];
+          for (int word = 0; word < WERDS_PER_CP_VECTOR; ++word)
+            *word_ptr++ = *pruner_word_ptr++;
+        }
+        for (int word = num_pruners * WERDS_PER_CP_VECTOR;
+             word < words_per_feature; ++word) {
+          *word_ptr++ = 0;
+        }
+      }
+      (*kernel_)(words, gather_features, words_per_feature, class_count_);
+    }
+  }
+
   // Adjusts the scores according to the number of expected features. Used
   // in lieu of a constant bias, this penalizes classes that expect more
   // features than there are present. Thus an actual c will score higher for c
@@ -385,6 +436,8 @@ class ClassPruner {
   int num_features_;
   // Final number of pruned classes.
   int num_classes_;
+  // Vectorized kernel for ComputeScores, or NULL to use the scalar code.
+  ClassPrunerKernel kernel_;
 };
 
 /*----------------------------------------------------------------------------
@@ -714,6 +767,9 @@ void IntegerMatcher::Init(tesseract::IntParam *classify_debug_level,
 
     similarity_evidence_table_[i] = (uinT8) (evidence + 0.5);
   }
+  for (int i = SE_TABLE_SIZE;
+       i < SE_TABLE_SIZE + tesseract::kEvidenceTablePadding; i++)
+    similarity_evidence_table_[i] = 0;
 
   /* Initialize evidence computation variables */
   evidence_table_mask_ =
@@ -721,6 +777,10 @@ void IntegerMatcher::Init(tesseract::IntParam *classify_debug_level,
   mult_trunc_shift_bits_ = (14 - kIntEvidenceTruncBits);
   table_trunc_shift_bits_ = (27 - SE_TABLE_BITS - (mult_trunc_shift_bits_ << 1));
   evidence_mult_mask_ = ((1 << kIntEvidenceTruncBits) - 1);
+
+  /* Select the fastest evidence kernels for this cpu */
+  evidence_kernel_ = tesseract::EvidenceKernelForCpu();
+  evidence_update_kernel_ = tesseract::EvidenceUpdateKernelForCpu();
 }
 
 /*--------------------------------------------------------------------------*/
@@ -743,6 +803,11 @@ void ScratchEvidence::Clear(const INT_CLASS class_template) {
          class_template->NumConfigs * sizeof(sum_feature_evidence_[0]));
   memset(proto_evidence_, 0,
          class_template->NumProtos * sizeof(proto_evidence_[0]));
+  protos_fit_rows_ = true;
+  for (int p = 0; p < class_template->NumProtos; ++p) {
+    if (class_template->ProtoLengths[p] > MAX_PROTO_INDEX)
+      protos_fit_rows_ = false;
+  }
 }
 
 void ScratchEvidence::ClearFeatureEvidence(const INT_CLASS class_template) {
@@ -822,6 +887,10 @@ int IntegerMatcher::UpdateTablesForFeature(
  **       For the given feature: prune protos, compute evidence,
  **       update Feature Evidence, Proto Evidence, and Sum of Feature
  **       Evidence tables.
+ **       The protos that survive pruning are gathered into structure-of-
+ **       arrays form, so the evidence of all of them can be computed in one
+ **       batch by the (SIMD) evidence_kernel_, and added to the evidence
+ **       tables in one batch by the evidence_update_kernel_, if any.
  **  Return:
  */
   register uinT32 ConfigWord;
@@ -846,9 +915,18 @@ int IntegerMatcher::UpdateTablesForFeature(
   uinT8 Temp;
   register int *IntPointer;
   int ConfigNum;
-  register inT32 M3;
-  register inT32 A3;
-  register uinT32 A4;
+  int NumMatchedProtos;
+  int MatchIndex;
+  /* Ids and parameters of the protos that survive pruning, and their
+     evidence */
+  uinT16 MatchedProtos[MAX_NUM_PROTOS];
+  inT16 ProtoA[MAX_NUM_PROTOS];
+  inT16 ProtoB[MAX_NUM_PROTOS];
+  inT16 ProtoC[MAX_NUM_PROTOS];
+  inT16 ProtoAngle[MAX_NUM_PROTOS];
+  uinT32 ProtoConfigs[MAX_NUM_PROTOS];
+  uinT8 ProtoLength[MAX_NUM_PROTOS];
+  uinT8 ProtoEvidence[MAX_NUM_PROTOS];
 
   tables->ClearFeatureEvidence(ClassTemplate);
 
@@ -857,6 +935,8 @@ int IntegerMatcher::UpdateTablesForFeature(
   YFeatureAddress = (NUM_PP_BUCKETS << 1) + ((Feature->Y >> 2) << 1);
   ThetaFeatureAddress = (NUM_PP_BUCKETS << 2) + ((Feature->Theta >> 2) << 1);
 
+  /* Gather the protos that survive pruning */
+  NumMatchedProtos = 0;
   for (ProtoSetIndex = 0, ActualProtoNum = 0;
   ProtoSetIndex < ClassTemplate->NumProtoSets; ProtoSetIndex++) {
     ProtoSet = ClassTemplate->ProtoSets[ProtoSetIndex];
@@ -883,65 +963,82 @@ int IntegerMatcher::UpdateTablesForFeature(
           proto_offset = offset_table[proto_byte] + proto_word_offset;
           proto_byte = next_table[proto_byte];
           Proto = &(ProtoSet->Protos[ProtoNum + proto_offset]);
-          ConfigWord = Proto->Configs[0];
-          A3 = (((Proto->A * (Feature->X - 128)) << 1)
-            - (Proto->B * (Feature->Y - 128)) + (Proto->C << 9));
-          M3 =
-            (((inT8) (Feature->Theta - Proto->Angle)) * kIntThetaFudge) << 1;
-
-          if (A3 < 0)
-            A3 = ~A3;
-          if (M3 < 0)
-            M3 = ~M3;
-          A3 >>= mult_trunc_shift_bits_;
-          M3 >>= mult_trunc_shift_bits_;
-          if (A3 > evidence_mult_mask_)
-            A3 = evidence_mult_mask_;
-          if (M3 > evidence_mult_mask_)
-            M3 = evidence_mult_mask_;
-
-          A4 = (A3 * A3) + (M3 * M3);
-          A4 >>= table_trunc_shift_bits_;
-          if (A4 > evidence_table_mask_)
-            Evidence = 0;
-          else
-            Evidence = similarity_evidence_table_[A4];
-
-          if (PrintFeatureMatchesOn (Debug))
-            IMDebugConfiguration (FeatureNum,
-              ActualProtoNum + proto_offset,
-              Evidence, ConfigMask, ConfigWord);
-
-          ConfigWord &= *ConfigMask;
-
-          UINT8Pointer = tables->feature_evidence_ - 8;
-          config_byte = 0;
-          while (ConfigWord != 0 || config_byte != 0) {
-            while (config_byte == 0) {
-              config_byte = ConfigWord & 0xff;
-              ConfigWord >>= 8;
-              UINT8Pointer += 8;
-            }
-            config_offset = offset_table[config_byte];
-            config_byte = next_table[config_byte];
-            if (Evidence > UINT8Pointer[config_offset])
-              UINT8Pointer[config_offset] = Evidence;
-          }
-
-          UINT8Pointer =
-            &(tables->proto_evidence_[ActualProtoNum + proto_offset][0]);
-          for (ProtoIndex =
+          MatchedProtos[NumMatchedProtos] =
+            ActualProtoNum + proto_offset;
+          ProtoA[NumMatchedProtos] = Proto->A;
+          ProtoB[NumMatchedProtos] = Proto->B;
+          ProtoC[NumMatchedProtos] = Proto->C;
+          ProtoAngle[NumMatchedProtos] = Proto->Angle;
+          ProtoConfigs[NumMatchedProtos] = Proto->Configs[0] & *ConfigMask;
+          ProtoLength[NumMatchedProtos] =
             ClassTemplate->ProtoLengths[ActualProtoNum + proto_offset];
-          ProtoIndex > 0; ProtoIndex--, UINT8Pointer++) {
-            if (Evidence > *UINT8Pointer) {
-              Temp = *UINT8Pointer;
-              *UINT8Pointer = Evidence;
-              Evidence = Temp;
-            }
-            else if (Evidence == 0)
-              break;
-          }
+          ++NumMatchedProtos;
+        }
+      }
+    }
+  }
+
+  /* Compute the evidence of all the matched protos at once */
+  tesseract::EvidenceKernelParams params;
+  params.feature_x = Feature->X;
+  params.feature_y = Feature->Y;
+  params.feature_theta = Feature->Theta;
+  params.theta_fudge = kIntThetaFudge;
+  params.mult_trunc_shift_bits = mult_trunc_shift_bits_;
+  params.evidence_mult_mask = evidence_mult_mask_;
+  params.table_trunc_shift_bits = table_trunc_shift_bits_;
+  params.evidence_table_mask = evidence_table_mask_;
+  params.similarity_evidence_table = similarity_evidence_table_;
+  (*evidence_kernel_)(params, NumMatchedProtos, ProtoA, ProtoB, ProtoC,
+                      ProtoAngle, ProtoEvidence);
+
+  /* Update the config and proto evidence of all the matched protos at
+     once, unless they are to be printed one by one, or the scalar code
+     below would spill the evidence of a long proto into the rows of the
+     next protos */
+  if (evidence_update_kernel_ != NULL && tables->protos_fit_rows_ &&
+      !PrintFeatureMatchesOn(Debug)) {
+    (*evidence_update_kernel_)(NumMatchedProtos, MatchedProtos, ProtoConfigs,
+                               ProtoLength, ProtoEvidence,
+                               tables->feature_evidence_,
+                               &tables->proto_evidence_[0][0]);
+  } else {
+    for (MatchIndex = 0; MatchIndex < NumMatchedProtos; MatchIndex++) {
+      ActualProtoNum = MatchedProtos[MatchIndex];
+      Proto = ProtoForProtoId(ClassTemplate, ActualProtoNum);
+      ConfigWord = Proto->Configs[0];
+      Evidence = ProtoEvidence[MatchIndex];
+
+      if (PrintFeatureMatchesOn (Debug))
+        IMDebugConfiguration (FeatureNum, ActualProtoNum,
+          Evidence, ConfigMask, ConfigWord);
+
+      ConfigWord &= *ConfigMask;
+
+      UINT8Pointer = tables->feature_evidence_ - 8;
+      config_byte = 0;
+      while (ConfigWord != 0 || config_byte != 0) {
+        while (config_byte == 0) {
+          config_byte = ConfigWord & 0xff;
+          ConfigWord >>= 8;
+          UINT8Pointer += 8;
+        }
+        config_offset = offset_table[config_byte];
+        config_byte = next_table[config_byte];
+        if (Evidence > UINT8Pointer[config_offset])
+          UINT8Pointer[config_offset] = Evidence;
+      }
+
+      UINT8Pointer = &(tables->proto_evidence_[ActualProtoNum][0]);
+      for (ProtoIndex = ClassTemplate->ProtoLengths[ActualProtoNum];
+      ProtoIndex > 0; ProtoIndex--, UINT8Pointer++) {
+        if (Evidence > *UINT8Pointer) {
+          Temp = *UINT8Pointer;
+          *UINT8Pointer = Evidence;
+          Evidence = Temp;
         }
+        else if (Evidence == 0)
+          break;
       }
     }
   }
@@ -37,6 +37,7 @@ extern INT_VAR_H(classify_integer_matcher_multiplier, 14,
 ----------------------------------------------------------------------------**/
 #include "intproto.h"
 #include "cutoffs.h"
+#include "intsimdmatch.h"
 
 struct INT_RESULT_STRUCT {
   FLOAT32 Rating;
@@ -77,6 +78,10 @@ struct ScratchEvidence {
   uinT8 feature_evidence_[MAX_NUM_CONFIGS];
   int sum_feature_evidence_[MAX_NUM_CONFIGS];
   uinT8 proto_evidence_[MAX_NUM_PROTOS][MAX_PROTO_INDEX];
+  // True if no proto of the class is longer than MAX_PROTO_INDEX, so the
+  // evidence of each proto stays in its row of proto_evidence_, as the
+  // evidence update kernels need.
+  bool protos_fit_rows_;
 
   void Clear(const INT_CLASS class_template);
   void ClearFeatureEvidence(const INT_CLASS class_template);
@@ -100,7 +105,9 @@ class IntegerMatcher {
   // Center of Similarity Curve.
   static const float kSimilarityCenter;
 
-  IntegerMatcher() : classify_debug_level_(0) {}
+  IntegerMatcher()
+      : classify_debug_level_(0), evidence_kernel_(NULL),
+        evidence_update_kernel_(NULL) {}
 
   void Init(tesseract::IntParam *classify_debug_level,
             int classify_integer_matcher_multiplier);
@@ -108,6 +115,15 @@ class IntegerMatcher {
   void SetBaseLineMatch();
   void SetCharNormMatch(int integer_matcher_multiplier);
 
+  // Overrides the evidence kernels selected by Init. A NULL update kernel
+  // selects the scalar code. Used by the benchmarks to compare the kernels.
+  // Must be called after Init.
+  void SetEvidenceKernels(tesseract::EvidenceKernel kernel,
+                          tesseract::EvidenceUpdateKernel update_kernel) {
+    evidence_kernel_ = kernel;
+    evidence_update_kernel_ = update_kernel;
+  }
+
   void Match(INT_CLASS ClassTemplate,
              BIT_VECTOR ProtoMask,
              BIT_VECTOR ConfigMask,
@@ -188,13 +204,20 @@ class IntegerMatcher {
 
 
  private:
-  uinT8 similarity_evidence_table_[SE_TABLE_SIZE];
+  // Padded for the 4 byte reads of the AVX2 evidence kernel.
+  uinT8 similarity_evidence_table_[SE_TABLE_SIZE +
+                                   tesseract::kEvidenceTablePadding];
   uinT32 evidence_table_mask_;
   uinT32 mult_trunc_shift_bits_;
   uinT32 table_trunc_shift_bits_;
   inT16 local_matcher_multiplier_;
   tesseract::IntParam *classify_debug_level_;
   uinT32 evidence_mult_mask_;
+  // Kernel that computes the evidence of the protos matched to a feature.
+  tesseract::EvidenceKernel evidence_kernel_;
+  // Kernel that adds that evidence to the evidence tables, or NULL for the
+  // scalar code.
+  tesseract::EvidenceUpdateKernel evidence_update_kernel_;
 };
 
 /**----------------------------------------------------------------------------
@@ -762,6 +762,7 @@ INT_TEMPLATES NewIntTemplates() {
   T = (INT_TEMPLATES) Emalloc (sizeof (INT_TEMPLATES_STRUCT));
   T->NumClasses = 0;
   T->NumClassPruners = 0;
+  T->ClassPrunersInPlace = false;
 
   for (i = 0; i < MAX_NUM_CLASSES; i++)
     ClassForClassId (T, i) = NULL;
@@ -776,14 +777,22 @@ void free_int_templates(INT_TEMPLATES templates) {
 
   for (i = 0; i < templates->NumClasses; i++)
     free_int_class(templates->Class[i]);
-  for (i = 0; i < templates->NumClassPruners; i++)
-    delete templates->ClassPruners[i];
+  if (!templates->ClassPrunersInPlace) {
+    for (i = 0; i < templates->NumClassPruners; i++)
+      delete templates->ClassPruners[i];
+  }
   Efree(templates);
 }
 
 
 namespace tesseract {
 INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
+  TFile file;
+  file.Open(File, -1);
+  return ReadIntTemplates(&file);
+}
+
+INT_TEMPLATES Classify::ReadIntTemplates(TFile *File) {
 /*
  ** Parameters:
  **   File    open file to read templates from
@@ -822,12 +831,12 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
   /* first read the high level template struct */
   Templates = NewIntTemplates();
   // Read Templates in parts for 64 bit compatibility.
-  if (fread(&unicharset_size, sizeof(int), 1, File) != 1)
+  if (File->FRead(&unicharset_size, sizeof(int), 1) != 1)
     cprintf("Bad read of inttemp!\n");
-  if (fread(&Templates->NumClasses,
-            sizeof(Templates->NumClasses), 1, File) != 1 ||
-      fread(&Templates->NumClassPruners,
-            sizeof(Templates->NumClassPruners), 1, File) != 1)
+  if (File->FRead(&Templates->NumClasses,
+                  sizeof(Templates->NumClasses), 1) != 1 ||
+      File->FRead(&Templates->NumClassPruners,
+                  sizeof(Templates->NumClassPruners), 1) != 1)
     cprintf("Bad read of inttemp!\n");
   // Swap status is determined automatically.
   swap = Templates->NumClassPruners < 0 ||
@@ -840,8 +849,8 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
   if (Templates->NumClasses < 0) {
     // This file has a version id!
     version_id = -Templates->NumClasses;
-    if (fread(&Templates->NumClasses, sizeof(Templates->NumClasses),
-              1, File) != 1)
+    if (File->FRead(&Templates->NumClasses,
+                    sizeof(Templates->NumClasses), 1) != 1)
       cprintf("Bad read of inttemp!\n");
     if (swap)
       Reverse32(&Templates->NumClasses);
@@ -854,11 +863,11 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
 
   if (version_id < 2) {
     for (i = 0; i < unicharset_size; ++i) {
-      if (fread(&IndexFor[i], sizeof(inT16), 1, File) != 1)
+      if (File->FRead(&IndexFor[i], sizeof(inT16), 1) != 1)
         cprintf("Bad read of inttemp!\n");
     }
     for (i = 0; i < Templates->NumClasses; ++i) {
-      if (fread(&ClassIdFor[i], sizeof(CLASS_ID), 1, File) != 1)
+      if (File->FRead(&ClassIdFor[i], sizeof(CLASS_ID), 1) != 1)
         cprintf("Bad read of inttemp!\n");
     }
     if (swap) {
@@ -870,11 +879,30 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
   }
 
   /* then read in the class pruners */
+  // Class pruners in the current format that need no swapping are used in
+  // place if the file is in memory, as they are never modified.
+  Templates->ClassPrunersInPlace = File->in_memory() && !swap &&
+                                   version_id >= 2;
   for (i = 0; i < Templates->NumClassPruners; i++) {
+    if (Templates->ClassPrunersInPlace) {
+      const char *data = File->FReadInPlace(sizeof(CLASS_PRUNER_STRUCT),
+                                            sizeof(uinT32));
+      if (data != NULL) {
+        Templates->ClassPruners[i] = reinterpret_cast<CLASS_PRUNER_STRUCT*>(
+            const_cast<char *>(data));
+        continue;
+      }
+      // This one can't be used in place, so copy any that were.
+      for (int p = 0; p < i; ++p) {
+        Pruner = new CLASS_PRUNER_STRUCT;
+        memcpy(Pruner, Templates->ClassPruners[p], sizeof(*Pruner));
+        Templates->ClassPruners[p] = Pruner;
+      }
+      Templates->ClassPrunersInPlace = false;
+    }
     Pruner = new CLASS_PRUNER_STRUCT;
-    if ((nread =
-         fread(Pruner, 1, sizeof(CLASS_PRUNER_STRUCT),
-                File)) != sizeof(CLASS_PRUNER_STRUCT))
+    if ((nread = File->FRead(Pruner, 1, sizeof(CLASS_PRUNER_STRUCT))) !=
+        sizeof(CLASS_PRUNER_STRUCT))
       cprintf("Bad read of inttemp!\n");
     if (swap) {
       for (x = 0; x < NUM_CP_BUCKETS; x++) {
@@ -950,21 +978,22 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
   for (i = 0; i < Templates->NumClasses; i++) {
     /* first read in the high level struct for the class */
     Class = (INT_CLASS) Emalloc (sizeof (INT_CLASS_STRUCT));
-    if (fread(&Class->NumProtos, sizeof(Class->NumProtos), 1, File) != 1 ||
-        fread(&Class->NumProtoSets, sizeof(Class->NumProtoSets), 1, File) != 1 ||
-        fread(&Class->NumConfigs, sizeof(Class->NumConfigs), 1, File) != 1)
+    if (File->FRead(&Class->NumProtos, sizeof(Class->NumProtos), 1) != 1 ||
+        File->FRead(&Class->NumProtoSets,
+                    sizeof(Class->NumProtoSets), 1) != 1 ||
+        File->FRead(&Class->NumConfigs, sizeof(Class->NumConfigs), 1) != 1)
       cprintf ("Bad read of inttemp!\n");
     if (version_id == 0) {
       // Only version 0 writes 5 pointless pointers to the file.
       for (j = 0; j < 5; ++j) {
         int junk;
-        if (fread(&junk, sizeof(junk), 1, File) != 1)
+        if (File->FRead(&junk, sizeof(junk), 1) != 1)
           cprintf ("Bad read of inttemp!\n");
       }
     }
     if (version_id < 4) {
       for (j = 0; j < MaxNumConfigs; ++j) {
-        if (fread(&Class->ConfigLengths[j], sizeof(uinT16), 1, File) != 1)
+        if (File->FRead(&Class->ConfigLengths[j], sizeof(uinT16), 1) != 1)
           cprintf ("Bad read of inttemp!\n");
       }
       if (swap) {
@@ -975,7 +1004,7 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
     } else {
       ASSERT_HOST(Class->NumConfigs < MaxNumConfigs);
       for (j = 0; j < Class->NumConfigs; ++j) {
-        if (fread(&Class->ConfigLengths[j], sizeof(uinT16), 1, File) != 1)
+        if (File->FRead(&Class->ConfigLengths[j], sizeof(uinT16), 1) != 1)
           cprintf ("Bad read of inttemp!\n");
       }
       if (swap) {
@@ -994,9 +1023,9 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
     Lengths = NULL;
     if (MaxNumIntProtosIn (Class) > 0) {
       Lengths = (uinT8 *)Emalloc(sizeof(uinT8) * MaxNumIntProtosIn(Class));
-      if ((nread =
-           fread((char *)Lengths, sizeof(uinT8),
-                 MaxNumIntProtosIn(Class), File)) != MaxNumIntProtosIn (Class))
+      if ((nread = File->FRead((char *)Lengths, sizeof(uinT8),
+                               MaxNumIntProtosIn(Class))) !=
+          MaxNumIntProtosIn (Class))
         cprintf ("Bad read of inttemp!\n");
     }
     Class->ProtoLengths = Lengths;
@@ -1005,29 +1034,28 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
     for (j = 0; j < Class->NumProtoSets; j++) {
       ProtoSet = (PROTO_SET)Emalloc(sizeof(PROTO_SET_STRUCT));
       if (version_id < 3) {
-        if ((nread =
-             fread((char *) &ProtoSet->ProtoPruner, 1,
-                    sizeof(PROTO_PRUNER), File)) != sizeof(PROTO_PRUNER))
+        if ((nread = File->FRead((char *) &ProtoSet->ProtoPruner, 1,
+                                 sizeof(PROTO_PRUNER))) != sizeof(PROTO_PRUNER))
           cprintf("Bad read of inttemp!\n");
         for (x = 0; x < PROTOS_PER_PROTO_SET; x++) {
-          if ((nread = fread((char *) &ProtoSet->Protos[x].A, 1,
-                             sizeof(inT8), File)) != sizeof(inT8) ||
-              (nread = fread((char *) &ProtoSet->Protos[x].B, 1,
-                             sizeof(uinT8), File)) != sizeof(uinT8) ||
-              (nread = fread((char *) &ProtoSet->Protos[x].C, 1,
-                             sizeof(inT8), File)) != sizeof(inT8) ||
-              (nread = fread((char *) &ProtoSet->Protos[x].Angle, 1,
-                             sizeof(uinT8), File)) != sizeof(uinT8))
+          if ((nread = File->FRead((char *) &ProtoSet->Protos[x].A, 1,
+                                   sizeof(inT8))) != sizeof(inT8) ||
+              (nread = File->FRead((char *) &ProtoSet->Protos[x].B, 1,
+                                   sizeof(uinT8))) != sizeof(uinT8) ||
+              (nread = File->FRead((char *) &ProtoSet->Protos[x].C, 1,
+                                   sizeof(inT8))) != sizeof(inT8) ||
+              (nread = File->FRead((char *) &ProtoSet->Protos[x].Angle, 1,
+                                   sizeof(uinT8))) != sizeof(uinT8))
             cprintf("Bad read of inttemp!\n");
           for (y = 0; y < WerdsPerConfigVec; y++)
-            if ((nread = fread((char *) &ProtoSet->Protos[x].Configs[y], 1,
-                               sizeof(uinT32), File)) != sizeof(uinT32))
+            if ((nread = File->FRead((char *) &ProtoSet->Protos[x].Configs[y],
+                                     1, sizeof(uinT32))) != sizeof(uinT32))
               cprintf("Bad read of inttemp!\n");
         }
       } else {
-        if ((nread =
-             fread((char *) ProtoSet, 1, sizeof(PROTO_SET_STRUCT),
-                   File)) != sizeof(PROTO_SET_STRUCT))
+        if ((nread = File->FRead((char *) ProtoSet, 1,
+                                 sizeof(PROTO_SET_STRUCT))) !=
+            sizeof(PROTO_SET_STRUCT))
           cprintf("Bad read of inttemp!\n");
       }
       if (swap) {
@@ -1044,7 +1072,7 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
     if (version_id < 4)
       Class->font_set_id = -1;
     else {
-      fread(&Class->font_set_id, sizeof(int), 1, File);
+      File->FRead(&Class->font_set_id, sizeof(int), 1);
       if (swap)
         Reverse32(&Class->font_set_id);
     }
@@ -121,6 +121,9 @@ typedef struct
   int NumClassPruners;
   INT_CLASS Class[MAX_NUM_CLASSES];
   CLASS_PRUNER_STRUCT* ClassPruners[MAX_NUM_CLASS_PRUNERS];
+  // True if the ClassPruners point into a memory-mapped file, so they are
+  // read-only and are not deleted with the templates.
+  bool ClassPrunersInPlace;
 }
 
 
@@ -226,6 +229,8 @@ INT_CLASS NewIntClass(int MaxNumProtos, int MaxNumConfigs);
 
 INT_TEMPLATES NewIntTemplates();
 
+void free_int_class(INT_CLASS int_class);
+
 void free_int_templates(INT_TEMPLATES templates);
 
 void ShowMatchDisplay();
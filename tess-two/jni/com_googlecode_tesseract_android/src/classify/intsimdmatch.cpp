@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intsimdmatch.cpp
+// Description: Vectorized kernels for the integer matcher and class pruner.
+// Created:     Fri Oct 16 10:12:41 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "intsimdmatch.h"
+#include "simddetect.h"
+
+namespace tesseract {
+
+// Returns the fastest class pruner kernel that is both compiled into this
+// library and supported by the running cpu, or NULL if there is none.
+ClassPrunerKernel ClassPrunerKernelForCpu() {
+  ClassPrunerKernel kernel = NULL;
+  if (SIMDDetect::IsAVX2Available())
+    kernel = ClassPrunerKernelAVX2();
+  if (kernel == NULL && SIMDDetect::IsSSE2Available())
+    kernel = ClassPrunerKernelSSE2();
+  if (kernel == NULL && SIMDDetect::IsNEONAvailable())
+    kernel = ClassPrunerKernelNEON();
+  return kernel;
+}
+
+// The scalar evidence kernel, available on all architectures.
+void ComputeEvidenceScalar(const EvidenceKernelParams& params,
+                           int num_protos, const inT16* a, const inT16* b,
+                           const inT16* c, const inT16* angle,
+                           uinT8* evidence) {
+  for (int p = 0; p < num_protos; ++p)
+    evidence[p] = ComputeProtoEvidence(params, a[p], b[p], c[p], angle[p]);
+}
+
+// Returns the fastest evidence kernel that is both compiled into this
+// library and supported by the running cpu.
+EvidenceKernel EvidenceKernelForCpu() {
+  EvidenceKernel kernel = NULL;
+  if (SIMDDetect::IsAVX2Available())
+    kernel = EvidenceKernelAVX2();
+  if (kernel == NULL && SIMDDetect::IsSSE2Available())
+    kernel = EvidenceKernelSSE2();
+  if (kernel == NULL && SIMDDetect::IsNEONAvailable())
+    kernel = EvidenceKernelNEON();
+  if (kernel == NULL)
+    kernel = ComputeEvidenceScalar;
+  return kernel;
+}
+
+// Returns the fastest evidence update kernel that is both compiled into this
+// library and supported by the running cpu, or NULL if there is none.
+EvidenceUpdateKernel EvidenceUpdateKernelForCpu() {
+  EvidenceUpdateKernel kernel = NULL;
+  if (SIMDDetect::IsSSE2Available())
+    kernel = EvidenceUpdateKernelSSE2();
+  if (kernel == NULL && SIMDDetect::IsNEONAvailable())
+    kernel = EvidenceUpdateKernelNEON();
+  return kernel;
+}
+
+}  // namespace tesseract.
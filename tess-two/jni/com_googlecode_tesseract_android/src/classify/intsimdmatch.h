@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intsimdmatch.h
+// Description: Vectorized kernels for the integer matcher and class pruner.
+// Created:     Fri Oct 16 10:12:41 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_INTSIMDMATCH_H_
+#define TESSERACT_CLASSIFY_INTSIMDMATCH_H_
+
+#include "host.h"
+
+namespace tesseract {
+
+// The class pruner kernels process the pruner words of a feature in groups
+// of this many words, so the words of each feature must be padded with zeros
+// to a multiple of kClassPrunerWordGroup.
+const int kClassPrunerWordGroup = 8;
+
+// A class pruner kernel sums the NUM_BITS_PER_CLASS-bit class weights of
+// num_features features into class_counts. The words of all the features
+// are packed contiguously in words, words_per_feature (a multiple of
+// kClassPrunerWordGroup) per feature, in the same order as the class ids,
+// ie word w holds the weights of classes [w * CLASSES_PER_CP_WERD,
+// (w + 1) * CLASSES_PER_CP_WERD), lowest bits first. class_counts must have
+// at least words_per_feature * CLASSES_PER_CP_WERD entries, and the result
+// is added to its existing contents, exactly as the scalar code in
+// ClassPruner::ComputeScores would.
+typedef void (*ClassPrunerKernel)(const uinT32* words, int num_features,
+                                  int words_per_feature, int* class_counts);
+
+// Returns the fastest class pruner kernel that is both compiled into this
+// library and supported by the running cpu, or NULL if there is none, in
+// which case the caller must use the scalar code.
+ClassPrunerKernel ClassPrunerKernelForCpu();
+
+// The kernels for each instruction set. Each returns NULL if the kernel is
+// not compiled in for the target architecture.
+ClassPrunerKernel ClassPrunerKernelSSE2();
+ClassPrunerKernel ClassPrunerKernelAVX2();
+ClassPrunerKernel ClassPrunerKernelNEON();
+
+// The similarity_evidence_table passed to the evidence kernels has this many
+// bytes past its SE_TABLE_SIZE entries, so that 4 byte reads at any index
+// stay inside it.
+const int kEvidenceTablePadding = 3;
+
+// The parameters of the proto evidence computation in
+// IntegerMatcher::UpdateTablesForFeature that are constant over all the
+// protos matched against one feature.
+struct EvidenceKernelParams {
+  // The feature being matched.
+  int feature_x;
+  int feature_y;
+  int feature_theta;
+  // Copies of the IntegerMatcher constants of the same names.
+  int theta_fudge;
+  int mult_trunc_shift_bits;
+  int evidence_mult_mask;
+  int table_trunc_shift_bits;
+  int evidence_table_mask;
+  // Table of SE_TABLE_SIZE entries that converts the truncated squared
+  // distance to an 8 bit evidence value, followed by kEvidenceTablePadding
+  // bytes.
+  const uinT8* similarity_evidence_table;
+};
+
+// An evidence kernel computes the 8 bit evidence of the match between the
+// feature in params and each of num_protos protos, whose parameters are
+// given in structure-of-arrays form in a, b, c and angle, which hold the
+// values of the A, B, C and Angle members of INT_PROTO_STRUCT. The results
+// are written to evidence[0, num_protos).
+typedef void (*EvidenceKernel)(const EvidenceKernelParams& params,
+                               int num_protos, const inT16* a, const inT16* b,
+                               const inT16* c, const inT16* angle,
+                               uinT8* evidence);
+
+// Computes the evidence of one proto exactly as the original scalar code in
+// IntegerMatcher::UpdateTablesForFeature. This is the reference that all
+// the evidence kernels must match bit for bit, and is used by the kernels
+// to finish the protos that don't fill a whole vector.
+inline uinT8 ComputeProtoEvidence(const EvidenceKernelParams& params,
+                                  int a, int b, int c, int angle) {
+  inT32 A3 = ((a * (params.feature_x - 128)) << 1) -
+      (b * (params.feature_y - 128)) + (c << 9);
+  inT32 M3 = (static_cast<inT8>(params.feature_theta - angle) *
+              params.theta_fudge) << 1;
+  if (A3 < 0)
+    A3 = ~A3;
+  if (M3 < 0)
+    M3 = ~M3;
+  A3 >>= params.mult_trunc_shift_bits;
+  M3 >>= params.mult_trunc_shift_bits;
+  if (A3 > params.evidence_mult_mask)
+    A3 = params.evidence_mult_mask;
+  if (M3 > params.evidence_mult_mask)
+    M3 = params.evidence_mult_mask;
+  uinT32 A4 = (A3 * A3) + (M3 * M3);
+  A4 >>= params.table_trunc_shift_bits;
+  if (A4 > static_cast<uinT32>(params.evidence_table_mask))
+    return 0;
+  return params.similarity_evidence_table[A4];
+}
+
+// The scalar evidence kernel, available on all architectures.
+void ComputeEvidenceScalar(const EvidenceKernelParams& params,
+                           int num_protos, const inT16* a, const inT16* b,
+                           const inT16* c, const inT16* angle,
+                           uinT8* evidence);
+
+// Returns the fastest evidence kernel that is both compiled into this
+// library and supported by the running cpu. Never returns NULL, as the
+// scalar kernel is always available.
+EvidenceKernel EvidenceKernelForCpu();
+
+// The evidence kernels for each instruction set. Each returns NULL if the
+// kernel is not compiled in for the target architecture.
+EvidenceKernel EvidenceKernelSSE2();
+EvidenceKernel EvidenceKernelAVX2();
+EvidenceKernel EvidenceKernelNEON();
+
+// An evidence update kernel adds the evidence of num_protos protos matched
+// to one feature to the evidence tables of UpdateTablesForFeature. For each
+// proto i, evidence[i] is:
+// - maxed into feature_evidence[c] for each config c whose bit is set in
+//   config_words[i], which holds the first 32 configs,
+// - inserted into row proto_ids[i] of proto_evidence, the descending list of
+//   the highest evidences of the proto in its first proto_lengths[i]
+//   entries, dropping the lowest.
+// proto_evidence is an array of rows of MAX_PROTO_INDEX entries, like
+// ScratchEvidence::proto_evidence_. The protos must all be different, and
+// no longer than MAX_PROTO_INDEX, so each row stays sorted. The result is
+// then exactly that of the scalar loop in UpdateTablesForFeature.
+typedef void (*EvidenceUpdateKernel)(int num_protos, const uinT16* proto_ids,
+                                     const uinT32* config_words,
+                                     const uinT8* proto_lengths,
+                                     const uinT8* evidence,
+                                     uinT8* feature_evidence,
+                                     uinT8* proto_evidence);
+
+// Returns the fastest evidence update kernel that is both compiled into this
+// library and supported by the running cpu, or NULL if there is none, in
+// which case the caller must use the scalar code.
+EvidenceUpdateKernel EvidenceUpdateKernelForCpu();
+
+// The evidence update kernels for each instruction set. Each returns NULL
+// if the kernel is not compiled in for the target architecture. AVX2 cpus
+// use the SSE2 kernel, as the evidence tables are no wider than 32 bytes.
+EvidenceUpdateKernel EvidenceUpdateKernelSSE2();
+EvidenceUpdateKernel EvidenceUpdateKernelNEON();
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CLASSIFY_INTSIMDMATCH_H_
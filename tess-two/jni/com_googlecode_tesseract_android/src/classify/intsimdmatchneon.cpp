@@ -0,0 +1,205 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intsimdmatchneon.cpp
+// Description: NEON kernels for the integer matcher and class pruner.
+// Created:     Fri Oct 16 10:12:41 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// On armeabi-v7a this file is built with -mfpu=neon (see Android.mk) and
+// the kernels are only called when the cpu reports NEON at runtime.
+
+#include "intsimdmatch.h"
+#include "intproto.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NEON_KERNELS_AVAILABLE
+#endif
+
+namespace tesseract {
+
+#ifdef NEON_KERNELS_AVAILABLE
+// Number of pruner words processed in parallel by the NEON kernel.
+const int kNEONLanes = 4;
+
+// NEON class pruner kernel. Each lane of a register accumulates one pruner
+// word, so sums[k] holds the count of class k of each of kNEONLanes
+// consecutive words. The sums are transposed back to class order at the end.
+static void ClassPrunerAccumulateNEON(const uinT32* words, int num_features,
+                                      int words_per_feature,
+                                      int* class_counts) {
+  const uint32x4_t class_mask = vdupq_n_u32(CLASS_PRUNER_CLASS_MASK);
+  for (int w = 0; w < words_per_feature; w += kNEONLanes) {
+    uint32x4_t sums[CLASSES_PER_CP_WERD];
+    for (int k = 0; k < CLASSES_PER_CP_WERD; ++k)
+      sums[k] = vdupq_n_u32(0);
+    const uinT32* word_ptr = words + w;
+    for (int f = 0; f < num_features; ++f, word_ptr += words_per_feature) {
+      uint32x4_t pruner_words = vld1q_u32(word_ptr);
+      for (int k = 0; k < CLASSES_PER_CP_WERD; ++k) {
+        sums[k] = vaddq_u32(sums[k], vandq_u32(pruner_words, class_mask));
+        pruner_words = vshrq_n_u32(pruner_words, NUM_BITS_PER_CLASS);
+      }
+    }
+    uinT32 lane_sums[CLASSES_PER_CP_WERD][kNEONLanes];
+    for (int k = 0; k < CLASSES_PER_CP_WERD; ++k)
+      vst1q_u32(lane_sums[k], sums[k]);
+    int* counts = class_counts + w * CLASSES_PER_CP_WERD;
+    for (int lane = 0; lane < kNEONLanes; ++lane) {
+      for (int k = 0; k < CLASSES_PER_CP_WERD; ++k)
+        *counts++ += static_cast<int>(lane_sums[k][lane]);
+    }
+  }
+}
+
+// Number of protos processed per iteration of the NEON evidence kernel.
+const int kNEONProtoGroup = 4;
+
+// NEON evidence kernel. A direct translation of ComputeProtoEvidence on 4
+// protos at a time. The final table lookup is scalar.
+static void ComputeEvidenceNEON(const EvidenceKernelParams& params,
+                                int num_protos, const inT16* a,
+                                const inT16* b, const inT16* c,
+                                const inT16* angle, uinT8* evidence) {
+  const int32_t x_offset = (params.feature_x - 128) << 1;
+  const int32_t y_offset = params.feature_y - 128;
+  const int32x4_t theta = vdupq_n_s32(params.feature_theta);
+  // Negative shift counts shift right with vshlq.
+  const int32x4_t mult_shift = vdupq_n_s32(-params.mult_trunc_shift_bits);
+  const int32x4_t mult_mask = vdupq_n_s32(params.evidence_mult_mask);
+  const int32x4_t table_shift = vdupq_n_s32(-params.table_trunc_shift_bits);
+  const uinT32 table_mask = params.evidence_table_mask;
+  const uinT8* table = params.similarity_evidence_table;
+  int p = 0;
+  for (; p + kNEONProtoGroup <= num_protos; p += kNEONProtoGroup) {
+    int32x4_t a3 = vmulq_n_s32(vmovl_s16(vld1_s16(a + p)), x_offset);
+    a3 = vmlsq_n_s32(a3, vmovl_s16(vld1_s16(b + p)), y_offset);
+    a3 = vaddq_s32(a3, vshlq_n_s32(vmovl_s16(vld1_s16(c + p)), 9));
+    // Sign-extend the low byte of the angle difference, as the inT8 cast.
+    int32x4_t diff = vsubq_s32(theta, vmovl_s16(vld1_s16(angle + p)));
+    diff = vshrq_n_s32(vshlq_n_s32(diff, 24), 24);
+    int32x4_t m3 = vshlq_n_s32(vmulq_n_s32(diff, params.theta_fudge), 1);
+    // x ^ (x >> 31) is ~x for negative x and x otherwise.
+    a3 = veorq_s32(a3, vshrq_n_s32(a3, 31));
+    m3 = veorq_s32(m3, vshrq_n_s32(m3, 31));
+    a3 = vminq_s32(vshlq_s32(a3, mult_shift), mult_mask);
+    m3 = vminq_s32(vshlq_s32(m3, mult_shift), mult_mask);
+    uint32x4_t a4 = vreinterpretq_u32_s32(
+        vmlaq_s32(vmulq_s32(a3, a3), m3, m3));
+    a4 = vshlq_u32(a4, table_shift);
+    uinT32 indices[kNEONProtoGroup];
+    vst1q_u32(indices, a4);
+    for (int i = 0; i < kNEONProtoGroup; ++i) {
+      evidence[p + i] = indices[i] > table_mask ? 0 : table[indices[i]];
+    }
+  }
+  for (; p < num_protos; ++p)
+    evidence[p] = ComputeProtoEvidence(params, a[p], b[p], c[p], angle[p]);
+}
+
+// Bit i % 8 of byte i, to expand config words to byte masks.
+static const uinT8 kConfigBitSelect[16] = {
+  1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+};
+
+// Row indices of the entries of a proto evidence row.
+static const uinT8 kRowIndices[16] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+// Inserts evidence into row, a descending list of the highest evidences of
+// a proto in its first length entries, as the SSE2 kernel does: entry i of
+// the result is max(row[i], min(row[i - 1], evidence)), taking row[-1] as
+// 255. The row is covered by two overlapping registers, of the first and
+// last 16 of its MAX_PROTO_INDEX entries.
+static inline void InsertProtoEvidenceNEON(uint8x16_t evidence,
+                                           uint8x16_t length, uinT8* row) {
+  const int kHiOffset = MAX_PROTO_INDEX - 16;
+  const uint8x16_t index_lo = vld1q_u8(kRowIndices);
+  const uint8x16_t index_hi = vaddq_u8(index_lo, vdupq_n_u8(kHiOffset));
+  uint8x16_t lo = vld1q_u8(row);
+  uint8x16_t hi = vld1q_u8(row + kHiOffset);
+  uint8x16_t prev_lo = vextq_u8(vdupq_n_u8(0xff), lo, 15);
+  uint8x16_t prev_hi = vld1q_u8(row + kHiOffset - 1);
+  uint8x16_t new_lo = vmaxq_u8(lo, vminq_u8(prev_lo, evidence));
+  uint8x16_t new_hi = vmaxq_u8(hi, vminq_u8(prev_hi, evidence));
+  // Entries past the length are left as they are.
+  new_lo = vbslq_u8(vcltq_u8(index_lo, length), new_lo, lo);
+  new_hi = vbslq_u8(vcltq_u8(index_hi, length), new_hi, hi);
+  // Both were computed from the original row, so they agree where they
+  // overlap.
+  vst1q_u8(row + kHiOffset, new_hi);
+  vst1q_u8(row, new_lo);
+}
+
+// NEON evidence update kernel. As the SSE2 kernel, the evidence of the
+// first 32 configs is kept in two registers over all the protos.
+static void UpdateEvidenceNEON(int num_protos, const uinT16* proto_ids,
+                               const uinT32* config_words,
+                               const uinT8* proto_lengths,
+                               const uinT8* evidence,
+                               uinT8* feature_evidence,
+                               uinT8* proto_evidence) {
+  const uint8x16_t bit_select = vld1q_u8(kConfigBitSelect);
+  uint8x16_t configs_lo = vld1q_u8(feature_evidence);
+  uint8x16_t configs_hi = vld1q_u8(feature_evidence + 16);
+  for (int p = 0; p < num_protos; ++p) {
+    // Zero evidence changes nothing.
+    if (evidence[p] == 0)
+      continue;
+    uint8x16_t proto_evidence_bytes = vdupq_n_u8(evidence[p]);
+    uinT32 config_word = config_words[p];
+    uint8x16_t bytes_lo = vcombine_u8(vdup_n_u8(config_word & 0xff),
+                                      vdup_n_u8((config_word >> 8) & 0xff));
+    uint8x16_t bytes_hi = vcombine_u8(vdup_n_u8((config_word >> 16) & 0xff),
+                                      vdup_n_u8(config_word >> 24));
+    uint8x16_t mask_lo = vtstq_u8(bytes_lo, bit_select);
+    uint8x16_t mask_hi = vtstq_u8(bytes_hi, bit_select);
+    configs_lo = vmaxq_u8(configs_lo, vandq_u8(mask_lo, proto_evidence_bytes));
+    configs_hi = vmaxq_u8(configs_hi, vandq_u8(mask_hi, proto_evidence_bytes));
+    InsertProtoEvidenceNEON(proto_evidence_bytes,
+                            vdupq_n_u8(proto_lengths[p]),
+                            proto_evidence + proto_ids[p] * MAX_PROTO_INDEX);
+  }
+  vst1q_u8(feature_evidence, configs_lo);
+  vst1q_u8(feature_evidence + 16, configs_hi);
+}
+#endif  // NEON_KERNELS_AVAILABLE
+
+ClassPrunerKernel ClassPrunerKernelNEON() {
+#ifdef NEON_KERNELS_AVAILABLE
+  return ClassPrunerAccumulateNEON;
+#else
+  return NULL;
+#endif
+}
+
+EvidenceKernel EvidenceKernelNEON() {
+#ifdef NEON_KERNELS_AVAILABLE
+  return ComputeEvidenceNEON;
+#else
+  return NULL;
+#endif
+}
+
+EvidenceUpdateKernel EvidenceUpdateKernelNEON() {
+  // The proto evidence rows must fit in two overlapping registers.
+#if defined(NEON_KERNELS_AVAILABLE) && MAX_PROTO_INDEX >= 16 && \
+    MAX_PROTO_INDEX <= 32
+  return UpdateEvidenceNEON;
+#else
+  return NULL;
+#endif
+}
+
+}  // namespace tesseract.
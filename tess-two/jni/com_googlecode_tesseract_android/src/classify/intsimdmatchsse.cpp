@@ -0,0 +1,408 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intsimdmatchsse.cpp
+// Description: SSE2 and AVX2 kernels for the integer matcher and class
+//              pruner.
+// Created:     Fri Oct 16 10:12:41 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "intsimdmatch.h"
+#include "intproto.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SSE2_KERNELS_AVAILABLE
+#endif
+
+// The AVX2 kernels are compiled with a function target attribute, so the
+// rest of the library doesn't need -mavx2. This needs a compiler that
+// declares the AVX2 intrinsics regardless of the command-line target.
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__AVX2__) || (defined(__clang__) && \
+    (__clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 8))) || \
+    (!defined(__clang__) && defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#include <immintrin.h>
+#define AVX2_KERNELS_AVAILABLE
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace tesseract {
+
+#ifdef SSE2_KERNELS_AVAILABLE
+// Number of pruner words processed in parallel by the SSE2 kernel.
+const int kSSE2Lanes = 4;
+
+// SSE2 class pruner kernel. Each lane of a register accumulates one pruner
+// word, so sums[k] holds the count of class k of each of kSSE2Lanes
+// consecutive words. The sums are transposed back to class order at the end.
+static void ClassPrunerAccumulateSSE2(const uinT32* words, int num_features,
+                                      int words_per_feature,
+                                      int* class_counts) {
+  const __m128i class_mask = _mm_set1_epi32(CLASS_PRUNER_CLASS_MASK);
+  for (int w = 0; w < words_per_feature; w += kSSE2Lanes) {
+    __m128i sums[CLASSES_PER_CP_WERD];
+    for (int k = 0; k < CLASSES_PER_CP_WERD; ++k)
+      sums[k] = _mm_setzero_si128();
+    const uinT32* word_ptr = words + w;
+    for (int f = 0; f < num_features; ++f, word_ptr += words_per_feature) {
+      __m128i pruner_words =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(word_ptr));
+      for (int k = 0; k < CLASSES_PER_CP_WERD; ++k) {
+        sums[k] = _mm_add_epi32(sums[k],
+                                _mm_and_si128(pruner_words, class_mask));
+        pruner_words = _mm_srli_epi32(pruner_words, NUM_BITS_PER_CLASS);
+      }
+    }
+    int lane_sums[CLASSES_PER_CP_WERD][kSSE2Lanes];
+    for (int k = 0; k < CLASSES_PER_CP_WERD; ++k) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(lane_sums[k]), sums[k]);
+    }
+    int* counts = class_counts + w * CLASSES_PER_CP_WERD;
+    for (int lane = 0; lane < kSSE2Lanes; ++lane) {
+      for (int k = 0; k < CLASSES_PER_CP_WERD; ++k)
+        *counts++ += lane_sums[k][lane];
+    }
+  }
+}
+
+// Returns the lane-wise minimum of a and b. SSE2 has no _mm_min_epi32.
+static inline __m128i MinEpi32SSE2(__m128i a, __m128i b) {
+  __m128i a_greater = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(a_greater, b),
+                      _mm_andnot_si128(a_greater, a));
+}
+
+// Given the distance a3 and angle mismatch m3 of 4 protos, returns the
+// truncated squared distance that indexes the similarity_evidence_table,
+// as in ComputeProtoEvidence. a3 and m3 are clipped to evidence_mult_mask,
+// which fits in 15 bits, so they can be packed into 16 bit pairs and
+// squared and summed with a single _mm_madd_epi16.
+static inline __m128i TableIndexSSE2(__m128i a3, __m128i m3,
+                                     __m128i mult_shift, __m128i mult_mask,
+                                     __m128i table_shift) {
+  // x ^ (x >> 31) is ~x for negative x and x otherwise.
+  a3 = _mm_xor_si128(a3, _mm_srai_epi32(a3, 31));
+  m3 = _mm_xor_si128(m3, _mm_srai_epi32(m3, 31));
+  a3 = MinEpi32SSE2(_mm_sra_epi32(a3, mult_shift), mult_mask);
+  m3 = MinEpi32SSE2(_mm_sra_epi32(m3, mult_shift), mult_mask);
+  __m128i pairs = _mm_or_si128(a3, _mm_slli_epi32(m3, 16));
+  return _mm_srl_epi32(_mm_madd_epi16(pairs, pairs), table_shift);
+}
+
+// Number of protos processed per iteration of the SSE2 evidence kernel.
+const int kSSE2ProtoGroup = 8;
+
+// SSE2 evidence kernel. All the products fit in 16 bits, so the distance is
+// computed with _mm_madd_epi16 on interleaved (A, B) pairs. The final table
+// lookup is scalar.
+static void ComputeEvidenceSSE2(const EvidenceKernelParams& params,
+                                int num_protos, const inT16* a,
+                                const inT16* b, const inT16* c,
+                                const inT16* angle, uinT8* evidence) {
+  if (params.evidence_mult_mask > MAX_INT16 || params.theta_fudge > 255 ||
+      params.theta_fudge < 0) {
+    // The 16 bit packing below would not be exact.
+    ComputeEvidenceScalar(params, num_protos, a, b, c, angle, evidence);
+    return;
+  }
+  // Multipliers of (A, B) for the distance, as 16 bit pairs.
+  const __m128i xy = _mm_set1_epi32(
+      static_cast<uinT16>((params.feature_x - 128) << 1) |
+      (static_cast<uinT16>(128 - params.feature_y) << 16));
+  const __m128i theta = _mm_set1_epi16(params.feature_theta);
+  const __m128i theta_fudge = _mm_set1_epi16(params.theta_fudge);
+  const __m128i mult_shift = _mm_cvtsi32_si128(params.mult_trunc_shift_bits);
+  const __m128i mult_mask = _mm_set1_epi32(params.evidence_mult_mask);
+  const __m128i table_shift = _mm_cvtsi32_si128(params.table_trunc_shift_bits);
+  const uinT32 table_mask = params.evidence_table_mask;
+  const uinT8* table = params.similarity_evidence_table;
+  int p = 0;
+  for (; p + kSSE2ProtoGroup <= num_protos; p += kSSE2ProtoGroup) {
+    __m128i a16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + p));
+    __m128i b16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + p));
+    __m128i c16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + p));
+    __m128i angle16 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(angle + p));
+    // M3 before the final doubling: the inT8 angle difference times the
+    // fudge, which fits in 16 bits.
+    __m128i diff16 = _mm_sub_epi16(theta, angle16);
+    diff16 = _mm_srai_epi16(_mm_slli_epi16(diff16, 8), 8);
+    diff16 = _mm_mullo_epi16(diff16, theta_fudge);
+    // Sign-extend to 32 bits by unpacking each value with itself.
+    __m128i m3_lo =
+        _mm_slli_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(diff16, diff16), 16),
+                       1);
+    __m128i m3_hi =
+        _mm_slli_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(diff16, diff16), 16),
+                       1);
+    __m128i c_lo = _mm_srai_epi32(_mm_unpacklo_epi16(c16, c16), 16);
+    __m128i c_hi = _mm_srai_epi32(_mm_unpackhi_epi16(c16, c16), 16);
+    __m128i a3_lo = _mm_add_epi32(
+        _mm_madd_epi16(_mm_unpacklo_epi16(a16, b16), xy),
+        _mm_slli_epi32(c_lo, 9));
+    __m128i a3_hi = _mm_add_epi32(
+        _mm_madd_epi16(_mm_unpackhi_epi16(a16, b16), xy),
+        _mm_slli_epi32(c_hi, 9));
+    uinT32 indices[kSSE2ProtoGroup];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices),
+                     TableIndexSSE2(a3_lo, m3_lo, mult_shift, mult_mask,
+                                    table_shift));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices + 4),
+                     TableIndexSSE2(a3_hi, m3_hi, mult_shift, mult_mask,
+                                    table_shift));
+    for (int i = 0; i < kSSE2ProtoGroup; ++i) {
+      evidence[p + i] = indices[i] > table_mask ? 0 : table[indices[i]];
+    }
+  }
+  for (; p < num_protos; ++p)
+    evidence[p] = ComputeProtoEvidence(params, a[p], b[p], c[p], angle[p]);
+}
+
+// Expands the 32 config bits of config_word to byte masks, 0xff for each set
+// bit, in lo for configs [0, 16) and in hi for configs [16, 32).
+static inline void ExpandConfigBitsSSE2(uinT32 config_word, __m128i* lo,
+                                        __m128i* hi) {
+  const __m128i bit_select = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1,
+                                          -128, 64, 32, 16, 8, 4, 2, 1);
+  // Repeat each byte of config_word 8 times.
+  __m128i bytes = _mm_cvtsi32_si128(config_word);
+  bytes = _mm_unpacklo_epi8(bytes, bytes);
+  bytes = _mm_unpacklo_epi16(bytes, bytes);
+  *lo = _mm_and_si128(_mm_unpacklo_epi32(bytes, bytes), bit_select);
+  *hi = _mm_and_si128(_mm_unpackhi_epi32(bytes, bytes), bit_select);
+  *lo = _mm_cmpeq_epi8(*lo, bit_select);
+  *hi = _mm_cmpeq_epi8(*hi, bit_select);
+}
+
+// Inserts evidence into row, a descending list of the highest evidences of
+// a proto in its first length entries, as the scalar loop in
+// UpdateTablesForFeature. As the row is sorted, entry i of the result is
+// max(row[i], min(row[i - 1], evidence)), taking row[-1] as 255, so no
+// search is needed. The row is covered by two overlapping registers, of the
+// first and last 16 of its MAX_PROTO_INDEX entries.
+static inline void InsertProtoEvidenceSSE2(__m128i evidence, __m128i length,
+                                           uinT8* row) {
+  const int kHiOffset = MAX_PROTO_INDEX - 16;
+  const __m128i index_lo = _mm_set_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                        7, 6, 5, 4, 3, 2, 1, 0);
+  const __m128i index_hi = _mm_add_epi8(index_lo, _mm_set1_epi8(kHiOffset));
+  __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+  __m128i hi =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + kHiOffset));
+  __m128i prev_lo = _mm_or_si128(_mm_slli_si128(lo, 1),
+                                 _mm_cvtsi32_si128(0xff));
+  __m128i prev_hi =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + kHiOffset - 1));
+  __m128i new_lo = _mm_max_epu8(lo, _mm_min_epu8(prev_lo, evidence));
+  __m128i new_hi = _mm_max_epu8(hi, _mm_min_epu8(prev_hi, evidence));
+  // Entries past the length are left as they are.
+  __m128i in_lo = _mm_cmplt_epi8(index_lo, length);
+  __m128i in_hi = _mm_cmplt_epi8(index_hi, length);
+  new_lo = _mm_or_si128(_mm_and_si128(in_lo, new_lo),
+                        _mm_andnot_si128(in_lo, lo));
+  new_hi = _mm_or_si128(_mm_and_si128(in_hi, new_hi),
+                        _mm_andnot_si128(in_hi, hi));
+  // Both were computed from the original row, so they agree where they
+  // overlap.
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(row + kHiOffset), new_hi);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(row), new_lo);
+}
+
+// SSE2 evidence update kernel. The evidence of the first 32 configs is kept
+// in two registers over all the protos, and updated with byte maximums of
+// the proto evidence under the config masks.
+static void UpdateEvidenceSSE2(int num_protos, const uinT16* proto_ids,
+                               const uinT32* config_words,
+                               const uinT8* proto_lengths,
+                               const uinT8* evidence,
+                               uinT8* feature_evidence,
+                               uinT8* proto_evidence) {
+  __m128i configs_lo =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(feature_evidence));
+  __m128i configs_hi =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(feature_evidence + 16));
+  for (int p = 0; p < num_protos; ++p) {
+    // Zero evidence changes nothing.
+    if (evidence[p] == 0)
+      continue;
+    __m128i proto_evidence_bytes = _mm_set1_epi8(evidence[p]);
+    __m128i mask_lo, mask_hi;
+    ExpandConfigBitsSSE2(config_words[p], &mask_lo, &mask_hi);
+    configs_lo = _mm_max_epu8(configs_lo,
+                              _mm_and_si128(mask_lo, proto_evidence_bytes));
+    configs_hi = _mm_max_epu8(configs_hi,
+                              _mm_and_si128(mask_hi, proto_evidence_bytes));
+    InsertProtoEvidenceSSE2(proto_evidence_bytes,
+                            _mm_set1_epi8(proto_lengths[p]),
+                            proto_evidence + proto_ids[p] * MAX_PROTO_INDEX);
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(feature_evidence), configs_lo);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(feature_evidence + 16),
+                   configs_hi);
+}
+#endif  // SSE2_KERNELS_AVAILABLE
+
+#ifdef AVX2_KERNELS_AVAILABLE
+// Number of pruner words processed in parallel by the AVX2 kernel.
+const int kAVX2Lanes = 8;
+
+// AVX2 class pruner kernel. As the SSE2 kernel, but with twice the lanes.
+AVX2_TARGET
+static void ClassPrunerAccumulateAVX2(const uinT32* words, int num_features,
+                                      int words_per_feature,
+                                      int* class_counts) {
+  const __m256i class_mask = _mm256_set1_epi32(CLASS_PRUNER_CLASS_MASK);
+  for (int w = 0; w < words_per_feature; w += kAVX2Lanes) {
+    __m256i sums[CLASSES_PER_CP_WERD];
+    for (int k = 0; k < CLASSES_PER_CP_WERD; ++k)
+      sums[k] = _mm256_setzero_si256();
+    const uinT32* word_ptr = words + w;
+    for (int f = 0; f < num_features; ++f, word_ptr += words_per_feature) {
+      __m256i pruner_words =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(word_ptr));
+      for (int k = 0; k < CLASSES_PER_CP_WERD; ++k) {
+        sums[k] = _mm256_add_epi32(sums[k],
+                                   _mm256_and_si256(pruner_words, class_mask));
+        pruner_words = _mm256_srli_epi32(pruner_words, NUM_BITS_PER_CLASS);
+      }
+    }
+    int lane_sums[CLASSES_PER_CP_WERD][kAVX2Lanes];
+    for (int k = 0; k < CLASSES_PER_CP_WERD; ++k) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lane_sums[k]), sums[k]);
+    }
+    int* counts = class_counts + w * CLASSES_PER_CP_WERD;
+    for (int lane = 0; lane < kAVX2Lanes; ++lane) {
+      for (int k = 0; k < CLASSES_PER_CP_WERD; ++k)
+        *counts++ += lane_sums[k][lane];
+    }
+  }
+  // The callers are not compiled for AVX, so avoid the penalty of their SSE
+  // code running with the upper halves of the registers in use.
+  _mm256_zeroupper();
+}
+
+// Number of protos processed per iteration of the AVX2 evidence kernel.
+const int kAVX2ProtoGroup = 8;
+
+// Loads 8 inT16 values and sign-extends them to 32 bits.
+AVX2_TARGET
+static inline __m256i LoadEpi16AsEpi32(const inT16* src) {
+  return _mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+}
+
+// AVX2 evidence kernel. With 32 bit multiplies and minimums available, this
+// is a direct translation of ComputeProtoEvidence on 8 protos at a time.
+// The evidence of the 8 protos is gathered from the table at once.
+AVX2_TARGET
+static void ComputeEvidenceAVX2(const EvidenceKernelParams& params,
+                                int num_protos, const inT16* a,
+                                const inT16* b, const inT16* c,
+                                const inT16* angle, uinT8* evidence) {
+  const __m256i x_offset = _mm256_set1_epi32(params.feature_x - 128);
+  const __m256i y_offset = _mm256_set1_epi32(params.feature_y - 128);
+  const __m256i theta = _mm256_set1_epi32(params.feature_theta);
+  const __m256i theta_fudge = _mm256_set1_epi32(params.theta_fudge);
+  const __m128i mult_shift = _mm_cvtsi32_si128(params.mult_trunc_shift_bits);
+  const __m256i mult_mask = _mm256_set1_epi32(params.evidence_mult_mask);
+  const __m128i table_shift = _mm_cvtsi32_si128(params.table_trunc_shift_bits);
+  const __m256i table_mask = _mm256_set1_epi32(params.evidence_table_mask);
+  const __m256i byte_mask = _mm256_set1_epi32(0xff);
+  const int* table =
+      reinterpret_cast<const int*>(params.similarity_evidence_table);
+  int p = 0;
+  for (; p + kAVX2ProtoGroup <= num_protos; p += kAVX2ProtoGroup) {
+    __m256i a3 = _mm256_slli_epi32(
+        _mm256_mullo_epi32(LoadEpi16AsEpi32(a + p), x_offset), 1);
+    a3 = _mm256_sub_epi32(a3,
+                          _mm256_mullo_epi32(LoadEpi16AsEpi32(b + p), y_offset));
+    a3 = _mm256_add_epi32(a3, _mm256_slli_epi32(LoadEpi16AsEpi32(c + p), 9));
+    // Sign-extend the low byte of the angle difference, as the inT8 cast.
+    __m256i diff = _mm256_sub_epi32(theta, LoadEpi16AsEpi32(angle + p));
+    diff = _mm256_srai_epi32(_mm256_slli_epi32(diff, 24), 24);
+    __m256i m3 = _mm256_slli_epi32(_mm256_mullo_epi32(diff, theta_fudge), 1);
+    // x ^ (x >> 31) is ~x for negative x and x otherwise.
+    a3 = _mm256_xor_si256(a3, _mm256_srai_epi32(a3, 31));
+    m3 = _mm256_xor_si256(m3, _mm256_srai_epi32(m3, 31));
+    a3 = _mm256_min_epi32(_mm256_sra_epi32(a3, mult_shift), mult_mask);
+    m3 = _mm256_min_epi32(_mm256_sra_epi32(m3, mult_shift), mult_mask);
+    __m256i a4 = _mm256_add_epi32(_mm256_mullo_epi32(a3, a3),
+                                  _mm256_mullo_epi32(m3, m3));
+    a4 = _mm256_srl_epi32(a4, table_shift);
+    // Read 4 table bytes at each index and keep the first. The table is
+    // padded, so the reads stay inside it. Indices past the table mask are
+    // not read, and get no evidence. a4 is under 2^30, so the signed
+    // comparison is exact.
+    __m256i in_table = _mm256_xor_si256(_mm256_cmpgt_epi32(a4, table_mask),
+                                        _mm256_set1_epi32(-1));
+    __m256i entries = _mm256_mask_i32gather_epi32(
+        _mm256_setzero_si256(), table, a4, in_table, 1);
+    entries = _mm256_and_si256(entries, byte_mask);
+    // Narrow the 8 entries to bytes.
+    __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(entries),
+                                     _mm256_extracti128_si256(entries, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(evidence + p),
+                     _mm_packus_epi16(words, words));
+  }
+  // As in ClassPrunerAccumulateAVX2.
+  _mm256_zeroupper();
+  for (; p < num_protos; ++p)
+    evidence[p] = ComputeProtoEvidence(params, a[p], b[p], c[p], angle[p]);
+}
+#endif  // AVX2_KERNELS_AVAILABLE
+
+ClassPrunerKernel ClassPrunerKernelSSE2() {
+#ifdef SSE2_KERNELS_AVAILABLE
+  return ClassPrunerAccumulateSSE2;
+#else
+  return NULL;
+#endif
+}
+
+ClassPrunerKernel ClassPrunerKernelAVX2() {
+#ifdef AVX2_KERNELS_AVAILABLE
+  return ClassPrunerAccumulateAVX2;
+#else
+  return NULL;
+#endif
+}
+
+EvidenceKernel EvidenceKernelSSE2() {
+#ifdef SSE2_KERNELS_AVAILABLE
+  return ComputeEvidenceSSE2;
+#else
+  return NULL;
+#endif
+}
+
+EvidenceKernel EvidenceKernelAVX2() {
+#ifdef AVX2_KERNELS_AVAILABLE
+  return ComputeEvidenceAVX2;
+#else
+  return NULL;
+#endif
+}
+
+EvidenceUpdateKernel EvidenceUpdateKernelSSE2() {
+  // The proto evidence rows must fit in two overlapping registers.
+#if defined(SSE2_KERNELS_AVAILABLE) && MAX_PROTO_INDEX >= 16 && \
+    MAX_PROTO_INDEX <= 32
+  return UpdateEvidenceSSE2;
+#else
+  return NULL;
+#endif
+}
+
+}  // namespace tesseract.
@@ -101,9 +101,11 @@ bool MasterTrainer::DeSerialize(bool swap, FILE* fp) {
   if (!verify_samples_.DeSerialize(swap, fp)) return false;
   if (!master_shapes_.DeSerialize(swap, fp)) return false;
   if (!flat_shapes_.DeSerialize(swap, fp)) return false;
-  if (!fontinfo_table_.read(fp, NewPermanentTessCallback(read_info), swap))
+  TFile file;
+  file.Open(fp, -1);
+  if (!fontinfo_table_.read(&file, NewPermanentTessCallback(read_info), swap))
     return false;
-  if (!fontinfo_table_.read(fp, NewPermanentTessCallback(read_spacing_info),
+  if (!fontinfo_table_.read(&file, NewPermanentTessCallback(read_spacing_info),
                             swap))
     return false;
   if (!xheights_.DeSerialize(swap, fp)) return false;
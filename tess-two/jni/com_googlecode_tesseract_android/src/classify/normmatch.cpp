@@ -227,7 +227,7 @@ void PrintNormMatch(FILE *File,
 
 /*---------------------------------------------------------------------------*/
 namespace tesseract {
-NORM_PROTOS *Classify::ReadNormProtos(FILE *File, inT64 end_offset) {
+NORM_PROTOS *Classify::ReadNormProtos(TFile *File) {
 /*
  **	Parameters:
  **		File	open text file to read normalization protos from
@@ -242,6 +242,7 @@ NORM_PROTOS *Classify::ReadNormProtos(FILE *File, inT64 end_offset) {
   NORM_PROTOS *NormProtos;
   int i;
   char unichar[2 * UNICHAR_LEN + 1];
+  char count[32];
   UNICHAR_ID unichar_id;
   LIST Protos;
   int NumProtos;
@@ -258,8 +259,9 @@ NORM_PROTOS *Classify::ReadNormProtos(FILE *File, inT64 end_offset) {
   NormProtos->ParamDesc = ReadParamDesc (File, NormProtos->NumParams);
 
   /* read protos for each class into a separate list */
-  while ((end_offset < 0 || ftell(File) < end_offset) &&
-         fscanf(File, "%s %d", unichar, &NumProtos) == 2) {
+  while (ReadToken(File, unichar, sizeof(unichar)) &&
+         ReadToken(File, count, sizeof(count)) &&
+         sscanf(count, "%d", &NumProtos) == 1) {
     if (unicharset.contains_unichar(unichar)) {
       unichar_id = unicharset.unichar_to_id(unichar);
       Protos = NormProtos->Protos[unichar_id];
@@ -273,7 +275,6 @@ NORM_PROTOS *Classify::ReadNormProtos(FILE *File, inT64 end_offset) {
       for (i = 0; i < NumProtos; i++)
         FreePrototype(ReadPrototype (File, NormProtos->NumParams));
     }
-    SkipNewline(File);
   }
   return (NormProtos);
 }                                /* ReadNormProtos */
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////
+// File:        resultcache.cpp
+// Description: LRU cache of adaptive classifier results.
+// Created:     Fri Oct 16 22:08:26 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "resultcache.h"
+
+#include <string.h>
+#include "tprintf.h"
+
+namespace tesseract {
+
+// Initial number of hash buckets. The number is doubled whenever there are
+// more entries than buckets.
+const int kInitialCacheBuckets = 256;
+
+ClassifierResultCache::ClassifierResultCache()
+  : max_bytes_(0), num_bytes_(0), num_entries_(0),
+    head_(NULL), tail_(NULL), hits_(0), misses_(0) {
+}
+
+ClassifierResultCache::~ClassifierResultCache() {
+  Clear();
+}
+
+void ClassifierResultCache::set_max_bytes(int max_bytes) {
+  max_bytes_ = max_bytes;
+  while (tail_ != NULL && num_bytes_ > max_bytes_)
+    Evict(tail_);
+}
+
+void ClassifierResultCache::Clear() {
+  while (tail_ != NULL)
+    Evict(tail_);
+  buckets_.clear();
+}
+
+const GenericVector<ScoredClass>* ClassifierResultCache::Lookup(
+    const GenericVector<inT32>& key, inT32* blob_length) {
+  if (buckets_.empty()) {
+    ++misses_;
+    return NULL;
+  }
+  uinT32 hash = HashKey(key);
+  Entry* entry = buckets_[hash & (buckets_.size() - 1)];
+  for (; entry != NULL; entry = entry->chain) {
+    if (entry->hash == hash && entry->key.size() == key.size() &&
+        memcmp(&entry->key[0], &key[0], key.size() * sizeof(key[0])) == 0)
+      break;
+  }
+  if (entry == NULL) {
+    ++misses_;
+    return NULL;
+  }
+  ++hits_;
+  if (entry != head_) {
+    Unlink(entry);
+    LinkAtFront(entry);
+  }
+  *blob_length = entry->blob_length;
+  return &entry->matches;
+}
+
+void ClassifierResultCache::Insert(const GenericVector<inT32>& key,
+                                   inT32 blob_length,
+                                   const ScoredClass* matches,
+                                   int num_matches) {
+  if (key.empty())
+    return;
+  int size = sizeof(Entry) + key.size() * sizeof(key[0]) +
+      num_matches * sizeof(matches[0]);
+  if (size > max_bytes_)
+    return;
+  while (tail_ != NULL && num_bytes_ + size > max_bytes_)
+    Evict(tail_);
+  if (buckets_.empty())
+    buckets_.init_to_size(kInitialCacheBuckets, NULL);
+  else if (num_entries_ >= buckets_.size())
+    GrowBuckets();
+
+  Entry* entry = new Entry;
+  entry->hash = HashKey(key);
+  entry->key = key;
+  entry->blob_length = blob_length;
+  entry->matches.reserve(num_matches);
+  for (int i = 0; i < num_matches; ++i)
+    entry->matches.push_back(matches[i]);
+  entry->size = size;
+  Entry** bucket = &buckets_[entry->hash & (buckets_.size() - 1)];
+  entry->chain = *bucket;
+  *bucket = entry;
+  LinkAtFront(entry);
+  num_bytes_ += size;
+  ++num_entries_;
+}
+
+void ClassifierResultCache::PrintStats() const {
+  int lookups = hits_ + misses_;
+  tprintf("Classifier result cache: %d hits, %d misses (%.1f%% hit rate),"
+          " %d entries, %d bytes\n",
+          hits_, misses_, lookups > 0 ? 100.0 * hits_ / lookups : 0.0,
+          num_entries_, num_bytes_);
+}
+
+// FNV-1a over the words of the key.
+uinT32 ClassifierResultCache::HashKey(const GenericVector<inT32>& key) {
+  uinT32 hash = 2166136261u;
+  for (int i = 0; i < key.size(); ++i) {
+    hash ^= static_cast<uinT32>(key[i]);
+    hash *= 16777619u;
+  }
+  return hash ^ (hash >> 16);
+}
+
+void ClassifierResultCache::Evict(Entry* entry) {
+  Unlink(entry);
+  Entry** link = &buckets_[entry->hash & (buckets_.size() - 1)];
+  while (*link != entry)
+    link = &(*link)->chain;
+  *link = entry->chain;
+  num_bytes_ -= entry->size;
+  --num_entries_;
+  delete entry;
+}
+
+void ClassifierResultCache::LinkAtFront(Entry* entry) {
+  entry->prev = NULL;
+  entry->next = head_;
+  if (head_ != NULL)
+    head_->prev = entry;
+  else
+    tail_ = entry;
+  head_ = entry;
+}
+
+void ClassifierResultCache::Unlink(Entry* entry) {
+  if (entry->prev != NULL)
+    entry->prev->next = entry->next;
+  else
+    head_ = entry->next;
+  if (entry->next != NULL)
+    entry->next->prev = entry->prev;
+  else
+    tail_ = entry->prev;
+}
+
+void ClassifierResultCache::GrowBuckets() {
+  GenericVector<Entry*> buckets;
+  buckets.init_to_size(buckets_.size() * 2, NULL);
+  for (Entry* entry = head_; entry != NULL; entry = entry->next) {
+    Entry** bucket = &buckets[entry->hash & (buckets.size() - 1)];
+    entry->chain = *bucket;
+    *bucket = entry;
+  }
+  buckets_ = buckets;
+}
+
+}  // namespace tesseract
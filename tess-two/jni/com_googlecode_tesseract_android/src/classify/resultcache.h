@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////
+// File:        resultcache.h
+// Description: LRU cache of adaptive classifier results.
+// Created:     Fri Oct 16 22:08:26 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_RESULTCACHE_H_
+#define TESSERACT_CLASSIFY_RESULTCACHE_H_
+
+#include "genericvector.h"
+#include "host.h"
+#include "matchdefs.h"
+
+// A class matched by the adaptive matcher, with its rating.
+struct ScoredClass {
+  CLASS_ID unichar_id;
+  int shape_id;
+  FLOAT32 rating;
+  bool adapted;
+  inT16 config;
+  inT16 fontinfo_id;
+  inT16 fontinfo_id2;
+};
+
+namespace tesseract {
+
+// Caches the sorted and pruned matches of Classify::AdaptiveClassifier,
+// keyed by a fingerprint of everything the matchers read from a blob: its
+// normalized features and the state of the adapted templates. Identical
+// glyphs, such as the many copies of each letter on a page of body text,
+// then only go through the class pruner and integer matcher once.
+// The entries are only matches, not BLOB_CHOICEs, as the x-height range of
+// a choice also depends on where the blob is, so the choices are rebuilt
+// from the matches on each hit.
+// The memory held by the entries is bounded, and the least recently used
+// entries are evicted to stay within the bound.
+class ClassifierResultCache {
+ public:
+  ClassifierResultCache();
+  ~ClassifierResultCache();
+
+  // Sets the max number of bytes held by the entries, evicting entries as
+  // needed. A limit of 0 disables the cache.
+  void set_max_bytes(int max_bytes);
+  int max_bytes() const {
+    return max_bytes_;
+  }
+  bool enabled() const {
+    return max_bytes_ > 0;
+  }
+
+  // Deletes all the entries. The hit and miss counts are kept.
+  void Clear();
+  // Zeroes the hit and miss counts.
+  void ResetStats() {
+    hits_ = 0;
+    misses_ = 0;
+  }
+
+  // Returns the cached matches for the given key, making its entry the most
+  // recently used one, or NULL if the key is not cached. On a hit, the blob
+  // length of the cached result is returned in *blob_length.
+  const GenericVector<ScoredClass>* Lookup(const GenericVector<inT32>& key,
+                                           inT32* blob_length);
+  // Caches the given matches under the given key, which must not already be
+  // cached, evicting the least recently used entries to make room.
+  void Insert(const GenericVector<inT32>& key, inT32 blob_length,
+              const ScoredClass* matches, int num_matches);
+
+  // Prints the hit and miss counts and the size of the cache.
+  void PrintStats() const;
+
+ private:
+  struct Entry {
+    uinT32 hash;
+    GenericVector<inT32> key;
+    inT32 blob_length;
+    GenericVector<ScoredClass> matches;
+    // Bytes of memory held by the entry.
+    int size;
+    // Neighbors in the recency list, most recently used first.
+    Entry* prev;
+    Entry* next;
+    // Next entry in the same hash bucket.
+    Entry* chain;
+  };
+
+  static uinT32 HashKey(const GenericVector<inT32>& key);
+  // Unlinks entry from the recency list and its hash bucket, and deletes it.
+  void Evict(Entry* entry);
+  // Links entry at the front of the recency list.
+  void LinkAtFront(Entry* entry);
+  // Unlinks entry from the recency list.
+  void Unlink(Entry* entry);
+  // Doubles the number of hash buckets and rehashes the entries.
+  void GrowBuckets();
+
+  int max_bytes_;
+  int num_bytes_;
+  int num_entries_;
+  // Hash buckets, a power of 2 in number.
+  GenericVector<Entry*> buckets_;
+  // The most and least recently used entries.
+  Entry* head_;
+  Entry* tail_;
+  int hits_;
+  int misses_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CLASSIFY_RESULTCACHE_H_
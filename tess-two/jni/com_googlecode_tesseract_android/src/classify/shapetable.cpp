@@ -38,8 +38,13 @@ bool UnicharAndFonts::Serialize(FILE* fp) {
 // Reads from the given file. Returns false in case of error.
 // If swap is true, assumes a big/little-endian swap is needed.
 bool UnicharAndFonts::DeSerialize(bool swap, FILE* fp) {
+  TFile file;
+  file.Open(fp, -1);
+  return DeSerialize(swap, &file);
+}
+bool UnicharAndFonts::DeSerialize(bool swap, TFile* fp) {
   inT32 uni_id;
-  if (fread(&uni_id, sizeof(uni_id), 1, fp) != 1) return false;
+  if (fp->FRead(&uni_id, sizeof(uni_id), 1) != 1) return false;
   if (swap)
     ReverseN(&uni_id, sizeof(uni_id));
   unichar_id = uni_id;
@@ -64,7 +69,12 @@ bool Shape::Serialize(FILE* fp) {
 // Reads from the given file. Returns false in case of error.
 // If swap is true, assumes a big/little-endian swap is needed.
 bool Shape::DeSerialize(bool swap, FILE* fp) {
-  if (fread(&unichars_sorted_, 1, 1, fp) != 1)
+  TFile file;
+  file.Open(fp, -1);
+  return DeSerialize(swap, &file);
+}
+bool Shape::DeSerialize(bool swap, TFile* fp) {
+  if (fp->FRead(&unichars_sorted_, 1, 1) != 1)
     return false;
   if (!unichars_.DeSerializeClasses(swap, fp)) return false;
   return true;
@@ -186,6 +196,11 @@ bool ShapeTable::Serialize(FILE* fp) const {
 // Reads from the given file. Returns false in case of error.
 // If swap is true, assumes a big/little-endian swap is needed.
 bool ShapeTable::DeSerialize(bool swap, FILE* fp) {
+  TFile file;
+  file.Open(fp, -1);
+  return DeSerialize(swap, &file);
+}
+bool ShapeTable::DeSerialize(bool swap, TFile* fp) {
   if (!shape_table_.DeSerialize(swap, fp)) return false;
   return true;
 }
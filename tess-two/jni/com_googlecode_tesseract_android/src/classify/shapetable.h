@@ -45,6 +45,7 @@ struct UnicharAndFonts {
   // Reads from the given file. Returns false in case of error.
   // If swap is true, assumes a big/little-endian swap is needed.
   bool DeSerialize(bool swap, FILE* fp);
+  bool DeSerialize(bool swap, TFile* fp);
 
   // Sort function to sort a pair of UnicharAndFonts by unichar_id.
   static int SortByUnicharId(const void* v1, const void* v2);
@@ -68,6 +69,7 @@ class Shape {
   // Reads from the given file. Returns false in case of error.
   // If swap is true, assumes a big/little-endian swap is needed.
   bool DeSerialize(bool swap, FILE* fp);
+  bool DeSerialize(bool swap, TFile* fp);
 
   int destination_index() const {
     return destination_index_;
@@ -135,6 +137,7 @@ class ShapeTable {
   // Reads from the given file. Returns false in case of error.
   // If swap is true, assumes a big/little-endian swap is needed.
   bool DeSerialize(bool swap, FILE* fp);
+  bool DeSerialize(bool swap, TFile* fp);
 
   // Accessors.
   int NumShapes() const {
@@ -144,6 +144,8 @@ WordAltList * BeamSearch::Search(SearchObject *srch_obj, LangModel *lang_mod) {
 
     // for all possible start segments
     int init_seg = MAX(0, end_seg - cntxt_->Params()->MaxSegPerChar());
+    // recognize all the segments that end in this column in one batch
+    srch_obj->RecognizeSegments(init_seg - 1, end_seg - 1);
     for (int strt_seg = init_seg; strt_seg < end_seg; strt_seg++) {
       int parent_nodes_cnt;
       SearchNode **parent_nodes;
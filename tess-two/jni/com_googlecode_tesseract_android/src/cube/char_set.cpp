@@ -59,33 +59,28 @@ CharSet *CharSet::Create(TessdataManager *tessdata_manager,
   }
 
   // First look for Cube's unicharset; if not there, use tesseract's
+  TFile charset_fp;
   bool cube_unicharset_exists;
   if (!(cube_unicharset_exists =
-        tessdata_manager->SeekToStart(TESSDATA_CUBE_UNICHARSET)) &&
-      !tessdata_manager->SeekToStart(TESSDATA_UNICHARSET)) {
+        tessdata_manager->GetComponent(TESSDATA_CUBE_UNICHARSET,
+                                       &charset_fp)) &&
+      !tessdata_manager->GetComponent(TESSDATA_UNICHARSET, &charset_fp)) {
     fprintf(stderr, "Cube ERROR (CharSet::Create): could not find "
             "either cube or tesseract unicharset\n");
     return false;
   }
-  FILE *charset_fp = tessdata_manager->GetDataFilePtr();
-  if (!charset_fp) {
-    fprintf(stderr, "Cube ERROR (CharSet::Create): could not load "
-            "a unicharset\n");
-    return false;
-  }
 
   // If we found a cube unicharset separate from tesseract's, load it and
   // map its unichars to tesseract's; if only one unicharset exists,
   // just load it.
   bool loaded;
   if (cube_unicharset_exists) {
-    char_set->cube_unicharset_.load_from_file(charset_fp);
-    loaded = tessdata_manager->SeekToStart(TESSDATA_CUBE_UNICHARSET);
-    loaded = loaded && char_set->LoadSupportedCharList(
-        tessdata_manager->GetDataFilePtr(), tess_unicharset);
+    char_set->cube_unicharset_.load_from_file(&charset_fp, false);
+    charset_fp.Rewind();
+    loaded = char_set->LoadSupportedCharList(&charset_fp, tess_unicharset);
     char_set->unicharset_ = &char_set->cube_unicharset_;
   } else {
-    loaded = char_set->LoadSupportedCharList(charset_fp, NULL);
+    loaded = char_set->LoadSupportedCharList(&charset_fp, NULL);
     char_set->unicharset_ = tess_unicharset;
   }
   if (!loaded) {
@@ -98,7 +93,7 @@ CharSet *CharSet::Create(TessdataManager *tessdata_manager,
 }
 
 // Load the list of supported chars from the given data file pointer.
-bool CharSet::LoadSupportedCharList(FILE *fp, UNICHARSET *tess_unicharset) {
+bool CharSet::LoadSupportedCharList(TFile *fp, UNICHARSET *tess_unicharset) {
   if (init_)
     return true;
 
@@ -106,7 +101,7 @@ bool CharSet::LoadSupportedCharList(FILE *fp, UNICHARSET *tess_unicharset) {
   // init hash table
   memset(hash_bin_size_, 0, sizeof(hash_bin_size_));
   // read the char count
-  if (fgets(str_line, sizeof(str_line), fp) == NULL) {
+  if (fp->FGets(str_line, sizeof(str_line)) == NULL) {
     fprintf(stderr, "Cube ERROR (CharSet::InitMemory): could not "
             "read char count.\n");
     return false;
@@ -137,7 +132,7 @@ bool CharSet::LoadSupportedCharList(FILE *fp, UNICHARSET *tess_unicharset) {
   // Read in character strings and add to hash table
   for (int class_id = 0; class_id < class_cnt_; class_id++) {
     // Read the class string
-    if (fgets(str_line, sizeof(str_line), fp) == NULL) {
+    if (fp->FGets(str_line, sizeof(str_line)) == NULL) {
       fprintf(stderr, "Cube ERROR (CharSet::ReadAndHashStrings): "
               "could not read class string with class_id=%d.\n", class_id);
       return false;
@@ -144,10 +144,10 @@ class CharSet {
     return Hash(b);
   }
 
-  // Load the list of supported chars from the given data file
-  // pointer. If tess_unicharset is non-NULL, mapping each Cube class
+  // Load the list of supported chars from the given unicharset
+  // file. If tess_unicharset is non-NULL, mapping each Cube class
   // id to a tesseract unicharid.
-  bool LoadSupportedCharList(FILE *fp, UNICHARSET *tess_unicharset);
+  bool LoadSupportedCharList(TFile *fp, UNICHARSET *tess_unicharset);
 
   // class count
   int class_cnt_;
@@ -69,6 +69,15 @@ class CharClassifier {
   // pure virtual functions that need to be implemented by any inheriting class
   virtual CharAltList * Classify(CharSamp *char_samp) = 0;
   virtual int CharCost(CharSamp *char_samp) = 0;
+  // Classifies samp_cnt charsamps at once, setting each alt_lists[samp] to
+  // what Classify(char_samps[samp]) would return. Classifiers that can score
+  // several samples in one pass override this loop
+  virtual void ClassifyBatch(CharSamp **char_samps, int samp_cnt,
+                             CharAltList **alt_lists) {
+    for (int samp = 0; samp < samp_cnt; samp++) {
+      alt_lists[samp] = Classify(char_samps[samp]);
+    }
+  }
   virtual bool Train(CharSamp *char_samp, int ClassID) = 0;
   virtual bool SetLearnParam(char *var_name, float val) = 0;
   virtual bool Init(const string &data_file_path, const string &lang,
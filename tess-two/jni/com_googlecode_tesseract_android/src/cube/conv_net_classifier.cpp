@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <vector>
 #include <wctype.h>
@@ -125,18 +126,11 @@ void ConvNetCharClassifier::Fold() {
   }
 }
 
-// Compute the features of specified charsamp and feedforward the
-// specified nets
-bool ConvNetCharClassifier::RunNets(CharSamp *char_samp) {
-  if (char_net_ == NULL) {
-    fprintf(stderr, "Cube ERROR (ConvNetCharClassifier::RunNets): "
-            "NeuralNet is NULL\n");
-    return false;
-  }
+// Allocates the i/p and o/p buffers if needed
+bool ConvNetCharClassifier::AllocNetBuffers() {
   int feat_cnt = char_net_->in_cnt();
   int class_cnt = char_set_->ClassCount();
 
-  // allocate i/p and o/p buffers if needed
   if (net_input_ == NULL) {
     net_input_ = new float[feat_cnt];
     if (net_input_ == NULL) {
@@ -152,6 +146,22 @@ bool ConvNetCharClassifier::RunNets(CharSamp *char_samp) {
       return false;
     }
   }
+  return true;
+}
+
+// Compute the features of specified charsamp and feedforward the
+// specified nets
+bool ConvNetCharClassifier::RunNets(CharSamp *char_samp) {
+  if (char_net_ == NULL) {
+    fprintf(stderr, "Cube ERROR (ConvNetCharClassifier::RunNets): "
+            "NeuralNet is NULL\n");
+    return false;
+  }
+
+  // allocate i/p and o/p buffers if needed
+  if (!AllocNetBuffers()) {
+    return false;
+  }
 
   // compute input features
   if (feat_extract_->ComputeFeatures(char_samp, net_input_) == false) {
@@ -189,6 +199,61 @@ CharAltList *ConvNetCharClassifier::Classify(CharSamp *char_samp) {
     return NULL;
   }
 
+  return OutputAltList();
+}
+
+// classifies a batch of charsamps. The features of all the samples are
+// fed forward together, and the outputs of each are folded and turned into
+// an alt list as in Classify
+void ConvNetCharClassifier::ClassifyBatch(CharSamp **char_samps, int samp_cnt,
+                                          CharAltList **alt_lists) {
+  for (int samp = 0; samp < samp_cnt; samp++) {
+    alt_lists[samp] = NULL;
+  }
+  if (char_net_ == NULL) {
+    fprintf(stderr, "Cube ERROR (ConvNetCharClassifier::ClassifyBatch): "
+            "NeuralNet is NULL\n");
+    return;
+  }
+  if (samp_cnt <= 0 || !AllocNetBuffers()) {
+    return;
+  }
+  int feat_cnt = char_net_->in_cnt();
+  int out_cnt = char_net_->out_cnt();
+
+  // compute the input features of all the samples
+  vector<float> inputs(samp_cnt * feat_cnt, 0.0f);
+  vector<bool> valid(samp_cnt);
+  for (int samp = 0; samp < samp_cnt; samp++) {
+    valid[samp] = feat_extract_->ComputeFeatures(char_samps[samp],
+                                                 &inputs[samp * feat_cnt]);
+    if (!valid[samp]) {
+      fprintf(stderr, "Cube ERROR (ConvNetCharClassifier::ClassifyBatch): "
+              "unable to compute features\n");
+    }
+  }
+
+  vector<float> outputs(samp_cnt * out_cnt);
+  if (!char_net_->FeedForwardBatch(&inputs[0], feat_cnt, samp_cnt,
+                                   &outputs[0])) {
+    fprintf(stderr, "Cube ERROR (ConvNetCharClassifier::ClassifyBatch): "
+            "unable to run feed-forward\n");
+    return;
+  }
+
+  for (int samp = 0; samp < samp_cnt; samp++) {
+    if (valid[samp]) {
+      memcpy(net_output_, &outputs[samp * out_cnt],
+             out_cnt * sizeof(*net_output_));
+      Fold();
+      alt_lists[samp] = OutputAltList();
+    }
+  }
+}
+
+// Creates an alt list of all the classes but the first (the non-char class)
+// from the folded net outputs
+CharAltList *ConvNetCharClassifier::OutputAltList() {
   int class_cnt = char_set_->ClassCount();
 
   // create an altlist
@@ -316,6 +316,45 @@ CharAltList * CubeSearchObject::RecognizeSegment(int start_pt, int end_pt) {
   return reco_cache_[start_pt + 1][end_pt];
 }
 
+// call from Beam Search to recognize all the start points of a column in
+// one batch before RecognizeSegment is called for each of them
+void CubeSearchObject::RecognizeSegments(int first_start_pt, int end_pt) {
+  // init if necessary
+  if (!init_ && !Init()) {
+    return;
+  }
+  // without a classifier RecognizeSegment invents the distributions
+  CharClassifier *char_classifier = cntxt_->Classifier();
+  if (!char_classifier) {
+    return;
+  }
+
+  // collect the char samples that are not recognized yet. Errors are left
+  // for RecognizeSegment to report
+  vector<int> start_pts;
+  vector<CharSamp *> samps;
+  for (int start_pt = first_start_pt; start_pt < end_pt; start_pt++) {
+    if (!IsValidSegmentRange(start_pt, end_pt) ||
+        reco_cache_[start_pt + 1][end_pt]) {
+      continue;
+    }
+    CharSamp *samp = CharSample(start_pt, end_pt);
+    if (samp) {
+      start_pts.push_back(start_pt);
+      samps.push_back(samp);
+    }
+  }
+  if (samps.empty()) {
+    return;
+  }
+
+  vector<CharAltList *> alt_lists(samps.size());
+  char_classifier->ClassifyBatch(&samps[0], samps.size(), &alt_lists[0]);
+  for (int samp = 0; samp < samps.size(); samp++) {
+    reco_cache_[start_pts[samp] + 1][end_pt] = alt_lists[samp];
+  }
+}
+
 // Perform segmentation of the bitmap by detecting connected components,
 // segmenting each connected component using windowed vertical pixel density
 // histogram and sorting the resulting segments in reading order
@@ -48,6 +48,10 @@ class CubeSearchObject : public SearchObject {
   // Recognize the set of segments given by the specified range and return
   // a list of possible alternate answers
   CharAltList * RecognizeSegment(int start_pt, int end_pt);
+  // Recognize all the valid segment ranges that end at end_pt and start
+  // at or after first_start_pt in one batch, and cache the results for
+  // RecognizeSegment
+  void RecognizeSegments(int first_start_pt, int end_pt);
   // Returns the CharSamp corresponding to the specified segment range
   CharSamp *CharSample(int start_pt, int end_pt);
   // Returns a leptonica box corresponding to the specified segment range
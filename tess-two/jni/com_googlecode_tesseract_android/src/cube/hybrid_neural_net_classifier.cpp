@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <vector>
 #include <wctype.h>
@@ -127,24 +128,31 @@ void HybridNeuralNetCharClassifier::Fold() {
   }
 }
 
-// compute the features of specified charsamp and
-// feedforward the specified nets
-bool HybridNeuralNetCharClassifier::RunNets(CharSamp *char_samp) {
-  int feat_cnt = feat_extract_->FeatureCnt();
-  int class_cnt = char_set_->ClassCount();
-
-  // allocate i/p and o/p buffers if needed
+// allocates the i/p and o/p buffers if needed
+bool HybridNeuralNetCharClassifier::AllocNetBuffers() {
   if (net_input_ == NULL) {
-    net_input_ = new float[feat_cnt];
+    net_input_ = new float[feat_extract_->FeatureCnt()];
     if (net_input_ == NULL) {
       return false;
     }
 
-    net_output_ = new float[class_cnt];
+    net_output_ = new float[char_set_->ClassCount()];
     if (net_output_ == NULL) {
       return false;
     }
   }
+  return true;
+}
+
+// compute the features of specified charsamp and
+// feedforward the specified nets
+bool HybridNeuralNetCharClassifier::RunNets(CharSamp *char_samp) {
+  int class_cnt = char_set_->ClassCount();
+
+  // allocate i/p and o/p buffers if needed
+  if (!AllocNetBuffers()) {
+    return false;
+  }
 
   // compute input features
   if (feat_extract_->ComputeFeatures(char_samp, net_input_) == false) {
@@ -192,6 +200,66 @@ CharAltList *HybridNeuralNetCharClassifier::Classify(CharSamp *char_samp) {
     return NULL;
   }
 
+  return OutputAltList();
+}
+
+// classifies a batch of charsamps. Each net feeds forward the features of
+// all the samples together, and the weighted outputs of each sample are
+// folded and turned into an alt list as in Classify
+void HybridNeuralNetCharClassifier::ClassifyBatch(CharSamp **char_samps,
+                                                  int samp_cnt,
+                                                  CharAltList **alt_lists) {
+  for (int samp = 0; samp < samp_cnt; samp++) {
+    alt_lists[samp] = NULL;
+  }
+  if (samp_cnt <= 0 || !AllocNetBuffers()) {
+    return;
+  }
+  int feat_cnt = feat_extract_->FeatureCnt();
+  int class_cnt = char_set_->ClassCount();
+
+  // compute the input features of all the samples
+  vector<float> inputs(samp_cnt * feat_cnt, 0.0f);
+  vector<bool> valid(samp_cnt);
+  for (int samp = 0; samp < samp_cnt; samp++) {
+    valid[samp] = feat_extract_->ComputeFeatures(char_samps[samp],
+                                                 &inputs[samp * feat_cnt]);
+  }
+
+  // go thru all the nets, each reading its own span of the features
+  vector<float> outputs(samp_cnt * class_cnt, 0.0f);
+  int input_offset = 0;
+  for (int net_idx = 0; net_idx < nets_.size(); net_idx++) {
+    int out_cnt = nets_[net_idx]->out_cnt();
+    vector<float> net_out(samp_cnt * out_cnt);
+    if (!nets_[net_idx]->FeedForwardBatch(&inputs[input_offset], feat_cnt,
+                                          samp_cnt, &net_out[0])) {
+      return;
+    }
+    // add the output values
+    int add_cnt = MIN(out_cnt, class_cnt);
+    for (int samp = 0; samp < samp_cnt; samp++) {
+      for (int class_idx = 0; class_idx < add_cnt; class_idx++) {
+        outputs[samp * class_cnt + class_idx] +=
+            net_out[samp * out_cnt + class_idx] * net_wgts_[net_idx];
+      }
+    }
+    input_offset += nets_[net_idx]->in_cnt();
+  }
+
+  for (int samp = 0; samp < samp_cnt; samp++) {
+    if (valid[samp]) {
+      memcpy(net_output_, &outputs[samp * class_cnt],
+             class_cnt * sizeof(*net_output_));
+      Fold();
+      alt_lists[samp] = OutputAltList();
+    }
+  }
+}
+
+// creates an alt list of all the classes but the first (the non-char class)
+// from the folded net outputs
+CharAltList *HybridNeuralNetCharClassifier::OutputAltList() {
   int class_cnt = char_set_->ClassCount();
 
   // create an altlist
@@ -60,6 +60,10 @@ class HybridNeuralNetCharClassifier : public CharClassifier {
   // Computes the cost of a specific charsamp being a character (versus a
   // non-character: part-of-a-character OR more-than-one-character)
   virtual int CharCost(CharSamp *char_samp);
+  // Classifies a batch of charsamps, feeding them forward through each net
+  // together
+  virtual void ClassifyBatch(CharSamp **char_samps, int samp_cnt,
+                             CharAltList **alt_lists);
 
  private:
   // Neural Net object used for classification
@@ -83,8 +87,12 @@ class HybridNeuralNetCharClassifier : public CharClassifier {
                                LangModel *lang_mod);
   // Folds the output of the NeuralNet using the loaded folding sets
   virtual void Fold();
+  // Allocates the Neural Net input and output buffers if needed
+  bool AllocNetBuffers();
   // Scales the input char_samp and feeds it to the NeuralNet as input
   bool RunNets(CharSamp *char_samp);
+  // Creates a CharAltList from the folded outputs of the NeuralNets
+  CharAltList *OutputAltList();
 };
 }
 #endif  // HYBRID_NEURAL_NET_CLASSIFIER_H
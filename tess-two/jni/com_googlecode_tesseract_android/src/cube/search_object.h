@@ -40,6 +40,11 @@ class SearchObject {
 
   virtual int SegPtCnt() = 0;
   virtual CharAltList *RecognizeSegment(int start_pt, int end_pt) = 0;
+  // Recognizes the segment ranges from every start pt in
+  // [first_start_pt, end_pt) to end_pt at once, if the search object can
+  // do that faster than one at a time. RecognizeSegment must still be
+  // called for each range to get its results
+  virtual void RecognizeSegments(int first_start_pt, int end_pt) {}
   virtual CharSamp *CharSample(int start_pt, int end_pt) = 0;
   virtual Box* CharBox(int start_pt, int end_pt) = 0;
 
@@ -69,12 +69,12 @@ TessLangModel::TessLangModel(const string &lm_params,
   // Load word_dawgs_ if needed.
   if (tessdata_manager->SeekToStart(TESSDATA_CUBE_UNICHARSET)) {
     word_dawgs_ = new DawgVector();
+    TFile fp;
     if (load_system_dawg &&
-        tessdata_manager->SeekToStart(TESSDATA_CUBE_SYSTEM_DAWG)) {
+        tessdata_manager->GetComponent(TESSDATA_CUBE_SYSTEM_DAWG, &fp)) {
       // The last parameter to the Dawg constructor (the debug level) is set to
       // false, until Cube has a way to express its preferred debug level.
-      *word_dawgs_ +=  new SquishedDawg(tessdata_manager->GetDataFilePtr(),
-                                        DAWG_TYPE_WORD,
+      *word_dawgs_ +=  new SquishedDawg(&fp, DAWG_TYPE_WORD,
                                         cntxt_->Lang().c_str(),
                                         SYSTEM_DAWG_PERM, false);
     }
@@ -178,11 +178,18 @@ void Dawg::init(DawgType type, const STRING &lang,
          F u n c t i o n s   f o r   S q u i s h e d    D a w g
 ----------------------------------------------------------------------*/
 
-SquishedDawg::~SquishedDawg() { memfree(edges_); }
+SquishedDawg::~SquishedDawg() {
+  if (!edges_in_place_) memfree(edges_);
+}
 
 EDGE_REF SquishedDawg::edge_char_of(NODE_REF node,
                                     UNICHAR_ID unichar_id,
                                     bool word_end) const {
+  if (!lookup_blocks_.empty() && node != NO_EDGE) {
+    const DawgLookupNode *lookup = lookup_node(node);
+    if (lookup != NULL)
+      return indexed_edge_char_of(node, *lookup, unichar_id, word_end);
+  }
   EDGE_REF edge = node;
   if (node == 0) {  // binary search
     EDGE_REF start = 0;
@@ -212,6 +219,111 @@ EDGE_REF SquishedDawg::edge_char_of(NODE_REF node,
   return (NO_EDGE);  // not found
 }
 
+EDGE_REF SquishedDawg::indexed_edge_char_of(NODE_REF node,
+                                            const DawgLookupNode &lookup,
+                                            UNICHAR_ID unichar_id,
+                                            bool word_end) const {
+  // Indexed nodes only have unichar ids in [0, unicharset_size_).
+  if (unichar_id < 0 || unichar_id >= unicharset_size_) return NO_EDGE;
+  int offset;
+  if (lookup.table) {
+    offset = lookup_tables_[lookup.start + unichar_id] - 1;
+    if (offset < 0) return NO_EDGE;
+  } else {
+    // Find the last key that is not greater than the greatest key of the
+    // unichar id. The loop only depends on the number of edges, and the
+    // comparison compiles to a conditional move.
+    const uinT32 *key = &lookup_keys_[lookup.start];
+    uinT32 target = (static_cast<uinT32>(unichar_id) << kLookupOffsetBits) |
+        ((1u << kLookupOffsetBits) - 1);
+    for (int n = lookup.num_edges; n > 1;) {
+      int half = n >> 1;
+      key = key[half] <= target ? key + half : key;
+      n -= half;
+    }
+    if ((*key >> kLookupOffsetBits) != static_cast<uinT32>(unichar_id))
+      return NO_EDGE;
+    offset = *key & ((1u << kLookupOffsetBits) - 1);
+  }
+  EDGE_REF edge = node + offset;
+  if (word_end && !end_of_word_from_edge_rec(edges_[edge])) return NO_EDGE;
+  return edge;
+}
+
+void SquishedDawg::build_lookup_index() {
+  lookup_blocks_.clear();
+  lookup_nodes_.clear();
+  lookup_keys_.clear();
+  lookup_tables_.clear();
+  // The keys hold unichar ids and offsets in 16 bits.
+  if (unicharset_size_ >= (1 << kLookupOffsetBits)) return;
+
+  DawgLookupBlock empty_block = { 0, 0 };
+  lookup_blocks_.init_to_size(
+      (num_edges_ + kLookupBlockEdges - 1) >> kLookupBlockBits, empty_block);
+  // node_of_id[id] is the last node seen with an edge of that unichar id.
+  GenericVector<EDGE_REF> node_of_id;
+  node_of_id.init_to_size(unicharset_size_, NO_EDGE);
+  GenericVector<uinT32> keys;
+  EDGE_REF edge = 0;
+  while (edge < num_edges_) {
+    if (!forward_edge(edge)) {  // skip back links and empty edges
+      ++edge;
+      continue;
+    }
+    NODE_REF node = edge;
+    int num_edges = num_forward_edges(node);
+    edge += num_edges;
+    if (num_edges <= kMaxLinearSearchEdges) continue;
+
+    keys.clear();
+    bool unique = true;
+    for (int offset = 0; offset < num_edges && unique; ++offset) {
+      UNICHAR_ID unichar_id = unichar_id_from_edge_rec(edges_[node + offset]);
+      unique = unichar_id < unicharset_size_ && node_of_id[unichar_id] != node;
+      if (unique) {
+        node_of_id[unichar_id] = node;
+        keys.push_back((static_cast<uinT32>(unichar_id) << kLookupOffsetBits) |
+                       offset);
+      }
+    }
+    if (!unique) continue;
+
+    DawgLookupNode lookup;
+    lookup.num_edges = num_edges;
+    lookup.table = num_edges < kMaxTableEdges &&
+        num_edges * kMaxTableEntriesPerEdge >= unicharset_size_;
+    if (lookup.table) {
+      lookup.start = lookup_tables_.size();
+      for (int i = 0; i < unicharset_size_; ++i) lookup_tables_.push_back(0);
+      for (int i = 0; i < num_edges; ++i) {
+        lookup_tables_[lookup.start + (keys[i] >> kLookupOffsetBits)] =
+            (keys[i] & ((1u << kLookupOffsetBits) - 1)) + 1;
+      }
+    } else {
+      keys.sort();
+      lookup.start = lookup_keys_.size();
+      for (int i = 0; i < num_edges; ++i) lookup_keys_.push_back(keys[i]);
+    }
+    DawgLookupBlock &block = lookup_blocks_[node >> kLookupBlockBits];
+    if (block.indexed == 0) block.first_node = lookup_nodes_.size();
+    block.indexed |= 1u << (node & (kLookupBlockEdges - 1));
+    lookup_nodes_.push_back(lookup);
+  }
+  if (lookup_nodes_.empty()) lookup_blocks_.clear();
+  if (debug_level_) {
+    tprintf("Indexed %d nodes of dawg in %d bytes\n", lookup_nodes_.size(),
+            lookup_index_size());
+  }
+}
+
+int SquishedDawg::lookup_index_size() const {
+  return lookup_blocks_.size() * sizeof(DawgLookupBlock) +
+      lookup_nodes_.size() * sizeof(DawgLookupNode) +
+      lookup_keys_.size() * sizeof(uinT32) +
+      lookup_tables_.size() * sizeof(uinT8);
+}
+
 inT32 SquishedDawg::num_forward_edges(NODE_REF node) const {
   EDGE_REF   edge = node;
   inT32        num  = 0;
@@ -296,22 +408,39 @@ void SquishedDawg::print_edge(EDGE_REF edge) const {
   }
 }
 
-void SquishedDawg::read_squished_dawg(FILE *file,
+void SquishedDawg::read_squished_dawg(TFile *file,
                                       DawgType type,
                                       const STRING &lang,
                                       PermuterType perm,
                                       int debug_level) {
   if (debug_level) tprintf("Reading squished dawg\n");
 
-  // Read the magic number and if it does not match kDawgMagicNumber
-  // set swap to true to indicate that we need to switch endianness.
+  // Read the magic number and if it does not match the magic number of the
+  // format set swap to true to indicate that we need to switch endianness.
+  // The flat format is always little-endian, so swap can only be true for it
+  // on a big-endian host.
   inT16 magic;
-  fread(&magic, sizeof(inT16), 1, file);
-  bool swap = (magic != kDawgMagicNumber);
+  file->FRead(&magic, sizeof(inT16), 1);
+  bool flat = magic == kFlatDawgMagicNumber ||
+              magic == static_cast<inT16>(reverse16(kFlatDawgMagicNumber));
+  bool swap = magic != (flat ? kFlatDawgMagicNumber : kDawgMagicNumber);
+  if (flat) {
+    inT16 version;
+    file->FRead(&version, sizeof(inT16), 1);
+    if (swap) version = reverse16(version);
+    if (version > kFlatDawgVersion) {
+      tprintf("Unsupported flat dawg version %d\n", version);
+      ASSERT_HOST(version <= kFlatDawgVersion);
+    }
+  }
 
   int unicharset_size;
-  fread(&unicharset_size, sizeof(inT32), 1, file);
-  fread(&num_edges_, sizeof(inT32), 1, file);
+  file->FRead(&unicharset_size, sizeof(inT32), 1);
+  file->FRead(&num_edges_, sizeof(inT32), 1);
+  if (flat) {
+    inT32 reserved;
+    file->FRead(&reserved, sizeof(inT32), 1);
+  }
 
   if (swap) {
     unicharset_size = reverse32(unicharset_size);
@@ -320,8 +449,18 @@ void SquishedDawg::read_squished_dawg(FILE *file,
   ASSERT_HOST(num_edges_ > 0);  // DAWG should not be empty
   Dawg::init(type, lang, perm, unicharset_size, debug_level);
 
-  edges_ = (EDGE_ARRAY) memalloc(sizeof(EDGE_RECORD) * num_edges_);
-  fread(&edges_[0], sizeof(EDGE_RECORD), num_edges_, file);
+  // The edges can be used in place if they are in memory in the right byte
+  // order and aligned. Otherwise they are copied.
+  const char *edge_data = swap ? NULL :
+      file->FReadInPlace(sizeof(EDGE_RECORD) * num_edges_,
+                         sizeof(EDGE_RECORD));
+  edges_in_place_ = edge_data != NULL;
+  if (edges_in_place_) {
+    edges_ = reinterpret_cast<EDGE_ARRAY>(const_cast<char *>(edge_data));
+  } else {
+    edges_ = (EDGE_ARRAY) memalloc(sizeof(EDGE_RECORD) * num_edges_);
+    file->FRead(&edges_[0], sizeof(EDGE_RECORD), num_edges_);
+  }
   EDGE_REF edge;
   if (swap) {
     for (edge = 0; edge < num_edges_; ++edge) {
@@ -366,7 +505,13 @@ NODE_MAP SquishedDawg::build_node_map(inT32 *num_nodes) const {
   return (node_map);
 }
 
-void SquishedDawg::write_squished_dawg(FILE *file) {
+// Returns true if the host stores the least significant byte first.
+static bool HostIsLittleEndian() {
+  const inT16 one = 1;
+  return *reinterpret_cast<const char *>(&one) == 1;
+}
+
+void SquishedDawg::write_squished_dawg(FILE *file, bool flat) {
   EDGE_REF    edge;
   inT32       num_edges;
   inT32       node_count = 0;
@@ -378,18 +523,31 @@ void SquishedDawg::write_squished_dawg(FILE *file) {
 
   node_map = build_node_map(&node_count);
 
-  // Write the magic number to help detecting a change in endianness.
-  inT16 magic = kDawgMagicNumber;
-  fwrite(&magic, sizeof(inT16), 1, file);
-  fwrite(&unicharset_size_, sizeof(inT32), 1, file);
-
   // Count the number of edges in this Dawg.
   num_edges = 0;
   for (edge=0; edge < num_edges_; edge++)
     if (forward_edge(edge))
       num_edges++;
 
-  fwrite(&num_edges, sizeof(inT32), 1, file);  // write edge count to file
+  // Write the magic number to help detecting a change in endianness.
+  // The flat format is always written little-endian.
+  bool swap = flat && !HostIsLittleEndian();
+  inT16 magic = flat ? kFlatDawgMagicNumber : kDawgMagicNumber;
+  inT16 version = kFlatDawgVersion;
+  inT32 unicharset_size = unicharset_size_;
+  inT32 reserved = 0;
+  inT32 edge_count = num_edges;
+  if (swap) {
+    magic = reverse16(magic);
+    version = reverse16(version);
+    unicharset_size = reverse32(unicharset_size);
+    edge_count = reverse32(edge_count);
+  }
+  fwrite(&magic, sizeof(inT16), 1, file);
+  if (flat) fwrite(&version, sizeof(inT16), 1, file);
+  fwrite(&unicharset_size, sizeof(inT32), 1, file);
+  fwrite(&edge_count, sizeof(inT32), 1, file);  // write edge count to file
+  if (flat) fwrite(&reserved, sizeof(inT32), 1, file);
 
   if (debug_level_) {
     tprintf("%d nodes in DAWG\n", node_count);
@@ -399,11 +557,12 @@ void SquishedDawg::write_squished_dawg(FILE *file) {
   for (edge = 0; edge < num_edges_; edge++) {
     if (forward_edge(edge)) {  // write forward edges
       do {
-        old_index = next_node_from_edge_rec(edges_[edge]);
-        set_next_node(edge, node_map[old_index]);
+        // Remap a copy, as edges_ may be read-only.
         temp_record = edges_[edge];
+        old_index = next_node_from_edge_rec(temp_record);
+        set_next_node_in_edge_rec(&temp_record, node_map[old_index]);
+        if (swap) temp_record = reverse64(temp_record);
         fwrite(&(temp_record), sizeof(EDGE_RECORD), 1, file);
-        set_next_node(edge, old_index);
       } while (!last_edge(edge++));
 
       if (edge >= num_edges_) break;
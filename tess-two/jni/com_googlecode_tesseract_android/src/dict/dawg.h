@@ -123,6 +123,14 @@ class Dawg {
  public:
   /// Magic number to determine endianness when reading the Dawg from file.
   static const inT16 kDawgMagicNumber = 42;
+  /// Magic number of the flat dawg format, which is the same as the
+  /// original format except that it is always little-endian and has a 16
+  /// byte header with a version number, so that the edges are 8 byte
+  /// aligned in a traineddata file and can be used in place when it is
+  /// memory mapped.
+  static const inT16 kFlatDawgMagicNumber = 43;
+  /// Latest version of the flat dawg format.
+  static const inT16 kFlatDawgVersion = 1;
   /// A special unichar id that indicates that any appropriate pattern
   /// (e.g.dicitonary word, 0-9 digit, etc) can be inserted instead
   /// Used for expressing patterns in punctuation and number Dawgs.
@@ -341,6 +349,28 @@ class DawgInfoVector : public GenericVector<DawgInfo> {
   }
 };
 
+//
+/// Lookup index record of a node of a SquishedDawg with many edges.
+//
+struct DawgLookupNode {
+  /// Index of the first key of the node in the sorted keys or, if table is
+  /// true, of its first entry in the tables.
+  inT32 start;
+  /// Number of forward edges of the node.
+  uinT16 num_edges;
+  bool table;
+};
+
+//
+/// Block of the edges of a SquishedDawg in its lookup index.
+//
+struct DawgLookupBlock {
+  /// Bit i is set if the node that starts at edge i of the block is indexed.
+  uinT32 indexed;
+  /// Index of the record of the first indexed node of the block.
+  inT32 first_node;
+};
+
 //
 /// Concrete class that can operate on a compacted (squished) Dawg (read,
 /// search and write to file). This class is read-only in the sense that
@@ -351,8 +381,31 @@ class DawgInfoVector : public GenericVector<DawgInfo> {
 //
 class SquishedDawg : public Dawg {
  public:
+  /// Nodes with at most this many edges are searched linearly, as their
+  /// edges fit in a cache line anyway.
+  static const int kMaxLinearSearchEdges = 8;
+  /// Nodes with fewer than kMaxTableEdges edges, but at least
+  /// 1 / kMaxTableEntriesPerEdge as many as there are unichar ids, get a
+  /// table in the lookup index.
+  static const int kMaxTableEntriesPerEdge = 8;
+  static const int kMaxTableEdges = 255;
+  /// Number of bits of the offset of the edge in a lookup key.
+  static const int kLookupOffsetBits = 16;
+  /// Log2 of the number of edges in a block of the lookup index.
+  static const int kLookupBlockBits = 5;
+  static const int kLookupBlockEdges = 1 << kLookupBlockBits;
+
   SquishedDawg(FILE *file, DawgType type, const STRING &lang,
                PermuterType perm, int debug_level) {
+    TFile tfile;
+    tfile.Open(file, -1);
+    read_squished_dawg(&tfile, type, lang, perm, debug_level);
+    num_forward_edges_in_node0 = num_forward_edges(0);
+  }
+  /// If file reads from memory, the edges are used in place when possible,
+  /// so the memory must then outlive the SquishedDawg.
+  SquishedDawg(TFile *file, DawgType type, const STRING &lang,
+               PermuterType perm, int debug_level) {
     read_squished_dawg(file, type, lang, perm, debug_level);
     num_forward_edges_in_node0 = num_forward_edges(0);
   }
@@ -363,14 +416,16 @@ class SquishedDawg : public Dawg {
       tprintf("Failed to open dawg file %s\n", filename);
       exit(1);
     }
-    read_squished_dawg(file, type, lang, perm, debug_level);
+    TFile tfile;
+    tfile.Open(file, -1);
+    read_squished_dawg(&tfile, type, lang, perm, debug_level);
     num_forward_edges_in_node0 = num_forward_edges(0);
     fclose(file);
   }
   SquishedDawg(EDGE_ARRAY edges, int num_edges, DawgType type,
                const STRING &lang, PermuterType perm,
                int unicharset_size, int debug_level) :
-    edges_(edges), num_edges_(num_edges) {
+    edges_(edges), edges_in_place_(false), num_edges_(num_edges) {
     init(type, lang, perm, unicharset_size, debug_level);
     num_forward_edges_in_node0 = num_forward_edges(0);
     if (debug_level > 3) print_all("SquishedDawg:");
@@ -379,6 +434,18 @@ class SquishedDawg : public Dawg {
 
   int NumEdges() { return num_edges_; }
 
+  /// Builds the lookup index that edge_char_of uses for the nodes with more
+  /// than kMaxLinearSearchEdges edges instead of scanning their edges.
+  /// Nodes with many edges for the size of the unicharset get a table
+  /// indexed by unichar id, the others their unichar ids packed with the
+  /// edge offsets in a sorted array, which is searched without branches.
+  /// Nodes with repeated unichar ids are left to the scan, so the edges
+  /// returned are the same either way. The edges are not modified, so this
+  /// also works with edges used in place.
+  void build_lookup_index();
+  /// Returns the memory used by the lookup index in bytes.
+  int lookup_index_size() const;
+
   /// Returns the edge that corresponds to the letter out of this node.
   EDGE_REF edge_char_of(NODE_REF node, UNICHAR_ID unichar_id,
                         bool word_end) const;
@@ -415,20 +482,27 @@ class SquishedDawg : public Dawg {
   /// At most max_num_edges will be printed.
   void print_node(NODE_REF node, int max_num_edges) const;
 
-  /// Writes the squished/reduced Dawg to a file.
-  void write_squished_dawg(FILE *file);
+  /// Writes the squished/reduced Dawg to a file, in the flat format if
+  /// flat is true, otherwise in the original format in host byte order.
+  void write_squished_dawg(FILE *file, bool flat);
+  void write_squished_dawg(FILE *file) {
+    write_squished_dawg(file, false);
+  }
 
   /// Opens the file with the given filename and writes the
   /// squished/reduced Dawg to the file.
-  void write_squished_dawg(const char *filename) {
+  void write_squished_dawg(const char *filename, bool flat) {
     FILE *file = fopen(filename, "wb");
     if (file == NULL) {
       tprintf("Error opening %s\n", filename);
       exit(1);
     }
-    this->write_squished_dawg(file);
+    this->write_squished_dawg(file, flat);
     fclose(file);
   }
+  void write_squished_dawg(const char *filename) {
+    write_squished_dawg(filename, false);
+  }
 
  private:
   /// Sets the next node link for this edge.
@@ -469,8 +543,32 @@ class SquishedDawg : public Dawg {
   /// Counts and returns the number of forward edges in this node.
   inT32 num_forward_edges(NODE_REF node) const;
 
-  /// Reads SquishedDawg from a file.
-  void read_squished_dawg(FILE *file, DawgType type, const STRING &lang,
+  /// Returns the lookup index record of the node, or NULL if the node is
+  /// not indexed.
+  inline const DawgLookupNode *lookup_node(NODE_REF node) const {
+    const DawgLookupBlock &block = lookup_blocks_[node >> kLookupBlockBits];
+    uinT32 bit = 1u << (node & (kLookupBlockEdges - 1));
+    if ((block.indexed & bit) == 0) return NULL;
+    return &lookup_nodes_[block.first_node +
+                          CountLookupBits(block.indexed & (bit - 1))];
+  }
+  /// Returns the number of set bits in the given block bits.
+  static inline int CountLookupBits(uinT32 bits) {
+#ifdef __GNUC__
+    return __builtin_popcount(bits);
+#else
+    bits -= (bits >> 1) & 0x55555555;
+    bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+    return (((bits + (bits >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+#endif
+  }
+  /// Returns the edge that corresponds to the letter out of the given
+  /// indexed node, using its lookup index record.
+  EDGE_REF indexed_edge_char_of(NODE_REF node, const DawgLookupNode &lookup,
+                                UNICHAR_ID unichar_id, bool word_end) const;
+
+  /// Reads SquishedDawg from a file in either format.
+  void read_squished_dawg(TFile *file, DawgType type, const STRING &lang,
                           PermuterType perm, int debug_level);
 
   /// Prints the contents of an edge indicated by the given EDGE_REF.
@@ -488,8 +586,24 @@ class SquishedDawg : public Dawg {
 
   // Member variables.
   EDGE_ARRAY edges_;
+  // True if edges_ points into the memory the dawg was read from, so it is
+  // read-only and not owned.
+  bool edges_in_place_;
   int num_edges_;
   int num_forward_edges_in_node0;
+  // Lookup index built by build_lookup_index, empty if there is none.
+  // Block i of lookup_blocks_ marks which of edges
+  // [i * kLookupBlockEdges, (i + 1) * kLookupBlockEdges) start an indexed
+  // node, whose records are in the same order in lookup_nodes_.
+  GenericVector<DawgLookupBlock> lookup_blocks_;
+  GenericVector<DawgLookupNode> lookup_nodes_;
+  // Sorted keys of the nodes without a table: for each edge, its unichar
+  // id in the high bits and its offset in the node in the low
+  // kLookupOffsetBits bits.
+  GenericVector<uinT32> lookup_keys_;
+  // Tables of unicharset_size_ entries, each the offset in the node plus one
+  // of the edge of that unichar id, or 0 if there is none.
+  GenericVector<uinT8> lookup_tables_;
 };
 
 }  // namespace tesseract
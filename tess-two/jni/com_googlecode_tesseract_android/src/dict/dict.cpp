@@ -55,6 +55,9 @@ Dict::Dict(Image* image_ptr)
                        getImage()->getCCUtil()->params()),
       BOOL_INIT_MEMBER(load_bigram_dawg, false, "Load dawg with special word "
                        "bigrams.", getImage()->getCCUtil()->params()),
+      BOOL_INIT_MEMBER(dawg_lookup_index, true, "Index the nodes of the"
+                       " loaded dawgs with many edges for faster lookups.",
+                       getImage()->getCCUtil()->params()),
       double_MEMBER(segment_penalty_dict_frequent_word, 1.0,
                     "Score multiplier for word matches which have good case and"
                     "are frequent in the given language (lower is better).",
@@ -204,8 +207,12 @@ Dict::Dict(Image* image_ptr)
   document_words_ = NULL;
   pending_words_ = NULL;
   bigram_dawg_ = NULL;
+  system_dawg_ = NULL;
+  number_dawg_ = NULL;
   freq_dawg_ = NULL;
+  unambig_dawg_ = NULL;
   punc_dawg_ = NULL;
+  shared_dawgs_source_ = NULL;
   max_fixed_length_dawgs_wdlen_ = -1;
   wordseg_rating_adjust_factor_ = -1.0f;
   output_ambig_words_file_ = NULL;
@@ -231,41 +238,35 @@ void Dict::Load() {
     getImage()->getCCUtil()->tessdata_manager;
 
   // Load dawgs_.
-  if (load_punc_dawg && tessdata_manager.SeekToStart(TESSDATA_PUNC_DAWG)) {
-    punc_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                  DAWG_TYPE_PUNCTUATION, lang, PUNC_PERM,
-                                  dawg_debug_level);
-    dawgs_ += punc_dawg_;
-  }
-  if (load_system_dawg && tessdata_manager.SeekToStart(TESSDATA_SYSTEM_DAWG)) {
-    dawgs_ += new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                               DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
-                               dawg_debug_level);
-  }
-  if (load_number_dawg && tessdata_manager.SeekToStart(TESSDATA_NUMBER_DAWG)) {
-    dawgs_ +=
-      new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                       DAWG_TYPE_NUMBER, lang, NUMBER_PERM, dawg_debug_level);
-  }
-  if (load_bigram_dawg && tessdata_manager.SeekToStart(TESSDATA_BIGRAM_DAWG)) {
-    bigram_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                    DAWG_TYPE_WORD, // doesn't actually matter.
-                                    lang,
-                                    COMPOUND_PERM,  // doesn't actually matter.
-                                    dawg_debug_level);
-  }
-  if (load_freq_dawg && tessdata_manager.SeekToStart(TESSDATA_FREQ_DAWG)) {
-    freq_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                  DAWG_TYPE_WORD, lang, FREQ_DAWG_PERM,
-                                  dawg_debug_level);
-    dawgs_ += freq_dawg_;
-  }
-  if (load_unambig_dawg &&
-      tessdata_manager.SeekToStart(TESSDATA_UNAMBIG_DAWG)) {
-    unambig_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                     DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
-                                     dawg_debug_level);
-    dawgs_ += unambig_dawg_;
+  if (load_punc_dawg) {
+    punc_dawg_ = LoadSquishedDawg(TESSDATA_PUNC_DAWG, DAWG_TYPE_PUNCTUATION,
+                                  PUNC_PERM);
+    if (punc_dawg_ != NULL) dawgs_ += punc_dawg_;
+  }
+  if (load_system_dawg) {
+    system_dawg_ = LoadSquishedDawg(TESSDATA_SYSTEM_DAWG, DAWG_TYPE_WORD,
+                                    SYSTEM_DAWG_PERM);
+    if (system_dawg_ != NULL) dawgs_ += system_dawg_;
+  }
+  if (load_number_dawg) {
+    number_dawg_ = LoadSquishedDawg(TESSDATA_NUMBER_DAWG, DAWG_TYPE_NUMBER,
+                                    NUMBER_PERM);
+    if (number_dawg_ != NULL) dawgs_ += number_dawg_;
+  }
+  if (load_bigram_dawg) {
+    bigram_dawg_ = LoadSquishedDawg(TESSDATA_BIGRAM_DAWG,
+                                    DAWG_TYPE_WORD,  // doesn't actually matter.
+                                    COMPOUND_PERM);  // doesn't actually matter.
+  }
+  if (load_freq_dawg) {
+    freq_dawg_ = LoadSquishedDawg(TESSDATA_FREQ_DAWG, DAWG_TYPE_WORD,
+                                  FREQ_DAWG_PERM);
+    if (freq_dawg_ != NULL) dawgs_ += freq_dawg_;
+  }
+  if (load_unambig_dawg) {
+    unambig_dawg_ = LoadSquishedDawg(TESSDATA_UNAMBIG_DAWG, DAWG_TYPE_WORD,
+                                     SYSTEM_DAWG_PERM);
+    if (unambig_dawg_ != NULL) dawgs_ += unambig_dawg_;
   }
 
   if (((STRING &)user_words_suffix).length() > 0) {
@@ -308,11 +309,12 @@ void Dict::Load() {
 
   // Load fixed length dawgs if necessary (used for phrase search
   // for non-space delimited languages).
+  TFile fp;
   if (load_fixed_length_dawgs &&
-      tessdata_manager.SeekToStart(TESSDATA_FIXED_LENGTH_DAWGS)) {
+      tessdata_manager.GetComponent(TESSDATA_FIXED_LENGTH_DAWGS, &fp)) {
     ReadFixedLengthDawgs(DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
-                         dawg_debug_level, tessdata_manager.GetDataFilePtr(),
-                         &dawgs_, &max_fixed_length_dawgs_wdlen_);
+                         dawg_debug_level, &fp, &dawgs_,
+                         &max_fixed_length_dawgs_wdlen_);
   }
 
   // Construct a list of corresponding successors for each dawg. Each entry i
@@ -335,11 +337,21 @@ void Dict::Load() {
 void Dict::End() {
   if (dawgs_.length() == 0)
     return;  // Not safe to call twice.
-  dawgs_.delete_data_pointers();
+  for (int i = 0; i < dawgs_.length(); ++i) {
+    if (!IsSharedDawg(dawgs_[i]))
+      delete dawgs_[i];
+  }
   successors_.delete_data_pointers();
   dawgs_.clear();
-  delete bigram_dawg_;
+  if (!IsSharedDawg(bigram_dawg_))
+    delete bigram_dawg_;
   successors_.clear();
+  bigram_dawg_ = NULL;
+  system_dawg_ = NULL;
+  number_dawg_ = NULL;
+  freq_dawg_ = NULL;
+  unambig_dawg_ = NULL;
+  punc_dawg_ = NULL;
   document_words_ = NULL;
   max_fixed_length_dawgs_wdlen_ = -1;
   if (pending_words_ != NULL) {
@@ -348,6 +360,60 @@ void Dict::End() {
   }
 }
 
+Dawg *Dict::GetSquishedDawg(TessdataType tessdata_type) const {
+  switch (tessdata_type) {
+    case TESSDATA_PUNC_DAWG:
+      return punc_dawg_;
+    case TESSDATA_SYSTEM_DAWG:
+      return system_dawg_;
+    case TESSDATA_NUMBER_DAWG:
+      return number_dawg_;
+    case TESSDATA_BIGRAM_DAWG:
+      return bigram_dawg_;
+    case TESSDATA_FREQ_DAWG:
+      return freq_dawg_;
+    case TESSDATA_UNAMBIG_DAWG:
+      return unambig_dawg_;
+    default:
+      return NULL;
+  }
+}
+
+Dawg *Dict::LoadSquishedDawg(TessdataType tessdata_type, DawgType type,
+                             PermuterType perm) {
+  if (shared_dawgs_source_ != NULL) {
+    Dawg *dawg = shared_dawgs_source_->GetSquishedDawg(tessdata_type);
+    if (dawg != NULL) return dawg;
+  }
+  TessdataManager &tessdata_manager =
+    getImage()->getCCUtil()->tessdata_manager;
+  TFile fp;
+  if (!tessdata_manager.GetComponent(tessdata_type, &fp)) return NULL;
+  SquishedDawg *dawg = new SquishedDawg(&fp, type,
+                                        getImage()->getCCUtil()->lang, perm,
+                                        dawg_debug_level);
+  if (dawg_lookup_index) dawg->build_lookup_index();
+  return dawg;
+}
+
+Trie *Dict::SwapDocumentDictionary(Trie *words) {
+  Trie *previous = document_words_;
+  for (int i = 0; i < dawgs_.length(); ++i) {
+    if (dawgs_[i] == previous)
+      dawgs_[i] = words;
+  }
+  document_words_ = words;
+  return previous;
+}
+
+bool Dict::IsSharedDawg(const Dawg *dawg) const {
+  if (dawg == NULL || shared_dawgs_source_ == NULL) return false;
+  const Dict *source = shared_dawgs_source_;
+  return dawg == source->punc_dawg_ || dawg == source->system_dawg_ ||
+      dawg == source->number_dawg_ || dawg == source->bigram_dawg_ ||
+      dawg == source->freq_dawg_ || dawg == source->unambig_dawg_;
+}
+
 // Create unicharset adaptations of known, short lists of UTF-8 equivalent
 // characters (think all hyphen-like symbols).  The first version of the
 // list is taken as equivalent for matching against the dictionary.
@@ -591,13 +657,13 @@ void Dict::ProcessPatternEdges(const Dawg *dawg, const DawgInfo &info,
 
 void Dict::ReadFixedLengthDawgs(DawgType type, const STRING &lang,
                                 PermuterType perm, int debug_level,
-                                FILE *file, DawgVector *dawg_vec,
+                                TFile *file, DawgVector *dawg_vec,
                                 int *max_wdlen) {
   int i;
   DawgVector dawg_vec_copy;
   dawg_vec_copy.move(dawg_vec); // save the input dawg_vec.
   inT32 num_dawgs;
-  fread(&num_dawgs, sizeof(inT32), 1, file);
+  file->FRead(&num_dawgs, sizeof(inT32), 1);
   bool swap = (num_dawgs > MAX_WERD_LENGTH);
   if (swap) num_dawgs = reverse32(num_dawgs);
   inT32 word_length;
@@ -606,7 +672,7 @@ void Dict::ReadFixedLengthDawgs(DawgType type, const STRING &lang,
   // dawg_vec[word_length] = pointer to dawg with word length of word_length,
   //                         NULL if such fixed-length dawg does not exist.
   for (i = 0; i < num_dawgs; ++i) {
-    fread(&word_length, sizeof(inT32), 1, file);
+    file->FRead(&word_length, sizeof(inT32), 1);
     if (swap) word_length = reverse32(word_length);
     ASSERT_HOST(word_length >  0 && word_length <= MAX_WERD_LENGTH);
     while (word_length >= dawg_vec->size()) dawg_vec->push_back(NULL);
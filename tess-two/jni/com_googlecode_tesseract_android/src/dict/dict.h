@@ -26,6 +26,7 @@
 #include "oldlist.h"
 #include "ratngs.h"
 #include "stopper.h"
+#include "tessdatamanager.h"
 #include "trie.h"
 #include "unicharset.h"
 #include "permute.h"
@@ -471,6 +472,26 @@ class Dict {
   void Load();
   void End();
 
+  /// Makes Load() take the punctuation, system, number, bigram, frequent and
+  /// unambiguous word dawgs from source instead of reading them from
+  /// [lang].traineddata. Those dawgs are never modified after loading, so a
+  /// single copy may be shared by any number of Dicts, but source must have
+  /// been loaded for the same language and must outlive this Dict.
+  /// Must be called before Load(). NULL restores loading.
+  void ShareSquishedDawgs(const Dict* source) {
+    shared_dawgs_source_ = source;
+  }
+
+  /// Returns the document dictionary, which holds the words recognized so
+  /// far in the document.
+  Trie *document_words() const { return document_words_; }
+  /// Makes words the document dictionary, in document_words_ and in dawgs_,
+  /// and returns the previous one. The caller keeps ownership of both, and
+  /// must swap the previous one back before End(). Used by word workers to
+  /// look words up in the document dictionary of the Tesseract they work
+  /// for during a pass, in which it is only read.
+  Trie *SwapDocumentDictionary(Trie *words);
+
   // Resets the document dictionary analogous to ResetAdaptiveClassifier.
   void ResetDocumentDictionary() {
     if (pending_words_ != NULL)
@@ -596,6 +617,10 @@ class Dict {
                                       const char* character,
                                       int character_bytes);
 
+  /// Return the dawg loaded from the given traineddata component by Load(),
+  /// or NULL if there is none.
+  Dawg *GetSquishedDawg(TessdataType tessdata_type) const;
+
   /// Return the number of dawgs in the dawgs_ vector.
   inline const int NumDawgs() const { return dawgs_.size(); }
   /// Return i-th dawg pointer recorded in the dawgs_ vector.
@@ -664,7 +689,7 @@ class Dict {
   /// of a particular length.
   static void ReadFixedLengthDawgs(DawgType type, const STRING &lang,
                                    PermuterType perm, int debug_level,
-                                   FILE *file, DawgVector *dawg_vec,
+                                   TFile *file, DawgVector *dawg_vec,
                                    int *max_wdlen);
   /// Writes the dawgs in the dawgs_vec to a file. Updates the given table with
   /// the indices of dawgs in the dawg_vec for the corresponding word lengths.
@@ -737,6 +762,14 @@ class Dict {
    * during compound word permutation.
    */
   bool keep_word_choices_;
+  /// Returns the dawg of the given traineddata component, borrowed from
+  /// shared_dawgs_source_ if it has one, or else read from [lang].traineddata,
+  /// or NULL if there is no such component.
+  Dawg *LoadSquishedDawg(TessdataType tessdata_type, DawgType type,
+                         PermuterType perm);
+  /// Returns true if dawg is borrowed from shared_dawgs_source_.
+  bool IsSharedDawg(const Dawg *dawg) const;
+
   /** Additional certainty padding allowed before a word is rejected. */
   FLOAT32 reject_offset_;
   /** Current word segmentation. */
@@ -770,10 +803,15 @@ class Dict {
   /// The dawgs will be deleted when dawgs_ vector is destroyed.
   // TODO(daria): need to support multiple languages in the future,
   // so maybe will need to maintain a list of dawgs of each kind.
+  Dawg *system_dawg_;
+  Dawg *number_dawg_;
   Dawg *freq_dawg_;
   Dawg *unambig_dawg_;
   Dawg *punc_dawg_;
   Trie *document_words_;
+  /// If not NULL, the Dict that owns the squished dawgs used by this one.
+  /// Borrowed dawgs are not deleted by End().
+  const Dict *shared_dawgs_source_;
   /// Maximum word length of fixed-length word dawgs.
   /// A value < 1 indicates that no fixed-length dawgs are loaded.
   int max_fixed_length_dawgs_wdlen_;
@@ -800,6 +838,8 @@ class Dict {
              " dawgs (e.g. for non-space delimited languages)");
   BOOL_VAR_H(load_bigram_dawg, false,
              "Load dawg with special word bigrams.");
+  BOOL_VAR_H(dawg_lookup_index, true, "Index the nodes of the loaded dawgs"
+             " with many edges for faster lookups.");
   double_VAR_H(segment_penalty_dict_frequent_word, 1.0,
                "Score multiplier for word matches which have good case and"
                "are frequent in the given language (lower is better).");
@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dense_kernels.cpp
+// Description: Vectorized kernels for the dense layers of NeuralNet.
+// Created:     Fri Oct 16 21:24:09 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "dense_kernels.h"
+#include "neuron.h"
+#include "simddetect.h"
+
+namespace tesseract {
+
+// The table sigmoid of activation, with the table index computed in float.
+float SigmoidLookup(float activation) {
+  if (activation <= -10.0f) {
+    return 0.0f;
+  } else if (activation >= 10.0f) {
+    return 1.0f;
+  } else {
+    return Neuron::sigmoid_table()[
+        static_cast<int>(100.0f * (activation + 10.0f))];
+  }
+}
+
+// The scalar dot product kernel.
+void DotProductScalar(const float *weights, int n,
+                      const float *const *inputs, int batch_size,
+                      float *sums) {
+  for (int b = 0; b < batch_size; b++) {
+    const float *input = inputs[b];
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+      sum += weights[i] * input[i];
+    }
+    sums[b] = sum;
+  }
+}
+
+// The scalar sigmoid kernel.
+void SigmoidScalar(const float *activations, int n, float *outputs) {
+  for (int i = 0; i < n; i++) {
+    outputs[i] = SigmoidLookup(activations[i]);
+  }
+}
+
+// Returns the fastest dot product kernel for the running cpu.
+DotProductKernel DotProductKernelForCpu() {
+  DotProductKernel kernel = NULL;
+  if (SIMDDetect::IsSSE2Available())
+    kernel = DotProductKernelSSE2();
+  if (kernel == NULL && SIMDDetect::IsNEONAvailable())
+    kernel = DotProductKernelNEON();
+  if (kernel == NULL)
+    kernel = DotProductScalar;
+  return kernel;
+}
+
+// Returns the fastest sigmoid kernel for the running cpu.
+SigmoidKernel SigmoidKernelForCpu() {
+  SigmoidKernel kernel = NULL;
+  if (SIMDDetect::IsSSE2Available())
+    kernel = SigmoidKernelSSE2();
+  if (kernel == NULL && SIMDDetect::IsNEONAvailable())
+    kernel = SigmoidKernelNEON();
+  if (kernel == NULL)
+    kernel = SigmoidScalar;
+  return kernel;
+}
+}
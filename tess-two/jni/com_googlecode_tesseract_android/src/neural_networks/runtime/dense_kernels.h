@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dense_kernels.h
+// Description: Vectorized kernels for the dense layers of NeuralNet.
+// Created:     Fri Oct 16 21:24:09 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef DENSE_KERNELS_H
+#define DENSE_KERNELS_H
+
+namespace tesseract {
+
+// The largest number of samples that a dot product kernel multiplies a row
+// of weights with at once.
+static const int kDenseBatchSize = 4;
+
+// A dot product kernel sets sums[b] to the dot product of the n weights
+// with inputs[b][0, n), for each b in [0, batch_size), where batch_size is
+// at most kDenseBatchSize. The weights are only read once for the batch.
+typedef void (*DotProductKernel)(const float *weights, int n,
+                                 const float *const *inputs, int batch_size,
+                                 float *sums);
+
+// A sigmoid kernel sets outputs[i] to the table sigmoid of activations[i],
+// for i in [0, n). outputs may be the same as activations.
+typedef void (*SigmoidKernel)(const float *activations, int n,
+                              float *outputs);
+
+// The table sigmoid of activation, as in Neuron::Sigmoid but computing the
+// table index in float. All the sigmoid kernels must match it exactly.
+float SigmoidLookup(float activation);
+
+// The scalar kernels, available on all architectures.
+void DotProductScalar(const float *weights, int n,
+                      const float *const *inputs, int batch_size,
+                      float *sums);
+void SigmoidScalar(const float *activations, int n, float *outputs);
+
+// Return the fastest kernels that are both compiled into this library and
+// supported by the running cpu. Never return NULL.
+DotProductKernel DotProductKernelForCpu();
+SigmoidKernel SigmoidKernelForCpu();
+
+// The kernels for each instruction set. Each returns NULL if the kernel is
+// not compiled in for the target architecture.
+DotProductKernel DotProductKernelSSE2();
+DotProductKernel DotProductKernelNEON();
+SigmoidKernel SigmoidKernelSSE2();
+SigmoidKernel SigmoidKernelNEON();
+}
+
+#endif  // DENSE_KERNELS_H
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dense_kernels_neon.cpp
+// Description: NEON kernels for the dense layers of NeuralNet.
+// Created:     Fri Oct 16 21:24:09 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// On armeabi-v7a this file is built with -mfpu=neon (see Android.mk) and
+// the kernels are only called when the cpu reports NEON at runtime.
+
+#include "dense_kernels.h"
+#include "neuron.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NEON_KERNELS_AVAILABLE
+#endif
+
+namespace tesseract {
+
+#ifdef NEON_KERNELS_AVAILABLE
+// Returns the sum of the 4 floats of sum.
+static inline float HorizontalSum(float32x4_t sum) {
+  float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  return vget_lane_f32(vpadd_f32(pair, pair), 0);
+}
+
+// NEON dot product kernel. A full batch keeps an accumulator per sample,
+// so each group of 4 weights is loaded once for all 4 samples.
+static void DotProductNEON(const float *weights, int n,
+                           const float *const *inputs, int batch_size,
+                           float *sums) {
+  int n4 = n & ~3;
+  if (batch_size == kDenseBatchSize) {
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+    float32x4_t sum2 = vdupq_n_f32(0.0f);
+    float32x4_t sum3 = vdupq_n_f32(0.0f);
+    for (int i = 0; i < n4; i += 4) {
+      float32x4_t w = vld1q_f32(weights + i);
+      sum0 = vmlaq_f32(sum0, w, vld1q_f32(inputs[0] + i));
+      sum1 = vmlaq_f32(sum1, w, vld1q_f32(inputs[1] + i));
+      sum2 = vmlaq_f32(sum2, w, vld1q_f32(inputs[2] + i));
+      sum3 = vmlaq_f32(sum3, w, vld1q_f32(inputs[3] + i));
+    }
+    sums[0] = HorizontalSum(sum0);
+    sums[1] = HorizontalSum(sum1);
+    sums[2] = HorizontalSum(sum2);
+    sums[3] = HorizontalSum(sum3);
+  } else {
+    for (int b = 0; b < batch_size; b++) {
+      float32x4_t sum = vdupq_n_f32(0.0f);
+      for (int i = 0; i < n4; i += 4) {
+        sum = vmlaq_f32(sum, vld1q_f32(weights + i), vld1q_f32(inputs[b] + i));
+      }
+      sums[b] = HorizontalSum(sum);
+    }
+  }
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = n4; i < n; i++) {
+      sums[b] += weights[i] * inputs[b][i];
+    }
+  }
+}
+
+// NEON sigmoid kernel. The table indices are computed 4 at a time, and the
+// table is read with scalar loads.
+static void SigmoidNEON(const float *activations, int n, float *outputs) {
+  const float *table = Neuron::sigmoid_table();
+  const float32x4_t min_activation = vdupq_n_f32(-10.0f);
+  const float32x4_t max_activation = vdupq_n_f32(10.0f);
+  const float32x4_t scale = vdupq_n_f32(100.0f);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t activation = vld1q_f32(activations + i);
+    uint32x4_t below = vcleq_f32(activation, min_activation);
+    uint32x4_t above = vcgeq_f32(activation, max_activation);
+    float32x4_t clipped = vminq_f32(vmaxq_f32(activation, min_activation),
+                                    max_activation);
+    // vcvtq_s32_f32 truncates, as the scalar cast does.
+    int32x4_t index = vcvtq_s32_f32(
+        vmulq_f32(vaddq_f32(clipped, max_activation), scale));
+    int indices[4];
+    vst1q_s32(indices, index);
+    float values[4] = {
+      table[indices[0]], table[indices[1]], table[indices[2]], table[indices[3]]
+    };
+    float32x4_t output = vld1q_f32(values);
+    output = vreinterpretq_f32_u32(
+        vbicq_u32(vreinterpretq_u32_f32(output), below));
+    output = vbslq_f32(above, one, output);
+    vst1q_f32(outputs + i, output);
+  }
+  for (; i < n; i++) {
+    outputs[i] = SigmoidLookup(activations[i]);
+  }
+}
+#endif  // NEON_KERNELS_AVAILABLE
+
+DotProductKernel DotProductKernelNEON() {
+#ifdef NEON_KERNELS_AVAILABLE
+  return DotProductNEON;
+#else
+  return NULL;
+#endif
+}
+
+SigmoidKernel SigmoidKernelNEON() {
+#ifdef NEON_KERNELS_AVAILABLE
+  return SigmoidNEON;
+#else
+  return NULL;
+#endif
+}
+}
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dense_kernels_sse.cpp
+// Description: SSE2 kernels for the dense layers of NeuralNet.
+// Created:     Fri Oct 16 21:24:09 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "dense_kernels.h"
+#include "neuron.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SSE2_KERNELS_AVAILABLE
+#endif
+
+namespace tesseract {
+
+#ifdef SSE2_KERNELS_AVAILABLE
+// Returns the sum of the 4 floats of sum.
+static inline float HorizontalSum(__m128 sum) {
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+}
+
+// SSE2 dot product kernel. A full batch keeps an accumulator per sample,
+// so each group of 4 weights is loaded once for all 4 samples.
+static void DotProductSSE2(const float *weights, int n,
+                           const float *const *inputs, int batch_size,
+                           float *sums) {
+  int n4 = n & ~3;
+  if (batch_size == kDenseBatchSize) {
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    __m128 sum2 = _mm_setzero_ps();
+    __m128 sum3 = _mm_setzero_ps();
+    for (int i = 0; i < n4; i += 4) {
+      __m128 w = _mm_loadu_ps(weights + i);
+      sum0 = _mm_add_ps(sum0, _mm_mul_ps(w, _mm_loadu_ps(inputs[0] + i)));
+      sum1 = _mm_add_ps(sum1, _mm_mul_ps(w, _mm_loadu_ps(inputs[1] + i)));
+      sum2 = _mm_add_ps(sum2, _mm_mul_ps(w, _mm_loadu_ps(inputs[2] + i)));
+      sum3 = _mm_add_ps(sum3, _mm_mul_ps(w, _mm_loadu_ps(inputs[3] + i)));
+    }
+    sums[0] = HorizontalSum(sum0);
+    sums[1] = HorizontalSum(sum1);
+    sums[2] = HorizontalSum(sum2);
+    sums[3] = HorizontalSum(sum3);
+  } else {
+    for (int b = 0; b < batch_size; b++) {
+      __m128 sum = _mm_setzero_ps();
+      for (int i = 0; i < n4; i += 4) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(weights + i),
+                                         _mm_loadu_ps(inputs[b] + i)));
+      }
+      sums[b] = HorizontalSum(sum);
+    }
+  }
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = n4; i < n; i++) {
+      sums[b] += weights[i] * inputs[b][i];
+    }
+  }
+}
+
+// SSE2 sigmoid kernel. The table indices are computed 4 at a time, and the
+// table is read with scalar loads.
+static void SigmoidSSE2(const float *activations, int n, float *outputs) {
+  const float *table = Neuron::sigmoid_table();
+  const __m128 min_activation = _mm_set1_ps(-10.0f);
+  const __m128 max_activation = _mm_set1_ps(10.0f);
+  const __m128 scale = _mm_set1_ps(100.0f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 activation = _mm_loadu_ps(activations + i);
+    __m128 below = _mm_cmple_ps(activation, min_activation);
+    __m128 above = _mm_cmpge_ps(activation, max_activation);
+    __m128 clipped = _mm_min_ps(_mm_max_ps(activation, min_activation),
+                                max_activation);
+    __m128i index = _mm_cvttps_epi32(
+        _mm_mul_ps(_mm_add_ps(clipped, max_activation), scale));
+    int indices[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(indices), index);
+    __m128 output = _mm_setr_ps(table[indices[0]], table[indices[1]],
+                                table[indices[2]], table[indices[3]]);
+    output = _mm_andnot_ps(below, output);
+    output = _mm_or_ps(_mm_andnot_ps(above, output), _mm_and_ps(above, one));
+    _mm_storeu_ps(outputs + i, output);
+  }
+  for (; i < n; i++) {
+    outputs[i] = SigmoidLookup(activations[i]);
+  }
+}
+#endif  // SSE2_KERNELS_AVAILABLE
+
+DotProductKernel DotProductKernelSSE2() {
+#ifdef SSE2_KERNELS_AVAILABLE
+  return DotProductSSE2;
+#else
+  return NULL;
+#endif
+}
+
+SigmoidKernel SigmoidKernelSSE2() {
+#ifdef SSE2_KERNELS_AVAILABLE
+  return SigmoidSSE2;
+#else
+  return NULL;
+#endif
+}
+}
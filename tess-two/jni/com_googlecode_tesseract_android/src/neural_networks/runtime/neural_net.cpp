@@ -9,6 +9,7 @@
 #include <string>
 #include "neural_net.h"
 #include "input_file_buffer.h"
+#include "ndminx.h"
 
 namespace tesseract {
 
@@ -45,12 +46,29 @@ void NeuralNet::Init() {
   inputs_std_dev_.clear();
   inputs_min_.clear();
   inputs_max_.clear();
+  dense_layers_.clear();
+  batch_outputs_.clear();
+  dot_product_ = NULL;
+  sigmoid_ = NULL;
 }
 
 // Does a fast feedforward for read_only nets
 // Templatized for float and double Types
 template <typename Type> bool NeuralNet::FastFeedForward(const Type *inputs,
                                                          Type *outputs) {
+  // use the dense layers if the net has them
+  if (!dense_layers_.empty()) {
+    float *node_outputs = &batch_outputs_[0];
+    for (int in = 0; in < in_cnt_; in++) {
+      node_outputs[in] = inputs[in] - fast_nodes_[in].bias;
+    }
+    DenseFeedForward(1);
+    node_outputs += neuron_cnt_ - out_cnt_;
+    for (int out = 0; out < out_cnt_; out++) {
+      outputs[out] = node_outputs[out];
+    }
+    return true;
+  }
   int node_idx = 0;
   Node *node = &fast_nodes_[0];
   // feed inputs in and offset them by the pre-computed bias
@@ -108,6 +126,71 @@ template <typename Type> bool NeuralNet::FeedForward(const Type *inputs,
   return true;
 }
 
+// Feeds forward a batch of samples. Nets without dense layers just feed
+// forward one sample at a time
+template <typename Type> bool NeuralNet::FeedForwardBatch(const Type *inputs,
+                                                          int inputs_stride,
+                                                          int sample_cnt,
+                                                          Type *outputs) {
+  if (!read_only_ || dense_layers_.empty()) {
+    for (int samp = 0; samp < sample_cnt; samp++) {
+      if (!FeedForward(inputs + samp * inputs_stride,
+                       outputs + samp * out_cnt_)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  for (int first = 0; first < sample_cnt; first += kDenseBatchSize) {
+    int batch_size = MIN(kDenseBatchSize, sample_cnt - first);
+    // feed the inputs of the batch in, offset by the pre-computed bias
+    for (int samp = 0; samp < batch_size; samp++) {
+      const Type *samp_inputs = inputs + (first + samp) * inputs_stride;
+      float *node_outputs = &batch_outputs_[samp * neuron_cnt_];
+      for (int in = 0; in < in_cnt_; in++) {
+        node_outputs[in] = samp_inputs[in] - fast_nodes_[in].bias;
+      }
+    }
+    DenseFeedForward(batch_size);
+    for (int samp = 0; samp < batch_size; samp++) {
+      const float *node_outputs =
+          &batch_outputs_[samp * neuron_cnt_ + neuron_cnt_ - out_cnt_];
+      Type *samp_outputs = outputs + (first + samp) * out_cnt_;
+      for (int out = 0; out < out_cnt_; out++) {
+        samp_outputs[out] = node_outputs[out];
+      }
+    }
+  }
+  return true;
+}
+
+// Runs all the dense layers on a batch of samples. Each row of weights is
+// multiplied with all the samples before moving on to the next
+void NeuralNet::DenseFeedForward(int sample_cnt) {
+  const float *layer_inputs[kDenseBatchSize];
+  float *layer_outputs[kDenseBatchSize];
+  float sums[kDenseBatchSize];
+  for (int layer_idx = 0; layer_idx < dense_layers_.size(); layer_idx++) {
+    const DenseLayer &layer = dense_layers_[layer_idx];
+    for (int samp = 0; samp < sample_cnt; samp++) {
+      float *node_outputs = &batch_outputs_[samp * neuron_cnt_];
+      layer_inputs[samp] = node_outputs + layer.in_first;
+      layer_outputs[samp] = node_outputs + layer.first_node;
+    }
+    const float *wts = layer.weights.empty() ? NULL : &layer.weights[0];
+    for (int node = 0; node < layer.node_cnt; node++) {
+      (*dot_product_)(wts + node * layer.in_cnt, layer.in_cnt,
+                      layer_inputs, sample_cnt, sums);
+      for (int samp = 0; samp < sample_cnt; samp++) {
+        layer_outputs[samp][node] = sums[samp] - layer.biases[node];
+      }
+    }
+    for (int samp = 0; samp < sample_cnt; samp++) {
+      (*sigmoid_)(layer_outputs[samp], layer.node_cnt, layer_outputs[samp]);
+    }
+  }
+}
+
 // Sets a connection between two neurons
 bool NeuralNet::SetConnection(int from, int to) {
   // allocate the wgt
@@ -181,7 +264,69 @@ bool NeuralNet::CreateFastNet() {
     }
   }
   // sanity check
-  return wts_cnt_ == wts_cnt;
+  if (wts_cnt_ != wts_cnt) {
+    return false;
+  }
+  CreateDenseLayers();
+  return true;
+}
+
+// Splits the non-input nodes of the fast net into dense layers. A layer
+// grows until a node depends on a node of the layer itself. If any layer
+// has too few connections for its span of fan-in nodes, the net is left
+// without dense layers and runs on the fan-in graph
+void NeuralNet::CreateDenseLayers() {
+  dense_layers_.clear();
+  int node_idx = in_cnt_;
+  while (node_idx < neuron_cnt_) {
+    DenseLayer layer;
+    layer.first_node = node_idx;
+    int in_first = node_idx;
+    int in_end = 0;
+    int connection_cnt = 0;
+    for (; node_idx < neuron_cnt_; node_idx++) {
+      const Node &node = fast_nodes_[node_idx];
+      int node_in_first = in_first;
+      int node_in_end = in_end;
+      bool independent = true;
+      for (int fan_in = 0; fan_in < node.fan_in_cnt && independent; fan_in++) {
+        int id = node.inputs[fan_in].input_node - &fast_nodes_[0];
+        independent = id < layer.first_node;
+        node_in_first = MIN(node_in_first, id);
+        node_in_end = MAX(node_in_end, id + 1);
+      }
+      if (!independent) {
+        break;
+      }
+      in_first = node_in_first;
+      in_end = node_in_end;
+      connection_cnt += node.fan_in_cnt;
+    }
+    layer.node_cnt = node_idx - layer.first_node;
+    layer.in_first = in_end > in_first ? in_first : 0;
+    layer.in_cnt = in_end > in_first ? in_end - in_first : 0;
+    if (connection_cnt <
+        kMinDenseLayerFill * layer.node_cnt * layer.in_cnt) {
+      dense_layers_.clear();
+      return;
+    }
+    // copy the weights, normalized as in the fan-in graph
+    layer.weights.resize(layer.node_cnt * layer.in_cnt, 0.0f);
+    layer.biases.resize(layer.node_cnt);
+    for (int node = 0; node < layer.node_cnt; node++) {
+      const Node &fast_node = fast_nodes_[layer.first_node + node];
+      layer.biases[node] = fast_node.bias;
+      float *node_wts = &layer.weights[node * layer.in_cnt];
+      for (int fan_in = 0; fan_in < fast_node.fan_in_cnt; fan_in++) {
+        int id = fast_node.inputs[fan_in].input_node - &fast_nodes_[0];
+        node_wts[id - layer.in_first] += fast_node.inputs[fan_in].input_weight;
+      }
+    }
+    dense_layers_.push_back(layer);
+  }
+  batch_outputs_.resize(kDenseBatchSize * neuron_cnt_);
+  dot_product_ = DotProductKernelForCpu();
+  sigmoid_ = SigmoidKernelForCpu();
 }
 
 // returns a pointer to the requested set of weights
@@ -289,6 +434,12 @@ template <typename Type> bool NeuralNet::GetNetOutput(const Type *inputs,
 // Instantiate all supported templates now that the functions have been defined.
 template bool NeuralNet::FeedForward(const float *inputs, float *outputs);
 template bool NeuralNet::FeedForward(const double *inputs, double *outputs);
+template bool NeuralNet::FeedForwardBatch(const float *inputs,
+                                          int inputs_stride, int sample_cnt,
+                                          float *outputs);
+template bool NeuralNet::FeedForwardBatch(const double *inputs,
+                                          int inputs_stride, int sample_cnt,
+                                          double *outputs);
 template bool NeuralNet::FastFeedForward(const float *inputs, float *outputs);
 template bool NeuralNet::FastFeedForward(const double *inputs,
                                          double *outputs);
@@ -13,11 +13,15 @@
 #include <vector>
 #include "neuron.h"
 #include "input_file_buffer.h"
+#include "dense_kernels.h"
 
 namespace tesseract {
 
 // Minimum input range below which we set the input weight to zero
 static const float kMinInputRange = 1e-6f;
+// Minimum fraction of the weights of a layer that must be actual connections
+// for the layer to be run as a dense matrix
+static const float kMinDenseLayerFill = 0.5f;
 
 class NeuralNet {
   public:
@@ -30,6 +34,14 @@ class NeuralNet {
     // Different flavors of feed forward function
     template <typename Type> bool FeedForward(const Type *inputs,
                                               Type *outputs);
+    // Feeds forward sample_cnt samples at once. The inputs of sample s
+    // start at inputs + s * inputs_stride, and its out_cnt() outputs are
+    // written at outputs + s * out_cnt(). Read only nets with dense layers
+    // multiply each weight row with several samples while it is in cache
+    template <typename Type> bool FeedForwardBatch(const Type *inputs,
+                                                   int inputs_stride,
+                                                   int sample_cnt,
+                                                   Type *outputs);
     // Compute the output of a specific output node.
     // This function is useful for application that are interested in a single
     // output of the net and do not want to waste time on the rest
@@ -94,6 +106,27 @@ class NeuralNet {
     // vector of input offsets used by fast read-only
     // feedforward function
     vector<Node> fast_nodes_;
+    // A run of nodes whose fan-ins all come before the first of them, so
+    // they can be computed as one matrix product. The fan-ins of all the
+    // nodes are within a single span of nodes, and the weights are stored
+    // as a row of in_cnt weights per node, with zeros for the missing
+    // connections
+    struct DenseLayer {
+      int first_node;
+      int node_cnt;
+      int in_first;
+      int in_cnt;
+      vector<float> weights;
+      vector<float> biases;
+    };
+    // The layers of the read only net, in order, or empty if the net is
+    // too sparse to be run as dense layers
+    vector<DenseLayer> dense_layers_;
+    // the outputs of all the nodes for each of kDenseBatchSize samples
+    vector<float> batch_outputs_;
+    // kernels used to run the dense layers
+    DotProductKernel dot_product_;
+    SigmoidKernel sigmoid_;
     // Network Initialization function
     void Init();
     // Clears all neurons
@@ -226,6 +259,11 @@ class NeuralNet {
     // Create a read only version of the net that
     // has faster feedforward performance
     bool CreateFastNet();
+    // Compiles the read only net into dense_layers_ if it is dense enough
+    void CreateDenseLayers();
+    // Runs the dense layers on the first sample_cnt samples of
+    // batch_outputs_, whose input nodes must already be set
+    void DenseFeedForward(int sample_cnt);
     // internal function to allocate a new set of weights
     // Centralized weight allocation attempts to increase
     // weights locality of reference making it more cache friendly
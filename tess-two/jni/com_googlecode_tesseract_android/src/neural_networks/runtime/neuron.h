@@ -117,6 +117,11 @@ class Neuron {
     Neuron::NeuronTypes node_type() const {
       return node_type_;
     }
+    // The lookup table of Sigmoid, of 2001 values of the sigmoid
+    // function over [-10, 10] in steps of 0.01
+    static const float *sigmoid_table() {
+      return kSigmoidTable;
+    }
 
   protected:
     // Type of Neuron
@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dawgbench.cpp
+// Description: Micro-benchmark of SquishedDawg edge lookups.
+// Created:     Fri Oct 16 18:12:40 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Looks up the words of a word list in a dawg one letter at a time, the way
+// the language model extends its paths, with and without the lookup index
+// of the dawg, and reports lookups/sec for each. Each letter is looked up
+// along with a few pseudo-random other unichar ids, since most of the
+// hypotheses of the recognizer are not in the dawg. The passes over the
+// lookups alternate between the dawgs and the fastest pass of each is
+// reported, to reduce the noise of other load on the cpu. The results with
+// the index are checked against those without it, and the program exits
+// with an error if any of them differ.
+//
+// To compare languages, unpack the traineddata file of each with
+// combine_tessdata -u and run on its unicharset and word-dawg.
+//
+// Usage: dawgbench <unicharset> <dawgfile> <wordlistfile> [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "dawg.h"
+#include "genericvector.h"
+#include "ratngs.h"
+#include "unicharset.h"
+
+// Number of other unichar ids looked up for each letter of a word.
+const int kMissesPerLetter = 3;
+// Default number of timed passes over the lookups with each dawg.
+const int kDefaultIterations = 20;
+const int kMaxWordLength = 1024;
+
+// A call to edge_char_of.
+struct DawgLookup {
+  NODE_REF node;
+  UNICHAR_ID unichar_id;
+  bool word_end;
+};
+
+// Fixed-seed linear congruential generator, so the lookups are the same on
+// every run and platform.
+static unsigned int rand_state = 12345;
+static int NextRand(int range) {
+  rand_state = rand_state * 1103515245 + 12345;
+  return (rand_state >> 8) % range;
+}
+
+// Adds the lookups of the words of the file to lookups, following the
+// edges of the letters in the dawg. Returns the number of words.
+static int MakeLookups(const char *filename, const UNICHARSET &unicharset,
+                       const tesseract::Dawg &dawg,
+                       GenericVector<DawgLookup> *lookups) {
+  FILE *file = fopen(filename, "r");
+  if (file == NULL) {
+    fprintf(stderr, "Could not open %s\n", filename);
+    exit(1);
+  }
+  int num_words = 0;
+  char line[kMaxWordLength];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    chomp_string(line);
+    WERD_CHOICE word(line, unicharset);
+    if (word.length() == 0 || word.contains_unichar_id(INVALID_UNICHAR_ID))
+      continue;
+    ++num_words;
+    NODE_REF node = 0;
+    for (int i = 0; i < word.length(); ++i) {
+      DawgLookup lookup;
+      lookup.node = node;
+      lookup.word_end = i == word.length() - 1;
+      for (int m = 0; m < kMissesPerLetter; ++m) {
+        lookup.unichar_id = NextRand(unicharset.size());
+        lookups->push_back(lookup);
+      }
+      lookup.unichar_id = word.unichar_id(i);
+      lookups->push_back(lookup);
+      EDGE_REF edge = dawg.edge_char_of(node, lookup.unichar_id,
+                                        lookup.word_end);
+      if (edge == NO_EDGE) break;
+      node = dawg.next_node(edge);
+      if (node == 0) break;
+    }
+  }
+  fclose(file);
+  return num_words;
+}
+
+// Runs all the lookups once and returns the elapsed cpu time in seconds.
+// The edges found are written to edges.
+static double RunLookups(const tesseract::Dawg &dawg,
+                         const GenericVector<DawgLookup> &lookups,
+                         EDGE_REF *edges) {
+  clock_t start = clock();
+  for (int l = 0; l < lookups.size(); ++l) {
+    const DawgLookup &lookup = lookups[l];
+    edges[l] = dawg.edge_char_of(lookup.node, lookup.unichar_id,
+                                 lookup.word_end);
+  }
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv) {
+  int iterations = argc > 4 ? atoi(argv[4]) : kDefaultIterations;
+  if (argc < 4 || argc > 5 || iterations <= 0) {
+    fprintf(stderr, "Usage: %s <unicharset> <dawgfile> <wordlistfile>"
+            " [iterations]\n", argv[0]);
+    return 1;
+  }
+  UNICHARSET unicharset;
+  if (!unicharset.load_from_file(argv[1])) {
+    fprintf(stderr, "Failed to load unicharset from %s\n", argv[1]);
+    return 1;
+  }
+  // The type, language and permuter do not matter for lookups.
+  tesseract::SquishedDawg linear_dawg(argv[2], tesseract::DAWG_TYPE_WORD, "",
+                                      SYSTEM_DAWG_PERM, 0);
+  tesseract::SquishedDawg indexed_dawg(argv[2], tesseract::DAWG_TYPE_WORD, "",
+                                       SYSTEM_DAWG_PERM, 0);
+  indexed_dawg.build_lookup_index();
+
+  GenericVector<DawgLookup> lookups;
+  int num_words = MakeLookups(argv[3], unicharset, linear_dawg, &lookups);
+  if (lookups.empty()) {
+    fprintf(stderr, "No words of %s are in the unicharset\n", argv[3]);
+    return 1;
+  }
+  printf("%d words, %d lookups, %d edges, index of %d bytes\n", num_words,
+         lookups.size(), linear_dawg.NumEdges(),
+         indexed_dawg.lookup_index_size());
+
+  const char *names[] = { "linear", "indexed" };
+  const tesseract::SquishedDawg *dawgs[] = { &linear_dawg, &indexed_dawg };
+  EDGE_REF *edges[] = {
+    new EDGE_REF[lookups.size()], new EDGE_REF[lookups.size()]
+  };
+  double best_seconds[] = { 0.0, 0.0 };
+  // Pass -1 warms up the caches and is not timed.
+  for (int i = -1; i < iterations; ++i) {
+    for (int d = 0; d < 2; ++d) {
+      double seconds = RunLookups(*dawgs[d], lookups, edges[d]);
+      if (i == 0 || (i > 0 && seconds < best_seconds[d]))
+        best_seconds[d] = seconds;
+    }
+  }
+  int mismatches = 0;
+  for (int l = 0; l < lookups.size(); ++l) {
+    if (edges[1][l] != edges[0][l]) ++mismatches;
+  }
+  for (int d = 0; d < 2; ++d) {
+    double seconds = best_seconds[d];
+    printf("%-8s %10.0f lookups/sec %5.2fx %s\n", names[d],
+           seconds > 0.0 ? lookups.size() / seconds : 0.0,
+           seconds > 0.0 ? best_seconds[0] / seconds : 0.0,
+           d == 0 || mismatches == 0 ? "" : "MISMATCH");
+  }
+  delete [] edges[0];
+  delete [] edges[1];
+  return mismatches == 0 ? 0 : 1;
+}
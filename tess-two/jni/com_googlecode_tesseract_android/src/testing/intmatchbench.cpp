@@ -0,0 +1,310 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intmatchbench.cpp
+// Description: Micro-benchmark of the IntegerMatcher evidence kernels and
+//              the class pruner kernels.
+// Created:     Fri Oct 16 14:02:17 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Matches a fixed, pseudo-randomly generated set of INT_FEATURE arrays
+// against a synthetic class with IntegerMatcher::Match, once with the
+// evidence and evidence update kernels of each instruction set that runs on
+// this cpu, and reports features/sec for each. The results of every kernel
+// are checked against the scalar code, and the program exits with an error
+// if any of them differ.
+//
+// Then does the same for the class pruner kernels, summing the class
+// weights of random pruner words for the same number of features, and
+// checking the class counts against the scalar loop of
+// ClassPruner::ComputeScores.
+//
+// Usage: intmatchbench [iterations]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bitvec.h"
+#include "const.h"
+#include "helpers.h"
+#include "intmatcher.h"
+#include "intproto.h"
+#include "intsimdmatch.h"
+#include "params.h"
+#include "protos.h"
+#include "simddetect.h"
+
+// Size of the synthetic class.
+const int kNumProtos = 256;
+const int kNumConfigs = 32;
+// The fixed feature set: kNumSamples blobs of kFeaturesPerSample features.
+const int kNumSamples = 64;
+const int kFeaturesPerSample = 48;
+// Default number of passes over the feature set for each kernel.
+const int kDefaultIterations = 50;
+// Pruner words per feature for the class pruner kernels, as for a character
+// set of 1024 classes.
+const int kPrunerWordsPerFeature = 64;
+
+// Fixed-seed linear congruential generator, so the data is the same on
+// every run and platform.
+static unsigned int rand_state = 12345;
+static int NextRand(int range) {
+  rand_state = rand_state * 1103515245 + 12345;
+  return (rand_state >> 8) % range;
+}
+static float NextUniform() {
+  return NextRand(1 << 20) / static_cast<float>(1 << 20);
+}
+
+// Builds a class of kNumProtos random line segment protos spread over
+// kNumConfigs configs. The float protos are kept for generating features.
+static INT_CLASS MakeClass(PROTO_STRUCT* float_protos) {
+  INT_CLASS int_class = NewIntClass(kNumProtos, kNumConfigs);
+  for (int c = 0; c < kNumConfigs; ++c)
+    AddIntConfig(int_class);
+  for (int p = 0; p < kNumProtos; ++p) {
+    PROTO_STRUCT* proto = &float_protos[p];
+    proto->X = NextUniform() - 0.5f;
+    proto->Y = NextUniform() - 0.5f;
+    proto->Angle = NextUniform();
+    proto->Length = 0.02f + 0.2f * NextUniform();
+    FillABC(proto);
+    int proto_id = AddIntProto(int_class);
+    AddProtoToProtoPruner(proto, proto_id, int_class, false);
+    INT_PROTO int_proto = ProtoForProtoId(int_class, proto_id);
+    // Same conversion as Classify::ConvertProto.
+    int_proto->A = ClipToRange(static_cast<int>(proto->A * 128), -128, 127);
+    int_proto->B = ClipToRange(static_cast<int>(-proto->B * 256), 0, 255);
+    int_proto->C = ClipToRange(static_cast<int>(proto->C * 128), -128, 127);
+    int_proto->Angle = static_cast<uinT8>(proto->Angle * 255);
+    int length = ClipToRange(static_cast<int>(proto->Length * 64 + 0.5),
+                             1, MAX_PROTO_INDEX);
+    int_class->ProtoLengths[proto_id] = length;
+    // Put each proto in a few configs.
+    for (int i = 0; i < 3; ++i) {
+      int config = NextRand(kNumConfigs);
+      if ((int_proto->Configs[0] & (1 << config)) == 0) {
+        int_proto->Configs[0] |= 1 << config;
+        int_class->ConfigLengths[config] += length;
+      }
+    }
+  }
+  return int_class;
+}
+
+// Fills features with points sampled along the protos, with some noise,
+// plus a few uniformly random outliers.
+static void MakeFeatures(const PROTO_STRUCT* float_protos,
+                         INT_FEATURE_STRUCT* features, int num_features) {
+  for (int f = 0; f < num_features; ++f) {
+    INT_FEATURE_STRUCT* feature = &features[f];
+    if (NextRand(8) == 0) {
+      feature->X = NextRand(256);
+      feature->Y = NextRand(256);
+      feature->Theta = NextRand(256);
+    } else {
+      const PROTO_STRUCT* proto = &float_protos[NextRand(kNumProtos)];
+      float t = (NextUniform() - 0.5f) * proto->Length;
+      float angle = proto->Angle * 2.0f * PI;
+      int x = static_cast<int>((proto->X + t * cos(angle)) * 256 + 128);
+      int y = static_cast<int>((proto->Y + t * sin(angle)) * 256 + 128);
+      int theta = static_cast<int>(proto->Angle * 256) + NextRand(9) - 4;
+      feature->X = ClipToRange(x + NextRand(5) - 2, 0, 255);
+      feature->Y = ClipToRange(y + NextRand(5) - 2, 0, 255);
+      feature->Theta = (theta + 256) % 256;
+    }
+    feature->CP_misses = 0;
+  }
+}
+
+// Matches all the samples and returns the elapsed cpu time in seconds.
+// The results of the last iteration are written to results.
+static double RunMatcher(IntegerMatcher* matcher, INT_CLASS int_class,
+                         BIT_VECTOR proto_mask, BIT_VECTOR config_mask,
+                         const INT_FEATURE_STRUCT* features, int iterations,
+                         INT_RESULT_STRUCT* results) {
+  clock_t start = clock();
+  for (int i = 0; i < iterations; ++i) {
+    for (int s = 0; s < kNumSamples; ++s) {
+      matcher->Match(int_class, proto_mask, config_mask, kFeaturesPerSample,
+                     features + s * kFeaturesPerSample, &results[s], 0, 0,
+                     false);
+    }
+  }
+  return static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Sums the class weights of the pruner words into class_counts, exactly as
+// the scalar loop in ClassPruner::ComputeScores, with the same arguments as
+// a tesseract::ClassPrunerKernel.
+static void ClassPrunerScalar(const uinT32* words, int num_features,
+                              int words_per_feature, int* class_counts) {
+  for (int f = 0; f < num_features; ++f) {
+    int class_id = 0;
+    for (int w = 0; w < words_per_feature; ++w) {
+      uinT32 pruner_word = *words++;
+      for (int k = 0; k < CLASSES_PER_CP_WERD; ++k) {
+        class_counts[class_id++] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+      }
+    }
+  }
+}
+
+// Runs each class pruner kernel that runs on this cpu over random pruner
+// words, and reports features/sec for each. Returns the number of kernels
+// whose class counts differ from those of the scalar loop.
+static int RunClassPrunerKernels(int iterations) {
+  const int kNumFeatures = kNumSamples * kFeaturesPerSample;
+  const int kNumClasses = kPrunerWordsPerFeature * CLASSES_PER_CP_WERD;
+  uinT32* words = new uinT32[kNumFeatures * kPrunerWordsPerFeature];
+  for (int w = 0; w < kNumFeatures * kPrunerWordsPerFeature; ++w)
+    words[w] = (NextRand(1 << 16) << 16) | NextRand(1 << 16);
+
+  const char* kernel_names[] = { "cp-scalar", "cp-sse2", "cp-avx2",
+                                 "cp-neon" };
+  tesseract::ClassPrunerKernel kernels[] = {
+    ClassPrunerScalar,
+    tesseract::ClassPrunerKernelSSE2(),
+    tesseract::ClassPrunerKernelAVX2(),
+    tesseract::ClassPrunerKernelNEON()
+  };
+  bool cpu_has[] = {
+    true,
+    tesseract::SIMDDetect::IsSSE2Available(),
+    tesseract::SIMDDetect::IsAVX2Available(),
+    tesseract::SIMDDetect::IsNEONAvailable()
+  };
+  const int kNumKernels = sizeof(kernels) / sizeof(kernels[0]);
+  int* scalar_counts = new int[kNumClasses];
+  int* counts = new int[kNumClasses];
+  double total_features = static_cast<double>(iterations) * kNumFeatures;
+  int num_mismatches = 0;
+  for (int k = 0; k < kNumKernels; ++k) {
+    if (kernels[k] == NULL || !cpu_has[k]) {
+      printf("%-9s not available\n", kernel_names[k]);
+      continue;
+    }
+    // A single pass from zero counts is checked, and also warms up the
+    // caches before timing.
+    int* check_counts = k == 0 ? scalar_counts : counts;
+    memset(check_counts, 0, sizeof(*check_counts) * kNumClasses);
+    (*kernels[k])(words, kNumFeatures, kPrunerWordsPerFeature, check_counts);
+    bool mismatch = k != 0 &&
+        memcmp(counts, scalar_counts, sizeof(*counts) * kNumClasses) != 0;
+    clock_t start = clock();
+    for (int i = 0; i < iterations; ++i) {
+      memset(counts, 0, sizeof(*counts) * kNumClasses);
+      (*kernels[k])(words, kNumFeatures, kPrunerWordsPerFeature, counts);
+    }
+    double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    printf("%-9s %10.0f features/sec %s\n", kernel_names[k],
+           seconds > 0.0 ? total_features / seconds : 0.0,
+           mismatch ? "MISMATCH" : "");
+    if (mismatch)
+      ++num_mismatches;
+  }
+
+  delete [] counts;
+  delete [] scalar_counts;
+  delete [] words;
+  return num_mismatches;
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : kDefaultIterations;
+  if (iterations <= 0) {
+    fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+  tesseract::ParamsVectors params;
+  tesseract::IntParam debug_level(0, "intmatchbench_debug_level",
+                                  "Debug level of the matcher", false,
+                                  &params);
+  IntegerMatcher matcher;
+  matcher.Init(&debug_level, 14);
+
+  PROTO_STRUCT* float_protos = new PROTO_STRUCT[kNumProtos];
+  INT_CLASS int_class = MakeClass(float_protos);
+  INT_FEATURE_STRUCT* features =
+      new INT_FEATURE_STRUCT[kNumSamples * kFeaturesPerSample];
+  MakeFeatures(float_protos, features, kNumSamples * kFeaturesPerSample);
+  BIT_VECTOR proto_mask = NewBitVector(MAX_NUM_PROTOS);
+  BIT_VECTOR config_mask = NewBitVector(MAX_NUM_CONFIGS);
+  set_all_bits(proto_mask, WordsInVectorOfSize(MAX_NUM_PROTOS));
+  set_all_bits(config_mask, WordsInVectorOfSize(MAX_NUM_CONFIGS));
+
+  const char* kernel_names[] = { "scalar", "sse2", "avx2", "neon" };
+  tesseract::EvidenceKernel kernels[] = {
+    tesseract::ComputeEvidenceScalar,
+    tesseract::EvidenceKernelSSE2(),
+    tesseract::EvidenceKernelAVX2(),
+    tesseract::EvidenceKernelNEON()
+  };
+  // AVX2 cpus use the SSE2 update kernel, as in EvidenceUpdateKernelForCpu.
+  tesseract::EvidenceUpdateKernel update_kernels[] = {
+    NULL,
+    tesseract::EvidenceUpdateKernelSSE2(),
+    tesseract::EvidenceUpdateKernelSSE2(),
+    tesseract::EvidenceUpdateKernelNEON()
+  };
+  bool cpu_has[] = {
+    true,
+    tesseract::SIMDDetect::IsSSE2Available(),
+    tesseract::SIMDDetect::IsAVX2Available(),
+    tesseract::SIMDDetect::IsNEONAvailable()
+  };
+  const int kNumKernels = sizeof(kernels) / sizeof(kernels[0]);
+  INT_RESULT_STRUCT scalar_results[kNumSamples];
+  INT_RESULT_STRUCT results[kNumSamples];
+  double total_features =
+      static_cast<double>(iterations) * kNumSamples * kFeaturesPerSample;
+  int num_mismatches = 0;
+  for (int k = 0; k < kNumKernels; ++k) {
+    if (kernels[k] == NULL || !cpu_has[k]) {
+      printf("%-8s not available\n", kernel_names[k]);
+      continue;
+    }
+    matcher.SetEvidenceKernels(kernels[k], update_kernels[k]);
+    // Warm up the caches before timing.
+    RunMatcher(&matcher, int_class, proto_mask, config_mask, features, 1,
+               results);
+    double seconds = RunMatcher(&matcher, int_class, proto_mask, config_mask,
+                                features, iterations,
+                                k == 0 ? scalar_results : results);
+    int mismatches = 0;
+    if (k != 0) {
+      for (int s = 0; s < kNumSamples; ++s) {
+        if (results[s].Rating != scalar_results[s].Rating ||
+            results[s].Config != scalar_results[s].Config ||
+            results[s].FeatureMisses != scalar_results[s].FeatureMisses)
+          ++mismatches;
+      }
+    }
+    printf("%-8s %10.0f features/sec %s\n", kernel_names[k],
+           seconds > 0.0 ? total_features / seconds : 0.0,
+           mismatches == 0 ? "" : "MISMATCH");
+    num_mismatches += mismatches;
+  }
+  num_mismatches += RunClassPrunerKernels(iterations);
+
+  FreeBitVector(proto_mask);
+  FreeBitVector(config_mask);
+  delete [] features;
+  delete [] float_protos;
+  free_int_class(int_class);
+  return num_mismatches == 0 ? 0 : 1;
+}
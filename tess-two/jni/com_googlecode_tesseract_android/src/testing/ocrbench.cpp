@@ -0,0 +1,567 @@
+///////////////////////////////////////////////////////////////////////
+// File:        ocrbench.cpp
+// Description: Benchmark of the TessBaseAPI entry points on a page corpus.
+// Created:     Fri Oct 16 23:37:52 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Runs each page of a corpus through each public entry point of
+// TessBaseAPI, and reports for each entry point the pages/sec, the median
+// and 99th percentile latency of a page, the peak resident memory and, for
+// the entry points that return text, the character accuracy against the
+// ground truth of the pages that have one. Each entry point runs in its own
+// child process, so its peak resident memory is not that of an earlier
+// one. It includes the pages of the corpus, which are loaded before the
+// children are started.
+// The results are checked against a budget file, and the program exits
+// with an error if any of them is outside its limit, so it can be used to
+// catch performance and accuracy regressions.
+//
+// The corpus file lists a page per line, as an image file and an optional
+// ground truth text file, both relative to the corpus file. Lines starting
+// with # are ignored. See bench/corpus.txt.
+//
+// The budget file lists a limit per line, as:
+//   mode metric limit
+// where mode is one of the modes below, or * for all the modes that ran, and
+// metric is one of min_pages_per_sec, max_p50_ms, max_p99_ms, max_rss_mb and
+// min_accuracy. A limit on a named mode that could not be run is a failure.
+// See bench/budget.txt.
+//
+// The modes are:
+//   text    SetImage and GetUTF8Text with the tesseract engine.
+//   words   SetImage and GetWords.
+//   layout  SetImage and AnalyseLayout, walking the whole PageIterator.
+//   osd     SetImage and DetectOS, with the osd language.
+//   cube    SetImage and GetUTF8Text with the cube engine.
+//
+// Usage: ocrbench [-tessdata dir] [-l lang] [-iterations n] [-modes list]
+//                 [-budget file] corpus
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "allheaders.h"
+#include "baseapi.h"
+#include "genericvector.h"
+#include "ndminx.h"
+#include "osdetect.h"
+#include "pagestats.h"
+#include "strngs.h"
+#include "unichar.h"
+
+enum BenchMode {
+  BM_TEXT,
+  BM_WORDS,
+  BM_LAYOUT,
+  BM_OSD,
+  BM_CUBE,
+  BM_COUNT
+};
+
+static const char* const kModeNames[BM_COUNT] = {
+  "text", "words", "layout", "osd", "cube"
+};
+
+enum BudgetMetric {
+  BUDGET_MIN_PAGES_PER_SEC,
+  BUDGET_MAX_P50_MS,
+  BUDGET_MAX_P99_MS,
+  BUDGET_MAX_RSS_MB,
+  BUDGET_MIN_ACCURACY,
+  BUDGET_COUNT
+};
+
+static const char* const kMetricNames[BUDGET_COUNT] = {
+  "min_pages_per_sec", "max_p50_ms", "max_p99_ms", "max_rss_mb",
+  "min_accuracy"
+};
+
+// Default number of timed runs of each page in each mode.
+const int kDefaultIterations = 3;
+// Max length of a line of the corpus and budget files.
+const int kMaxLineSize = 1024;
+
+// A page of the corpus.
+struct BenchPage {
+  STRING image_file;
+  Pix* pix;
+  // Ground truth, as unicodes with whitespace collapsed, or empty if none.
+  GenericVector<int> truth;
+};
+
+// The results of a mode.
+struct BenchResult {
+  BenchResult() : ran(false), pages_per_sec(0.0), p50_ms(0.0), p99_ms(0.0),
+                  rss_mb(0.0), accuracy(-1.0) {}
+
+  bool ran;
+  double pages_per_sec;
+  double p50_ms;
+  double p99_ms;
+  double rss_mb;
+  // Percentage of correct characters, or -1 if not measured.
+  double accuracy;
+};
+
+// A limit of the budget file.
+struct BudgetLimit {
+  int mode;  // A BenchMode, or -1 for all.
+  BudgetMetric metric;
+  double limit;
+};
+
+// Appends the unicodes of the utf8 text to unicodes, with each run of
+// whitespace replaced by a single space, and without leading or trailing
+// whitespace, so only the characters and the word breaks are compared.
+static void NormalizeText(const char* utf8, GenericVector<int>* unicodes) {
+  bool pending_space = false;
+  while (*utf8 != '\0') {
+    int step = UNICHAR::utf8_step(utf8);
+    if (step <= 0) {
+      // Skip an invalid byte.
+      ++utf8;
+      continue;
+    }
+    int unicode = UNICHAR(utf8, step).first_uni();
+    utf8 += step;
+    if (unicode == ' ' || unicode == '\t' || unicode == '\n' ||
+        unicode == '\r' || unicode == '\f') {
+      pending_space = !unicodes->empty();
+      continue;
+    }
+    if (pending_space)
+      unicodes->push_back(' ');
+    pending_space = false;
+    unicodes->push_back(unicode);
+  }
+}
+
+// Returns the Levenshtein distance between a and b.
+static int EditDistance(const GenericVector<int>& a,
+                        const GenericVector<int>& b) {
+  // Two rows of the distance matrix.
+  int* prev = new int[b.size() + 1];
+  int* curr = new int[b.size() + 1];
+  for (int j = 0; j <= b.size(); ++j)
+    prev[j] = j;
+  for (int i = 1; i <= a.size(); ++i) {
+    curr[0] = i;
+    for (int j = 1; j <= b.size(); ++j) {
+      int cost = prev[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+      cost = MIN(cost, prev[j] + 1);
+      curr[j] = MIN(cost, curr[j - 1] + 1);
+    }
+    int* row = prev;
+    prev = curr;
+    curr = row;
+  }
+  int distance = prev[b.size()];
+  delete [] prev;
+  delete [] curr;
+  return distance;
+}
+
+// Returns the dir of file, with a trailing slash, or an empty string.
+static STRING DirName(const char* file) {
+  const char* slash = strrchr(file, '/');
+  STRING dir;
+  if (slash != NULL) {
+    for (const char* c = file; c <= slash; ++c)
+      dir += *c;
+  }
+  return dir;
+}
+
+// Returns file, relative to dir unless it is an absolute path.
+static STRING JoinPath(const STRING& dir, const char* file) {
+  if (file[0] == '/')
+    return STRING(file);
+  return dir + file;
+}
+
+// Reads the pages listed in the corpus file. Returns false on error.
+static bool ReadCorpus(const char* corpus_file,
+                       GenericVector<BenchPage>* pages) {
+  FILE* fp = fopen(corpus_file, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "Can't open corpus file %s\n", corpus_file);
+    return false;
+  }
+  STRING dir = DirName(corpus_file);
+  char line[kMaxLineSize];
+  char image_name[kMaxLineSize];
+  char truth_name[kMaxLineSize];
+  bool ok = true;
+  while (ok && fgets(line, kMaxLineSize, fp) != NULL) {
+    if (line[0] == '#')
+      continue;
+    int num_fields = sscanf(line, "%s %s", image_name, truth_name);
+    if (num_fields < 1)
+      continue;
+    BenchPage page;
+    page.image_file = JoinPath(dir, image_name);
+    page.pix = pixRead(page.image_file.string());
+    if (page.pix == NULL) {
+      fprintf(stderr, "Can't read image %s\n", page.image_file.string());
+      ok = false;
+      break;
+    }
+    if (num_fields > 1) {
+      STRING truth_file = JoinPath(dir, truth_name);
+      FILE* truth_fp = fopen(truth_file.string(), "rb");
+      if (truth_fp == NULL) {
+        fprintf(stderr, "Can't open truth file %s\n", truth_file.string());
+        pixDestroy(&page.pix);
+        ok = false;
+        break;
+      }
+      STRING truth;
+      int ch;
+      while ((ch = fgetc(truth_fp)) != EOF)
+        truth += static_cast<char>(ch);
+      fclose(truth_fp);
+      NormalizeText(truth.string(), &page.truth);
+    }
+    pages->push_back(page);
+  }
+  fclose(fp);
+  if (ok && pages->empty()) {
+    fprintf(stderr, "No pages in corpus file %s\n", corpus_file);
+    ok = false;
+  }
+  return ok;
+}
+
+// Reads the limits of the budget file. Returns false on error.
+static bool ReadBudget(const char* budget_file,
+                       GenericVector<BudgetLimit>* limits) {
+  FILE* fp = fopen(budget_file, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "Can't open budget file %s\n", budget_file);
+    return false;
+  }
+  char line[kMaxLineSize];
+  char mode_name[kMaxLineSize];
+  char metric_name[kMaxLineSize];
+  bool ok = true;
+  for (int line_num = 1; fgets(line, kMaxLineSize, fp) != NULL; ++line_num) {
+    if (line[0] == '#')
+      continue;
+    BudgetLimit limit;
+    int num_fields = sscanf(line, "%s %s %lf", mode_name, metric_name,
+                            &limit.limit);
+    if (num_fields <= 0)
+      continue;
+    limit.mode = BM_COUNT;
+    if (strcmp(mode_name, "*") == 0)
+      limit.mode = -1;
+    for (int m = 0; m < BM_COUNT; ++m) {
+      if (strcmp(mode_name, kModeNames[m]) == 0)
+        limit.mode = m;
+    }
+    limit.metric = BUDGET_COUNT;
+    for (int b = 0; b < BUDGET_COUNT; ++b) {
+      if (strcmp(metric_name, kMetricNames[b]) == 0)
+        limit.metric = static_cast<BudgetMetric>(b);
+    }
+    if (num_fields != 3 || limit.mode == BM_COUNT ||
+        limit.metric == BUDGET_COUNT) {
+      fprintf(stderr, "%s:%d: expected a mode, a metric and a limit\n",
+              budget_file, line_num);
+      ok = false;
+      continue;
+    }
+    limits->push_back(limit);
+  }
+  fclose(fp);
+  return ok;
+}
+
+// Initializes api for mode. Returns false if the language data it needs is
+// not available.
+static bool InitMode(BenchMode mode, const char* tessdata, const char* lang,
+                     tesseract::TessBaseAPI* api) {
+  int rc;
+  if (mode == BM_OSD)
+    rc = api->Init(tessdata, "osd", tesseract::OEM_TESSERACT_ONLY);
+  else if (mode == BM_CUBE)
+    rc = api->Init(tessdata, lang, tesseract::OEM_CUBE_ONLY);
+  else
+    rc = api->Init(tessdata, lang, tesseract::OEM_TESSERACT_ONLY);
+  return rc == 0;
+}
+
+// Runs the page through the entry point of mode. If the mode returns text,
+// adds the edit distance to the ground truth of the page, if any, to
+// *errors and the length of the ground truth to *chars.
+static void RunPage(BenchMode mode, const BenchPage& page,
+                    tesseract::TessBaseAPI* api, int* errors, int* chars) {
+  api->SetImage(page.pix);
+  if (mode == BM_TEXT || mode == BM_CUBE) {
+    char* text = api->GetUTF8Text();
+    if (text != NULL && !page.truth.empty()) {
+      GenericVector<int> unicodes;
+      NormalizeText(text, &unicodes);
+      *errors += EditDistance(unicodes, page.truth);
+      *chars += page.truth.size();
+    }
+    delete [] text;
+  } else if (mode == BM_WORDS) {
+    Pixa* pixa = NULL;
+    Boxa* boxa = api->GetWords(&pixa);
+    boxaDestroy(&boxa);
+    pixaDestroy(&pixa);
+  } else if (mode == BM_LAYOUT) {
+    tesseract::PageIterator* it = api->AnalyseLayout();
+    if (it != NULL) {
+      int left, top, right, bottom;
+      do {
+        it->BoundingBox(tesseract::RIL_WORD, &left, &top, &right, &bottom);
+      } while (it->Next(tesseract::RIL_WORD));
+      delete it;
+    }
+  } else if (mode == BM_OSD) {
+    OSResults osr;
+    api->DetectOS(&osr);
+  }
+}
+
+// Runs all the pages through mode iterations times, after an untimed warm
+// up run of the first page. The rss_mb of the result is left 0.
+static BenchResult RunMode(BenchMode mode, const char* tessdata,
+                           const char* lang, int iterations,
+                           const GenericVector<BenchPage>& pages) {
+  BenchResult result;
+  tesseract::TessBaseAPI api;
+  if (!InitMode(mode, tessdata, lang, &api))
+    return result;
+  int errors = 0;
+  int chars = 0;
+  RunPage(mode, pages[0], &api, &errors, &chars);
+  errors = 0;
+  chars = 0;
+  GenericVector<double> latencies;
+  inT64 start_usecs = tesseract::PageStats::NowMicros();
+  for (int i = 0; i < iterations; ++i) {
+    for (int p = 0; p < pages.size(); ++p) {
+      inT64 page_start_usecs = tesseract::PageStats::NowMicros();
+      RunPage(mode, pages[p], &api, &errors, &chars);
+      latencies.push_back(
+          (tesseract::PageStats::NowMicros() - page_start_usecs) / 1000.0);
+    }
+  }
+  double seconds = (tesseract::PageStats::NowMicros() - start_usecs) / 1e6;
+  api.End();
+
+  result.ran = true;
+  result.pages_per_sec = seconds > 0.0 ? latencies.size() / seconds : 0.0;
+  latencies.sort();
+  // Nearest rank percentiles.
+  result.p50_ms = latencies[(latencies.size() - 1) / 2];
+  result.p99_ms = latencies[(latencies.size() * 99 + 99) / 100 - 1];
+  if (chars > 0)
+    result.accuracy = 100.0 * MAX(chars - errors, 0) / chars;
+  return result;
+}
+
+// Runs RunMode in a child process and returns its results, with rss_mb set
+// to the peak resident memory of the child in MB. Where there is no fork,
+// RunMode runs in this process and rss_mb is left 0.
+static BenchResult RunModeInChild(BenchMode mode, const char* tessdata,
+                                  const char* lang, int iterations,
+                                  const GenericVector<BenchPage>& pages) {
+#ifdef _WIN32
+  return RunMode(mode, tessdata, lang, iterations, pages);
+#else
+  BenchResult result;
+  int fds[2];
+  if (pipe(fds) != 0) {
+    perror("pipe");
+    return result;
+  }
+  // Don't let the child write out what this has buffered so far.
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    close(fds[0]);
+    close(fds[1]);
+    return result;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    BenchResult child_result = RunMode(mode, tessdata, lang, iterations,
+                                       pages);
+    bool written = write(fds[1], &child_result, sizeof(child_result)) ==
+        static_cast<ssize_t>(sizeof(child_result));
+    fflush(stdout);
+    fflush(stderr);
+    _exit(written ? 0 : 1);
+  }
+  close(fds[1]);
+  BenchResult child_result;
+  bool read_ok = read(fds[0], &child_result, sizeof(child_result)) ==
+      static_cast<ssize_t>(sizeof(child_result));
+  close(fds[0]);
+  int status;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) ||
+      WEXITSTATUS(status) != 0 || !read_ok) {
+    fprintf(stderr, "Mode %s did not complete\n", kModeNames[mode]);
+    return result;
+  }
+  result = child_result;
+  // ru_maxrss is in KB on Linux.
+  result.rss_mb = usage.ru_maxrss / 1024.0;
+  return result;
+#endif
+}
+
+// Returns the value of metric in result.
+static double MetricValue(const BenchResult& result, BudgetMetric metric) {
+  switch (metric) {
+    case BUDGET_MIN_PAGES_PER_SEC: return result.pages_per_sec;
+    case BUDGET_MAX_P50_MS: return result.p50_ms;
+    case BUDGET_MAX_P99_MS: return result.p99_ms;
+    case BUDGET_MAX_RSS_MB: return result.rss_mb;
+    default: return result.accuracy;
+  }
+}
+
+// Checks the results against the limits and prints the failures. Returns
+// the number of failures.
+static int CheckBudget(const GenericVector<BudgetLimit>& limits,
+                       const BenchResult* results) {
+  int failures = 0;
+  for (int l = 0; l < limits.size(); ++l) {
+    const BudgetLimit& limit = limits[l];
+    for (int m = 0; m < BM_COUNT; ++m) {
+      if (limit.mode != m && (limit.mode != -1 || !results[m].ran))
+        continue;
+      const char* metric_name = kMetricNames[limit.metric];
+      if (!results[m].ran) {
+        printf("FAIL %s %s: mode did not run\n", kModeNames[m], metric_name);
+        ++failures;
+        continue;
+      }
+      double value = MetricValue(results[m], limit.metric);
+      if (limit.metric == BUDGET_MIN_ACCURACY && value < 0.0) {
+        printf("FAIL %s %s: no ground truth\n", kModeNames[m], metric_name);
+        ++failures;
+        continue;
+      }
+      bool is_min = limit.metric == BUDGET_MIN_PAGES_PER_SEC ||
+                    limit.metric == BUDGET_MIN_ACCURACY;
+      if (is_min ? value < limit.limit : value > limit.limit) {
+        printf("FAIL %s %s: %.2f, limit %.2f\n", kModeNames[m], metric_name,
+               value, limit.limit);
+        ++failures;
+      }
+    }
+  }
+  return failures;
+}
+
+static void Usage(const char* program) {
+  fprintf(stderr, "Usage: %s [-tessdata dir] [-l lang] [-iterations n]"
+          " [-modes text,words,layout,osd,cube] [-budget file] corpus\n",
+          program);
+}
+
+int main(int argc, char** argv) {
+  const char* tessdata = NULL;
+  const char* lang = "eng";
+  const char* modes = NULL;
+  const char* budget_file = NULL;
+  const char* corpus_file = NULL;
+  int iterations = kDefaultIterations;
+  for (int arg = 1; arg < argc; ++arg) {
+    if (strcmp(argv[arg], "-tessdata") == 0 && arg + 1 < argc) {
+      tessdata = argv[++arg];
+    } else if (strcmp(argv[arg], "-l") == 0 && arg + 1 < argc) {
+      lang = argv[++arg];
+    } else if (strcmp(argv[arg], "-iterations") == 0 && arg + 1 < argc) {
+      iterations = atoi(argv[++arg]);
+    } else if (strcmp(argv[arg], "-modes") == 0 && arg + 1 < argc) {
+      modes = argv[++arg];
+    } else if (strcmp(argv[arg], "-budget") == 0 && arg + 1 < argc) {
+      budget_file = argv[++arg];
+    } else if (argv[arg][0] != '-' && corpus_file == NULL) {
+      corpus_file = argv[arg];
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (corpus_file == NULL || iterations <= 0) {
+    Usage(argv[0]);
+    return 1;
+  }
+  bool run_modes[BM_COUNT];
+  for (int m = 0; m < BM_COUNT; ++m) {
+    run_modes[m] = modes == NULL;
+    if (modes != NULL) {
+      // Find the mode name as a whole item of the comma separated list.
+      int len = strlen(kModeNames[m]);
+      for (const char* item = modes; item != NULL;
+           item = strchr(item, ',') != NULL ? strchr(item, ',') + 1 : NULL) {
+        if (strncmp(item, kModeNames[m], len) == 0 &&
+            (item[len] == ',' || item[len] == '\0'))
+          run_modes[m] = true;
+      }
+    }
+  }
+  GenericVector<BudgetLimit> limits;
+  if (budget_file != NULL && !ReadBudget(budget_file, &limits))
+    return 1;
+  GenericVector<BenchPage> pages;
+  bool ok = ReadCorpus(corpus_file, &pages);
+
+  BenchResult results[BM_COUNT];
+  if (ok) {
+    printf("%-8s %10s %10s %10s %10s %10s\n", "mode", "pages/sec",
+           "p50 ms", "p99 ms", "rss MB", "accuracy");
+    for (int m = 0; m < BM_COUNT; ++m) {
+      if (!run_modes[m])
+        continue;
+      results[m] = RunModeInChild(static_cast<BenchMode>(m), tessdata, lang,
+                                  iterations, pages);
+      const BenchResult& result = results[m];
+      if (!result.ran) {
+        printf("%-8s not available\n", kModeNames[m]);
+        continue;
+      }
+      printf("%-8s %10.2f %10.1f %10.1f %10.1f", kModeNames[m],
+             result.pages_per_sec, result.p50_ms, result.p99_ms,
+             result.rss_mb);
+      if (result.accuracy >= 0.0)
+        printf(" %9.2f%%\n", result.accuracy);
+      else
+        printf(" %10s\n", "-");
+    }
+  }
+  for (int p = 0; p < pages.size(); ++p)
+    pixDestroy(&pages[p].pix);
+  if (!ok)
+    return 1;
+  return CheckBudget(limits, results) == 0 ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////
+// File:        thresholdbench.cpp
+// Description: Micro-benchmark and check of the banded, multi-threaded
+//              Otsu thresholding of ImageThresholder.
+// Created:     Fri Oct 16 09:12:40 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Thresholds a fixed, pseudo-randomly generated page of dark text-like
+// strokes on a noisy light background with ImageThresholder::ThresholdToPix,
+// for grey, RGB and RGBA images and for a sub-rectangle of each, with 1, 2,
+// 3, 4 and 8 threads, and reports megapixels/sec for each.
+// Every result is checked bit for bit against a reference made on the
+// calling thread alone, from the single-threaded Otsu thresholds and the
+// pixel by pixel test of IsBlackPixel, and the program exits with an error
+// if any of them differ.
+//
+// Usage: thresholdbench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "allheaders.h"
+#include "host.h"
+#include "ndminx.h"
+#include "otsuthr.h"
+#include "pagestats.h"
+#include "thresholder.h"
+#include "thresholdsimd.h"
+
+// Size of the page. The width is not a multiple of 32, so the last word of
+// each row is partial.
+const int kPageWidth = 2047;
+const int kPageHeight = 1531;
+// The sub-rectangle, which starts inside a word and a band.
+const int kRectLeft = 101;
+const int kRectTop = 77;
+const int kRectWidth = 1203;
+const int kRectHeight = 899;
+// Default number of thresholdings of each image for each thread count.
+const int kDefaultIterations = 10;
+
+// Fixed-seed linear congruential generator, so the data is the same on
+// every run and platform.
+static unsigned int rand_state = 12345;
+static int NextRand(int range) {
+  rand_state = rand_state * 1103515245 + 12345;
+  return (rand_state >> 8) % range;
+}
+
+// Makes a page of bytes_per_pixel bytes per pixel, with rows padded to a
+// multiple of 4 bytes. Delete [] after use.
+static uinT8* MakePage(int bytes_per_pixel, int* bytes_per_line) {
+  *bytes_per_line = (kPageWidth * bytes_per_pixel + 3) & ~3;
+  int size = *bytes_per_line * kPageHeight;
+  uinT8* page = new uinT8[size];
+  for (int i = 0; i < size; ++i)
+    page[i] = 200 + NextRand(56);
+  // Dark horizontal and vertical strokes, like the parts of characters.
+  int num_strokes = kPageWidth * kPageHeight / 400;
+  for (int s = 0; s < num_strokes; ++s) {
+    int x = NextRand(kPageWidth);
+    int y = NextRand(kPageHeight);
+    bool vertical = NextRand(2) != 0;
+    int length = 4 + NextRand(20);
+    for (int i = 0; i < length; ++i) {
+      int px = vertical ? x : MIN(x + i, kPageWidth - 1);
+      int py = vertical ? MIN(y + i, kPageHeight - 1) : y;
+      uinT8* pixel = page + py * *bytes_per_line + px * bytes_per_pixel;
+      for (int ch = 0; ch < bytes_per_pixel; ++ch)
+        pixel[ch] = NextRand(80);
+    }
+  }
+  return page;
+}
+
+// Thresholds the given rectangle of the page on the calling thread, with
+// the scalar code only.
+static Pix* ReferenceThreshold(const uinT8* page, int bytes_per_pixel,
+                               int bytes_per_line, int left, int top,
+                               int width, int height) {
+  int* thresholds;
+  int* hi_values;
+  tesseract::OtsuThreshold(page, bytes_per_pixel, bytes_per_line,
+                           left, top, width, height,
+                           &thresholds, &hi_values);
+  tesseract::ThresholdRowParams params;
+  params.bytes_per_pixel = bytes_per_pixel;
+  for (int ch = 0; ch < bytes_per_pixel; ++ch) {
+    params.thresholds[ch] = thresholds[ch];
+    params.hi_values[ch] = hi_values[ch];
+  }
+  delete [] thresholds;
+  delete [] hi_values;
+  Pix* pix = pixCreate(width, height, 1);
+  for (int y = 0; y < height; ++y) {
+    const uinT8* row = page + (top + y) * bytes_per_line +
+                       left * bytes_per_pixel;
+    for (int x = 0; x < width; ++x) {
+      if (tesseract::IsBlackPixel(params, row + x * bytes_per_pixel))
+        pixSetPixel(pix, x, y, 1);
+    }
+  }
+  return pix;
+}
+
+// Thresholds the given rectangle of the page iterations times with
+// num_threads threads, checks each result against reference, and returns
+// the number of mismatches. *seconds is set to the time taken.
+static int RunThresholder(const uinT8* page, int bytes_per_pixel,
+                          int bytes_per_line, int left, int top,
+                          int width, int height, int num_threads,
+                          int iterations, Pix* reference, double* seconds) {
+  tesseract::ImageThresholder thresholder;
+  thresholder.SetImage(page, kPageWidth, kPageHeight, bytes_per_pixel,
+                       bytes_per_line);
+  thresholder.SetRectangle(left, top, width, height);
+  thresholder.SetNumThreads(num_threads);
+  int mismatches = 0;
+  inT64 start_usecs = tesseract::PageStats::NowMicros();
+  for (int i = 0; i < iterations; ++i) {
+    Pix* pix = NULL;
+    thresholder.ThresholdToPix(&pix);
+    l_int32 same = 0;
+    if (pix == NULL || pixEqual(pix, reference, &same) != 0 || !same)
+      ++mismatches;
+    pixDestroy(&pix);
+  }
+  *seconds = (tesseract::PageStats::NowMicros() - start_usecs) / 1e6;
+  return mismatches;
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : kDefaultIterations;
+  if (iterations <= 0) {
+    fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+  const int kBytesPerPixel[] = { 1, 3, 4 };
+  const int kNumThreads[] = { 1, 2, 3, 4, 8 };
+  const int kNumImages = sizeof(kBytesPerPixel) / sizeof(kBytesPerPixel[0]);
+  const int kNumThreadCounts = sizeof(kNumThreads) / sizeof(kNumThreads[0]);
+  int num_mismatches = 0;
+  for (int i = 0; i < kNumImages; ++i) {
+    int bytes_per_pixel = kBytesPerPixel[i];
+    int bytes_per_line;
+    uinT8* page = MakePage(bytes_per_pixel, &bytes_per_line);
+    for (int r = 0; r < 2; ++r) {
+      int left = r == 0 ? 0 : kRectLeft;
+      int top = r == 0 ? 0 : kRectTop;
+      int width = r == 0 ? kPageWidth : kRectWidth;
+      int height = r == 0 ? kPageHeight : kRectHeight;
+      Pix* reference = ReferenceThreshold(page, bytes_per_pixel,
+                                          bytes_per_line, left, top,
+                                          width, height);
+      for (int t = 0; t < kNumThreadCounts; ++t) {
+        double seconds;
+        int mismatches = RunThresholder(page, bytes_per_pixel, bytes_per_line,
+                                        left, top, width, height,
+                                        kNumThreads[t], iterations,
+                                        reference, &seconds);
+        double megapixels =
+            static_cast<double>(iterations) * width * height / 1e6;
+        printf("%d bpp %-4s %d threads %8.1f Mpixels/sec %s\n",
+               bytes_per_pixel * 8, r == 0 ? "page" : "rect", kNumThreads[t],
+               seconds > 0.0 ? megapixels / seconds : 0.0,
+               mismatches == 0 ? "" : "MISMATCH");
+        num_mismatches += mismatches;
+      }
+      pixDestroy(&reference);
+    }
+    delete [] page;
+  }
+  return num_mismatches == 0 ? 0 : 1;
+}
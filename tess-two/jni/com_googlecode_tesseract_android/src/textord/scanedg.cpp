@@ -26,55 +26,135 @@
                                  /*W->B->W */
 #define FLIP_COLOUR(pix)  (1-(pix))
 
+/**********************************************************************
+ * count_leading_zeros
+ *
+ * Return the number of zero bits above the highest set bit of a nonzero
+ * word.
+ **********************************************************************/
+
+static inline int count_leading_zeros(uinT32 word) {
+#ifdef __GNUC__
+  return __builtin_clz(word);
+#else
+  int count = 0;
+  while ((word & 0x80000000u) == 0) {
+    word <<= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
 /**********************************************************************
  * block_edges
  *
  * Extract edges from a PDBLK.
  **********************************************************************/
 
-void block_edges(IMAGE *t_image,       // thresholded image
+void block_edges(Pix *t_pix,           // thresholded image
                  PDBLK *block,         // block in image
                  C_OUTLINE_IT* outline_it) {
-  uinT8 margin;                  // margin colour
-  inT16 x;                       // line coords
-  inT16 y;                       // current line
   ICOORD bleft;                  // bounding box
   ICOORD tright;
-  ICOORD block_bleft;            // bounding box
-  ICOORD block_tright;
-  int xindex;                    // index to pixel
   BLOCK_LINE_IT line_it = block; // line iterator
-  IMAGELINE bwline;              // thresholded line
-                                 // lines in progress
-  CRACKEDGE **ptrline = new CRACKEDGE*[t_image->get_xsize()+1];
-  CRACKEDGE *free_cracks = NULL;
-
-  block->bounding_box(bleft, tright);  // block box
-  block_bleft = bleft;
-  block_tright = tright;
-  for (x = tright.x() - bleft.x(); x >= 0; x--)
-    ptrline[x] = NULL;           //no lines in progress
-
-  bwline.init(t_image->get_xsize());
 
-  margin = WHITE_PIX;
+  ASSERT_HOST(pixGetDepth(t_pix) == 1);
+  int height = pixGetHeight(t_pix);
+  int wpl = pixGetWpl(t_pix);
+  l_uint32* data = pixGetData(t_pix);
 
-  for (y = tright.y() - 1; y >= bleft.y() - 1; y--) {
-    if (y >= block_bleft.y() && y < block_tright.y()) {
-      t_image->get_line(bleft.x(), y, tright.x() - bleft.x(), &bwline, 0);
-      make_margins(block, &line_it, bwline.pixels, margin, bleft.x(),
+  block->bounding_box(bleft, tright);  // block box
+  int width = tright.x() - bleft.x();
+                                 // lines in progress
+  CRACKEDGE **ptrline = new CRACKEDGE*[width + 1];
+  CRACKEDGE *free_cracks = NULL;
+  for (int x = width; x >= 0; x--)
+    ptrline[x] = NULL;           // no lines in progress
+
+  // Thresholded lines, packed 32 pixels per word. The line above starts
+  // as all margin, like the nonexistent line above the block.
+  int line_wpl = (width + 31) / 32;
+  uinT32* bwline = new uinT32[line_wpl];
+  uinT32* upperline = new uinT32[line_wpl];
+  fill_line_bits(upperline, 0, line_wpl * 32, WHITE_PIX);
+
+  for (int y = tright.y() - 1; y >= bleft.y() - 1; y--) {
+    if (y >= bleft.y() && y < tright.y()) {
+      // Pix rows run top down, and a set bit is black.
+      get_line_bits(data + (height - 1 - y) * wpl, wpl, bleft.x(), width,
+                    bwline);
+      make_margins(block, &line_it, bwline, WHITE_PIX, bleft.x(),
                    tright.x(), y);
     } else {
-      x = tright.x() - bleft.x();
-      for (xindex = 0; xindex < x; xindex++)
-        bwline.pixels[xindex] = margin;
+      fill_line_bits(bwline, 0, width, WHITE_PIX);
     }
-    line_edges(bleft.x(), y, tright.x() - bleft.x(),
-               margin, bwline.pixels, ptrline, &free_cracks, outline_it);
+    line_edges(bleft.x(), y, width, WHITE_PIX, bwline, upperline,
+               ptrline, &free_cracks, outline_it);
+    uinT32* tmp = upperline;
+    upperline = bwline;
+    bwline = tmp;
   }
 
   free_crackedges(free_cracks);  // really free them
   delete[] ptrline;
+  delete[] bwline;
+  delete[] upperline;
+}
+
+
+/**********************************************************************
+ * get_line_bits
+ *
+ * Copy xext pixels from x of a 1 bpp Pix row into a packed line in
+ * thresholded colours, ie inverted so that WHITE_PIX is a set bit.
+ **********************************************************************/
+
+void get_line_bits(const l_uint32 *pixline,   // row of Pix data
+                   int wpl,                   // words in pixline
+                   int x,                     // first pixel to copy
+                   int xext,                  // pixels to copy
+                   uinT32 *bwline) {          // packed line
+  int shift = x & 31;
+  const l_uint32* src = pixline + (x >> 5);
+  const l_uint32* src_end = pixline + wpl;
+  int line_wpl = (xext + 31) / 32;
+  for (int i = 0; i < line_wpl; ++i, ++src) {
+    uinT32 word = *src << shift;
+    if (shift != 0 && src + 1 < src_end)
+      word |= src[1] >> (32 - shift);
+    bwline[i] = ~word;
+  }
+}
+
+
+/**********************************************************************
+ * fill_line_bits
+ *
+ * Set the pixels [start, end) of a packed line to the given colour.
+ **********************************************************************/
+
+void fill_line_bits(uinT32 *bwline,       // packed line
+                    int start,            // first pixel to set
+                    int end,              // end of pixels to set
+                    uinT8 colour) {       // colour to set
+  if (start >= end)
+    return;
+  int first = start >> 5;
+  int last = (end - 1) >> 5;
+  uinT32 first_mask = 0xffffffffu >> (start & 31);
+  uinT32 last_mask = 0xffffffffu << (31 - ((end - 1) & 31));
+  for (int i = first; i <= last; ++i) {
+    uinT32 mask = 0xffffffffu;
+    if (i == first)
+      mask &= first_mask;
+    if (i == last)
+      mask &= last_mask;
+    if (colour == WHITE_PIX)
+      bwline[i] |= mask;
+    else
+      bwline[i] &= ~mask;
+  }
 }
 
 
@@ -87,7 +167,7 @@ void block_edges(IMAGE *t_image,       // thresholded image
 void make_margins(                         //get a line
                   PDBLK *block,            //block in image
                   BLOCK_LINE_IT *line_it,  //for old style
-                  uinT8 *pixels,           //pixels to strip
+                  uinT32 *bwline,          //packed pixels to strip
                   uinT8 margin,            //white-out pixel
                   inT16 left,              //block edges
                   inT16 right,
@@ -108,30 +188,39 @@ void make_margins(                         //get a line
       seg_it.mark_cycle_pt ();
       start = seg_it.data ()->x ();
       xext = seg_it.data ()->y ();
-      for (xindex = left; xindex < right; xindex++) {
-        if (xindex >= start && !seg_it.cycled_list ()) {
-          xindex = start + xext - 1;
+      xindex = left;
+      while (xindex < right) {
+        if (seg_it.cycled_list ()) {
+                                 //no more segments
+          fill_line_bits (bwline, xindex - left, right - left, margin);
+          xindex = right;
+        }
+        else if (xindex >= start) {
+                                 //skip the segment
+          xindex = start + xext;
           seg_it.forward ();
           start = seg_it.data ()->x ();
           xext = seg_it.data ()->y ();
         }
-        else
-          pixels[xindex - left] = margin;
+        else {
+                                 //margin up to segment
+          fill_line_bits (bwline, xindex - left,
+                          MIN (start, right) - left, margin);
+          xindex = MIN (start, right);
+        }
       }
     }
     else {
-      for (xindex = left; xindex < right; xindex++)
-        pixels[xindex - left] = margin;
+      fill_line_bits (bwline, 0, right - left, margin);
     }
     delete segments;
     delete lines;
   }
   else {
     start = line_it->get_line (y, xext);
-    for (xindex = left; xindex < start; xindex++)
-      pixels[xindex - left] = margin;
-    for (xindex = start + xext; xindex < right; xindex++)
-      pixels[xindex - left] = margin;
+    fill_line_bits (bwline, 0, MIN (start, right) - left, margin);
+    fill_line_bits (bwline, MAX (start + xext, left) - left, right - left,
+                    margin);
   }
 }
 
@@ -173,70 +262,102 @@ void whiteout_block(                 //clean it
  *
  * Scan a line for edges and update the edges in progress.
  * When edges close into loops, send them for approximation.
+ * Only pixels that differ from the pixel to the left, the pixel above, or
+ * the pixel above and to the left from the pixel above are visited. In the
+ * flat runs between them nothing changes except that any horizontal edge
+ * in progress ends, so the runs are skipped a word at a time.
  **********************************************************************/
 
 void line_edges(inT16 x,                         // coord of line start
                 inT16 y,                         // coord of line
                 inT16 xext,                      // width of line
                 uinT8 uppercolour,               // start of prev line
-                uinT8 * bwpos,                   // thresholded line
+                const uinT32 *bwline,            // packed thresholded line
+                const uinT32 *upperline,         // packed previous line
                 CRACKEDGE ** prevline,           // edges in progress
                 CRACKEDGE **free_cracks,
                 C_OUTLINE_IT* outline_it) {
   CrackPos pos = {free_cracks, x, y };
-  int xmax;                      // max x coord
   int colour;                    // of current pixel
   int prevcolour;                // of previous pixel
+  int next_index;                // of pixel after last visited
   CRACKEDGE *current;            // current h edge
   CRACKEDGE *newcurrent;         // new h edge
+  CRACKEDGE **edge;              // edge in progress at pixel
+  uinT32 left_carry;             // last pixel of previous word
+  uinT32 upper_carry;            // same in previous line
 
-  xmax = x + xext;               // max allowable coord
   prevcolour = uppercolour;      // forced plain margin
   current = NULL;                // nothing yet
-
-                                 // do each pixel
-  for (; pos.x < xmax; pos.x++, prevline++) {
-    colour = *bwpos++;           // current pixel
-    if (*prevline != NULL) {
+  next_index = 0;
+  left_carry = upper_carry = uppercolour;
+  int line_wpl = (xext + 31) / 32;
+  for (int w = 0; w < line_wpl; ++w) {
+    uinT32 bits = bwline[w];
+    uinT32 upper = upperline[w];
+                                 // pixels that need a visit
+    uinT32 changes = (bits ^ (bits >> 1 | left_carry << 31)) |
+                     (upper ^ (upper >> 1 | upper_carry << 31)) |
+                     (bits ^ upper);
+    left_carry = bits & 1;
+    upper_carry = upper & 1;
+    if (w == line_wpl - 1 && (xext & 31) != 0)
+      changes &= 0xffffffffu << (32 - (xext & 31));
+    while (changes != 0) {
+      int bit = count_leading_zeros(changes);
+      changes &= ~(0x80000000u >> bit);
+      int index = w * 32 + bit;
+      if (index != next_index)
+        current = NULL;          // skipped a plain run
+      next_index = index + 1;
+      pos.x = x + index;
+      edge = prevline + index;
+      colour = (bits >> (31 - bit)) & 1;
+      if (*edge != NULL) {
                                  // changed above
                                  // change colour
-      uppercolour = FLIP_COLOUR(uppercolour);
-      if (colour == prevcolour) {
-        if (colour == uppercolour) {
+        uppercolour = FLIP_COLOUR(uppercolour);
+        if (colour == prevcolour) {
+          if (colour == uppercolour) {
                                  // finish a line
-          join_edges(current, *prevline, free_cracks, outline_it);
-          current = NULL;        // no edge now
-        } else {
+            join_edges(current, *edge, free_cracks, outline_it);
+            current = NULL;      // no edge now
+          } else {
                                  // new horiz edge
-          current = h_edge(uppercolour - colour, *prevline, &pos);
+            current = h_edge(uppercolour - colour, *edge, &pos);
+          }
+          *edge = NULL;          // no change this time
+        } else {
+          if (colour == uppercolour)
+            *edge = v_edge(colour - prevcolour, *edge, &pos);
+                                 // 8 vs 4 connection
+          else if (colour == WHITE_PIX) {
+            join_edges(current, *edge, free_cracks, outline_it);
+            current = h_edge(uppercolour - colour, NULL, &pos);
+            *edge = v_edge(colour - prevcolour, current, &pos);
+          } else {
+            newcurrent = h_edge(uppercolour - colour, *edge, &pos);
+            *edge = v_edge(colour - prevcolour, current, &pos);
+            current = newcurrent;  // right going h edge
+          }
+          prevcolour = colour;   // remember new colour
         }
-        *prevline = NULL;        // no change this time
       } else {
-        if (colour == uppercolour)
-          *prevline = v_edge(colour - prevcolour, *prevline, &pos);
-                                 // 8 vs 4 connection
-        else if (colour == WHITE_PIX) {
-          join_edges(current, *prevline, free_cracks, outline_it);
-          current = h_edge(uppercolour - colour, NULL, &pos);
-          *prevline = v_edge(colour - prevcolour, current, &pos);
-        } else {
-          newcurrent = h_edge(uppercolour - colour, *prevline, &pos);
-          *prevline = v_edge(colour - prevcolour, current, &pos);
-          current = newcurrent;  // right going h edge
+        if (colour != prevcolour) {
+          *edge = current = v_edge(colour - prevcolour, current, &pos);
+          prevcolour = colour;
         }
-        prevcolour = colour;     // remember new colour
-      }
-    } else {
-      if (colour != prevcolour) {
-        *prevline = current = v_edge(colour - prevcolour, current, &pos);
-        prevcolour = colour;
+        if (colour != uppercolour)
+          current = h_edge(uppercolour - colour, current, &pos);
+        else
+          current = NULL;        // no edge now
       }
-      if (colour != uppercolour)
-        current = h_edge(uppercolour - colour, current, &pos);
-      else
-        current = NULL;          // no edge now
     }
   }
+  if (next_index != xext)
+    current = NULL;              // ended in a plain run
+  pos.x = x + xext;
+  prevline += xext;
   if (current != NULL) {
                                  // out of block
     if (*prevline != NULL) {     // got one to join to?
@@ -25,6 +25,7 @@
 #include          "img.h"
 #include          "pdblock.h"
 #include          "crakedge.h"
+#include          "allheaders.h"
 
 class C_OUTLINE_IT;
 
@@ -34,12 +35,21 @@ struct CrackPos {
   int y;
 };
 
-void block_edges(IMAGE *t_image,       // thresholded image
+void block_edges(Pix *t_pix,           // thresholded image
                  PDBLK *block,         // block in image
                  C_OUTLINE_IT* outline_it);
+void get_line_bits(const l_uint32 *pixline,  // row of Pix data
+                   int wpl,                  // words in pixline
+                   int x,                    // first pixel to copy
+                   int xext,                 // pixels to copy
+                   uinT32 *bwline);          // packed line
+void fill_line_bits(uinT32 *bwline,          // packed line
+                    int start,               // first pixel to set
+                    int end,                 // end of pixels to set
+                    uinT8 colour);           // colour to set
 void make_margins(PDBLK *block,            // block in image
                   BLOCK_LINE_IT *line_it,  // for old style
-                  uinT8 *pixels,           // pixels to strip
+                  uinT32 *bwline,          // packed pixels to strip
                   uinT8 margin,            // white-out pixel
                   inT16 left,              // block edges
                   inT16 right,
@@ -50,7 +60,8 @@ void line_edges(inT16 x,                     // coord of line start
                 inT16 y,                     // coord of line
                 inT16 xext,                  // width of line
                 uinT8 uppercolour,           // start of prev line
-                uinT8 * bwpos,               // thresholded line
+                const uinT32 *bwline,        // packed thresholded line
+                const uinT32 *upperline,     // packed previous line
                 CRACKEDGE ** prevline,       // edges in progress
                 CRACKEDGE **free_cracks,
                 C_OUTLINE_IT* outline_it);
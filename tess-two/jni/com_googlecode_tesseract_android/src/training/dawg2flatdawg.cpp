@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dawg2flatdawg.cpp
+// Description: Program to convert a DAWG to the flat dawg format.
+// Created:     Fri Oct 16 17:05:33 PDT 2026
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// The flat format can be used in place from a memory mapped traineddata
+// file. To convert the dawgs of an existing traineddata file, unpack it with
+// combine_tessdata -u, convert each of its dawgs, and put them back with
+// combine_tessdata -o, which also aligns them in the traineddata file.
+
+#include "dawg.h"
+#include "host.h"
+#include "tprintf.h"
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    tprintf("Convert a dawg in either format to the flat dawg format.\n");
+    tprintf("Usage: %s <dawgfile> <flatdawgfile>\n", argv[0]);
+    return 1;
+  }
+  const char *dawg_file = argv[1];
+  const char *flat_dawg_file = argv[2];
+  FILE *in = fopen(dawg_file, "rb");
+  if (in == NULL) {
+    tprintf("Could not open %s for reading.\n", dawg_file);
+    return 1;
+  }
+  // The type, language and permuter of the dawg are not stored in the file,
+  // so any will do.
+  tesseract::SquishedDawg dawg(in, tesseract::DAWG_TYPE_WORD, "", NO_PERM, 0);
+  fclose(in);
+  FILE *out = fopen(flat_dawg_file, "wb");
+  if (out == NULL) {
+    tprintf("Could not open %s for writing.\n", flat_dawg_file);
+    return 1;
+  }
+  dawg.write_squished_dawg(out, true);
+  tprintf("Wrote %d edges to %s\n", dawg.NumEdges(), flat_dawg_file);
+  return fclose(out);
+}
@@ -747,6 +747,7 @@ void Wordrec::improve_by_chopping(WERD_RES *word,
   inT32 blob_number;
   float old_best;
   bool updated_best_choice = false;
+  PageStageTimer timer(&page_stats, PS_CHOPPER);
 
   while (1) {  // improvement loop
     old_best = word->best_choice->rating();
@@ -755,6 +756,7 @@ void Wordrec::improve_by_chopping(WERD_RES *word,
                          fixpt, (fragments_guide_chopper &&
                                  word->best_choice->fragment_mark()),
                                  word->blamer_bundle)) {
+      page_stats.Count(PC_CHOPS);
       getDict().LogNewSplit(blob_number);
       updated_best_choice =
         getDict().permute_characters(*char_choices, word->best_choice,
@@ -38,6 +38,7 @@ void Wordrec::SegSearch(CHUNKS_RECORD *chunks_record,
                         WERD_CHOICE *raw_choice,
                         STATE *output_best_state,
                         BlamerBundle *blamer_bundle) {
+  PageStageTimer timer(&page_stats, PS_SEG_SEARCH);
   int row, col = 0;
   if (segsearch_debug_level > 0) {
     tprintf("Starting SegSearch on ratings matrix:\n");
@@ -261,6 +262,7 @@ void Wordrec::ProcessSegSearchPainPoint(float pain_point_priority,
                                         CHUNKS_RECORD *chunks_record,
                                         HEAP *pain_points,
                                         BlamerBundle *blamer_bundle) {
+  page_stats.Count(PC_PAIN_POINTS);
   if (segsearch_debug_level > 0) {
     tprintf("Classifying pain point priority=%.4f, col=%d, row=%d\n",
             pain_point_priority, pain_point.col, pain_point.row);
@@ -20,20 +20,50 @@
 #include "android/bitmap.h"
 #include "common.h"
 #include "baseapi.h"
+#include "langmodelbundle.h"
 #include "allheaders.h"
+#include "ocrclass.h"
+#include "pagestats.h"
 
 static jfieldID field_mNativeData;
+static jmethodID method_onRowResult;
+// Global reference to java.lang.String, for the word arrays of onRowResult.
+static jclass class_String;
 
 struct native_data_t {
   tesseract::TessBaseAPI api;
   PIX *pix;
   void *data;
+  // Global reference to the direct ByteBuffer whose memory is being read in
+  // place by the api, or NULL.
+  jobject buffer;
   bool debug;
+  // Whether the api holds the recognition results of the current image and
+  // rectangle, so they are not recognized again.
+  bool recognized;
+  // Set by nativeStop to cancel the recognition in progress, or else the next
+  // recognition of the current image. Cleared when that recognition finishes
+  // or the image is released.
+  volatile bool cancel_requested;
+  // Recognition time limit in milliseconds, or 0 for none.
+  int timeout_msecs;
+  // Whether to report the words of each row to the Java object.
+  bool report_rows;
+  // During a recognition, the environment and Java object to report to.
+  JNIEnv *env;
+  jobject object;
 
   native_data_t() {
     pix = NULL;
     data = NULL;
+    buffer = NULL;
     debug = false;
+    recognized = false;
+    cancel_requested = false;
+    timeout_msecs = 0;
+    report_rows = false;
+    env = NULL;
+    object = NULL;
   }
 };
 
@@ -41,6 +71,94 @@ static inline native_data_t * get_native_data(JNIEnv *env, jobject object) {
   return (native_data_t *) (env->GetIntField(object, field_mNativeData));
 }
 
+// Since Tesseract doesn't take ownership of the memory, we keep a pointer in the native
+// code struct. We need to free that pointer when we release our instance of Tesseract or
+// attempt to set a new image using one of the nativeSet* methods. At most one of data,
+// pix and buffer is set at any time.
+static void release_image(JNIEnv *env, native_data_t *nat) {
+  if (nat->data != NULL)
+    free(nat->data);
+  else if (nat->pix != NULL)
+    pixDestroy(&nat->pix);
+  else if (nat->buffer != NULL)
+    env->DeleteGlobalRef(nat->buffer);
+  nat->data = NULL;
+  nat->pix = NULL;
+  nat->buffer = NULL;
+
+  // A stop requested for the released image doesn't carry over to the next.
+  nat->cancel_requested = false;
+}
+
+// CANCEL_FUNC of the recognition monitor.
+static bool cancel_func(void *cancel_this, int words) {
+  native_data_t *nat = (native_data_t *) cancel_this;
+  return nat->cancel_requested;
+}
+
+// ROW_RESULT_FUNC of the recognition monitor, which passes the words of the
+// row on to TessBaseAPI.onRowResult.
+static void row_result_func(void *result_this, int pass, int progress, int row_index,
+                            int num_words, const char* const* words, const int *boxes,
+                            const int *confidences) {
+  native_data_t *nat = (native_data_t *) result_this;
+  JNIEnv *env = nat->env;
+
+  // Don't call Java with an exception pending from an earlier row.
+  if (env->ExceptionCheck())
+    return;
+
+  jobjectArray j_words = env->NewObjectArray(num_words, class_String, NULL);
+  for (int i = 0; i < num_words; ++i) {
+    jstring word = env->NewStringUTF(words[i]);
+    env->SetObjectArrayElement(j_words, i, word);
+    env->DeleteLocalRef(word);
+  }
+  jintArray j_boxes = env->NewIntArray(4 * num_words);
+  env->SetIntArrayRegion(j_boxes, 0, 4 * num_words, boxes);
+  jintArray j_confidences = env->NewIntArray(num_words);
+  env->SetIntArrayRegion(j_confidences, 0, num_words, confidences);
+
+  env->CallVoidMethod(nat->object, method_onRowResult, pass, progress, row_index,
+                      j_words, j_boxes, j_confidences);
+
+  // Let an exception thrown by the listener stop the recognition, and be
+  // thrown to the caller when it returns.
+  if (env->ExceptionCheck())
+    nat->cancel_requested = true;
+
+  env->DeleteLocalRef(j_confidences);
+  env->DeleteLocalRef(j_boxes);
+  env->DeleteLocalRef(j_words);
+}
+
+// Recognizes the current image, unless it has been already, with a monitor so
+// that the recognition can be stopped, can time out and can report its rows.
+static void recognize(JNIEnv *env, jobject object, native_data_t *nat) {
+  if (nat->recognized)
+    return;
+
+  ETEXT_DESC monitor;
+  monitor.cancel = cancel_func;
+  monitor.cancel_this = nat;
+  if (nat->timeout_msecs > 0)
+    monitor.set_deadline_msecs(nat->timeout_msecs);
+  if (nat->report_rows) {
+    monitor.row_result = row_result_func;
+    monitor.result_this = nat;
+    nat->env = env;
+    nat->object = object;
+  }
+
+  nat->api.Recognize(&monitor);
+  nat->recognized = true;
+  // Clear the request only once recognition has finished, so that a stop
+  // requested just before it started is not lost.
+  nat->cancel_requested = false;
+  nat->env = NULL;
+  nat->object = NULL;
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -60,6 +178,12 @@ void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeClassInit(JNIEnv* e
                                                                        jclass clazz) {
 
   field_mNativeData = env->GetFieldID(clazz, "mNativeData", "I");
+  method_onRowResult = env->GetMethodID(clazz, "onRowResult",
+                                        "(III[Ljava/lang/String;[I[I)V");
+
+  jclass string_class = env->FindClass("java/lang/String");
+  class_String = (jclass) env->NewGlobalRef(string_class);
+  env->DeleteLocalRef(string_class);
 }
 
 void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeConstruct(JNIEnv* env,
@@ -80,15 +204,7 @@ void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeFinalize(JNIEnv* en
 
   native_data_t *nat = get_native_data(env, object);
 
-  // Since Tesseract doesn't take ownership of the memory, we keep a pointer in the native
-  // code struct. We need to free that pointer when we release our instance of Tesseract or
-  // attempt to set a new image using one of the nativeSet* methods.
-  if (nat->data != NULL)
-    free(nat->data);
-  else if (nat->pix != NULL)
-    pixDestroy(&nat->pix);
-  nat->data = NULL;
-  nat->pix = NULL;
+  release_image(env, nat);
 
   if (nat != NULL)
     delete nat;
@@ -106,6 +222,8 @@ jboolean Java_com_googlecode_tesseract_android_TessBaseAPI_nativeInit(JNIEnv *en
 
   jboolean res = JNI_TRUE;
 
+  nat->recognized = false;
+
   if (nat->api.Init(c_dir, c_lang)) {
     LOGE("Could not initialize Tesseract API with language=%s!", c_lang);
     res = JNI_FALSE;
@@ -132,6 +250,8 @@ jboolean Java_com_googlecode_tesseract_android_TessBaseAPI_nativeInitOem(JNIEnv
 
   jboolean res = JNI_TRUE;
 
+  nat->recognized = false;
+
   if (nat->api.Init(c_dir, c_lang, (tesseract::OcrEngineMode) mode)) {
     LOGE("Could not initialize Tesseract API with language=%s!", c_lang);
     res = JNI_FALSE;
@@ -145,6 +265,29 @@ jboolean Java_com_googlecode_tesseract_android_TessBaseAPI_nativeInitOem(JNIEnv
   return res;
 }
 
+jboolean Java_com_googlecode_tesseract_android_TessBaseAPI_nativeInitShared(JNIEnv *env,
+                                                                            jobject thiz,
+                                                                            jint nativeBundle,
+                                                                            jint mode) {
+
+  native_data_t *nat = get_native_data(env, thiz);
+  tesseract::LanguageModelBundle *bundle = (tesseract::LanguageModelBundle *) nativeBundle;
+
+  jboolean res = JNI_TRUE;
+
+  nat->recognized = false;
+
+  if (nat->api.InitShared(bundle, (tesseract::OcrEngineMode) mode)) {
+    LOGE("Could not initialize Tesseract API with shared language=%s!",
+         bundle->language().string());
+    res = JNI_FALSE;
+  } else {
+    LOGI("Initialized Tesseract API with shared language=%s", bundle->language().string());
+  }
+
+  return res;
+}
+
 jstring Java_com_googlecode_tesseract_android_TessBaseAPI_nativeGetInitLanguagesAsString(JNIEnv *env,
                                                                                          jobject thiz) {
 
@@ -166,30 +309,72 @@ void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetImageBytes(JNIEn
                                                                            jint bpp,
                                                                            jint bpl) {
 
-  jbyte *data_array = env->GetByteArrayElements(data, NULL);
+  // A jbyte is always 8 bits, so the array can be copied straight into the buffer
+  // that Tesseract reads, without pinning or copying the Java array first.
   int count = env->GetArrayLength(data);
   unsigned char* imagedata = (unsigned char *) malloc(count * sizeof(unsigned char));
 
-  // This is painfully slow, but necessary because we don't know
-  // how many bits the JVM might be using to represent a byte
-  for (int i = 0; i < count; i++) {
-    imagedata[i] = (unsigned char) data_array[i];
+  if (imagedata == NULL) {
+    LOGE("%s: out of memory!", __FUNCTION__);
+    return;
   }
 
-  env->ReleaseByteArrayElements(data, data_array, JNI_ABORT);
+  env->GetByteArrayRegion(data, 0, count, (jbyte *) imagedata);
 
   native_data_t *nat = get_native_data(env, thiz);
   nat->api.SetImage(imagedata, (int) width, (int) height, (int) bpp, (int) bpl);
 
-  // Since Tesseract doesn't take ownership of the memory, we keep a pointer in the native
-  // code struct. We need to free that pointer when we release our instance of Tesseract or
-  // attempt to set a new image using one of the nativeSet* methods.
-  if (nat->data != NULL)
-    free(nat->data);
-  else if (nat->pix != NULL)
-    pixDestroy(&nat->pix);
+  nat->recognized = false;
+  release_image(env, nat);
   nat->data = imagedata;
-  nat->pix = NULL;
+}
+
+void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetImageBuffer(JNIEnv *env,
+                                                                            jobject thiz,
+                                                                            jobject buffer,
+                                                                            jint width,
+                                                                            jint height,
+                                                                            jint bpp,
+                                                                            jint bpl) {
+
+  unsigned char *imagedata = (unsigned char *) env->GetDirectBufferAddress(buffer);
+  jlong capacity = env->GetDirectBufferCapacity(buffer);
+
+  if (imagedata == NULL || capacity < 0) {
+    LOGE("%s: image buffer is not a direct buffer!", __FUNCTION__);
+    return;
+  }
+
+  jlong row_bytes = (bpp == 0) ? ((jlong) width + 7) / 8 : (jlong) width * bpp;
+
+  if (width <= 0 || height <= 0 || bpp < 0 || bpp > 4 || bpl < row_bytes) {
+    LOGE("%s: invalid image size %dx%d, %d bytes per pixel, %d bytes per line",
+         __FUNCTION__, width, height, bpp, bpl);
+    return;
+  }
+
+  if (capacity < (jlong) bpl * height) {
+    LOGE("%s: image buffer holds %lld bytes, need %lld", __FUNCTION__,
+         (long long) capacity, (long long) bpl * height);
+    return;
+  }
+
+  // The thresholder reads the buffer in place, using bpl as the stride, so instead of
+  // copying the image we hold a global reference to the buffer until the image is
+  // replaced or released.
+  jobject buffer_ref = env->NewGlobalRef(buffer);
+
+  if (buffer_ref == NULL) {
+    LOGE("%s: out of memory!", __FUNCTION__);
+    return;
+  }
+
+  native_data_t *nat = get_native_data(env, thiz);
+  nat->api.SetImage(imagedata, (int) width, (int) height, (int) bpp, (int) bpl);
+
+  nat->recognized = false;
+  release_image(env, nat);
+  nat->buffer = buffer_ref;
 }
 
 void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetImagePix(JNIEnv *env,
@@ -202,14 +387,8 @@ void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetImagePix(JNIEnv
   native_data_t *nat = get_native_data(env, thiz);
   nat->api.SetImage(pixd);
 
-  // Since Tesseract doesn't take ownership of the memory, we keep a pointer in the native
-  // code struct. We need to free that pointer when we release our instance of Tesseract or
-  // attempt to set a new image using one of the nativeSet* methods.
-  if (nat->data != NULL)
-    free(nat->data);
-  else if (nat->pix != NULL)
-    pixDestroy(&nat->pix);
-  nat->data = NULL;
+  nat->recognized = false;
+  release_image(env, nat);
   nat->pix = pixd;
 }
 
@@ -223,6 +402,7 @@ void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetRectangle(JNIEnv
   native_data_t *nat = get_native_data(env, thiz);
 
   nat->api.SetRectangle(left, top, width, height);
+  nat->recognized = false;
 }
 
 jstring Java_com_googlecode_tesseract_android_TessBaseAPI_nativeGetUTF8Text(JNIEnv *env,
@@ -230,6 +410,8 @@ jstring Java_com_googlecode_tesseract_android_TessBaseAPI_nativeGetUTF8Text(JNIE
 
   native_data_t *nat = get_native_data(env, thiz);
 
+  recognize(env, thiz, nat);
+
   char *text = nat->api.GetUTF8Text();
 
   jstring result = env->NewStringUTF(text);
@@ -239,12 +421,72 @@ jstring Java_com_googlecode_tesseract_android_TessBaseAPI_nativeGetUTF8Text(JNIE
   return result;
 }
 
+jbyteArray Java_com_googlecode_tesseract_android_TessBaseAPI_nativeRecognizeBatch(JNIEnv *env,
+                                                                                 jobject thiz,
+                                                                                 jint nativePix,
+                                                                                 jint nativePixa,
+                                                                                 jint mode,
+                                                                                 jintArray results) {
+
+  PIX *pixs = (PIX *) nativePix;
+  PIXA *pixa = (PIXA *) nativePixa;
+  PIX *pixd = pixClone(pixs);
+  BOXA *boxa = pixaGetBoxa(pixa, L_CLONE);
+
+  native_data_t *nat = get_native_data(env, thiz);
+
+  int *lengths = NULL;
+  int *confs = NULL;
+  char *text = nat->api.RecognizeBatch(pixd, boxa, (tesseract::PageSegMode) mode,
+                                       &lengths, &confs);
+
+  // The api now holds the batch image, as after nativeSetImagePix.
+  release_image(env, nat);
+  nat->pix = pixd;
+  nat->recognized = false;
+
+  if (text == NULL) {
+    LOGE("Could not recognize batch!");
+    boxaDestroy(&boxa);
+    return NULL;
+  }
+
+  // Pack the lengths of the texts followed by the confidences into results,
+  // which has room for one of each per element of the Pixa, and return the
+  // concatenated texts as UTF-8 bytes. Any elements without a box are left
+  // at their initial values.
+  int count = env->GetArrayLength(results) / 2;
+  int num_boxes = boxaGetCount(boxa);
+  if (num_boxes > count)
+    num_boxes = count;
+  env->SetIntArrayRegion(results, 0, num_boxes, lengths);
+  env->SetIntArrayRegion(results, count, num_boxes, confs);
+
+  int size = 0;
+  for (int i = 0; i < num_boxes; ++i)
+    size += lengths[i];
+  jbyteArray ret = env->NewByteArray(size);
+
+  LOG_ASSERT((ret != NULL), "Could not create Java text array!");
+
+  env->SetByteArrayRegion(ret, 0, size, (jbyte *) text);
+
+  boxaDestroy(&boxa);
+  delete[] text;
+  delete[] lengths;
+  delete[] confs;
+
+  return ret;
+}
+
 void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeStop(JNIEnv *env, 
                                                                   jobject thiz) {
 
   native_data_t *nat = get_native_data(env, thiz);
 
-  // TODO How do we stop without a monitor?!
+  // Cancels the recognition in progress at its next word, or else the next
+  // recognition of the current image.
+  nat->cancel_requested = true;
 }
 
 jint Java_com_googlecode_tesseract_android_TessBaseAPI_nativeMeanConfidence(JNIEnv *env,
@@ -252,6 +494,8 @@ jint Java_com_googlecode_tesseract_android_TessBaseAPI_nativeMeanConfidence(JNIE
 
   native_data_t *nat = get_native_data(env, thiz);
 
+  recognize(env, thiz, nat);
+
   return (jint) nat->api.MeanTextConf();
 }
 
@@ -260,6 +504,8 @@ jintArray Java_com_googlecode_tesseract_android_TessBaseAPI_nativeWordConfidence
 
   native_data_t *nat = get_native_data(env, thiz);
 
+  recognize(env, thiz, nat);
+
   int *confs = nat->api.AllWordConfidences();
 
   if (confs == NULL) {
@@ -284,6 +530,29 @@ jintArray Java_com_googlecode_tesseract_android_TessBaseAPI_nativeWordConfidence
   return ret;
 }
 
+jstring Java_com_googlecode_tesseract_android_TessBaseAPI_nativeGetPageStats(JNIEnv *env,
+                                                                          jobject thiz,
+                                                                          jboolean chromeTrace) {
+
+  native_data_t *nat = get_native_data(env, thiz);
+
+  recognize(env, thiz, nat);
+
+  tesseract::PageStats stats;
+
+  if (!nat->api.GetPageStats(&stats))
+    return NULL;
+
+  STRING json;
+
+  if (chromeTrace)
+    stats.ToChromeTrace(&json);
+  else
+    stats.ToJSON(&json);
+
+  return env->NewStringUTF(json.string());
+}
+
 jboolean Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetVariable(JNIEnv *env,
                                                                              jobject thiz,
                                                                              jstring var,
@@ -312,15 +581,8 @@ void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeClear(JNIEnv *env,
   // Call between pages or documents etc to free up memory and forget adaptive data.
   nat->api.ClearAdaptiveClassifier();
 
-  // Since Tesseract doesn't take ownership of the memory, we keep a pointer in the native
-  // code struct. We need to free that pointer when we release our instance of Tesseract or
-  // attempt to set a new image using one of the nativeSet* methods.
-  if (nat->data != NULL)
-    free(nat->data);
-  else if (nat->pix != NULL)
-    pixDestroy(&nat->pix);
-  nat->data = NULL;
-  nat->pix = NULL;
+  nat->recognized = false;
+  release_image(env, nat);
 }
 
 void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeEnd(JNIEnv *env,
@@ -330,15 +592,8 @@ void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeEnd(JNIEnv *env,
 
   nat->api.End();
 
-  // Since Tesseract doesn't take ownership of the memory, we keep a pointer in the native
-  // code struct. We need to free that pointer when we release our instance of Tesseract or
-  // attempt to set a new image using one of the nativeSet* methods.
-  if (nat->data != NULL)
-    free(nat->data);
-  else if (nat->pix != NULL)
-    pixDestroy(&nat->pix);
-  nat->data = NULL;
-  nat->pix = NULL;
+  nat->recognized = false;
+  release_image(env, nat);
 }
 
 void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetDebug(JNIEnv *env,
@@ -350,6 +605,24 @@ void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetDebug(JNIEnv *en
   nat->debug = (debug == JNI_TRUE) ? TRUE : FALSE;
 }
 
+void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetTimeout(JNIEnv *env,
+                                                                        jobject thiz,
+                                                                        jint milliseconds) {
+
+  native_data_t *nat = get_native_data(env, thiz);
+
+  nat->timeout_msecs = milliseconds;
+}
+
+void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetReportRows(JNIEnv *env,
+                                                                           jobject thiz,
+                                                                           jboolean report) {
+
+  native_data_t *nat = get_native_data(env, thiz);
+
+  nat->report_rows = (report == JNI_TRUE);
+}
+
 void Java_com_googlecode_tesseract_android_TessBaseAPI_nativeSetPageSegMode(JNIEnv *env,
                                                                             jobject thiz,
                                                                             jint mode) {
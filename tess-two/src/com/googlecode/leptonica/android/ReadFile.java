@@ -18,6 +18,7 @@ package com.googlecode.leptonica.android;
 
 import android.graphics.Bitmap;
 import android.graphics.BitmapFactory;
+import android.graphics.Rect;
 
 import java.io.File;
 
@@ -31,6 +32,15 @@ public class ReadFile {
         System.loadLibrary("lept");
     }
 
+    /** Luma is the average of the red, green and blue components. */
+    public static final int LUMA_AVERAGE = 0;
+
+    /** Luma has the perceptual weights of ITU-R BT.601 (standard video). */
+    public static final int LUMA_BT601 = 1;
+
+    /** Luma has the perceptual weights of ITU-R BT.709 (HD video). */
+    public static final int LUMA_BT709 = 2;
+
     /**
      * Creates a 32bpp Pix object from encoded data. Supported formats are BMP
      * and JPEG.
@@ -156,19 +166,47 @@ public class ReadFile {
     }
 
     /**
-     * Creates a Pix object from Bitmap data. Currently supports only
-     * ARGB_8888-formatted bitmaps.
+     * Creates an 8bpp Pix object from Bitmap data. Supports ARGB_8888 and
+     * RGB_565 bitmaps.
      *
      * @param bmp The Bitmap object to convert to a Pix.
-     * @return a Pix object
+     * @return an 8bpp Pix object
      */
     public static Pix readBitmap(Bitmap bmp) {
+        return readBitmap(bmp, null, 1, LUMA_AVERAGE);
+    }
+
+    /**
+     * Creates an 8bpp Pix object from an area of Bitmap data, optionally
+     * reduced in size. Supports ARGB_8888 and RGB_565 bitmaps. The bitmap is
+     * converted, cropped and reduced in a single pass.
+     *
+     * @param bmp The Bitmap object to convert to a Pix.
+     * @param crop The area of the bitmap to convert, or null for the whole
+     *            bitmap.
+     * @param reduction The factor to reduce the area by: 1, 2 or 4. Each pixel
+     *            of the Pix is the average of a block of pixels of the area.
+     * @param luma The weights of the color components in the luma, one of
+     *            {@link #LUMA_AVERAGE}, {@link #LUMA_BT601} or
+     *            {@link #LUMA_BT709}.
+     * @return an 8bpp Pix object
+     */
+    public static Pix readBitmap(Bitmap bmp, Rect crop, int reduction, int luma) {
         if (bmp == null)
             throw new IllegalArgumentException("Bitmap must be non-null");
-        if (bmp.getConfig() != Bitmap.Config.ARGB_8888)
-            throw new IllegalArgumentException("Bitmap config must be ARGB_8888");
+        if (bmp.getConfig() != Bitmap.Config.ARGB_8888
+                && bmp.getConfig() != Bitmap.Config.RGB_565)
+            throw new IllegalArgumentException("Bitmap config must be ARGB_8888 or RGB_565");
+        if (luma != LUMA_AVERAGE && luma != LUMA_BT601 && luma != LUMA_BT709)
+            throw new IllegalArgumentException("Invalid luma weights");
+
+        if (crop == null)
+            crop = new Rect(0, 0, bmp.getWidth(), bmp.getHeight());
+
+        checkArea(crop, bmp.getWidth(), bmp.getHeight(), reduction);
 
-        int nativePix = nativeReadBitmap(bmp);
+        int nativePix = nativeReadBitmap(bmp, crop.left, crop.top, crop.width(),
+                crop.height(), reduction, luma);
 
         if (nativePix == 0)
             throw new RuntimeException("Failed to read pix from bitmap");
@@ -176,6 +214,54 @@ public class ReadFile {
         return new Pix(nativePix);
     }
 
+    /**
+     * Creates an 8bpp Pix object from the luma of an area of an NV21 camera
+     * frame, optionally reduced in size. The luma is read directly from the
+     * frame in a single pass, so this also works for other YUV 4:2:0 frames
+     * that start with a Y plane of width bytes per row.
+     *
+     * @param data The frame data.
+     * @param width The width of the frame.
+     * @param height The height of the frame.
+     * @param crop The area of the frame to convert, or null for the whole
+     *            frame.
+     * @param reduction The factor to reduce the area by: 1, 2 or 4. Each pixel
+     *            of the Pix is the average of a block of pixels of the area.
+     * @return an 8bpp Pix object
+     */
+    public static Pix readNv21(byte[] data, int width, int height, Rect crop, int reduction) {
+        if (data == null)
+            throw new IllegalArgumentException("Byte array must be non-null");
+        if (width <= 0)
+            throw new IllegalArgumentException("Image width must be greater than 0");
+        if (height <= 0)
+            throw new IllegalArgumentException("Image height must be greater than 0");
+        if (data.length < width * height)
+            throw new IllegalArgumentException("Array length does not match dimensions");
+
+        if (crop == null)
+            crop = new Rect(0, 0, width, height);
+
+        checkArea(crop, width, height, reduction);
+
+        int nativePix = nativeReadNv21(data, width, height, crop.left, crop.top, crop.width(),
+                crop.height(), reduction);
+
+        if (nativePix == 0)
+            throw new RuntimeException("Failed to read pix from frame");
+
+        return new Pix(nativePix);
+    }
+
+    private static void checkArea(Rect crop, int width, int height, int reduction) {
+        if (reduction != 1 && reduction != 2 && reduction != 4)
+            throw new IllegalArgumentException("Reduction must be 1, 2 or 4");
+        if (crop.left < 0 || crop.top < 0 || crop.right > width || crop.bottom > height)
+            throw new IllegalArgumentException("Crop area must be inside the image");
+        if (crop.width() < reduction || crop.height() < reduction)
+            throw new IllegalArgumentException("Crop area must be at least the reduction");
+    }
+
     // ***************
     // * NATIVE CODE *
     // ***************
@@ -190,5 +276,9 @@ public class ReadFile {
 
     private static native int nativeReadFile(String filename);
 
-    private static native int nativeReadBitmap(Bitmap bitmap);
+    private static native int nativeReadBitmap(Bitmap bitmap, int x, int y, int w, int h,
+            int reduction, int luma);
+
+    private static native int nativeReadNv21(byte[] data, int width, int height, int x, int y,
+            int w, int h, int reduction);
 }
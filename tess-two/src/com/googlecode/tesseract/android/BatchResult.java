@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2011 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+package com.googlecode.tesseract.android;
+
+import java.io.UnsupportedEncodingException;
+
+/**
+ * Results of {@link TessBaseAPI#recognizeBatch(com.googlecode.leptonica.android.Pix,
+ * com.googlecode.leptonica.android.Pixa, int)}: the text and mean confidence
+ * of each region, in the order of the regions. The texts are kept as the
+ * packed UTF-8 bytes returned by the native code and only decoded when asked
+ * for.
+ */
+public class BatchResult {
+    private final byte[] mText;
+
+    private final int[] mOffsets;
+
+    private final int[] mLengths;
+
+    private final int[] mConfidences;
+
+    /**
+     * Constructs a batch result.
+     *
+     * @param text the UTF-8 text of all the regions, concatenated
+     * @param lengths the byte length of the text of each region
+     * @param confidences the mean confidence of each region
+     */
+    BatchResult(byte[] text, int[] lengths, int[] confidences) {
+        mText = text;
+        mLengths = lengths;
+        mConfidences = confidences;
+        mOffsets = new int[lengths.length];
+
+        int offset = 0;
+        for (int i = 0; i < lengths.length; i++) {
+            mOffsets[i] = offset;
+            offset += lengths[i];
+        }
+    }
+
+    /**
+     * Returns the number of regions in this result.
+     *
+     * @return the number of regions
+     */
+    public int size() {
+        return mLengths.length;
+    }
+
+    /**
+     * Returns the recognized text of a region, trimmed as by
+     * {@link TessBaseAPI#getUTF8Text()}.
+     *
+     * @param index the index of the region
+     * @return the recognized text, or an empty string if the region could not
+     *         be recognized
+     */
+    public String getText(int index) {
+        try {
+            return new String(mText, mOffsets[index], mLengths[index], "UTF-8").trim();
+        } catch (UnsupportedEncodingException e) {
+            throw new RuntimeException(e);
+        }
+    }
+
+    /**
+     * Returns the mean confidence of the text of a region.
+     *
+     * @param index the index of the region
+     * @return the mean confidence (between 0 and 100), or -1 if the region
+     *         was too small or could not be recognized
+     */
+    public int getConfidence(int index) {
+        return mConfidences[index];
+    }
+}
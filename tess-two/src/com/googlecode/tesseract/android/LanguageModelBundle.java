@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2011 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ */
+
+package com.googlecode.tesseract.android;
+
+import java.io.File;
+
+/**
+ * Java representation of the read-only parts of a Tesseract language model:
+ * the classifier templates and the dictionaries. A bundle is loaded once and
+ * may then be passed to {@link TessBaseAPI#init(LanguageModelBundle, int)} on
+ * any number of TessBaseAPI instances, including instances used by different
+ * threads at the same time, so they share a single copy of that data instead
+ * of each loading their own.
+ * <p>
+ * Each TessBaseAPI initialized from a bundle keeps the native data alive until
+ * it is ended, so it is safe to recycle the bundle as soon as the instances
+ * that need it have been initialized.
+ */
+public class LanguageModelBundle {
+    static {
+        System.loadLibrary("lept");
+        System.loadLibrary("tess");
+    }
+
+    /** Package-accessible pointer to the native bundle */
+    final int mNativeBundle;
+
+    private final String mLanguage;
+
+    private boolean mRecycled;
+
+    private LanguageModelBundle(int nativeBundle, String language) {
+        mNativeBundle = nativeBundle;
+        mLanguage = language;
+        mRecycled = false;
+    }
+
+    /**
+     * Loads a language model bundle. The datapath and language are given
+     * exactly as to {@link TessBaseAPI#init(String, String)}.
+     *
+     * @param datapath the parent directory of tessdata ending in a forward
+     *            slash
+     * @param language (optional) an ISO 639-3 string representing the language(s)
+     * @return the loaded bundle, or <code>null</code> on failure
+     */
+    public static LanguageModelBundle load(String datapath, String language) {
+        if (datapath == null)
+            throw new IllegalArgumentException("Data path must not be null!");
+        if (!datapath.endsWith(File.separator))
+            datapath += File.separator;
+
+        File tessdata = new File(datapath + "tessdata");
+        if (!tessdata.exists() || !tessdata.isDirectory())
+            throw new IllegalArgumentException("Data path must contain subfolder tessdata!");
+
+        if (language == null)
+            language = "eng";
+
+        int nativeBundle = nativeLoad(datapath, language);
+
+        if (nativeBundle == 0)
+            return null;
+
+        return new LanguageModelBundle(nativeBundle, language);
+    }
+
+    /**
+     * Returns the language string the bundle was loaded with.
+     *
+     * @return the language string
+     */
+    public String getLanguage() {
+        return mLanguage;
+    }
+
+    /**
+     * Returns whether {@link #recycle()} has been called on this bundle.
+     *
+     * @return <code>true</code> if the bundle has been recycled
+     */
+    public boolean isRecycled() {
+        return mRecycled;
+    }
+
+    /**
+     * Releases this reference to the native bundle. The native data is freed
+     * once every TessBaseAPI initialized from the bundle has also been ended.
+     */
+    public void recycle() {
+        if (!mRecycled) {
+            nativeRelease(mNativeBundle);
+
+            mRecycled = true;
+        }
+    }
+
+    @Override
+    protected void finalize() throws Throwable {
+        recycle();
+
+        super.finalize();
+    }
+
+    // ***************
+    // * NATIVE CODE *
+    // ***************
+
+    private static native int nativeLoad(String datapath, String language);
+
+    private static native void nativeRelease(int nativeBundle);
+}
@@ -26,6 +26,8 @@ import com.googlecode.leptonica.android.Pix;
 import com.googlecode.leptonica.android.ReadFile;
 
 import java.io.File;
+import java.nio.ByteBuffer;
+import java.util.Arrays;
 
 /**
  * Java interface for the Tesseract OCR engine. Does not implement all available
@@ -43,6 +45,13 @@ public class TessBaseAPI {
      */
     private int mNativeData;
 
+    /** The listener to report recognized rows to, if any. */
+    private ProgressListener mProgressListener;
+
+    /** The offset of the rectangle being recognized in the image. */
+    private int mRectLeft;
+    private int mRectTop;
+
     static {
         System.loadLibrary("lept");
         System.loadLibrary("tess");
@@ -85,6 +94,13 @@ public class TessBaseAPI {
 
     /** Blacklist of characters to not recognize. */
     public static final String VAR_CHAR_BLACKLIST = "tessedit_char_blacklist";
+
+    /**
+     * Collection of per-stage times and counters for {@link #getPageStats}: 0
+     * for off (the default), 1 for totals, 2 to also record each call for
+     * the trace.
+     */
+    public static final String VAR_PAGE_STATS = "tessedit_page_stats";
     
     /** Run Tesseract only - fastest */
     public static final int OEM_TESSERACT_ONLY = 0;
@@ -98,6 +114,29 @@ public class TessBaseAPI {
     /** Default OCR engine mode. */
     public static final int OEM_DEFAULT = 3;
 
+    /**
+     * Interface definition for a callback to be invoked as recognition
+     * progresses.
+     */
+    public interface ProgressListener {
+        /**
+         * Called on the recognizing thread each time recognition of a text
+         * row is finished, once in each recognition pass. Rows are reported
+         * in page order within a pass. Throwing from this method stops the
+         * recognition as {@link TessBaseAPI#stop()} does.
+         *
+         * @param pass the recognition pass, 1 or 2
+         * @param progress the overall progress of recognition, between 0 and
+         *            100
+         * @param rowIndex the index of the row on the page
+         * @param words the text of each word of the row
+         * @param boxes the bounding box of each word in image coordinates
+         * @param confidences the confidence (between 0 and 100) of each word
+         */
+        public void onRowRecognized(int pass, int progress, int rowIndex,
+                String[] words, Rect[] boxes, int[] confidences);
+    }
+
     /**
      * Constructs an instance of TessBaseAPI.
      */
@@ -203,6 +242,29 @@ public class TessBaseAPI {
         return nativeInitOem(datapath, language, ocrEngineMode);	
     }
 
+    /**
+     * Initializes the Tesseract engine with the language model(s) of a
+     * previously loaded bundle, sharing the bundle's classifier templates and
+     * dictionaries instead of loading another copy of them. Any number of
+     * instances, in any number of threads, may be initialized from the same
+     * bundle. Returns <code>true</code> on success.
+     * <p>
+     * The instance keeps the bundle's native data alive until {@link #end()}
+     * is called, so the bundle may be recycled once this returns.
+     *
+     * @param bundle the loaded language model bundle
+     * @param ocrEngineMode the OCR engine mode to be set
+     * @return <code>true</code> on success
+     */
+    public boolean init(LanguageModelBundle bundle, int ocrEngineMode) {
+        if (bundle == null)
+            throw new IllegalArgumentException("Language model bundle must not be null!");
+        if (bundle.isRecycled())
+            throw new IllegalStateException("Language model bundle has been recycled!");
+
+        return nativeInitShared(bundle.mNativeBundle, ocrEngineMode);
+    }
+
     /**
      * Returns the languages string used in the last valid initialization.
      * If the last initialization specified "deu+hin" then that will be
@@ -223,6 +285,9 @@ public class TessBaseAPI {
      * Recognize or Get* operation.
      */
     public void clear() {
+        mRectLeft = 0;
+        mRectTop = 0;
+
         nativeClear();
     }
 
@@ -297,6 +362,9 @@ public class TessBaseAPI {
      * @param height the height of the bounding box
      */
     public void setRectangle(int left, int top, int width, int height) {
+        mRectLeft = Math.max(left, 0);
+        mRectTop = Math.max(top, 0);
+
         nativeSetRectangle(left, top, width, height);
     }
 
@@ -312,6 +380,9 @@ public class TessBaseAPI {
             throw new RuntimeException("Failed to read image file");
         }
 
+        mRectLeft = 0;
+        mRectTop = 0;
+
         nativeSetImagePix(image.getNativePix());
     }
 
@@ -329,6 +400,9 @@ public class TessBaseAPI {
             throw new RuntimeException("Failed to read bitmap");
         }
 
+        mRectLeft = 0;
+        mRectTop = 0;
+
         nativeSetImagePix(image.getNativePix());
     }
 
@@ -340,6 +414,9 @@ public class TessBaseAPI {
      * @param image Leptonica pix representation of the image
      */
     public void setImage(Pix image) {
+        mRectLeft = 0;
+        mRectTop = 0;
+
         nativeSetImagePix(image.getNativePix());
     }
 
@@ -357,9 +434,59 @@ public class TessBaseAPI {
      * @param bpl bytes per line
      */
     public void setImage(byte[] imagedata, int width, int height, int bpp, int bpl) {
+        mRectLeft = 0;
+        mRectTop = 0;
+
         nativeSetImageBytes(imagedata, width, height, bpp, bpl);
     }
 
+    /**
+     * Provides an image for Tesseract to recognize. Does not copy the image
+     * buffer, which is read in place using bpl as the stride, so camera
+     * preview frames may be passed without conversion; for example, the
+     * luminance plane of an NV21 frame is an 8-bit grey image with bpp 1 and
+     * bpl equal to the frame width. A reference to the buffer is kept until
+     * another image is set or the API is cleared or ended, and the buffer
+     * contents must not be modified until then.
+     *
+     * @param imagedata direct buffer holding the image, starting at the first
+     *            byte of the buffer
+     * @param width image width
+     * @param height image height
+     * @param bpp bytes per pixel, or 0 for a binary image
+     * @param bpl bytes per line, at least width * bpp
+     */
+    public void setImage(ByteBuffer imagedata, int width, int height, int bpp, int bpl) {
+        if (imagedata == null || !imagedata.isDirect()) {
+            throw new IllegalArgumentException("Image buffer must be a direct buffer!");
+        }
+
+        if (width <= 0 || height <= 0) {
+            throw new IllegalArgumentException("Image must not be empty!");
+        }
+
+        if (bpp < 0 || bpp > 4) {
+            throw new IllegalArgumentException("Bytes per pixel must be 0 to 4!");
+        }
+
+        // Each line is read in place, so it must hold a full row of pixels,
+        // packed 8 to a byte when bpp is 0. In long arithmetic, as the size of
+        // a large image may overflow an int.
+        final long rowBytes = (bpp == 0) ? (width + 7L) / 8 : (long) width * bpp;
+        if (bpl < rowBytes) {
+            throw new IllegalArgumentException("Bytes per line is too small!");
+        }
+
+        if (imagedata.capacity() < (long) bpl * height) {
+            throw new IllegalArgumentException("Image buffer is too small!");
+        }
+
+        mRectLeft = 0;
+        mRectTop = 0;
+
+        nativeSetImageBuffer(imagedata, width, height, bpp, bpl);
+    }
+
     /**
      * The recognized text is returned as a String which is coded as UTF8.
      *
@@ -399,6 +526,99 @@ public class TessBaseAPI {
         return conf;
     }
 
+    /**
+     * Returns the time spent in each stage of the recognition of the current
+     * image, such as thresholding, page segmentation, the recognition passes,
+     * the chopper and the adaptive classifier, and counters such as the
+     * number of classifier calls. Stages nest, so the time of a stage
+     * includes that of the stages run within it. Collection must be enabled
+     * beforehand with {@link #VAR_PAGE_STATS}.
+     *
+     * @param chromeTrace <code>true</code> for the Chrome trace event format,
+     *            as loaded by chrome://tracing, or <code>false</code> for a
+     *            JSON object of totals with "stages" and "counters"
+     * @return the stats as JSON, or <code>null</code> if collection is off
+     */
+    public String getPageStats(boolean chromeTrace) {
+        return nativeGetPageStats(chromeTrace);
+    }
+
+    /**
+     * Recognizes each of the regions of an image in one call, as setting the
+     * image, then setting each region as the rectangle and getting its text
+     * and mean confidence would, but without the per-region setup and JNI
+     * overhead. The image is thresholded once, and each region is recognized
+     * from its part of the thresholded image, so results can differ slightly
+     * from thresholding each region on its own. Regions are clipped to the
+     * image.
+     * <p>
+     * Note that this replaces the image and rectangle set by any earlier call
+     * to {@link #setImage(Pix)} or {@link #setRectangle(Rect)}, and discards
+     * their results. Afterwards the image is set as by {@link #setImage(Pix)}
+     * and the page segmentation mode is unchanged.
+     *
+     * @param image Leptonica pix representation of the image
+     * @param regions the regions to recognize, as the boxes of a Pixa, for
+     *            example the text areas found by a text detector
+     * @param pageSegMode the page segmentation mode to recognize the regions
+     *            in, for example PSM_SINGLE_LINE
+     * @return the text and mean confidence of each region, or
+     *         <code>null</code> on failure
+     */
+    public BatchResult recognizeBatch(Pix image, Pixa regions, int pageSegMode) {
+        int count = regions.size();
+        int[] results = new int[2 * count];
+        Arrays.fill(results, count, 2 * count, -1);
+
+        mRectLeft = 0;
+        mRectTop = 0;
+
+        byte[] text = nativeRecognizeBatch(
+                image.getNativePix(), regions.getNativePixa(), pageSegMode, results);
+
+        if (text == null)
+            return null;
+
+        int[] lengths = new int[count];
+        int[] confidences = new int[count];
+        System.arraycopy(results, 0, lengths, 0, count);
+        System.arraycopy(results, count, confidences, 0, count);
+
+        return new BatchResult(text, lengths, confidences);
+    }
+
+    /**
+     * Sets the listener to report recognized rows to while recognizing, so
+     * results can be shown before the whole image has been recognized.
+     *
+     * @param listener the listener, or <code>null</code> to stop reporting
+     */
+    public void setProgressListener(ProgressListener listener) {
+        mProgressListener = listener;
+
+        nativeSetReportRows(listener != null);
+    }
+
+    /**
+     * Sets the maximum time to spend recognizing an image. Recognition that
+     * takes longer is stopped, and the results are those of the words
+     * recognized so far.
+     *
+     * @param milliseconds the time limit, or 0 for no limit
+     */
+    public void setTimeout(int milliseconds) {
+        nativeSetTimeout(milliseconds);
+    }
+
+    /**
+     * Cancels the recognition in progress, or else the next recognition of
+     * the current image. May be called from any thread. The call that
+     * started recognition returns the results of the words recognized so far.
+     */
+    public void stop() {
+        nativeStop();
+    }
+
     /**
      * Returns the result of page layout analysis as a Pixa, in reading order.
      * 
@@ -448,6 +668,28 @@ public class TessBaseAPI {
         return new Pixa(nativeGetCharacters(), 0, 0);
     }
 
+    /**
+     * Called from native code with the results of each row when a progress
+     * listener is set. The boxes are the left, top, right and bottom of each
+     * word, relative to the rectangle being recognized.
+     */
+    private void onRowResult(int pass, int progress, int rowIndex, String[] words,
+            int[] boxes, int[] confidences) {
+        ProgressListener listener = mProgressListener;
+
+        if (listener == null)
+            return;
+
+        Rect[] rects = new Rect[words.length];
+
+        for (int i = 0; i < words.length; i++) {
+            rects[i] = new Rect(boxes[4 * i] + mRectLeft, boxes[4 * i + 1] + mRectTop,
+                    boxes[4 * i + 2] + mRectLeft, boxes[4 * i + 3] + mRectTop);
+        }
+
+        listener.onRowRecognized(pass, progress, rowIndex, words, rects, confidences);
+    }
+
     // ******************
     // * Native methods *
     // ******************
@@ -471,6 +713,8 @@ public class TessBaseAPI {
     
     private native boolean nativeInitOem(String datapath, String language, int mode);
 
+    private native boolean nativeInitShared(int nativeBundle, int mode);
+
     private native String nativeGetInitLanguagesAsString();
     
     private native void nativeClear();
@@ -480,21 +724,35 @@ public class TessBaseAPI {
     private native void nativeSetImageBytes(
             byte[] imagedata, int width, int height, int bpp, int bpl);
 
+    private native void nativeSetImageBuffer(
+            ByteBuffer imagedata, int width, int height, int bpp, int bpl);
+
     private native void nativeSetImagePix(int nativePix);
 
     private native void nativeSetRectangle(int left, int top, int width, int height);
 
     private native String nativeGetUTF8Text();
 
+    private native byte[] nativeRecognizeBatch(
+            int nativePix, int nativePixa, int mode, int[] results);
+
     private native int nativeMeanConfidence();
 
     private native int[] nativeWordConfidences();
 
+    private native String nativeGetPageStats(boolean chromeTrace);
+
     private native boolean nativeSetVariable(String var, String value);
 
     private native void nativeSetDebug(boolean debug);
 
     private native void nativeSetPageSegMode(int mode);
+
+    private native void nativeSetTimeout(int milliseconds);
+
+    private native void nativeSetReportRows(boolean reportRows);
+
+    private native void nativeStop();
     
     private native int nativeGetRegions();
 